@@ -0,0 +1,661 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <string>
+#endif
+
+#include <Base/Exception.h>
+
+#include "Application.h"
+#include "CompiledExpression.h"
+#include "DocumentObject.h"
+#include "ExpressionParser.h"
+#include "PropertyStandard.h"
+#include "PropertyUnits.h"
+
+
+using namespace App;
+
+namespace
+{
+
+std::atomic<unsigned long> structureRevision {1};
+
+// Largest magnitude up to which a double holds every integer, beyond that the
+// result of Python's unbounded integers can't be reproduced.
+constexpr double maxExactInteger = 9007199254740992.0;  // 2^53
+
+void connectSignals()
+{
+    static const bool connected = [] {
+        auto objectChanged = [](const DocumentObject&) {
+            CompiledExpression::invalidate();
+        };
+        auto propertyChanged = [](const Property&) {
+            CompiledExpression::invalidate();
+        };
+        auto documentChanged = [](const Document&) {
+            CompiledExpression::invalidate();
+        };
+
+        // The connections live as long as the application
+        Application& app = GetApplication();
+        app.signalNewObject.connect(objectChanged);
+        app.signalDeletedObject.connect(objectChanged);
+        app.signalRelabelObject.connect(objectChanged);
+        app.signalAppendDynamicProperty.connect(propertyChanged);
+        app.signalRemoveDynamicProperty.connect(propertyChanged);
+        app.signalNewDocument.connect([](const Document&, bool) {
+            CompiledExpression::invalidate();
+        });
+        app.signalDeleteDocument.connect(documentChanged);
+        app.signalRelabelDocument.connect(documentChanged);
+        app.signalRenameDocument.connect(documentChanged);
+        app.signalFinishRestoreDocument.connect(documentChanged);
+        app.signalUndoDocument.connect(documentChanged);
+        app.signalRedoDocument.connect(documentChanged);
+        return true;
+    }();
+    (void)connected;
+}
+
+// Same as pyFromQuantity() in Expression.cpp
+bool fromQuantity(const Base::Quantity& quantity, CompiledExpression::Value& value)
+{
+    value.quantity = quantity;
+    if (!quantity.getUnit().isEmpty()) {
+        value.kind = CompiledExpression::Kind::Quantity;
+        return true;
+    }
+    double intpart {};
+    if (std::modf(quantity.getValue(), &intpart) == 0.0 && std::isfinite(intpart)) {
+        if (intpart >= INT_MIN && intpart <= INT_MAX) {
+            value.kind = CompiledExpression::Kind::Integer;
+            return true;
+        }
+        // Values beyond int are converted with a narrowing cast there
+        if (intpart >= static_cast<double>(LONG_MIN) && intpart <= static_cast<double>(LONG_MAX)) {
+            return false;
+        }
+    }
+    value.kind = CompiledExpression::Kind::Float;
+    return true;
+}
+
+bool isTrue(const CompiledExpression::Value& value)
+{
+    return value.quantity.getValue() != 0.0;
+}
+
+void setNumber(CompiledExpression::Value& value, CompiledExpression::Kind kind, double number)
+{
+    value.kind = kind;
+    value.quantity = Base::Quantity(number);
+}
+
+bool load(const Property* prop, CompiledExpression::Kind kind, CompiledExpression::Value& value)
+{
+    switch (kind) {
+        case CompiledExpression::Kind::Quantity:
+            value.kind = kind;
+            value.quantity = static_cast<const PropertyQuantity*>(prop)->getQuantityValue();
+            return true;
+        case CompiledExpression::Kind::Float:
+            setNumber(value, kind, static_cast<const PropertyFloat*>(prop)->getValue());
+            return true;
+        case CompiledExpression::Kind::Integer: {
+            auto number = static_cast<double>(static_cast<const PropertyInteger*>(prop)->getValue());
+            setNumber(value, kind, number);
+            return std::fabs(number) <= maxExactInteger;
+        }
+        case CompiledExpression::Kind::Boolean:
+            setNumber(value, kind, static_cast<const PropertyBool*>(prop)->getValue() ? 1.0 : 0.0);
+            return true;
+    }
+    return false;
+}
+
+// PyNumber_Negative() and PyNumber_Positive()
+bool unary(int op, CompiledExpression::Value& value)
+{
+    using Kind = CompiledExpression::Kind;
+    switch (op) {
+        case OperatorExpression::NEG:
+            if (value.kind == Kind::Quantity) {
+                value.quantity = value.quantity * -1.0;
+            }
+            else if (value.kind == Kind::Float) {
+                setNumber(value, Kind::Float, -value.quantity.getValue());
+            }
+            else {
+                // Integers have no negative zero
+                setNumber(value, Kind::Integer, 0.0 - value.quantity.getValue());
+            }
+            return true;
+        case OperatorExpression::POS:
+            if (value.kind == Kind::Boolean) {
+                value.kind = Kind::Integer;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// PyObject_RichCompareBool(), see QuantityPy::richCompare() for quantities
+bool compare(int op, const CompiledExpression::Value& left, const CompiledExpression::Value& right)
+{
+    if (left.kind == CompiledExpression::Kind::Quantity
+        && right.kind == CompiledExpression::Kind::Quantity) {
+        const Base::Quantity& a = left.quantity;
+        const Base::Quantity& b = right.quantity;
+        switch (op) {
+            case OperatorExpression::EQ:
+                return a == b;
+            case OperatorExpression::NEQ:
+                return !(a == b);
+            case OperatorExpression::LT:
+                return a < b;
+            case OperatorExpression::LTE:
+                return a < b || a == b;
+            case OperatorExpression::GT:
+                return !(a < b) && !(a == b);
+            default:
+                return !(a < b);
+        }
+    }
+
+    double a = left.quantity.getValue();
+    double b = right.quantity.getValue();
+    switch (op) {
+        case OperatorExpression::EQ:
+            return a == b;
+        case OperatorExpression::NEQ:
+            return a != b;
+        case OperatorExpression::LT:
+            return a < b;
+        case OperatorExpression::LTE:
+            return a <= b;
+        case OperatorExpression::GT:
+            return a > b;
+        default:
+            return a >= b;
+    }
+}
+
+// Arithmetic of Python int, float and bool
+bool arithmetic(int op, CompiledExpression::Value& left, const CompiledExpression::Value& right)
+{
+    using Kind = CompiledExpression::Kind;
+    double a = left.quantity.getValue();
+    double b = right.quantity.getValue();
+    bool integer = left.kind != Kind::Float && right.kind != Kind::Float;
+    double result {};
+
+    switch (op) {
+        case OperatorExpression::ADD:
+            result = a + b;
+            break;
+        case OperatorExpression::SUB:
+            result = a - b;
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            result = a * b;
+            break;
+        case OperatorExpression::DIV:
+            // ZeroDivisionError
+            if (b == 0.0) {
+                return false;
+            }
+            result = a / b;
+            integer = false;
+            break;
+        case OperatorExpression::POW:
+            // ZeroDivisionError
+            if (a == 0.0 && b < 0.0) {
+                return false;
+            }
+            if (integer) {
+                integer = b >= 0.0;
+            }
+            else if (a < 0.0 && b != std::floor(b)) {
+                // Complex result
+                return false;
+            }
+            result = std::pow(a, b);
+            // OverflowError
+            if (!integer && std::isinf(result) && std::isfinite(a) && std::isfinite(b)) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    if (integer && std::fabs(result) > maxExactInteger) {
+        return false;
+    }
+    setNumber(left, integer ? Kind::Integer : Kind::Float, result);
+    return true;
+}
+
+// The number handlers of QuantityPy
+bool quantityArithmetic(int op, CompiledExpression::Value& left, const CompiledExpression::Value& right)
+{
+    using Kind = CompiledExpression::Kind;
+    switch (op) {
+        case OperatorExpression::ADD:
+            left.quantity = left.quantity + right.quantity;
+            break;
+        case OperatorExpression::SUB:
+            left.quantity = left.quantity - right.quantity;
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            left.quantity = left.quantity * right.quantity;
+            break;
+        case OperatorExpression::DIV:
+            left.quantity = left.quantity / right.quantity;
+            break;
+        case OperatorExpression::POW:
+            // Only a quantity can be raised to a power
+            if (left.kind != Kind::Quantity) {
+                return false;
+            }
+            if (right.kind == Kind::Quantity) {
+                left.quantity = left.quantity.pow(right.quantity);
+            }
+            else {
+                left.quantity = left.quantity.pow(right.quantity.getValue());
+            }
+            break;
+        default:
+            return false;
+    }
+    left.kind = Kind::Quantity;
+    return true;
+}
+
+bool binary(int op, CompiledExpression::Value& left, const CompiledExpression::Value& right)
+{
+    switch (op) {
+        case OperatorExpression::EQ:
+        case OperatorExpression::NEQ:
+        case OperatorExpression::LT:
+        case OperatorExpression::LTE:
+        case OperatorExpression::GT:
+        case OperatorExpression::GTE:
+            setNumber(left, CompiledExpression::Kind::Boolean, compare(op, left, right) ? 1.0 : 0.0);
+            return true;
+        default:
+            break;
+    }
+    if (left.kind == CompiledExpression::Kind::Quantity
+        || right.kind == CompiledExpression::Kind::Quantity) {
+        return quantityArithmetic(op, left, right);
+    }
+    return arithmetic(op, left, right);
+}
+
+bool isScalarFunction(int f)
+{
+    switch (f) {
+        case FunctionExpression::ABS:
+        case FunctionExpression::ACOS:
+        case FunctionExpression::ASIN:
+        case FunctionExpression::ATAN:
+        case FunctionExpression::ATAN2:
+        case FunctionExpression::CATH:
+        case FunctionExpression::CBRT:
+        case FunctionExpression::CEIL:
+        case FunctionExpression::COS:
+        case FunctionExpression::COSH:
+        case FunctionExpression::EXP:
+        case FunctionExpression::FLOOR:
+        case FunctionExpression::HYPOT:
+        case FunctionExpression::LOG:
+        case FunctionExpression::LOG10:
+        case FunctionExpression::MOD:
+        case FunctionExpression::POW:
+        case FunctionExpression::ROUND:
+        case FunctionExpression::SIN:
+        case FunctionExpression::SINH:
+        case FunctionExpression::SQRT:
+        case FunctionExpression::TAN:
+        case FunctionExpression::TANH:
+        case FunctionExpression::TRUNC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isSupportedOperator(int op)
+{
+    switch (op) {
+        case OperatorExpression::ADD:
+        case OperatorExpression::SUB:
+        case OperatorExpression::MUL:
+        case OperatorExpression::DIV:
+        case OperatorExpression::POW:
+        case OperatorExpression::EQ:
+        case OperatorExpression::NEQ:
+        case OperatorExpression::LT:
+        case OperatorExpression::GT:
+        case OperatorExpression::LTE:
+        case OperatorExpression::GTE:
+        case OperatorExpression::UNIT:
+        case OperatorExpression::NEG:
+        case OperatorExpression::POS:
+            return true;
+        default:
+            // The remainder also formats strings
+            return false;
+    }
+}
+
+}  // namespace
+
+unsigned long CompiledExpression::revision()
+{
+    return structureRevision.load(std::memory_order_acquire);
+}
+
+void CompiledExpression::invalidate()
+{
+    structureRevision.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(const Expression* expr)
+{
+    // Property bindings need an owner, and with it the application
+    if (!expr || !expr->getOwner()) {
+        return {};
+    }
+    connectSignals();
+
+    std::unique_ptr<CompiledExpression> program(new CompiledExpression);
+    bool constant = false;
+    if (!program->compileNode(expr, constant)) {
+        return {};
+    }
+    return program;
+}
+
+void CompiledExpression::push(int index)
+{
+    Instruction instruction {OpCode::Push};
+    instruction.index = index;
+    code.push_back(instruction);
+    maxDepth = std::max(maxDepth, ++depth);
+}
+
+bool CompiledExpression::fold(std::size_t begin)
+{
+    // Evaluating a constant sub-expression here also checks its units once
+    Value value;
+    if (!run(begin, code.size(), value)) {
+        return false;
+    }
+    code.resize(begin);
+    --depth;
+    constants.push_back(value);
+    push(static_cast<int>(constants.size()) - 1);
+    return true;
+}
+
+bool CompiledExpression::compileNode(const Expression* expr, bool& constant)
+{
+    if (expr->hasComponent()) {
+        return false;
+    }
+
+    std::size_t begin = code.size();
+    Base::Type type = expr->getTypeId();
+
+    if (type == UnitExpression::getClassTypeId() || type == NumberExpression::getClassTypeId()) {
+        Value value;
+        if (!fromQuantity(static_cast<const UnitExpression*>(expr)->getQuantity(), value)) {
+            return false;
+        }
+        constants.push_back(value);
+        push(static_cast<int>(constants.size()) - 1);
+        constant = true;
+        return true;
+    }
+
+    if (type == ConstantExpression::getClassTypeId()) {
+        auto cexpr = static_cast<const ConstantExpression*>(expr);
+        Value value;
+        std::string name = cexpr->getName();
+        if (name == "True" || name == "False") {
+            setNumber(value, Kind::Boolean, name == "True" ? 1.0 : 0.0);
+        }
+        else if (name == "None" || !fromQuantity(cexpr->getQuantity(), value)) {
+            return false;
+        }
+        constants.push_back(value);
+        push(static_cast<int>(constants.size()) - 1);
+        constant = true;
+        return true;
+    }
+
+    if (type == OperatorExpression::getClassTypeId()) {
+        auto oexpr = static_cast<const OperatorExpression*>(expr);
+        int op = oexpr->getOperator();
+        if (!isSupportedOperator(op)) {
+            return false;
+        }
+
+        bool leftConstant = false;
+        if (!compileNode(oexpr->getLeft(), leftConstant)) {
+            return false;
+        }
+        Instruction instruction {OpCode::Unary};
+        instruction.operation = op;
+        constant = leftConstant;
+        if (op != OperatorExpression::NEG && op != OperatorExpression::POS) {
+            bool rightConstant = false;
+            if (!compileNode(oexpr->getRight(), rightConstant)) {
+                return false;
+            }
+            instruction.code = OpCode::Binary;
+            constant = constant && rightConstant;
+            --depth;
+        }
+        code.push_back(instruction);
+        return !constant || fold(begin);
+    }
+
+    if (type == ConditionalExpression::getClassTypeId()) {
+        auto cexpr = static_cast<const ConditionalExpression*>(expr);
+        bool conditionConstant = false;
+        bool trueConstant = false;
+        bool falseConstant = false;
+        if (!compileNode(cexpr->getCondition(), conditionConstant)) {
+            return false;
+        }
+        std::size_t jumpIfFalse = code.size();
+        code.push_back(Instruction {OpCode::JumpIfFalse});
+        --depth;
+
+        if (!compileNode(cexpr->getTrueExpr(), trueConstant)) {
+            return false;
+        }
+        std::size_t jump = code.size();
+        code.push_back(Instruction {OpCode::Jump});
+        // Only one of the branches leaves its value on the stack
+        --depth;
+
+        code[jumpIfFalse].index = static_cast<int>(code.size());
+        if (!compileNode(cexpr->getFalseExpr(), falseConstant)) {
+            return false;
+        }
+        code[jump].index = static_cast<int>(code.size());
+
+        constant = conditionConstant && trueConstant && falseConstant;
+        return !constant || fold(begin);
+    }
+
+    if (type == FunctionExpression::getClassTypeId()) {
+        auto fexpr = static_cast<const FunctionExpression*>(expr);
+        const auto& args = fexpr->getArgs();
+        if (!isScalarFunction(fexpr->getFunction()) || args.empty()) {
+            return false;
+        }
+
+        // Further arguments are ignored by the interpreter as well
+        int count = static_cast<int>(std::min<std::size_t>(args.size(), 3));
+        constant = true;
+        for (int i = 0; i < count; ++i) {
+            bool argConstant = false;
+            if (!compileNode(args[i], argConstant)) {
+                return false;
+            }
+            constant = constant && argConstant;
+        }
+        Instruction instruction {OpCode::Function};
+        instruction.operation = fexpr->getFunction();
+        instruction.count = count;
+        code.push_back(instruction);
+        depth -= count - 1;
+        return !constant || fold(begin);
+    }
+
+    if (type == VariableExpression::getClassTypeId()) {
+        ObjectIdentifier path = static_cast<const VariableExpression*>(expr)->getPath();
+        if (!path.getSubObjectName().empty() || path.numSubComponents() != 1) {
+            return false;
+        }
+
+        // Pseudo properties, e.g. _shape or _pla, are computed in Python
+        int ptype = -1;
+        const Property* prop = path.getProperty(&ptype);
+        if (!prop || ptype != 0 || prop->getContainer() != path.getDocumentObject()) {
+            return false;
+        }
+
+        Instruction instruction {OpCode::Load};
+        instruction.property = prop;
+        if (prop->isDerivedFrom(PropertyQuantity::getClassTypeId())) {
+            instruction.kind = Kind::Quantity;
+        }
+        else if (prop->isDerivedFrom(PropertyFloat::getClassTypeId())) {
+            instruction.kind = Kind::Float;
+        }
+        else if (prop->isDerivedFrom(PropertyInteger::getClassTypeId())) {
+            instruction.kind = Kind::Integer;
+        }
+        else if (prop->isDerivedFrom(PropertyBool::getClassTypeId())) {
+            instruction.kind = Kind::Boolean;
+        }
+        else {
+            return false;
+        }
+        code.push_back(instruction);
+        maxDepth = std::max(maxDepth, ++depth);
+        return true;
+    }
+
+    return false;
+}
+
+bool CompiledExpression::evaluate(Value& result) const
+{
+    return run(0, code.size(), result);
+}
+
+bool CompiledExpression::run(std::size_t begin, std::size_t end, Value& result) const
+{
+    // One stack per thread, so that cells can be evaluated concurrently
+    thread_local std::vector<Value> stack;
+    if (stack.size() < static_cast<std::size_t>(maxDepth)) {
+        stack.resize(maxDepth);
+    }
+
+    int top = 0;
+    try {
+        for (std::size_t pc = begin; pc < end;) {
+            const Instruction& instruction = code[pc++];
+            switch (instruction.code) {
+                case OpCode::Push:
+                    stack[top++] = constants[instruction.index];
+                    break;
+                case OpCode::Load:
+                    if (!load(instruction.property, instruction.kind, stack[top++])) {
+                        return false;
+                    }
+                    break;
+                case OpCode::Unary:
+                    if (!unary(instruction.operation, stack[top - 1])) {
+                        return false;
+                    }
+                    break;
+                case OpCode::Binary:
+                    --top;
+                    if (!binary(instruction.operation, stack[top - 1], stack[top])) {
+                        return false;
+                    }
+                    break;
+                case OpCode::Function: {
+                    top -= instruction.count;
+                    const Value* args = &stack[top];
+                    Base::Quantity value = FunctionExpression::evaluateQuantity(
+                        nullptr,
+                        instruction.operation,
+                        args[0].quantity,
+                        instruction.count > 1 ? &args[1].quantity : nullptr,
+                        instruction.count > 2 ? &args[2].quantity : nullptr);
+                    stack[top].kind = Kind::Quantity;
+                    stack[top++].quantity = value;
+                    break;
+                }
+                case OpCode::Jump:
+                    pc = instruction.index;
+                    break;
+                case OpCode::JumpIfFalse:
+                    if (!isTrue(stack[--top])) {
+                        pc = instruction.index;
+                    }
+                    break;
+            }
+        }
+    }
+    catch (const Base::Exception&) {
+        // Unit mismatches and invalid function arguments
+        return false;
+    }
+
+    if (top != 1) {
+        return false;
+    }
+    result = stack[0];
+    return true;
+}
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef APP_COMPILEDEXPRESSION_H
+#define APP_COMPILEDEXPRESSION_H
+
+#include <memory>
+#include <vector>
+
+#include <Base/Quantity.h>
+#include <FCGlobal.h>
+
+
+namespace App
+{
+
+class Expression;
+class Property;
+
+/**
+ * @brief Flat, Python free form of a numeric expression.
+ *
+ * An expression made only of numbers, units, constants, arithmetic and
+ * comparison operators, conditionals, scalar functions and plain references to
+ * numeric properties is compiled into a short instruction list. The properties
+ * are resolved once, at compile time, and constant sub-expressions are folded,
+ * which also checks their units.
+ *
+ * Evaluating the program gives the same value as Expression::getPyValue(). It
+ * bails out instead of raising an error, and the caller then falls back to the
+ * interpreter to get the exact error message.
+ *
+ * The property bindings stay valid until the document structure changes, see
+ * revision().
+ */
+class AppExport CompiledExpression
+{
+public:
+    /// Python type the interpreter would give the value
+    enum class Kind
+    {
+        Integer,
+        Float,
+        Boolean,
+        Quantity,
+    };
+
+    struct Value
+    {
+        Kind kind {Kind::Integer};
+        Base::Quantity quantity;
+    };
+
+    /** Compile \a expr
+     *
+     * @return The program, or null if \a expr is not supported.
+     */
+    static std::unique_ptr<CompiledExpression> compile(const Expression* expr);
+
+    /** Run the program
+     *
+     * @return False if the result can't be computed without the interpreter.
+     * This is the case for all errors.
+     */
+    bool evaluate(Value& result) const;
+
+    /** Structure revision
+     *
+     * Changes whenever objects, dynamic properties or documents are added,
+     * removed or renamed, or references in an expression are rewritten. A
+     * program compiled at an older revision must be compiled again.
+     */
+    static unsigned long revision();
+
+    /// Increment the structure revision
+    static void invalidate();
+
+private:
+    enum class OpCode
+    {
+        Push,         // push constants[index]
+        Load,         // push the value of property
+        Unary,        // apply operation to the top of the stack
+        Binary,       // apply operation to the two top most values
+        Function,     // call function operation with count arguments
+        Jump,         // continue at index
+        JumpIfFalse,  // pop the top value, continue at index if it is false
+    };
+
+    struct Instruction
+    {
+        OpCode code;
+        int operation {0};
+        int index {0};
+        int count {0};
+        Kind kind {Kind::Integer};
+        const Property* property {nullptr};
+    };
+
+    CompiledExpression() = default;
+
+    bool compileNode(const Expression* expr, bool& constant);
+    bool fold(std::size_t begin);
+    void push(int index);
+    bool run(std::size_t begin, std::size_t end, Value& result) const;
+
+    std::vector<Instruction> code;
+    std::vector<Value> constants;
+    int depth {0};
+    int maxDepth {0};
+};
+
+}  // namespace App
+
+#endif  // APP_COMPILEDEXPRESSION_H
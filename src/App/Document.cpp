@@ -75,7 +75,13 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 #endif //USE_OLD_DAG
 
 #include <boost/regex.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <random>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -138,6 +144,70 @@ namespace App {
 static bool globalIsRestoring;
 static bool globalIsRelabeling;
 
+// Runs the property change notifications raised by the worker threads of a
+// parallel recompute on the main thread, see Document::_recomputeBatch()
+class RecomputeNotifier
+{
+public:
+    explicit RecomputeNotifier(int workers)
+        : workers(workers)
+    {}
+
+    /// called by a worker, returns once the main thread has run \a func
+    void run(const std::function<void()> &func)
+    {
+        Task task {&func};
+        std::unique_lock<std::mutex> lock(mutex);
+        tasks.push_back(&task);
+        cond.notify_all();
+        cond.wait(lock, [&task]() { return task.done; });
+        if (task.error)
+            std::rethrow_exception(task.error);
+    }
+
+    /// called by a worker when it has nothing more to do
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --workers;
+        cond.notify_all();
+    }
+
+    /// called by the main thread, runs the notifications until all workers have finished
+    void process()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cond.wait(lock, [this]() { return !tasks.empty() || workers == 0; });
+            if (tasks.empty())
+                return;
+            Task *task = tasks.front();
+            tasks.pop_front();
+            lock.unlock();
+            try {
+                (*task->func)();
+            }
+            catch (...) {
+                task->error = std::current_exception();
+            }
+            lock.lock();
+            task->done = true;
+            cond.notify_all();
+        }
+    }
+
+private:
+    struct Task {
+        const std::function<void()> *func;
+        bool done = false;
+        std::exception_ptr error;
+    };
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Task*> tasks;
+    int workers;
+};
+
 DocumentP::DocumentP()
 {
     Hasher = new StringHasher;
@@ -500,6 +570,12 @@ void Document::_commitTransaction(bool notify)
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        while(d->UndoMemSize && mUndoTransactions.size() > 1
+                && getUndoMemSize() > d->UndoMemSize) {
+            mUndoMap.erase(mUndoTransactions.front()->getID());
+            delete mUndoTransactions.front();
+            mUndoTransactions.pop_front();
+        }
         signalCommitTransaction(*this);
 
         // closeActiveTransaction() may call again _commitTransaction()
@@ -691,7 +767,12 @@ int Document::getUndoMode() const
 
 unsigned int Document::getUndoMemSize () const
 {
-    return d->UndoMemSize;
+    unsigned int size = 0;
+    for (auto transaction : mUndoTransactions)
+        size += transaction->getMemSize();
+    for (auto transaction : mRedoTransactions)
+        size += transaction->getMemSize();
+    return size;
 }
 
 void Document::setUndoLimit(unsigned int UndoMemSize)
@@ -864,6 +945,12 @@ Document::Document(const char* documentName)
                       0,
                       PropertyType(Prop_None),
                       "Whether to show hidden object items in the tree view");
+    ADD_PROPERTY_TYPE(BinaryBrep,
+                      (paramGrp->GetBool("SaveBinaryBrep", true)),
+                      0,
+                      PropertyType(Prop_None),
+                      "Save shapes in the binary BRep format, which is smaller and faster\n"
+                      "to load than the text format. Both formats are detected on load.");
 
     // this creates and sets 'TransientDir' in onChanged()
     ADD_PROPERTY_TYPE(TransientDir,
@@ -1909,6 +1996,21 @@ private:
 };
 }
 
+void Document::setPreviousArchive(Base::ZipWriter& writer) const
+{
+    auto hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    if (!hGrp->GetBool("IncrementalSave", false) || d->archivePath.empty())
+        return;
+
+    // Do not trust the recorded files if the project file has been replaced
+    Base::FileInfo fi(d->archivePath);
+    if (!fi.isReadable() || fi.size() != d->archiveSize
+            || fi.lastModified().getTime_t() != d->archiveTime)
+        return;
+
+    writer.setPreviousArchive(d->archivePath, d->archiveId);
+}
+
 bool Document::saveToFile(const char* filename) const
 {
     signalStartSave(*this, filename);
@@ -1974,9 +2076,18 @@ bool Document::saveToFile(const char* filename) const
 
         writer.setComment("FreeCAD Document");
         writer.setLevel(compression);
+        // 0 means one thread per core, 1 disables the parallel file writing
+        int threads = hGrp->GetInt("SaveThreads", 0);
+        if (threads <= 0)
+            threads = std::max(1, int(std::thread::hardware_concurrency()));
+        writer.setThreadCount(threads);
+        writer.setArchiveId(uuid);
+        // Without backup policy the previous file is overwritten while writing
+        if (policy)
+            setPreviousArchive(writer);
         writer.putNextEntry("Document.xml");
 
-        if (hGrp->GetBool("SaveBinaryBrep", false))
+        if (BinaryBrep.getValue())
             writer.setMode("BinaryBrep");
 
         writer.Stream() << "<?xml version='1.0' encoding='utf-8'?>" << endl
@@ -2025,6 +2136,12 @@ bool Document::saveToFile(const char* filename) const
         policy.apply(fn, nativePath);
     }
 
+    Base::FileInfo saved(nativePath);
+    d->archivePath = nativePath;
+    d->archiveId = uuid;
+    d->archiveSize = saved.size();
+    d->archiveTime = saved.lastModified().getTime_t();
+
     signalFinishSave(*this, filename);
 
     return true;
@@ -2077,6 +2194,11 @@ void Document::restore (const char *filename,
 
     zipios::ZipInputStream zipstream(file);
     Base::XMLReader reader(filename, zipstream);
+    reader.setLazyRestore(App::GetApplication().GetParameterGroupByPath
+            ("User parameter:BaseApp/Preferences/Document")->GetBool("LazyRestore", false));
+    std::string archiveId = Base::Uuid::createUuid();
+    reader.setArchiveId(archiveId);
+    d->archivePath.clear();
 
     if (!reader.isValid())
         throw Base::FileException("Error reading compression file",filename);
@@ -2108,6 +2230,12 @@ void Document::restore (const char *filename,
         setStatus(Document::PartialRestore, true);
         Base::Console().Error("There were errors while loading the file. Some data might have been modified or not recovered at all. Look above for more specific information about the objects involved.\n");
     }
+    else {
+        d->archivePath = fi.filePath();
+        d->archiveId = archiveId;
+        d->archiveSize = fi.size();
+        d->archiveTime = fi.lastModified().getTime_t();
+    }
 
     if(!delaySignal)
         afterRestore(true);
@@ -2804,6 +2932,7 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
 
     Base::ObjectStatusLocker<Document::Status, Document> exe(Document::Recomputing, this);
     signalBeforeRecompute(*this);
+    RecomputeProfiler::RunGuard profilerRun(d->profiler);
 
 #if 0
     //////////////////////////////////////////////////////////////////////////
@@ -2832,8 +2961,43 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     ParameterGrp::handle hGrp = GetApplication().GetParameterGroupByPath(
             "User parameter:BaseApp/Preferences/Document");
     bool canAbort = hGrp->GetBool("CanAbortRecompute",true);
+    bool parallel = hGrp->GetBool("ParallelRecompute",false);
+
+    if (parallel) {
+        // Regroup the objects by their depth in the dependency graph, so that
+        // independent branches end up next to each other and can be
+        // recomputed in the same batch. The result is still a valid
+        // topological order. Leave the order alone if there is any cycle.
+        std::unordered_map<App::DocumentObject*, int> levels;
+        bool acyclic = true;
+        for (auto obj : topoSortedObjects)
+            levels[obj] = -1;
+        for (auto obj : topoSortedObjects) {
+            int level = 0;
+            for (auto dep : obj->getOutList()) {
+                auto it = levels.find(dep);
+                if (it == levels.end() || dep == obj)
+                    continue;
+                if (it->second < 0) {
+                    acyclic = false;
+                    break;
+                }
+                level = std::max(level, it->second + 1);
+            }
+            if (!acyclic)
+                break;
+            levels[obj] = level;
+        }
+        if (acyclic) {
+            std::stable_sort(topoSortedObjects.begin(), topoSortedObjects.end(),
+                [&levels](App::DocumentObject *a, App::DocumentObject *b) {
+                    return levels[a] < levels[b];
+                });
+        }
+    }
 
     std::set<App::DocumentObject *> filter;
+    std::map<App::DocumentObject *, int> batchResults;
     size_t idx = 0;
 
     FC_TIME_INIT(t2);
@@ -2852,10 +3016,22 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
                     continue;
                 // ask the object if it should be recomputed
                 bool doRecompute = false;
-                if (obj->mustRecompute()) {
+                auto itBatch = batchResults.find(obj);
+                if (itBatch != batchResults.end() || obj->mustRecompute()) {
                     doRecompute = true;
                     ++objectCount;
-                    int res = _recomputeFeature(obj);
+                    int res;
+                    if (itBatch == batchResults.end() && parallel && obj->isExecuteThreadSafe()) {
+                        _recomputeBatch(topoSortedObjects, idx, filter, batchResults);
+                        itBatch = batchResults.find(obj);
+                    }
+                    if (itBatch != batchResults.end()) {
+                        res = itBatch->second;
+                        batchResults.erase(itBatch);
+                    }
+                    else {
+                        res = _recomputeFeature(obj);
+                    }
                     if(res) {
                         if(hasError)
                             *hasError = true;
@@ -2911,6 +3087,7 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
         obj->setStatus(ObjectStatus::Recompute2,false);
     }
 
+    profilerRun.endRun(topoSortedObjects);
     signalRecomputed(*this,topoSortedObjects);
 
     FC_TIME_LOG(t,"Recompute total");
@@ -3119,19 +3296,18 @@ const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
     return d->findRecomputeLog(Obj);
 }
 
-// call the recompute of the Feature and handle the exceptions and errors.
-int Document::_recomputeFeature(DocumentObject* Feat)
+RecomputeProfiler &Document::getRecomputeProfiler()
 {
-    FC_LOG("Recomputing " << Feat->getFullName());
+    return d->profiler;
+}
 
+// run one recompute step of the Feature and handle the exceptions and errors.
+static int _executeFeature(DocumentP *d, DocumentObject* Feat,
+                           const std::function<DocumentObjectExecReturn*()> &func)
+{
     DocumentObjectExecReturn  *returnCode = nullptr;
     try {
-        returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
-        if (returnCode == DocumentObject::StdReturn) {
-            returnCode = Feat->recompute();
-            if(returnCode == DocumentObject::StdReturn)
-                returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
-        }
+        returnCode = func();
     }
     catch(Base::AbortException &e){
         e.ReportException();
@@ -3175,6 +3351,172 @@ int Document::_recomputeFeature(DocumentObject* Feat)
     return 0;
 }
 
+// call the recompute of the Feature and handle the exceptions and errors.
+int Document::_recomputeFeature(DocumentObject* Feat)
+{
+    FC_LOG("Recomputing " << Feat->getFullName());
+
+    bool profiling = d->profiler.isRunning();
+    std::string reason;
+    if (profiling)
+        reason = RecomputeProfiler::getTouchedReason(Feat);
+    Base::TimeElapsed start;
+
+    int res = _executeFeature(d, Feat, [Feat]() {
+        auto returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
+        if (returnCode == DocumentObject::StdReturn) {
+            returnCode = Feat->recompute();
+            if(returnCode == DocumentObject::StdReturn)
+                returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
+        }
+        return returnCode;
+    });
+
+    if (profiling)
+        d->profiler.addRecord(Feat, reason, Base::TimeElapsed::diffTimeF(start), res != 0);
+    return res;
+}
+
+void Document::_recomputeBatch(const std::vector<App::DocumentObject*> &objs, size_t idx,
+                               const std::set<App::DocumentObject*> &filter,
+                               std::map<App::DocumentObject*, int> &results)
+{
+    // Collect the consecutive thread safe objects that do not depend on each
+    // other. Because the objects are topologically sorted, any dependency
+    // path between two of them must go through the objects in between, so
+    // it is enough to check the direct dependencies. Objects that have
+    // nothing to do are skipped over but still count as batch members.
+    std::vector<App::DocumentObject*> batch;
+    std::set<App::DocumentObject*> members;
+    for (; idx < objs.size(); ++idx) {
+        auto obj = objs[idx];
+        if (!obj->isAttachedToDocument() || filter.count(obj))
+            continue;
+        bool depends = false;
+        for (auto dep : obj->getOutList()) {
+            if (members.count(dep)) {
+                depends = true;
+                break;
+            }
+        }
+        if (depends)
+            break;
+        if (obj->mustRecompute()) {
+            if (!obj->isExecuteThreadSafe())
+                break;
+            batch.push_back(obj);
+        }
+        else if (obj->isTouched()) {
+            break;
+        }
+        members.insert(obj);
+    }
+
+    bool profiling = d->profiler.isRunning();
+    std::map<App::DocumentObject*, std::pair<std::string, double> > profile;
+
+    // Expressions may call into Python, so evaluate them on the main thread
+    std::vector<App::DocumentObject*> pending;
+    pending.reserve(batch.size());
+    for (auto obj : batch) {
+        FC_LOG("Recomputing " << obj->getFullName() << " in parallel");
+        std::string reason;
+        if (profiling)
+            reason = RecomputeProfiler::getTouchedReason(obj);
+        Base::TimeElapsed start;
+        int res = _executeFeature(d, obj, [obj]() {
+            return obj->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
+        });
+        if (profiling)
+            profile[obj] = std::make_pair(reason, Base::TimeElapsed::diffTimeF(start));
+        if (res)
+            results[obj] = res;
+        else
+            pending.push_back(obj);
+    }
+
+    std::vector<int> codes(pending.size(), 0);
+    std::vector<double> times(pending.size(), 0.0);
+    if (pending.size() == 1) {
+        Base::TimeElapsed start;
+        codes[0] = _executeFeature(d, pending[0], [obj = pending[0]]() {
+            return obj->recompute();
+        });
+        times[0] = Base::TimeElapsed::diffTimeF(start);
+    }
+    else if (!pending.empty()) {
+        ParameterGrp::handle hGrp = GetApplication().GetParameterGroupByPath(
+                "User parameter:BaseApp/Preferences/Document");
+        int threads = hGrp->GetInt("RecomputeThreads", 0);
+        if (threads <= 0)
+            threads = std::max(1, int(std::thread::hardware_concurrency()));
+        threads = std::min(threads, int(pending.size()));
+
+        // The workers only run recompute(). The property change notifications
+        // they raise are run here on the main thread one at a time, while the
+        // raising worker waits. So the observers get them in order, with the
+        // 'before change' before the value is changed. The results and
+        // errors are reported here as well once all workers are done.
+        std::vector<DocumentObjectExecReturn*> returns(pending.size(), nullptr);
+        std::vector<std::exception_ptr> errors(pending.size());
+        RecomputeNotifier notifier(threads);
+        std::atomic<size_t> next(0);
+        auto worker = [&pending, &returns, &errors, &times, &notifier, &next]() {
+            Property::Notifier notify = [&notifier](const std::function<void()> &func) {
+                notifier.run(func);
+            };
+            Property::setNotifier(&notify);
+            for (size_t i = next++; i < pending.size(); i = next++) {
+                Base::TimeElapsed start;
+                try {
+                    returns[i] = pending[i]->recompute();
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+                times[i] = Base::TimeElapsed::diffTimeF(start);
+            }
+            Property::setNotifier(nullptr);
+            notifier.finish();
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back(worker);
+        notifier.process();
+        for (auto &t : workers)
+            t.join();
+
+        for (size_t i = 0; i < pending.size(); ++i) {
+            codes[i] = _executeFeature(d, pending[i], [&returns, &errors, i]() {
+                if (errors[i])
+                    std::rethrow_exception(errors[i]);
+                return returns[i];
+            });
+        }
+    }
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        auto obj = pending[i];
+        Base::TimeElapsed start;
+        if (!codes[i]) {
+            codes[i] = _executeFeature(d, obj, [obj]() {
+                return obj->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
+            });
+        }
+        results[obj] = codes[i];
+        if (profiling)
+            profile[obj].second += times[i] + Base::TimeElapsed::diffTimeF(start);
+    }
+
+    if (profiling) {
+        for (auto obj : batch) {
+            const auto &v = profile[obj];
+            d->profiler.addRecord(obj, v.first, v.second, results[obj] != 0);
+        }
+    }
+}
+
 bool Document::recomputeFeature(DocumentObject* Feat, bool recursive)
 {
     // delete recompute log
@@ -3187,7 +3529,10 @@ bool Document::recomputeFeature(DocumentObject* Feat, bool recursive)
             recompute({Feat},true,&hasError);
             return !hasError;
         } else {
+            // a call during a document recompute is recorded in its run
+            RecomputeProfiler::RunGuard profilerRun(d->profiler, !d->profiler.isRunning());
             _recomputeFeature(Feat);
+            profilerRun.endRun({Feat});
             signalRecomputedObject(*Feat);
             return Feat->isValid();
         }
@@ -39,6 +39,7 @@
 
 namespace Base {
     class Writer;
+    class ZipWriter;
 }
 
 namespace App
@@ -50,6 +51,7 @@ namespace App
     class DocumentPy; // the python document class
     class Application;
     class Transaction;
+    class RecomputeProfiler;
     class StringHasher;
     using StringHasherRef = Base::Reference<StringHasher>;
 }
@@ -117,6 +119,8 @@ public:
     PropertyString TipName;
     /// Whether to show hidden items in TreeView
     PropertyBool ShowHidden;
+    /// Whether to save shapes in the binary instead of the text BRep format
+    PropertyBool BinaryBrep;
     //@}
 
     /** @name Signals of the document */
@@ -194,6 +198,11 @@ public:
     bool save ();
     bool saveAs(const char* file);
     bool saveCopy(const char* file) const;
+    /** Let \a writer copy the unchanged files of the last saved project file
+     * Only done if incremental saving is enabled and the project file has
+     * not been modified by someone else in the meantime.
+     */
+    void setPreviousArchive(Base::ZipWriter& writer) const;
     /// Restore the document from the file in Property Path
     void restore (const char *filename=nullptr,
             bool delaySignal=false, const std::vector<std::string> &objNames={});
@@ -351,6 +360,8 @@ public:
     bool recomputeFeature(DocumentObject* Feat,bool recursive=false);
     /// get the text of the error of a specified object
     const char* getErrorDescription(const App::DocumentObject*) const;
+    /// get the profiler recording the time spent by recompute() in each object
+    RecomputeProfiler &getRecomputeProfiler();
     /// return the status bits
     bool testStatus(Status pos) const;
     /// set the status bits
@@ -567,6 +578,12 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /// helper which recomputes a batch of independent thread safe features
+    /// starting at \a idx of \a objs on worker threads, and stores the
+    /// return code of _recomputeFeature() of each one into \a results
+    void _recomputeBatch(const std::vector<App::DocumentObject*> &objs, size_t idx,
+                         const std::set<App::DocumentObject*> &filter,
+                         std::map<App::DocumentObject*, int> &results);
     void _clearRedos();
 
     /// refresh the internal dependency graph
@@ -445,6 +445,17 @@ public:
     /* Return true to bypass duplicate label checking */
     virtual bool allowDuplicateLabel() const {return false;}
 
+    /** Return true if execute() of this object may run on a worker thread
+     *
+     * Only used by Document::recompute() when the 'ParallelRecompute'
+     * preference is enabled. An object returning true promises that its
+     * execute() only reads its dependencies, only modifies its own
+     * properties and never calls into Python or the GUI. The change
+     * notifications of its properties are run on the main thread while the
+     * worker thread waits, see Property::setNotifier().
+     */
+    virtual bool isExecuteThreadSafe() const {return false;}
+
     /*** Called to let object itself control relabeling
      *
      * @param newLabel: input as the new label, which can be modified by object itself
@@ -31,6 +31,7 @@
 #include "DocumentObject.h"
 #include "DocumentObjectPy.h"
 #include "MergeDocuments.h"
+#include "RecomputeProfiler.h"
 
 // inclusion of the generated files (generated By DocumentPy.xml)
 #include "DocumentPy.h"
@@ -970,6 +971,97 @@ PyObject *DocumentPy::getDependentDocuments(PyObject *args) {
     } PY_CATCH;
 }
 
+PyObject *DocumentPy::getRecomputeProfile(PyObject *args) {
+    if (!PyArg_ParseTuple(args, ""))
+        return nullptr;
+    PY_TRY {
+        Py::List ret;
+        for (const auto &run : getDocumentPtr()->getRecomputeProfiler().getRuns()) {
+            Py::Dict dict;
+            dict.setItem("Run", Py::Long(run.id));
+            dict.setItem("Time", Py::Float(run.time));
+            dict.setItem("CriticalPathTime", Py::Float(run.criticalPathTime));
+            Py::List path;
+            for (const auto &name : run.criticalPath)
+                path.append(Py::String(name));
+            dict.setItem("CriticalPath", path);
+            Py::List objs;
+            for (const auto &record : run.objects) {
+                Py::Dict obj;
+                obj.setItem("Name", Py::String(record.name));
+                obj.setItem("Label", Py::String(record.label));
+                obj.setItem("Type", Py::String(record.type));
+                obj.setItem("Reason", Py::String(record.reason));
+                obj.setItem("Time", Py::Float(record.time));
+                obj.setItem("Count", Py::Long(record.count));
+                obj.setItem("Error", Py::Boolean(record.error));
+                objs.append(obj);
+            }
+            dict.setItem("Objects", objs);
+            ret.append(dict);
+        }
+        return Py::new_reference_to(ret);
+    } PY_CATCH;
+}
+
+PyObject *DocumentPy::exportRecomputeProfile(PyObject *args) {
+    char* fn=nullptr;
+    const char* format="json";
+    if (!PyArg_ParseTuple(args, "|zs",&fn,&format))
+        return nullptr;
+
+    bool csv = false;
+    if (strcmp(format, "csv") == 0) {
+        csv = true;
+    }
+    else if (strcmp(format, "json") != 0) {
+        PyErr_SetString(PyExc_ValueError, "format must be 'json' or 'csv'");
+        return nullptr;
+    }
+
+    PY_TRY {
+        const auto &profiler = getDocumentPtr()->getRecomputeProfiler();
+        if (fn) {
+            Base::FileInfo fi(fn);
+            Base::ofstream str(fi);
+            if (!str.is_open()) {
+                throw Base::FileException("Failed to open file", fi);
+            }
+            if (csv)
+                profiler.writeCSV(str);
+            else
+                profiler.writeJSON(str);
+            str.close();
+            Py_Return;
+        }
+        else {
+            std::stringstream str;
+            if (csv)
+                profiler.writeCSV(str);
+            else
+                profiler.writeJSON(str);
+            return PyUnicode_FromString(str.str().c_str());
+        }
+    } PY_CATCH;
+}
+
+PyObject *DocumentPy::clearRecomputeProfile(PyObject *args) {
+    if (!PyArg_ParseTuple(args, ""))
+        return nullptr;
+    getDocumentPtr()->getRecomputeProfiler().clear();
+    Py_Return;
+}
+
+Py::Boolean DocumentPy::getRecomputeProfiling() const
+{
+    return {getDocumentPtr()->getRecomputeProfiler().isEnabled()};
+}
+
+void DocumentPy::setRecomputeProfiling(Py::Boolean arg)
+{
+    getDocumentPtr()->getRecomputeProfiler().setEnabled(arg.isTrue());
+}
+
 Py::Boolean DocumentPy::getRestoring() const
 {
     return {getDocumentPtr()->testStatus(Document::Status::Restoring)};
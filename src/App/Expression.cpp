@@ -49,6 +49,7 @@
 #include <Base/RotationPy.h>
 #include <Base/VectorPy.h>
 
+#include "CompiledExpression.h"
 #include "ExpressionParser.h"
 
 
@@ -237,8 +238,14 @@ void ExpressionVisitor::getIdentifiers(Expression &e, std::map<App::ObjectIdenti
     e._getIdentifiers(ids);
 }
 
+// The dispatchers below rewrite references in place, which invalidates the
+// property bindings of any compiled expression containing \a e.
+
 bool ExpressionVisitor::adjustLinks(Expression &e, const std::set<App::DocumentObject*> &inList) {
-    return e._adjustLinks(inList,*this);
+    if(!e._adjustLinks(inList,*this))
+        return false;
+    CompiledExpression::invalidate();
+    return true;
 }
 
 void ExpressionVisitor::importSubNames(Expression &e, const ObjectIdentifier::SubNameMap &subNameMap) {
@@ -252,19 +259,28 @@ void ExpressionVisitor::updateLabelReference(Expression &e,
 }
 
 bool ExpressionVisitor::updateElementReference(Expression &e, App::DocumentObject *feature, bool reverse) {
-    return e._updateElementReference(feature,reverse,*this);
+    if(!e._updateElementReference(feature,reverse,*this))
+        return false;
+    CompiledExpression::invalidate();
+    return true;
 }
 
 bool ExpressionVisitor::relabeledDocument(
         Expression &e, const std::string &oldName, const std::string &newName)
 {
-    return e._relabeledDocument(oldName,newName,*this);
+    if(!e._relabeledDocument(oldName,newName,*this))
+        return false;
+    CompiledExpression::invalidate();
+    return true;
 }
 
 bool ExpressionVisitor::renameObjectIdentifier(Expression &e,
         const std::map<ObjectIdentifier,ObjectIdentifier> &paths, const ObjectIdentifier &path)
 {
-    return e._renameObjectIdentifier(paths,path,*this);
+    if(!e._renameObjectIdentifier(paths,path,*this))
+        return false;
+    CompiledExpression::invalidate();
+    return true;
 }
 
 void ExpressionVisitor::collectReplacement(Expression &e,
@@ -276,10 +292,12 @@ void ExpressionVisitor::collectReplacement(Expression &e,
 
 void ExpressionVisitor::moveCells(Expression &e, const CellAddress &address, int rowCount, int colCount) {
     e._moveCells(address,rowCount,colCount,*this);
+    CompiledExpression::invalidate();
 }
 
 void ExpressionVisitor::offsetCells(Expression &e, int rowOffset, int colOffset) {
     e._offsetCells(rowOffset,colOffset,*this);
+    CompiledExpression::invalidate();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1106,7 +1124,33 @@ ExpressionPtr Expression::replaceObject(const DocumentObject *parent,
     return ExpressionPtr(expr);
 }
 
+const CompiledExpression *Expression::getCompiled() const {
+    if(!owner)
+        return nullptr;
+    // Read the revision first, so that a change during compilation is caught
+    // on the next evaluation.
+    unsigned long revision = CompiledExpression::revision();
+    if(compiledRevision != revision) {
+        compiled = CompiledExpression::compile(this);
+        compiledRevision = revision;
+    }
+    return compiled.get();
+}
+
 App::any Expression::getValueAsAny() const {
+    CompiledExpression::Value value;
+    auto program = getCompiled();
+    if(program && program->evaluate(value)) {
+        switch(value.kind) {
+        case CompiledExpression::Kind::Quantity:
+            return App::any(value.quantity);
+        case CompiledExpression::Kind::Float:
+            return App::any(value.quantity.getValue());
+        default:
+            return App::any(static_cast<long>(value.quantity.getValue()));
+        }
+    }
+
     Base::PyGILStateLocker lock;
     return pyObjectToAny(getPyValue());
 }
@@ -1138,6 +1182,17 @@ void Expression::visit(ExpressionVisitor &v) {
 }
 
 Expression* Expression::eval() const {
+    CompiledExpression::Value value;
+    auto program = getCompiled();
+    if(program && program->evaluate(value)) {
+        if(value.kind == CompiledExpression::Kind::Boolean) {
+            if(value.quantity.getValue() != 0.0)
+                return new ConstantExpression(owner,"True",Quantity(1.0));
+            return new ConstantExpression(owner,"False",Quantity(0.0));
+        }
+        return new NumberExpression(owner,value.quantity);
+    }
+
     Base::PyGILStateLocker lock;
     return expressionFromPy(owner,getPyValue());
 }
@@ -2407,6 +2462,38 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         v3 = pyToQuantity(e3,expr,"Invalid third argument.");
     }
 
+    switch (f) {
+    case ROTATIONX:
+    case ROTATIONY:
+    case ROTATIONZ:
+        if (!(v1.isDimensionlessOrUnit(Unit::Angle)))
+            _EXPR_THROW("Unit must be either empty or an angle.", expr);
+        return Py::asObject(new Base::RotationPy(Base::Rotation(
+            Vector3d(static_cast<double>(f == ROTATIONX), static_cast<double>(f == ROTATIONY), static_cast<double>(f == ROTATIONZ)),
+            v1.getValue() * M_PI / 180.0)));
+    case TRANSLATIONM:
+        if (v1.isDimensionlessOrUnit(Unit::Length) && v2.isDimensionlessOrUnit(Unit::Length) && v3.isDimensionlessOrUnit(Unit::Length))
+            return translationMatrix(v1.getValue(), v2.getValue(), v3.getValue());
+        _EXPR_THROW("Translation units must be a length or dimensionless.", expr);
+    default:
+        break;
+    }
+
+    Quantity res = evaluateQuantity(expr, f, v1,
+            e2.isNone() ? nullptr : &v2, e3.isNone() ? nullptr : &v3);
+    return Py::asObject(new QuantityPy(new Quantity(res)));
+}
+
+/**
+  * Evaluate the function \a f of numbers and quantities. The arguments \a v2 and
+  * \a v3 are null if not given.
+  *
+  * @returns The result, always a quantity.
+  */
+
+Quantity FunctionExpression::evaluateQuantity(const Expression *expr, int f,
+        const Quantity &v1, const Quantity *v2, const Quantity *v3)
+{
     double output;
     Unit unit;
     double scaler = 1;
@@ -2418,9 +2505,6 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     case COS:
     case SIN:
     case TAN:
-    case ROTATIONX:
-    case ROTATIONY:
-    case ROTATIONZ:
         if (!(v1.isDimensionlessOrUnit(Unit::Angle)))
             _EXPR_THROW("Unit must be either empty or an angle.", expr);
 
@@ -2504,28 +2588,28 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         break;
     }
     case ATAN2:
-        if (e2.isNone())
+        if (!v2)
             _EXPR_THROW("Invalid second argument.",expr);
 
-        if (v1.getUnit() != v2.getUnit())
+        if (v1.getUnit() != v2->getUnit())
             _EXPR_THROW("Units must be equal.",expr);
         unit = Unit::Angle;
         scaler = 180.0 / M_PI;
         break;
     case MOD:
-        if (e2.isNone())
+        if (!v2)
             _EXPR_THROW("Invalid second argument.",expr);
-        unit = v1.getUnit() / v2.getUnit();
+        unit = v1.getUnit() / v2->getUnit();
         break;
     case POW: {
-        if (e2.isNone())
+        if (!v2)
             _EXPR_THROW("Invalid second argument.",expr);
 
-        if (!v2.isDimensionless())
+        if (!v2->isDimensionless())
             _EXPR_THROW("Exponent is not allowed to have a unit.",expr);
 
         // Compute new unit for exponentiation
-        double exponent = v2.getValue();
+        double exponent = v2->getValue();
         if (!v1.isDimensionless()) {
             if (exponent - boost::math::round(exponent) < 1e-9)
                 unit = v1.getUnit().pow(exponent);
@@ -2536,23 +2620,17 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     }
     case HYPOT:
     case CATH:
-        if (e2.isNone())
+        if (!v2)
             _EXPR_THROW("Invalid second argument.",expr);
-        if (v1.getUnit() != v2.getUnit())
+        if (v1.getUnit() != v2->getUnit())
             _EXPR_THROW("Units must be equal.",expr);
 
-        if (args.size() > 2) {
-            if (e3.isNone())
-                _EXPR_THROW("Invalid second argument.",expr);
-            if (v2.getUnit() != v3.getUnit())
+        if (v3) {
+            if (v2->getUnit() != v3->getUnit())
                 _EXPR_THROW("Units must be equal.",expr);
         }
         unit = v1.getUnit();
         break;
-    case TRANSLATIONM:
-        if (v1.isDimensionlessOrUnit(Unit::Length) && v2.isDimensionlessOrUnit(Unit::Length) && v3.isDimensionlessOrUnit(Unit::Length))
-            break;
-        _EXPR_THROW("Translation units must be a length or dimensionless.", expr);
     default:
         _EXPR_THROW("Unknown function: " << f,0);
     }
@@ -2605,23 +2683,23 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         output = cosh(value);
         break;
     case MOD: {
-        output = fmod(value, v2.getValue());
+        output = fmod(value, v2->getValue());
         break;
     }
     case ATAN2: {
-        output = atan2(value, v2.getValue());
+        output = atan2(value, v2->getValue());
         break;
     }
     case POW: {
-        output = pow(value, v2.getValue());
+        output = pow(value, v2->getValue());
         break;
     }
     case HYPOT: {
-        output = sqrt(pow(v1.getValue(), 2) + pow(v2.getValue(), 2) + (!e3.isNone() ? pow(v3.getValue(), 2) : 0));
+        output = sqrt(pow(v1.getValue(), 2) + pow(v2->getValue(), 2) + (v3 ? pow(v3->getValue(), 2) : 0));
         break;
     }
     case CATH: {
-        output = sqrt(pow(v1.getValue(), 2) - pow(v2.getValue(), 2) - (!e3.isNone() ? pow(v3.getValue(), 2) : 0));
+        output = sqrt(pow(v1.getValue(), 2) - pow(v2->getValue(), 2) - (v3 ? pow(v3->getValue(), 2) : 0));
         break;
     }
     case ROUND:
@@ -2636,19 +2714,11 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     case FLOOR:
         output = floor(value);
         break;
-    case ROTATIONX:
-    case ROTATIONY:
-    case ROTATIONZ:
-        return Py::asObject(new Base::RotationPy(Base::Rotation(
-            Vector3d(static_cast<double>(f == ROTATIONX), static_cast<double>(f == ROTATIONY), static_cast<double>(f == ROTATIONZ)),
-            value)));
-    case TRANSLATIONM:
-        return translationMatrix(v1.getValue(), v2.getValue(), v3.getValue());
     default:
         _EXPR_THROW("Unknown function: " << f,0);
     }
 
-    return Py::asObject(new QuantityPy(new Quantity(scaler * output, unit)));
+    return Quantity(scaler * output, unit);
 }
 
 Py::Object FunctionExpression::_getPyValue() const {
@@ -3122,6 +3192,7 @@ void VariableExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVi
 void VariableExpression::setPath(const ObjectIdentifier &path)
 {
      var = path;
+     CompiledExpression::invalidate();
 }
 
 //
@@ -24,6 +24,7 @@
 #define EXPRESSION_H
 
 #include <deque>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -41,6 +42,7 @@ class Quantity;
 
 namespace App  {
 
+class CompiledExpression;
 class DocumentObject;
 class Expression;
 class Document;
@@ -181,6 +183,9 @@ public:
 
     boost::any getValueAsAny() const;
 
+    /// Whether the value is computed without Python from numeric properties, see CompiledExpression
+    bool isCompiled() const { return getCompiled() != nullptr; }
+
     Py::Object getPyValue() const;
 
     bool isSame(const Expression &other, bool checkComment=true) const;
@@ -211,11 +216,16 @@ protected:
     virtual Py::Object _getPyValue() const = 0;
     virtual void _visit(ExpressionVisitor &) {}
 
+    const CompiledExpression *getCompiled() const;
+
 protected:
     App::DocumentObject * owner; /**< The document object used to access unqualified variables (i.e local scope) */
 
     ComponentList components;
 
+    mutable std::unique_ptr<CompiledExpression> compiled; /**< Python free program, if this expression can be compiled */
+    mutable unsigned long compiledRevision = 0; /**< CompiledExpression::revision() at compile time */
+
 public:
     std::string comment;
 };
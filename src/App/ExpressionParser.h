@@ -221,6 +221,12 @@ public:
 
     int priority() const override;
 
+    Expression * getCondition() const { return condition; }
+
+    Expression * getTrueExpr() const { return trueExpr; }
+
+    Expression * getFalseExpr() const { return falseExpr; }
+
 protected:
     Expression * _copy() const override;
     void _visit(ExpressionVisitor & v) override;
@@ -337,6 +343,8 @@ public:
     Expression * simplify() const override;
 
     static Py::Object evaluate(const Expression *owner, int type, const std::vector<Expression*> &args);
+    static Base::Quantity evaluateQuantity(const Expression *owner, int type,
+            const Base::Quantity &v1, const Base::Quantity *v2, const Base::Quantity *v3);
 
     Function getFunction() const {return f;}
     const std::vector<Expression*> &getArgs() const {return args;}
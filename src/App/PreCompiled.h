@@ -46,6 +46,8 @@
 
 // standard
 #include <cassert>
+#include <climits>
+#include <cmath>
 #include <csignal>
 #include <cstdio>
 #include <ctime>
@@ -68,6 +70,8 @@
 #include <sstream>
 
 // STL
+#include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <exception>
 #include <functional>
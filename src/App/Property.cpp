@@ -222,6 +222,14 @@ struct PropertyCleaner {
 std::vector<Property*> PropertyCleaner::_RemovedProps;
 int PropertyCleaner::_PropCleanerCounter = 0;
 
+// Set on the worker threads of a parallel recompute, see setNotifier()
+static thread_local const Property::Notifier *_Notifier;
+
+void Property::setNotifier(const Notifier *notifier)
+{
+    _Notifier = notifier;
+}
+
 void Property::destroy(Property *p) {
     if (p) {
         // Is it necessary to nullify the container? May cause crash if any
@@ -235,6 +243,11 @@ void Property::destroy(Property *p) {
 
 void Property::touch()
 {
+    // the notifier runs this again on a thread that notifies directly
+    if (_Notifier && father) {
+        (*_Notifier)([this]() { touch(); });
+        return;
+    }
     PropertyCleaner guard(this);
     if (father) {
         father->onEarlyChange(this);
@@ -250,6 +263,10 @@ void Property::setReadOnly(bool readOnly)
 
 void Property::hasSetValue()
 {
+    if (_Notifier && father) {
+        (*_Notifier)([this]() { Property::hasSetValue(); });
+        return;
+    }
     PropertyCleaner guard(this);
     if (father) {
         father->onChanged(this);
@@ -263,6 +280,10 @@ void Property::hasSetValue()
 
 void Property::aboutToSetValue()
 {
+    if (_Notifier && father) {
+        (*_Notifier)([this]() { Property::aboutToSetValue(); });
+        return;
+    }
     if (father)
         father->onBeforeChange(this);
 }
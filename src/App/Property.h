@@ -29,6 +29,7 @@
 #include <boost/any.hpp>
 #include <boost/signals2.hpp>
 #include <bitset>
+#include <functional>
 #include <string>
 #include <FCGlobal.h>
 
@@ -107,6 +108,18 @@ public:
     /// For safe deleting of a dynamic property
     static void destroy(Property *p);
 
+    /// Function running a change notification, see setNotifier()
+    using Notifier = std::function<void(const std::function<void()>&)>;
+
+    /** Run the change notifications of all properties changed by the
+     * calling thread through \a notifier
+     *
+     * Used by Document::recompute() on the worker threads of a parallel
+     * recompute to pass the notifications to the main thread. Call with
+     * nullptr to notify directly again.
+     */
+    static void setNotifier(const Notifier *notifier);
+
     /** This method is used to get the size of objects
      * It is not meant to have the exact size, it is more or less an estimation
      * which runs fast! Is it two bytes or a GB?
@@ -31,6 +31,7 @@
 #include <Base/Writer.h>
 #include <CXX/Objects.hxx>
 
+#include "CompiledExpression.h"
 #include "PropertyExpressionEngine.h"
 #include "ExpressionVisitors.h"
 
@@ -77,8 +78,117 @@ struct PropertyExpressionEngine::Private {
     // defined in header, hence the private structure here.
     std::vector<boost::signals2::scoped_connection> conns;
     std::unordered_map<std::string, std::vector<ObjectIdentifier> > propMap;
+
+    // Cached dependencies of one expression
+    struct Binding {
+        const ObjectIdentifier *path = nullptr;
+        std::weak_ptr<Expression> expression; /**< The expression the dependencies were collected from */
+        std::vector<ObjectIdentifier> deps; /**< Canonical paths of the non hidden dependencies */
+        std::vector<const Property*> inputs; /**< Properties read, including hidden references */
+        std::vector<DocumentObject*> inputObjects; /**< Objects read as a whole or through a sub path */
+        bool dirty = true; /**< Whether an input changed since the last evaluation */
+    };
+
+    // Persistent dependency graph, see updateBindings()
+    std::map<ObjectIdentifier, Binding> bindings;
+    std::vector<Binding*> order; /**< Evaluation order of all bindings */
+    bool acyclic = true;
+    bool valid = false;
+    unsigned long revision = 0; /**< CompiledExpression::revision() of the graph */
+    unsigned long evaluations = 0; /**< Expressions evaluated by execute() */
+
+    // Bindings to mark dirty on change of a property, or of any property of an object
+    std::vector<boost::signals2::scoped_connection> inputConns;
+    std::unordered_map<const Property*, std::vector<Binding*> > propertyInputs;
+    std::unordered_map<const DocumentObject*, std::vector<Binding*> > objectInputs;
 };
 
+namespace {
+
+using DependencyGraph = boost::adjacency_list< boost::listS, boost::vecS, boost::directedS >;
+
+/**
+ * @brief The cycle_detector struct is used by the boost graph routines to detect cycles in the graph.
+ */
+
+struct cycle_detector : public boost::dfs_visitor<> {
+    cycle_detector( bool& has_cycle, int & src)
+      : _has_cycle(has_cycle), _src(src) { }
+
+    template <class Edge, class Graph>
+    void back_edge(Edge e, Graph&g) {
+      _has_cycle = true;
+      _src = source(e, g);
+    }
+
+  protected:
+    bool& _has_cycle;
+    int & _src;
+};
+
+/**
+ * @brief Sort expression bindings by their dependencies.
+ * @param paths Paths of the bindings
+ * @param deps Dependencies of each binding in \a paths
+ * @param order Receives the indices into \a paths, dependencies first
+ * @return Index of a binding in a dependency cycle, or -1 if there is none
+ */
+
+int sortBindings(const std::vector<const ObjectIdentifier*> &paths,
+                 const std::vector<const std::vector<ObjectIdentifier>*> &deps,
+                 std::vector<int> &order)
+{
+    boost::unordered_map<ObjectIdentifier, int> nodes;
+    for (std::size_t i = 0; i < paths.size(); ++i)
+        nodes[*paths[i]] = static_cast<int>(i);
+
+    // Only dependencies on other bindings can create a cycle or affect the order
+    DependencyGraph g(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        for (auto &dep : *deps[i]) {
+            auto it = nodes.find(dep);
+            if (it != nodes.end())
+                add_edge(static_cast<int>(i), it->second, g);
+        }
+    }
+
+    bool has_cycle = false;
+    int src = -1;
+    cycle_detector vis(has_cycle, src);
+    depth_first_search(g, visitor(vis));
+    if (has_cycle)
+        return src;
+
+    order.clear();
+    topological_sort(g, std::back_inserter(order));
+    return -1;
+}
+
+/**
+ * @brief Check whether the binding of \a path takes part in execution with \a option.
+ */
+
+bool isExecuted(const ObjectIdentifier &path, PropertyExpressionEngine::ExecuteOption option)
+{
+    if(option == PropertyExpressionEngine::ExecuteAll)
+        return true;
+    auto prop = path.getProperty();
+    if(!prop)
+        throw Base::RuntimeError("Path does not resolve to a property.");
+    bool is_output = prop->testStatus(App::Property::Output)||(prop->getType()&App::Prop_Output);
+    if((is_output && option==PropertyExpressionEngine::ExecuteNonOutput)
+            || (!is_output && option==PropertyExpressionEngine::ExecuteOutput))
+        return false;
+    if(option == PropertyExpressionEngine::ExecuteOnRestore
+            && !prop->testStatus(Property::Transient)
+            && !(prop->getType() & Prop_Transient)
+            && !prop->testStatus(Property::EvalOnRestore))
+        return false;
+    return true;
+}
+
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 TYPESYSTEM_SOURCE(App::PropertyExpressionEngine , App::PropertyExpressionContainer)
@@ -129,6 +239,10 @@ Property *PropertyExpressionEngine::Copy() const
 
 void PropertyExpressionEngine::hasSetValue()
 {
+    // The expressions changed, the dependency graph is rebuilt on demand
+    if(pimpl)
+        pimpl->valid = false;
+
     App::DocumentObject *owner = dynamic_cast<App::DocumentObject*>(getContainer());
     if(!owner || !owner->isAttachedToDocument() || owner->isRestoring() || testFlag(LinkDetached)) {
         PropertyExpressionContainer::hasSetValue();
@@ -406,6 +520,11 @@ size_t PropertyExpressionEngine::numExpressions() const
     return expressions.size();
 }
 
+unsigned long PropertyExpressionEngine::numEvaluations() const
+{
+    return pimpl ? pimpl->evaluations : 0;
+}
+
 void PropertyExpressionEngine::afterRestore()
 {
     DocumentObject * docObj = freecad_dynamic_cast<DocumentObject>(getContainer());
@@ -486,6 +605,7 @@ void PropertyExpressionEngine::setValue(const ObjectIdentifier & path, std::shar
     }
 
     if (expr) {
+        updateBindings();
         std::string error = validateExpression(usePath, expr);
         if (!error.empty())
             throw Base::RuntimeError(error.c_str());
@@ -501,25 +621,6 @@ void PropertyExpressionEngine::setValue(const ObjectIdentifier & path, std::shar
     }
 }
 
-/**
- * @brief The cycle_detector struct is used by the boost graph routines to detect cycles in the graph.
- */
-
-struct cycle_detector : public boost::dfs_visitor<> {
-    cycle_detector( bool& has_cycle, int & src)
-      : _has_cycle(has_cycle), _src(src) { }
-
-    template <class Edge, class Graph>
-    void back_edge(Edge e, Graph&g) {
-      _has_cycle = true;
-      _src = source(e, g);
-    }
-
-  protected:
-    bool& _has_cycle;
-    int & _src;
-};
-
 /**
  * @brief Build a graph of all expressions in \a exprs.
  * @param exprs Expressions to use in graph
@@ -536,19 +637,8 @@ void PropertyExpressionEngine::buildGraph(const ExpressionMap & exprs,
 
     // Build data structure for graph
     for (const auto & expr : exprs) {
-        if(option!=ExecuteAll) {
-            auto prop = expr.first.getProperty();
-            if(!prop)
-                throw Base::RuntimeError("Path does not resolve to a property.");
-            bool is_output = prop->testStatus(App::Property::Output)||(prop->getType()&App::Prop_Output);
-            if((is_output && option==ExecuteNonOutput) || (!is_output && option==ExecuteOutput))
-                continue;
-            if(option == ExecuteOnRestore
-                    && !prop->testStatus(Property::Transient)
-                    && !(prop->getType() & Prop_Transient)
-                    && !prop->testStatus(Property::EvalOnRestore))
-                continue;
-        }
+        if(!isExecuted(expr.first, option))
+            continue;
         buildGraphStructures(expr.first, expr.second.expression, nodes, revNodes, edges);
     }
 
@@ -572,6 +662,140 @@ void PropertyExpressionEngine::buildGraph(const ExpressionMap & exprs,
     }
 }
 
+/**
+ * @brief Collect the canonical paths \a expression depends on.
+ */
+
+static std::vector<ObjectIdentifier> dependencyPaths(const Expression &expression)
+{
+    std::vector<ObjectIdentifier> paths;
+    for(auto &dep : expression.getDeps()) {
+        for(auto &info : dep.second) {
+            if(info.first.empty())
+                continue;
+            for(auto &oid : info.second)
+                paths.push_back(oid.canonicalPath());
+        }
+    }
+    return paths;
+}
+
+/**
+ * @brief Bring the persistent dependency graph up to date.
+ *
+ * Only bindings whose expression was added or replaced since the last call
+ * collect their dependencies again, the other ones reuse them. Everything is
+ * collected again after a structural change of the documents, because
+ * references may then resolve to other properties.
+ *
+ * The graph also tracks which bindings need evaluation: a binding is dirty
+ * until it was evaluated, and again on any change of a property it reads or
+ * of the property it is bound to.
+ */
+
+void PropertyExpressionEngine::updateBindings()
+{
+    unsigned long revision = CompiledExpression::revision();
+    if(!pimpl)
+        pimpl = std::make_unique<Private>();
+    else if(pimpl->valid && pimpl->revision == revision)
+        return;
+
+    bool rebind = pimpl->revision != revision;
+    pimpl->valid = false;
+    pimpl->order.clear();
+    pimpl->inputConns.clear();
+    pimpl->propertyInputs.clear();
+    pimpl->objectInputs.clear();
+
+    auto &bindings = pimpl->bindings;
+    for(auto it = bindings.begin(); it != bindings.end();) {
+        auto e = expressions.find(it->first);
+        if(e == expressions.end() || !e->second.expression)
+            it = bindings.erase(it);
+        else
+            ++it;
+    }
+
+    std::vector<const ObjectIdentifier*> paths;
+    std::vector<const std::vector<ObjectIdentifier>*> deps;
+    std::vector<Private::Binding*> nodes;
+    std::set<DocumentObject*> inputObjects;
+    auto owner = freecad_dynamic_cast<DocumentObject>(getContainer());
+    if(owner)
+        inputObjects.insert(owner);
+
+    for(auto &e : expressions) {
+        auto &expression = e.second.expression;
+        if(!expression)
+            continue;
+        auto &binding = bindings[e.first];
+        if(rebind || binding.expression.lock() != expression) {
+            binding.expression = expression;
+            binding.deps = dependencyPaths(*expression);
+            binding.inputs.clear();
+            binding.inputObjects.clear();
+            // The bound property itself, in case it is changed by someone else
+            if(auto prop = e.first.getProperty())
+                binding.inputs.push_back(prop);
+            for(auto &dep : expression->getDeps(Expression::DepAll)) {
+                for(auto &info : dep.second) {
+                    auto prop = info.first.empty() ? nullptr : dep.first->getPropertyByName(info.first.c_str());
+                    if(prop)
+                        binding.inputs.push_back(prop);
+                    else
+                        binding.inputObjects.push_back(dep.first);
+                }
+            }
+            binding.dirty = true;
+        }
+        binding.path = &bindings.find(e.first)->first;
+        paths.push_back(binding.path);
+        deps.push_back(&binding.deps);
+        nodes.push_back(&binding);
+
+        for(auto prop : binding.inputs) {
+            pimpl->propertyInputs[prop].push_back(&binding);
+            if(auto obj = freecad_dynamic_cast<DocumentObject>(prop->getContainer()))
+                inputObjects.insert(obj);
+        }
+        for(auto obj : binding.inputObjects) {
+            pimpl->objectInputs[obj].push_back(&binding);
+            inputObjects.insert(obj);
+        }
+    }
+
+    std::vector<int> order;
+    pimpl->acyclic = sortBindings(paths, deps, order) < 0;
+    for(int i : order)
+        pimpl->order.push_back(nodes[i]);
+
+    //NOLINTBEGIN
+    for(auto obj : inputObjects) {
+        pimpl->inputConns.emplace_back(obj->signalChanged.connect(std::bind(
+                    &PropertyExpressionEngine::slotInputChanged,this,sp::_1,sp::_2)));
+    }
+    //NOLINTEND
+
+    pimpl->revision = revision;
+    pimpl->valid = true;
+}
+
+void PropertyExpressionEngine::slotInputChanged(const App::DocumentObject &obj, const App::Property &prop) {
+    if(!pimpl || &prop == this)
+        return;
+    auto it = pimpl->propertyInputs.find(&prop);
+    if(it != pimpl->propertyInputs.end()) {
+        for(auto binding : it->second)
+            binding->dirty = true;
+    }
+    auto jt = pimpl->objectInputs.find(&obj);
+    if(jt != pimpl->objectInputs.end()) {
+        for(auto binding : jt->second)
+            binding->dirty = true;
+    }
+}
+
 /**
  * The code below builds a graph for all expressions in the engine, and
  * finds any circular dependencies. It also computes the internal evaluation
@@ -648,16 +872,34 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute(ExecuteOption o
 
     resetter r(running);
 
-    // Compute evaluation order
-    std::vector<App::ObjectIdentifier> evaluationOrder = computeEvaluationOrder(option);
-    std::vector<ObjectIdentifier>::const_iterator it = evaluationOrder.begin();
+    // Get the evaluation order from the persistent graph. With a cycle, let
+    // the full graph of this option report it.
+    updateBindings();
+    std::vector<Private::Binding*> bindings;
+    if (pimpl->acyclic) {
+        for (auto binding : pimpl->order) {
+            if (isExecuted(*binding->path, option))
+                bindings.push_back(binding);
+        }
+    }
+    else {
+        for (auto &path : computeEvaluationOrder(option))
+            bindings.push_back(&pimpl->bindings[path]);
+    }
 
 #ifdef FC_PROPERTYEXPRESSIONENGINE_LOG
     std::clog << "Computing expressions for " << getName() << std::endl;
 #endif
 
     /* Evaluate the expressions, and update properties */
-    for (;it != evaluationOrder.end();++it) {
+    for (auto binding : bindings) {
+        const ObjectIdentifier *it = binding->path;
+        std::shared_ptr<App::Expression> expression = expressions[*it].expression;
+
+        // An expression that does not depend on Python only needs evaluation
+        // if one of its inputs changed.
+        if (!binding->dirty && expression && expression->isCompiled())
+            continue;
 
         // Get property to update
         Property * prop = it->getProperty();
@@ -675,8 +917,8 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute(ExecuteOption o
         App::any value;
         try {
             // Evaluate expression
-            std::shared_ptr<App::Expression> expression = expressions[*it].expression;
             if (expression) {
+                ++pimpl->evaluations;
                 value = expression->getValueAsAny();
 
                 // Enable value comparison for all expression bindings to reduce
@@ -692,12 +934,15 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute(ExecuteOption o
                 //
                 // if (option == ExecuteOnRestore && prop->testStatus(Property::EvalOnRestore))
                 {
-                    if (isAnyEqual(value, prop->getPathValue(*it)))
+                    if (isAnyEqual(value, prop->getPathValue(*it))) {
+                        binding->dirty = false;
                         continue;
+                    }
                     if (touched)
                         *touched = true;
                 }
                 prop->setPathValue(*it, value);
+                binding->dirty = false;
             }
         }catch(Base::Exception &e) {
             std::ostringstream ss;
@@ -793,6 +1038,28 @@ std::string PropertyExpressionEngine::validateExpression(const ObjectIdentifier
 
     // Check for internal document object dependencies
 
+    // With an up to date dependency graph, only the dependencies of the new
+    // expression have to be collected
+    if (pimpl && pimpl->valid && pimpl->revision == CompiledExpression::revision()) {
+        std::vector<const ObjectIdentifier*> paths;
+        std::vector<const std::vector<ObjectIdentifier>*> deps;
+        std::vector<ObjectIdentifier> newDeps = dependencyPaths(*expr);
+        for (auto &binding : pimpl->bindings) {
+            if (binding.first == usePath)
+                continue;
+            paths.push_back(&binding.first);
+            deps.push_back(&binding.second.deps);
+        }
+        paths.push_back(&usePath);
+        deps.push_back(&newDeps);
+
+        std::vector<int> order;
+        int src = sortBindings(paths, deps, order);
+        if (src >= 0)
+            return paths[src]->toString() + " reference creates a cyclic dependency.";
+        return {};
+    }
+
     // Copy current expressions
     ExpressionMap newExpressions = expressions;
 
@@ -154,6 +154,9 @@ public:
 
     size_t numExpressions() const;
 
+    /// The number of expressions evaluated by execute(), skipped clean bindings are not counted
+    unsigned long numEvaluations() const;
+
     ///signal called when an expression was changed
     boost::signals2::signal<void (const App::ObjectIdentifier &)> expressionChanged;
 
@@ -193,6 +196,9 @@ private:
                 boost::unordered_map<int, App::ObjectIdentifier> &revNodes,
                 DiGraph &g, ExecuteOption option=ExecuteAll) const;
 
+    void updateBindings();
+
+    void slotInputChanged(const App::DocumentObject &obj, const App::Property &prop);
     void slotChangedObject(const App::DocumentObject &obj, const App::Property &prop);
     void slotChangedProperty(const App::DocumentObject &obj, const App::Property &prop);
     void updateHiddenReference(const std::string &key);
@@ -23,6 +23,7 @@
 #ifndef RANGE_H
 #define RANGE_H
 
+#include <functional>
 #include <string>
 #include <Base/Bitmask.h>
 #ifndef FC_GLOBAL_H
@@ -183,4 +184,20 @@ private:
 
 ENABLE_BITMASK_OPERATORS(App::CellAddress::Cell)
 
+namespace std {
+
+/** Hash of a cell address to use it as key of unordered containers */
+template<>
+struct hash<App::CellAddress>
+{
+    std::size_t operator()(const App::CellAddress & address) const noexcept
+    {
+        unsigned int row = static_cast<unsigned short>(address.row());
+        unsigned int col = static_cast<unsigned short>(address.col());
+        return std::hash<unsigned int>()((row << 16) | col);
+    }
+};
+
+}
+
 #endif // RANGE_H
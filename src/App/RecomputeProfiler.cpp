@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <unordered_map>
+#endif
+
+#include "RecomputeProfiler.h"
+#include "DocumentObject.h"
+
+
+using namespace App;
+
+namespace
+{
+
+std::string escapeJSON(const std::string& str)
+{
+    std::ostringstream ss;
+    for (unsigned char c : str) {
+        switch (c) {
+            case '"':
+                ss << "\\\"";
+                break;
+            case '\\':
+                ss << "\\\\";
+                break;
+            case '\n':
+                ss << "\\n";
+                break;
+            case '\r':
+                ss << "\\r";
+                break;
+            case '\t':
+                ss << "\\t";
+                break;
+            default:
+                if (c < 0x20) {
+                    ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c)
+                       << std::dec;
+                }
+                else {
+                    ss << c;
+                }
+                break;
+        }
+    }
+    return ss.str();
+}
+
+std::string escapeCSV(const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos) {
+        return str;
+    }
+    std::string res("\"");
+    for (char c : str) {
+        if (c == '"') {
+            res += '"';
+        }
+        res += c;
+    }
+    res += '"';
+    return res;
+}
+
+}  // namespace
+
+void RecomputeProfiler::setEnabled(bool on)
+{
+    enabled = on;
+    if (!on) {
+        running = false;
+        currentIndex.clear();
+    }
+}
+
+void RecomputeProfiler::setHistorySize(std::size_t size)
+{
+    historySize = std::max<std::size_t>(size, 1);
+    while (runs.size() > historySize) {
+        runs.pop_front();
+    }
+}
+
+void RecomputeProfiler::beginRun()
+{
+    if (!enabled) {
+        return;
+    }
+    running = true;
+    currentIndex.clear();
+    runStart = Base::TimeElapsed();
+    Run run;
+    run.id = ++lastId;
+    runs.push_back(std::move(run));
+    while (runs.size() > historySize) {
+        runs.pop_front();
+    }
+}
+
+void RecomputeProfiler::abortRun()
+{
+    if (!running) {
+        return;
+    }
+    running = false;
+    currentIndex.clear();
+    runs.pop_back();
+}
+
+void RecomputeProfiler::endRun(const std::vector<DocumentObject*>& objs)
+{
+    if (!running) {
+        return;
+    }
+    running = false;
+    Run& run = runs.back();
+    run.time = Base::TimeElapsed::diffTimeF(runStart, Base::TimeElapsed());
+
+    // Longest path through the dependency graph weighted by the recompute
+    // time of each object. The objects are topologically sorted with the
+    // dependencies first.
+    std::unordered_map<const DocumentObject*, std::pair<double, const DocumentObject*>> finish;
+    const DocumentObject* last = nullptr;
+    double lastTime = 0.0;
+    for (auto obj : objs) {
+        double start = 0.0;
+        const DocumentObject* prev = nullptr;
+        for (auto dep : obj->getOutList()) {
+            auto it = finish.find(dep);
+            if (it != finish.end() && (!prev || it->second.first > start)) {
+                start = it->second.first;
+                prev = dep;
+            }
+        }
+        auto it = currentIndex.find(obj);
+        double time = start + (it != currentIndex.end() ? run.objects[it->second].time : 0.0);
+        finish[obj] = std::make_pair(time, prev);
+        if (!last || time > lastTime) {
+            lastTime = time;
+            last = obj;
+        }
+    }
+
+    run.criticalPathTime = lastTime;
+    for (auto obj = last; obj; obj = finish[obj].second) {
+        auto it = currentIndex.find(obj);
+        if (it != currentIndex.end()) {
+            run.criticalPath.push_back(run.objects[it->second].name);
+        }
+    }
+    std::reverse(run.criticalPath.begin(), run.criticalPath.end());
+    currentIndex.clear();
+}
+
+void RecomputeProfiler::addRecord(const DocumentObject* obj,
+                                  const std::string& reason,
+                                  double time,
+                                  bool error)
+{
+    if (!running || !obj) {
+        return;
+    }
+    Run& run = runs.back();
+    auto res = currentIndex.emplace(obj, run.objects.size());
+    if (res.second) {
+        ObjectRecord record;
+        if (obj->isAttachedToDocument()) {
+            record.name = obj->getNameInDocument();
+        }
+        record.label = obj->Label.getStrValue();
+        record.type = obj->getTypeId().getName();
+        record.reason = reason;
+        run.objects.push_back(std::move(record));
+    }
+    ObjectRecord& record = run.objects[res.first->second];
+    record.time += time;
+    record.count += 1;
+    record.error = error;
+}
+
+std::string RecomputeProfiler::getTouchedReason(const DocumentObject* obj)
+{
+    std::string reason;
+    std::vector<std::pair<const char*, Property*>> props;
+    obj->getPropertyNamedList(props);
+    for (const auto& v : props) {
+        if (v.second->isTouched()) {
+            if (!reason.empty()) {
+                reason += ' ';
+            }
+            reason += v.first;
+        }
+    }
+    if (reason.empty()) {
+        if (obj->testStatus(ObjectStatus::Recompute2)) {
+            reason = "second pass";
+        }
+        else if (obj->testStatus(ObjectStatus::Enforce)) {
+            reason = "enforced";
+        }
+    }
+    return reason;
+}
+
+void RecomputeProfiler::clear()
+{
+    runs.clear();
+    currentIndex.clear();
+    running = false;
+}
+
+void RecomputeProfiler::writeJSON(std::ostream& str) const
+{
+    str << "[";
+    bool firstRun = true;
+    for (const auto& run : runs) {
+        str << (firstRun ? "\n" : ",\n");
+        firstRun = false;
+        str << "  {\"run\": " << run.id << ", \"time\": " << run.time
+            << ", \"criticalPathTime\": " << run.criticalPathTime << ",\n"
+            << "   \"criticalPath\": [";
+        for (std::size_t i = 0; i < run.criticalPath.size(); ++i) {
+            str << (i ? ", " : "") << '"' << escapeJSON(run.criticalPath[i]) << '"';
+        }
+        str << "],\n   \"objects\": [";
+        bool firstObj = true;
+        for (const auto& obj : run.objects) {
+            str << (firstObj ? "\n" : ",\n");
+            firstObj = false;
+            str << "    {\"name\": \"" << escapeJSON(obj.name) << "\", \"label\": \""
+                << escapeJSON(obj.label) << "\", \"type\": \"" << escapeJSON(obj.type)
+                << "\", \"reason\": \"" << escapeJSON(obj.reason) << "\", \"time\": " << obj.time
+                << ", \"count\": " << obj.count << ", \"error\": " << (obj.error ? "true" : "false")
+                << "}";
+        }
+        str << "]}";
+    }
+    str << "\n]\n";
+}
+
+void RecomputeProfiler::writeCSV(std::ostream& str) const
+{
+    str << "run,name,label,type,reason,time,count,error,critical\n";
+    for (const auto& run : runs) {
+        for (const auto& obj : run.objects) {
+            bool critical = std::find(run.criticalPath.begin(), run.criticalPath.end(), obj.name)
+                != run.criticalPath.end();
+            str << run.id << ',' << escapeCSV(obj.name) << ',' << escapeCSV(obj.label) << ','
+                << escapeCSV(obj.type) << ',' << escapeCSV(obj.reason) << ',' << obj.time << ','
+                << obj.count << ',' << (obj.error ? 1 : 0) << ',' << (critical ? 1 : 0) << '\n';
+        }
+    }
+}
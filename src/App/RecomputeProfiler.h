@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef APP_RECOMPUTEPROFILER_H
+#define APP_RECOMPUTEPROFILER_H
+
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+#include <Base/TimeInfo.h>
+#include <FCGlobal.h>
+
+namespace App
+{
+
+class DocumentObject;
+
+/** Collects the time spent by Document::recompute() in each object
+ *
+ * The profiler is owned by the document and is disabled by default. Once
+ * enabled, each document recompute is recorded as a run that holds, for every
+ * recomputed object, the wall time, the reason why it was recomputed and the
+ * number of times it was recomputed during the run. The critical path, i.e.
+ * the most expensive chain of dependent objects, is computed at the end of
+ * each run. The most recent runs are kept and can be written as JSON or CSV.
+ */
+class AppExport RecomputeProfiler
+{
+public:
+    struct ObjectRecord
+    {
+        /// internal name of the object
+        std::string name;
+        std::string label;
+        std::string type;
+        /// names of the touched properties, or the reason of an enforced recompute
+        std::string reason;
+        /// accumulated wall time in seconds
+        double time = 0.0;
+        /// number of times the object was recomputed during the run
+        int count = 0;
+        bool error = false;
+    };
+
+    struct Run
+    {
+        int id = 0;
+        /// total wall time of the run in seconds
+        double time = 0.0;
+        /// recomputed objects in the order of their first recompute
+        std::vector<ObjectRecord> objects;
+        /// internal names of the objects on the critical path, upstream first
+        std::vector<std::string> criticalPath;
+        /// accumulated time of the objects on the critical path
+        double criticalPathTime = 0.0;
+    };
+
+    void setEnabled(bool on);
+    bool isEnabled() const
+    {
+        return enabled;
+    }
+    /// Set the number of runs kept in the history
+    void setHistorySize(std::size_t size);
+    std::size_t getHistorySize() const
+    {
+        return historySize;
+    }
+
+    /// Called by the document when it starts a recompute
+    void beginRun();
+    /// Called by the document when it finishes a recompute of the topologically sorted \a objs
+    void endRun(const std::vector<DocumentObject*>& objs);
+    /// Drops the current run, e.g. if the recompute was left by an exception
+    void abortRun();
+    /// Returns true between beginRun() and endRun()
+    bool isRunning() const
+    {
+        return running;
+    }
+    /// Record one recompute of \a obj that took \a time seconds
+    void addRecord(const DocumentObject* obj, const std::string& reason, double time, bool error);
+    /// Describe why \a obj is going to be recomputed
+    static std::string getTouchedReason(const DocumentObject* obj);
+
+    const std::deque<Run>& getRuns() const
+    {
+        return runs;
+    }
+    void clear();
+
+    void writeJSON(std::ostream& str) const;
+    void writeCSV(std::ostream& str) const;
+
+    /** Begins a run and aborts it when leaving the scope before endRun() was called
+     *
+     * Nothing is done if \a begin is false, e.g. because the run is part of an
+     * enclosing one.
+     */
+    class RunGuard
+    {
+    public:
+        explicit RunGuard(RecomputeProfiler& profiler, bool begin = true)
+            : profiler(profiler)
+            , active(begin)
+        {
+            if (active) {
+                profiler.beginRun();
+            }
+        }
+        ~RunGuard()
+        {
+            if (active) {
+                profiler.abortRun();
+            }
+        }
+        void endRun(const std::vector<DocumentObject*>& objs)
+        {
+            if (active) {
+                active = false;
+                profiler.endRun(objs);
+            }
+        }
+
+        RunGuard(const RunGuard&) = delete;
+        RunGuard& operator=(const RunGuard&) = delete;
+
+    private:
+        RecomputeProfiler& profiler;
+        bool active;
+    };
+
+private:
+    std::deque<Run> runs;
+    std::map<const DocumentObject*, std::size_t> currentIndex;
+    Base::TimeElapsed runStart;
+    std::size_t historySize = 20;
+    int lastId = 0;
+    bool enabled = false;
+    bool running = false;
+};
+
+}  // namespace App
+
+#endif  // APP_RECOMPUTEPROFILER_H
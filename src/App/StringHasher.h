@@ -648,6 +648,10 @@ public:
     void Save(Base::Writer& /*writer*/) const override;
     void Restore(Base::XMLReader& /*reader*/) override;
     void SaveDocFile(Base::Writer& /*writer*/) const override;
+    bool isSaveDocFileThreadSafe(const Base::Writer& /*writer*/) const override
+    {
+        return true;
+    }
     void RestoreDocFile(Base::Reader& /*reader*/) override;
     void setPersistenceFileName(const char* name) const;
     const std::string& getPersistenceFileName() const;
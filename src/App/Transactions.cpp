@@ -111,7 +111,10 @@ int Transaction::getLastID() {
 
 unsigned int Transaction::getMemSize () const
 {
-    return 0;
+    unsigned int size = 0;
+    for (const auto& info : _Objects)
+        size += info.second->getMemSize();
+    return size;
 }
 
 void Transaction::Save (Base::Writer &/*writer*/) const
@@ -406,7 +409,14 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
 
 unsigned int TransactionObject::getMemSize () const
 {
-    return 0;
+    // Properties holding large data share it with the live property until
+    // either of them changes, so this reports what the snapshots actually cost
+    unsigned int size = 0;
+    for (const auto& v : _PropChangeMap) {
+        if (v.second.property)
+            size += v.second.property->getMemSize();
+    }
+    return size;
 }
 
 void TransactionObject::Save (Base::Writer &/*writer*/) const
@@ -29,10 +29,12 @@
 
 #include <App/DocumentObject.h>
 #include <App/DocumentObserver.h>
+#include <App/RecomputeProfiler.h>
 #include <App/StringHasher.h>
 #include <CXX/Objects.hxx>
 #include <boost/bimap.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <ctime>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -93,6 +95,15 @@ struct DocumentP
 
     StringHasherRef Hasher;
 
+    RecomputeProfiler profiler;
+
+    // The project file the document was last restored from or saved to, used
+    // to copy unchanged files when saving, see Document::setPreviousArchive()
+    std::string archivePath;
+    std::string archiveId;
+    std::time_t archiveTime {};
+    unsigned int archiveSize {};
+
     DocumentP();
 
     void addRecomputeLog(const char *why, App::DocumentObject *obj) {
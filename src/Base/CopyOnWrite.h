@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef BASE_COPYONWRITE_H
+#define BASE_COPYONWRITE_H
+
+#include <memory>
+#include <utility>
+
+#include "Handle.h"
+
+
+namespace Base
+{
+
+/** Copy-on-write access to a reference counted object
+ *
+ * Copies of a CopyOnWrite share the referenced object until one of them is
+ * about to modify it. The one that modifies keeps the object, so pointers
+ * handed out to it before stay valid, while all other copies continue with
+ * an unchanged duplicate. This makes copying a large object, e.g. for an
+ * undo snapshot, cheap as long as it is not modified afterwards.
+ *
+ * \a T must inherit Base::Handled and be copy and move constructible.
+ */
+template<class T>
+class CopyOnWrite
+{
+public:
+    CopyOnWrite()
+        : cell(std::make_shared<Cell>())
+    {}
+    explicit CopyOnWrite(T* object)
+        : cell(std::make_shared<Cell>(object))
+    {}
+
+    /// The referenced object, not to be modified without detach()
+    T* get() const
+    {
+        return static_cast<T*>(cell->object);
+    }
+    T& operator*() const
+    {
+        return *get();
+    }
+    T* operator->() const
+    {
+        return get();
+    }
+
+    /// Number of copies sharing the object, including this one
+    long useCount() const
+    {
+        return cell.use_count();
+    }
+
+    /** Prepare the object for modification
+     * If the object is shared the other copies get a duplicate of its content.
+     * If \a keepContent is false the caller is going to replace the content,
+     * so it is moved to the other copies instead of duplicated and the object
+     * is left in the moved-from state of \a T.
+     * @return The object that may now be modified
+     */
+    T* detach(bool keepContent = true)
+    {
+        if (cell.use_count() > 1) {
+            std::shared_ptr<Cell> shared = std::move(cell);
+            cell = std::make_shared<Cell>(shared->object);
+            if (keepContent) {
+                shared->object = new T(*get());
+            }
+            else {
+                shared->object = new T(std::move(*get()));
+            }
+        }
+        return get();
+    }
+
+    /// Reference \a object from now on, the other copies keep the current one
+    void reset(T* object)
+    {
+        if (cell.use_count() > 1) {
+            cell = std::make_shared<Cell>(object);
+        }
+        else {
+            cell->object = object;
+        }
+    }
+
+private:
+    struct Cell
+    {
+        Cell() = default;
+        explicit Cell(T* obj)
+            : object(obj)
+        {}
+        Reference<T> object;
+    };
+    std::shared_ptr<Cell> cell;
+};
+
+}  // namespace Base
+
+#endif  // BASE_COPYONWRITE_H
@@ -72,6 +72,13 @@ void Persistence::SaveDocFile(Writer& /*writer*/) const
 void Persistence::RestoreDocFile(Reader& /*reader*/)
 {}
 
+void Persistence::deferRestoreDocFile(const std::shared_ptr<DeferredDocFile>& file)
+{
+    file->restore([this](Reader& reader) {
+        RestoreDocFile(reader);
+    });
+}
+
 std::string Persistence::encodeAttribute(const std::string& str)
 {
     std::string tmp;
@@ -24,10 +24,14 @@
 #ifndef APP_PERSISTENCE_H
 #define APP_PERSISTENCE_H
 
+#include <memory>
+#include <string>
+
 #include "BaseClass.h"
 
 namespace Base
 {
+class DeferredDocFile;
 class Reader;
 class Writer;
 class XMLReader;
@@ -112,6 +116,17 @@ public:
      * ostream).
      */
     virtual void SaveDocFile(Writer& /*writer*/) const;
+    /** Returns true if SaveDocFile() may be called from a worker thread
+     * when saving with a multithreaded ZipWriter. An object returning true
+     * promises that SaveDocFile() only reads its own data, does not call
+     * addFile() and never calls into Python, the GUI or the parameter system.
+     * The default implementation returns false, in which case SaveDocFile()
+     * is always called from the thread that started the save.
+     */
+    virtual bool isSaveDocFileThreadSafe(const Writer& /*writer*/) const
+    {
+        return false;
+    }
     /** This method is used to restore large amounts of data from a file
      * In this method you simply stream in your SaveDocFile() saved data.
      * Again you have to apply for the call of this method in the Restore() call:
@@ -142,6 +157,38 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader& /*reader*/);
+    /** Returns true if RestoreDocFile() may be postponed when the document is
+     * restored lazily. In this case deferRestoreDocFile() is called instead and
+     * the object restores its data from the passed file once it is needed.
+     * The default implementation returns false.
+     */
+    virtual bool isRestoreDocFileDeferrable() const
+    {
+        return false;
+    }
+    /** Called instead of RestoreDocFile() if isRestoreDocFileDeferrable()
+     * returns true and the XMLReader restores lazily. The default
+     * implementation restores the data immediately.
+     */
+    virtual void deferRestoreDocFile(const std::shared_ptr<DeferredDocFile>& file);
+    /** Returns the name of the file in the archive \a archive which holds
+     * exactly what SaveDocFile() would write now, or an empty string if the
+     * data has been changed since then or is unknown. This allows an
+     * incremental save to copy the file instead of writing it again.
+     * The default implementation returns an empty string.
+     * \see ZipWriter::setPreviousArchive()
+     */
+    virtual std::string getArchivedDocFile(const std::string& /*archive*/) const
+    {
+        return {};
+    }
+    /** Called after the data of this object has been written to or read from
+     * the file \a file of the archive \a archive. An object supporting
+     * getArchivedDocFile() remembers both until its data is changed.
+     */
+    virtual void setArchivedDocFile(const std::string& /*archive*/,
+                                    const std::string& /*file*/) const
+    {}
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
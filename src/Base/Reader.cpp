@@ -34,6 +34,7 @@
 #include "Base64.h"
 #include "Base64Filter.h"
 #include "Console.h"
+#include "Exception.h"
 #include "InputSource.h"
 #include "Persistence.h"
 #include "Sequencer.h"
@@ -43,7 +44,10 @@
 #ifdef _MSC_VER
 #include <zipios++/zipios-config.h>
 #endif
+#include <zipios++/zipfile.h>
+#include <zipios++/zipheadio.h>
 #include <zipios++/zipinputstream.h>
+#include <zlib.h>
 #include <boost/iostreams/filtering_stream.hpp>
 
 
@@ -402,6 +406,22 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
         // project file was created without GUI
         return;
     }
+    // For lazy restore the central directory gives access to the raw entry data
+    std::unique_ptr<zipios::ZipFile> zip;
+    Base::ifstream archive;
+    if (_lazyRestore && _File.exists()) {
+        try {
+            zip = std::make_unique<zipios::ZipFile>(_File.filePath());
+            archive.open(_File, std::ios::in | std::ios::binary);
+        }
+        catch (const std::exception& e) {
+            Base::Console().Warning("Lazy restore disabled for %s: %s\n",
+                                    _File.filePath().c_str(),
+                                    e.what());
+            zip.reset();
+        }
+    }
+
     std::vector<FileEntry>::const_iterator it = FileList.begin();
     Base::SequencerLauncher seq("Importing project files...", FileList.size());
     while (entry->isValid() && it != FileList.end()) {
@@ -413,10 +433,31 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
         }
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
-        if (jt != FileList.end()) {
+        std::shared_ptr<DeferredDocFile> deferred;
+        if (jt != FileList.end() && zip && archive
+            && jt->Object->isRestoreDocFileDeferrable()) {
+            try {
+                deferred = DeferredDocFile::fromArchive(*zip, archive, jt->FileName, FileVersion);
+            }
+            catch (...) {
+                // restore it directly
+                archive.clear();
+            }
+        }
+        if (deferred) {
+            jt->Object->deferRestoreDocFile(deferred);
+            if (!_archiveId.empty()) {
+                jt->Object->setArchivedDocFile(_archiveId, jt->FileName);
+            }
+            it = jt + 1;
+        }
+        else if (jt != FileList.end()) {
             try {
                 Base::Reader reader(zipstream, jt->FileName, FileVersion);
                 jt->Object->RestoreDocFile(reader);
+                if (!_archiveId.empty()) {
+                    jt->Object->setArchivedDocFile(_archiveId, jt->FileName);
+                }
                 if (reader.getLocalReader()) {
                     reader.getLocalReader()->readFiles(zipstream);
                 }
@@ -669,3 +710,186 @@ std::shared_ptr<Base::XMLReader> Base::Reader::getLocalReader() const
 {
     return (this->localreader);
 }
+
+// ----------------------------------------------------------
+
+Base::DeferredDocFile::DeferredDocFile(std::string name,
+                                       int version,
+                                       std::string data,
+                                       std::uint32_t size,
+                                       std::uint32_t crc,
+                                       bool deflated)
+    : _name(std::move(name))
+    , fileVersion(version)
+    , _data(std::move(data))
+    , _size(size)
+    , _crc(crc)
+    , _deflated(deflated)
+{}
+
+std::shared_ptr<Base::DeferredDocFile> Base::DeferredDocFile::fromArchive(zipios::ZipFile& zip,
+                                                                         std::istream& archive,
+                                                                         const std::string& name,
+                                                                         int version)
+{
+    zipios::ConstEntryPointer entry = zip.getEntry(name);
+    if (!entry || !entry->isValid()) {
+        throw Base::FileException("Entry not found in archive", name);
+    }
+    auto cdir = static_cast<const zipios::ZipCDirEntry*>(entry.get());
+    if (cdir->getMethod() != zipios::DEFLATED && cdir->getMethod() != zipios::STORED) {
+        throw Base::FileException("Unsupported compression method", name);
+    }
+
+    // The sizes in the local header may be zero if a data descriptor is
+    // used, so only take its length from there
+    zipios::ZipLocalEntry header;
+    archive.seekg(cdir->getLocalHeaderOffset());
+    archive >> header;
+    if (!archive || !header.isValid()) {
+        throw Base::FileException("Invalid local header in archive", name);
+    }
+    archive.seekg(cdir->getLocalHeaderOffset() + header.getLocalHeaderSize());
+
+    std::string data(cdir->getCompressedSize(), '\0');
+    archive.read(&data[0], static_cast<std::streamsize>(data.size()));
+    if (!archive) {
+        throw Base::FileException("Failed to read entry from archive", name);
+    }
+
+    return std::make_shared<DeferredDocFile>(name,
+                                             version,
+                                             std::move(data),
+                                             cdir->getSize(),
+                                             cdir->getCrc(),
+                                             cdir->getMethod() == zipios::DEFLATED);
+}
+
+const std::string& Base::DeferredDocFile::getFileName() const
+{
+    return _name;
+}
+
+std::size_t Base::DeferredDocFile::getCompressedSize() const
+{
+    return _data.size();
+}
+
+const std::string& Base::DeferredDocFile::getCompressedData() const
+{
+    return _data;
+}
+
+std::uint32_t Base::DeferredDocFile::getSize() const
+{
+    return _size;
+}
+
+std::uint32_t Base::DeferredDocFile::getCrc() const
+{
+    return _crc;
+}
+
+bool Base::DeferredDocFile::isDeflated() const
+{
+    return _deflated;
+}
+
+void Base::DeferredDocFile::restore(const std::function<void(Reader&)>& func) const
+{
+    std::string data;
+    if (_deflated) {
+        data.resize(_size);
+        z_stream zs {};
+        if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+            throw Base::RuntimeError("Failed to initialize decompression");
+        }
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(_data.data()));
+        zs.avail_in = static_cast<uInt>(_data.size());
+        zs.next_out = reinterpret_cast<Bytef*>(&data[0]);
+        zs.avail_out = static_cast<uInt>(data.size());
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+        int err = inflate(&zs, Z_FINISH);
+        inflateEnd(&zs);
+        if (err != Z_STREAM_END || zs.total_out != _size) {
+            throw Base::FileException("Failed to decompress embedded file", _name);
+        }
+    }
+    else {
+        data = _data;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    uLong crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.data()), _size);
+    if (crc != _crc) {
+        throw Base::FileException("CRC mismatch in embedded file", _name);
+    }
+
+    std::istringstream str(data);
+    Base::Reader reader(str, _name, fileVersion);
+    func(reader);
+}
+
+// ----------------------------------------------------------
+
+std::shared_ptr<Base::DeferredDocFile> Base::DeferredDocFileHandle::getFile() const
+{
+    if (!_hasFile) {
+        return {};
+    }
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return _file;
+}
+
+void Base::DeferredDocFileHandle::setFile(const std::shared_ptr<DeferredDocFile>& file)
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    _file = file;
+    _hasFile = file != nullptr;
+}
+
+void Base::DeferredDocFileHandle::reset()
+{
+    if (_hasFile) {
+        setFile({});
+    }
+}
+
+std::size_t Base::DeferredDocFileHandle::getCompressedSize() const
+{
+    auto file = getFile();
+    return file ? file->getCompressedSize() : 0;
+}
+
+void Base::DeferredDocFileHandle::load(const std::function<void(Reader&)>& func)
+{
+    if (!_hasFile) {
+        return;
+    }
+    // only waits for another thread loading the same file
+    std::lock_guard<std::mutex> loading(loadMutex);
+    auto file = getFile();
+    if (!file) {
+        return;
+    }
+    // the file stays available to getFile() while it is parsed
+    try {
+        file->restore(func);
+    }
+    catch (...) {
+        release(file);
+        throw;
+    }
+    release(file);
+}
+
+void Base::DeferredDocFileHandle::release(const std::shared_ptr<DeferredDocFile>& file)
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    // it may have been replaced meanwhile
+    if (_file == file) {
+        _file.reset();
+        _hasFile = false;
+    }
+}
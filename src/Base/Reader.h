@@ -23,9 +23,13 @@
 #ifndef BASE_READER_H
 #define BASE_READER_H
 
+#include <atomic>
 #include <bitset>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -40,6 +44,7 @@
 
 namespace zipios
 {
+class ZipFile;
 class ZipInputStream;
 }
 
@@ -242,6 +247,24 @@ public:
     const char* addFile(const char* Name, Base::Persistence* Object);
     /// process the requested file writes
     void readFiles(zipios::ZipInputStream& zipstream) const;
+    /** Enable lazy restore
+     * If enabled, the files of objects that support it are not restored by
+     * readFiles() but kept compressed in memory until the object needs them.
+     * \see Persistence::isRestoreDocFileDeferrable()
+     */
+    void setLazyRestore(bool on)
+    {
+        _lazyRestore = on;
+    }
+    bool isLazyRestore() const
+    {
+        return _lazyRestore;
+    }
+    /// Set the identifier of the archive read, see Persistence::setArchivedDocFile()
+    void setArchiveId(const std::string& id)
+    {
+        _archiveId = id;
+    }
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
     bool isRegistered(Base::Persistence* Object) const;
@@ -343,6 +366,8 @@ private:
     XERCES_CPP_NAMESPACE_QUALIFIER XMLPScanToken token;
     bool _valid {false};
     bool _verbose {true};
+    bool _lazyRestore {false};
+    std::string _archiveId;
 
 public:
     struct FileEntry
@@ -377,6 +402,84 @@ private:
     std::shared_ptr<Base::XMLReader> localreader;
 };
 
+/** The DeferredDocFile class
+ * Holds the still compressed data of a file inside a project archive whose
+ * restore has been postponed by a lazily restoring XMLReader.
+ * \see Persistence::deferRestoreDocFile()
+ */
+class BaseExport DeferredDocFile
+{
+public:
+    DeferredDocFile(std::string name,
+                    int version,
+                    std::string data,
+                    std::uint32_t size,
+                    std::uint32_t crc,
+                    bool deflated);
+
+    /// Read the raw data of the entry \a name of the zip archive \a archive
+    static std::shared_ptr<DeferredDocFile> fromArchive(zipios::ZipFile& zip,
+                                                        std::istream& archive,
+                                                        const std::string& name,
+                                                        int version);
+
+    const std::string& getFileName() const;
+    /// The number of bytes held in memory
+    std::size_t getCompressedSize() const;
+    /// The data as stored in the archive
+    const std::string& getCompressedData() const;
+    std::uint32_t getSize() const;
+    std::uint32_t getCrc() const;
+    bool isDeflated() const;
+    /// Decompress the data and pass it to \a func
+    void restore(const std::function<void(Reader&)>& func) const;
+
+private:
+    std::string _name;
+    int fileVersion;
+    std::string _data;
+    std::uint32_t _size;
+    std::uint32_t _crc;
+    bool _deflated;
+};
+
+/** The DeferredDocFileHandle class
+ * Holds the deferred file of a property until the property loads it. The
+ * file is parsed without holding the lock that guards it, so that loading
+ * one property neither blocks other properties nor copying this one.
+ */
+class BaseExport DeferredDocFileHandle
+{
+public:
+    DeferredDocFileHandle() = default;
+    DeferredDocFileHandle(const DeferredDocFileHandle&) = delete;
+    DeferredDocFileHandle& operator=(const DeferredDocFileHandle&) = delete;
+
+    /// Whether a file is still to be loaded
+    bool hasFile() const
+    {
+        return _hasFile;
+    }
+    std::shared_ptr<DeferredDocFile> getFile() const;
+    void setFile(const std::shared_ptr<DeferredDocFile>& file);
+    void reset();
+    /// The number of bytes held in memory by a pending file
+    std::size_t getCompressedSize() const;
+    /** Passes the pending file to \a func and releases it afterwards, even if
+     * restoring it throws an exception. Concurrent calls wait until it is loaded.
+     */
+    void load(const std::function<void(Reader&)>& func);
+
+private:
+    void release(const std::shared_ptr<DeferredDocFile>& file);
+
+private:
+    std::mutex loadMutex;
+    mutable std::mutex fileMutex;
+    std::shared_ptr<DeferredDocFile> _file;
+    std::atomic<bool> _hasFile {false};
+};
+
 }  // namespace Base
 
 
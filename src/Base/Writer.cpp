@@ -23,9 +23,14 @@
 
 #include "PreCompiled.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <limits>
 #include <locale>
 #include <iomanip>
+#include <thread>
+#include <zlib.h>
 
 #include "Writer.h"
 #include "Base64.h"
@@ -33,6 +38,7 @@
 #include "Exception.h"
 #include "FileInfo.h"
 #include "Persistence.h"
+#include "Reader.h"
 #include "Stream.h"
 #include "Tools.h"
 
@@ -77,6 +83,98 @@ struct cdata_filter
     int state = 0;
 };
 
+namespace
+{
+
+// Collects the output of a single SaveDocFile() call in memory
+class ZipEntryWriter: public Writer
+{
+public:
+    explicit ZipEntryWriter(const Writer& parent)
+        : parent(parent)
+    {
+#ifdef _MSC_VER
+        StrStream.imbue(std::locale::empty());
+#else
+        StrStream.imbue(std::locale::classic());
+#endif
+        StrStream.precision(std::numeric_limits<double>::digits10 + 1);
+        StrStream.setf(ios::fixed, ios::floatfield);
+
+        setForceXML(parent.isForceXML());
+        setFileVersion(parent.getFileVersion());
+        setModes(parent.getModes());
+    }
+
+    std::ostream& Stream() override
+    {
+        return StrStream;
+    }
+    void writeFiles() override
+    {}
+
+    std::string takeData()
+    {
+        std::string data = StrStream.str();
+        StrStream.str(std::string());
+        return data;
+    }
+    const std::vector<FileEntry>& getAddedFiles() const
+    {
+        return FileList;
+    }
+
+protected:
+    std::string getUniqueFileName(const char* Name) override
+    {
+        // files added by SaveDocFile() must not clash with the ones of the parent
+        if (FileList.empty()) {
+            const auto& names = parent.getFilenames();
+            FileNames.insert(FileNames.begin(), names.begin(), names.end());
+        }
+        return Writer::getUniqueFileName(Name);
+    }
+
+private:
+    const Writer& parent;
+    std::stringstream StrStream;
+};
+
+// Compress the data in place with raw deflate as used by zip archives
+void deflateEntry(std::string& data, int level, uint32_t& size, uint32_t& crc)
+{
+    if (data.size() > std::numeric_limits<uInt>::max()) {
+        throw Base::FileException("ZipWriter: file entry exceeds 4 GB");
+    }
+
+    size = static_cast<uint32_t>(data.size());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto input = reinterpret_cast<Bytef*>(data.data());
+    crc = crc32(crc32(0L, Z_NULL, 0), input, size);
+
+    z_stream zs {};
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw Base::RuntimeError("ZipWriter: failed to initialize compression");
+    }
+
+    std::string output(deflateBound(&zs, size), '\0');
+    zs.next_in = input;
+    zs.avail_in = size;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    zs.next_out = reinterpret_cast<Bytef*>(output.data());
+    zs.avail_out = static_cast<uInt>(output.size());
+    int err = deflate(&zs, Z_FINISH);
+    output.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (err != Z_STREAM_END) {
+        throw Base::RuntimeError("ZipWriter: failed to compress file entry");
+    }
+
+    data.swap(output);
+}
+
+}  // namespace
+
 // ---------------------------------------------------------------------------
 //  Writer: Constructors and Destructor
 // ---------------------------------------------------------------------------
@@ -358,21 +456,212 @@ void ZipWriter::putNextEntry(const char* file, const char* obj)
     ZipStream.putNextEntry(file);
 }
 
+void ZipWriter::setPreviousArchive(const std::string& path, const std::string& id)
+{
+    previousZip.reset();
+    previousFile.reset();
+    previousId.clear();
+    if (path.empty() || id.empty()) {
+        return;
+    }
+
+    try {
+        auto zip = std::make_unique<zipios::ZipFile>(path);
+        auto file = std::make_unique<Base::ifstream>(FileInfo(path), std::ios::in | std::ios::binary);
+        if (*file) {
+            previousZip = std::move(zip);
+            previousFile = std::move(file);
+            previousId = id;
+        }
+    }
+    catch (const std::exception&) {
+        // not a valid archive, write all files
+    }
+}
+
+std::string ZipWriter::getArchivedFile(const std::string& fileName,
+                                       const Base::Persistence* object) const
+{
+    if (!previousZip) {
+        return {};
+    }
+    std::string name = object->getArchivedDocFile(previousId);
+    // the extension tells the format of the data, e.g. .brp or .bin
+    if (name.empty() || FileInfo(name).extension() != FileInfo(fileName).extension()) {
+        return {};
+    }
+    return name;
+}
+
+bool ZipWriter::copyArchivedFile(const std::string& fileName, const std::string& archivedName)
+{
+    std::shared_ptr<DeferredDocFile> file;
+    try {
+        file = DeferredDocFile::fromArchive(*previousZip, *previousFile, archivedName, 0);
+    }
+    catch (...) {
+        previousFile->clear();
+        return false;
+    }
+    if (!file->isDeflated()) {
+        return false;
+    }
+
+    Writer::putNextEntry(fileName.c_str());
+    const std::string& data = file->getCompressedData();
+    ZipStream.putRawEntry(fileName,
+                          data.data(),
+                          static_cast<uint32_t>(data.size()),
+                          file->getSize(),
+                          file->getCrc());
+    return true;
+}
+
 void ZipWriter::writeFiles()
 {
+    if (threadCount > 1) {
+        writeFilesParallel();
+        return;
+    }
+
     // use a while loop because it is possible that while
     // processing the files new ones can be added
     size_t index = 0;
     while (index < FileList.size()) {
         FileEntry entry = FileList[index];
-        putNextEntry(entry.FileName.c_str());
-        indent = 0;
-        indBuf[0] = 0;
-        entry.Object->SaveDocFile(*this);
+        std::string archived = getArchivedFile(entry.FileName, entry.Object);
+        if (archived.empty() || !copyArchivedFile(entry.FileName, archived)) {
+            putNextEntry(entry.FileName.c_str());
+            indent = 0;
+            indBuf[0] = 0;
+            entry.Object->SaveDocFile(*this);
+        }
+        if (!archiveId.empty()) {
+            entry.Object->setArchivedDocFile(archiveId, entry.FileName);
+        }
         index++;
     }
 }
 
+void ZipWriter::writeFilesParallel()
+{
+    struct Job
+    {
+        std::string FileName;
+        const Base::Persistence* Object {};
+        bool threadSafe {};
+        std::string archived;
+        std::unique_ptr<ZipEntryWriter> writer;
+        std::string data;
+        uint32_t size {};
+        uint32_t crc {};
+        std::exception_ptr error;
+    };
+
+    // Limit the number of entries held in memory at once
+    const size_t window = 4 * static_cast<size_t>(threadCount);
+
+    // use a while loop because it is possible that while
+    // processing the files new ones can be added
+    size_t index = 0;
+    while (index < FileList.size()) {
+        std::vector<Job> jobs(std::min(window, FileList.size() - index));
+        for (auto& job : jobs) {
+            job.FileName = FileList[index].FileName;
+            job.Object = FileList[index].Object;
+            job.threadSafe = job.Object->isSaveDocFileThreadSafe(*this);
+            job.archived = getArchivedFile(job.FileName, job.Object);
+            ++index;
+        }
+
+        // Objects that are not thread safe are serialized here and in order,
+        // so that the files they add are appended exactly as in writeFiles()
+        for (auto& job : jobs) {
+            job.writer = std::make_unique<ZipEntryWriter>(*this);
+            job.writer->putNextEntry(job.FileName.c_str());
+            if (job.threadSafe || !job.archived.empty()) {
+                continue;
+            }
+            try {
+                job.Object->SaveDocFile(*job.writer);
+                job.data = job.writer->takeData();
+            }
+            catch (...) {
+                job.error = std::current_exception();
+                break;
+            }
+            for (const auto& entry : job.writer->getAddedFiles()) {
+                FileList.push_back(entry);
+                FileNames.push_back(entry.FileName);
+            }
+        }
+
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < jobs.size(); i = next++) {
+                Job& job = jobs[i];
+                if (job.error || !job.writer || !job.archived.empty()) {
+                    continue;
+                }
+                try {
+                    if (job.threadSafe) {
+                        job.Object->SaveDocFile(*job.writer);
+                        job.data = job.writer->takeData();
+                    }
+                    deflateEntry(job.data, level, job.size, job.crc);
+                }
+                catch (...) {
+                    job.error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        size_t count = std::min(jobs.size(), static_cast<size_t>(threadCount));
+        for (size_t i = 1; i < count; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (auto& job : jobs) {
+            if (job.error) {
+                std::rethrow_exception(job.error);
+            }
+            if (!job.archived.empty()) {
+                if (copyArchivedFile(job.FileName, job.archived)) {
+                    if (!archiveId.empty()) {
+                        job.Object->setArchivedDocFile(archiveId, job.FileName);
+                    }
+                    continue;
+                }
+                // fall back to writing it here
+                job.Object->SaveDocFile(*job.writer);
+                job.data = job.writer->takeData();
+                deflateEntry(job.data, level, job.size, job.crc);
+                for (const auto& entry : job.writer->getAddedFiles()) {
+                    FileList.push_back(entry);
+                    FileNames.push_back(entry.FileName);
+                }
+            }
+            Writer::putNextEntry(job.FileName.c_str());
+            ZipStream.putRawEntry(job.FileName,
+                                  job.data.data(),
+                                  static_cast<uint32_t>(job.data.size()),
+                                  job.size,
+                                  job.crc);
+            for (const auto& error : job.writer->getErrors()) {
+                addError(error);
+            }
+            if (!archiveId.empty()) {
+                job.Object->setArchivedDocFile(archiveId, job.FileName);
+            }
+        }
+    }
+}
+
 ZipWriter::~ZipWriter()
 {
     ZipStream.close();
@@ -45,6 +45,7 @@
 namespace Base
 {
 
+class ifstream;
 class Persistence;
 
 
@@ -151,7 +152,7 @@ public:
     std::string ObjectName;
 
 protected:
-    std::string getUniqueFileName(const char* Name);
+    virtual std::string getUniqueFileName(const char* Name);
     struct FileEntry
     {
         std::string FileName;
@@ -208,7 +209,37 @@ public:
     void setLevel(int level)
     {
         ZipStream.setLevel(level);
+        this->level = level;
     }
+    /** Set the number of threads used by writeFiles()
+     * With more than one thread the additional files are serialized and
+     * compressed into memory buffers in parallel and then written to the
+     * archive in the order they were requested. Objects whose
+     * isSaveDocFileThreadSafe() returns false are still serialized by the
+     * calling thread, only their compression is done in parallel.
+     */
+    void setThreadCount(int count)
+    {
+        threadCount = count;
+    }
+    int getThreadCount() const
+    {
+        return threadCount;
+    }
+    /** Set the identifier of the archive written
+     * If set, every object is told which file its data went to,
+     * see Persistence::setArchivedDocFile().
+     */
+    void setArchiveId(const std::string& id)
+    {
+        archiveId = id;
+    }
+    /** Copy unchanged files from a previous archive
+     * The files of objects whose Persistence::getArchivedDocFile() returns a
+     * file of the archive \a id are copied from \a path as they are, instead
+     * of being written and compressed again.
+     */
+    void setPreviousArchive(const std::string& path, const std::string& id);
     void putNextEntry(const char* filename, const char* objName = nullptr) override;
 
     ZipWriter(const ZipWriter&) = delete;
@@ -216,8 +247,19 @@ public:
     ZipWriter& operator=(const ZipWriter&) = delete;
     ZipWriter& operator=(ZipWriter&&) = delete;
 
+private:
+    void writeFilesParallel();
+    std::string getArchivedFile(const std::string& fileName, const Base::Persistence* object) const;
+    bool copyArchivedFile(const std::string& fileName, const std::string& archivedName);
+
 private:
     zipios::ZipOutputStream ZipStream;
+    int level {zipios::ZipOutputStreambuf::DEFAULT_COMPRESSION};
+    int threadCount {1};
+    std::string archiveId;
+    std::string previousId;
+    std::unique_ptr<zipios::ZipFile> previousZip;
+    std::unique_ptr<Base::ifstream> previousFile;
 };
 
 /** The StringWriter class
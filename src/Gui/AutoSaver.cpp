@@ -207,6 +207,10 @@ void AutoSaver::saveDocument(const std::string& name, AutoSaveProperty& saver)
 
                     writer.setComment("AutoRecovery file");
                     writer.setLevel(1); // apparently the fastest compression
+                    // With incremental saving enabled the unchanged mesh and shape files are
+                    // copied from the project file. No archive id is set, so that the records
+                    // of the project file stay valid for the next save.
+                    doc->setPreviousArchive(writer);
                     writer.putNextEntry("Document.xml");
 
                     doc->Save(writer);
@@ -157,9 +157,8 @@ namespace PathApp {
               App::DocumentObject* obj = static_cast<App::DocumentObjectPy*>(pObj)->getDocumentObjectPtr();
               if (obj->getTypeId().isDerivedFrom(Base::Type::fromName("Path::Feature"))) {
                   const Path::Toolpath& path = static_cast<Path::Feature*>(obj)->Path.getValue();
-                  std::string gcode = path.toGCode();
                   Base::ofstream ofile(file);
-                  ofile << gcode;
+                  path.toGCode(ofile);
                   ofile.close();
               }
               else {
@@ -26,7 +26,10 @@
 #define BOOST_GEOMETRY_DISABLE_DEPRECATED_03_WARNING
 
 #ifndef _PreComp_
+# include <atomic>
 # include <cfloat>
+# include <future>
+# include <thread>
 
 # include <boost_geometry.hpp>
 # include <boost/geometry/geometries/register/point.hpp>
@@ -39,6 +42,7 @@
 # include <BRepAdaptor_Curve.hxx>
 # include <BRepAdaptor_Surface.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeEdge.hxx>
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
@@ -160,7 +164,7 @@ CAreaConfig::~CAreaConfig() {
 
 TYPESYSTEM_SOURCE(Path::Area, Base::BaseClass)
 
-bool Area::s_aborting;
+std::atomic<bool> Area::s_aborting(false);
 
 Area::Area(const AreaParams* params)
     :myParams(s_params)
@@ -1520,6 +1524,65 @@ int Area::project(TopoDS_Shape& shape_out,
     return skips;
 }
 
+/** Returns the number of threads to process \a count independent levels */
+static std::size_t levelWorkers(std::size_t count) {
+    // showShape() adds objects to the active document, so stay on the
+    // calling thread when debugging
+    if (count < 2 || FC_LOG_INSTANCE.level() > FC_LOGLEVEL_TRACE)
+        return 1;
+    return std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), count);
+}
+
+/** Calls \a func(worker, level) for the levels 0 to \a count - 1
+ *
+ * The levels are handed out in order to \a workers threads, the calling one
+ * being worker 0. The others apply the libarea settings of the calling thread.
+ * The caller stores the results by level, so the output does not depend on the
+ * scheduling. After Area::abort() no new level is started and AbortException is
+ * thrown. Otherwise the exception of the lowest failed level is rethrown.
+ */
+template<class Func>
+static void foreachLevel(std::size_t count, std::size_t workers, Func func) {
+    CAreaParams conf;
+#define AREA_CONF_GET(_param) \
+    conf.PARAM_FNAME(_param) = BOOST_PP_CAT(CArea::get_,PARAM_FARG(_param))();
+    PARAM_FOREACH(AREA_CONF_GET, AREA_PARAMS_CAREA);
+
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::exception_ptr> errors(count);
+    auto run = [&](std::size_t worker) {
+        for (std::size_t i = next++; i < count && !failed && !Area::aborting(); i = next++) {
+            try {
+                func(worker, i);
+            }
+            catch (...) {
+                // the lower levels are all started, so they can still fail first
+                errors[i] = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::future<void> > futures;
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+        futures.push_back(std::async(std::launch::async, [&, worker]() {
+            CAreaConfig c(conf, false);
+            run(worker);
+        }));
+    }
+    run(0);
+    for (auto& f : futures)
+        f.get();
+
+    if (Area::aborting())
+        throw Base::AbortException("operation aborted");
+    for (auto& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
 std::vector<shared_ptr<Area> > Area::makeSections(
     PARAM_ARGS(PARAM_FARG, AREA_PARAMS_SECTION_EXTRA),
     const std::vector<double>& _heights,
@@ -1536,7 +1599,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     if (plane.IsNull())
         throw Base::ValueError("failed to obtain section plane");
 
-    FC_TIME_INIT2(t, t1);
+    FC_TIME_INIT(t);
 
     TopLoc_Location loc(trsf);
 
@@ -1673,7 +1736,24 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     bool can_retry = fabs(tolerance) > Precision::Confusion();
     TopLoc_Location locInverse(loc.Inverted());
 
-    for (size_t i = 0; i < heights.size(); ++i) {
+    // The levels are independent. Each is sliced and converted on its own
+    // thread, and the results are collected in the order of the heights.
+    std::vector<shared_ptr<Area> > levels(heights.size());
+    std::size_t workers = levelWorkers(heights.size());
+
+    // OCC may modify the input shapes of a boolean operation (e.g. by adding
+    // pcurves), so each thread slices its own copy of the shapes
+    std::vector<std::vector<TopoDS_Shape> > copies(workers);
+    if (!project) {
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            for (const auto& s : myShapes)
+                copies[worker].push_back(worker ? BRepBuilderAPI_Copy(s.shape).Shape() : s.shape);
+        }
+    }
+
+    foreachLevel(heights.size(), workers, [&](std::size_t worker, std::size_t i) {
+        FC_TIME_INIT(t1);
+        const auto& solids = copies[worker];
         double z = heights[i];
         bool retried = !can_retry;
         while (true) {
@@ -1694,17 +1774,18 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                     TopLoc_Location wloc(t);
                     area->add(s.shape.Moved(wloc).Moved(locInverse), s.op);
                 }
-                sections.push_back(area);
+                levels[i] = area;
                 break;
             }
 
-            for (auto it = myShapes.begin(); it != myShapes.end(); ++it) {
+            auto itSolid = solids.begin();
+            for (auto it = myShapes.begin(); it != myShapes.end(); ++it, ++itSolid) {
                 const auto& s = *it;
                 BRep_Builder builder;
                 TopoDS_Compound comp;
                 builder.MakeCompound(comp);
 
-                for (TopExp_Explorer xp(s.shape.Moved(loc), TopAbs_SOLID); xp.More(); xp.Next()) {
+                for (TopExp_Explorer xp(itSolid->Moved(loc), TopAbs_SOLID); xp.More(); xp.Next()) {
                     showShape(xp.Current(), nullptr, "section_%u_shape", i);
                     std::list<TopoDS_Wire> wires;
                     Part::CrossSection section(a, b, c, xp.Current());
@@ -1765,9 +1846,12 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 }
             }
             if (!area->myShapes.empty()) {
-                sections.push_back(area);
+                levels[i] = area;
+                // build the level and its pocket or offset shape while still
+                // on this thread, callers then only collect the results
+                const TopoDS_Shape& shape = area->getShape();
                 FC_TIME_LOG(t1, "makeSection " << z);
-                showShape(area->getShape(), nullptr, "section_%u_final", i);
+                showShape(shape, nullptr, "section_%u_final", i);
                 break;
             }
             if (retried) {
@@ -1780,6 +1864,10 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 retried = true;
             }
         }
+    });
+    for (auto& area : levels) {
+        if (area)
+            sections.push_back(area);
     }
     FC_TIME_LOG(t, "makeSection count: " << sections.size() << ", total");
     return sections;
@@ -1972,11 +2060,15 @@ TopoDS_Shape Area::toShape(CArea& area, short fill, int reorient) {
         if(_index>=(int)mySections.size())\
             return TopoDS_Shape();\
         if(_index<0) {\
+            std::vector<TopoDS_Shape> shapes(mySections.size());\
+            foreachLevel(mySections.size(), levelWorkers(mySections.size()),\
+                [&](std::size_t, std::size_t i) {\
+                    shapes[i] = mySections[i]->_op(_index, ## __VA_ARGS__);\
+                });\
             BRep_Builder builder;\
             TopoDS_Compound compound;\
             builder.MakeCompound(compound);\
-            for(shared_ptr<Area> area : mySections){\
-                const TopoDS_Shape &s = area->_op(_index, ## __VA_ARGS__);\
+            for(const TopoDS_Shape &s : shapes){\
                 if(s.IsNull()) continue;\
                 builder.Add(compound,s);\
             }\
@@ -3411,7 +3503,7 @@ static inline void addParameter(bool verbose, Command& cmd, const char* name,
         cmd.Parameters[name] = relative ? d : next;
 }
 
-static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
+static inline Command makeGCode(bool verbose, const gp_Pnt& last,
     const gp_Pnt& next, const char* name)
 {
     Command cmd;
@@ -3419,19 +3511,25 @@ static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
     addParameter(verbose, cmd, "X", last.X(), next.X());
     addParameter(verbose, cmd, "Y", last.Y(), next.Y());
     addParameter(verbose, cmd, "Z", last.Z(), next.Z());
-    path.addCommand(cmd);
+    return cmd;
+}
+
+static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
+    const gp_Pnt& next, const char* name)
+{
+    path.addCommand(makeGCode(verbose, last, next, name));
     return;
 }
 
 static inline void addG1(bool verbose, Toolpath& path, const gp_Pnt& last,
     const gp_Pnt& next, double f, double& last_f)
 {
-    addGCode(verbose, path, last, next, "G1");
+    Command cmd = makeGCode(verbose, last, next, "G1");
     if (f > Precision::Confusion()) {
-        Command* cmd = path.getCommands().back();
-        addParameter(verbose, *cmd, "F", last_f, f);
+        addParameter(verbose, cmd, "F", last_f, f);
         last_f = f;
     }
+    path.addCommand(cmd);
     return;
 }
 
@@ -3735,6 +3833,7 @@ void Area::toPath(Toolpath& path, const std::list<TopoDS_Shape>& shapes,
 
 void Area::abort(bool aborting) {
     s_aborting = aborting;
+    CArea::set_please_abort(aborting);
 }
 
 bool Area::aborting() {
@@ -23,6 +23,7 @@
 #ifndef PATH_AREA_H
 #define PATH_AREA_H
 
+#include <atomic>
 #include <chrono>
 #include <list>
 #include <memory>
@@ -132,7 +133,7 @@ protected:
     bool myProjecting;
     mutable int mySkippedShapes;
 
-    static bool s_aborting;
+    static std::atomic<bool> s_aborting;
     static AreaStaticParams s_params;
 
     /** Called internally to combine children shapes for further processing */
@@ -34,6 +34,7 @@
 #include <Base/Writer.h>
 
 #include "Command.h"
+#include "GCode.h"
 
 
 using namespace Base;
@@ -99,106 +100,46 @@ bool Command::has(const std::string& attr) const
 
 std::string Command::toGCode (int precision, bool padzero) const
 {
-    std::stringstream str;
-    str.fill('0');
-    str << Name;
-    if(precision<0)
-        precision = 0;
-    double scale = std::pow(10.0,precision+1);
-    std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
+    std::string result;
+    GCodeWriter writer(result, precision, padzero);
+    writer.addName(Name);
     for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         if(i->first == "N") continue;
+        writer.addWord(i->first, i->second);
+    }
+    return result;
+}
 
-        str << " " << i->first;
+namespace {
 
-        std::int64_t v = static_cast<std::int64_t>(i->second*scale);
-        if(v<0) {
-            v = -v;
-            str << '-'; //shall we allow -0 ?
-        }
-        v+=5;
-        v /= 10;
-        str << (v/iscale);
-        if(!precision) continue;
+// sets the name and the parameters of a command
+class CommandBuilder : public GCodeHandler
+{
+public:
+    explicit CommandBuilder(Command &cmd)
+        : cmd(cmd)
+    {}
 
-        int width = precision;
-        std::int64_t digits = v%iscale;
-        if(!padzero) {
-            if(!digits) continue;
-            while(digits%10 == 0) {
-                digits/=10;
-                --width;
-            }
-        }
-        str << '.' << std::setw(width) << std::right << digits;
+    void onCommand(const std::string &name, const std::vector<GCodeWord> &words) override
+    {
+        cmd.Name = name;
+        cmd.Parameters.clear();
+        for (const auto &word : words)
+            cmd.Parameters[std::string(1, word.key)] = word.value;
     }
-    return str.str();
-}
+
+private:
+    Command &cmd;
+};
+
+} // namespace
 
 void Command::setFromGCode (const std::string& str)
 {
-    Parameters.clear();
-    std::string mode = "none";
-    std::string key;
-    std::string value;
-    for (unsigned int i=0; i < str.size(); i++) {
-        if ( (isdigit(str[i])) || (str[i] == '-') || (str[i] == '.') ) {
-            value += str[i];
-        } else if (isalpha(str[i])) {
-            if (mode == "command") {
-                if (!key.empty() && !value.empty()) {
-                    std::string cmd = key + value;
-                    boost::to_upper(cmd);
-                    Name = cmd;
-                    key = "";
-                    value = "";
-                    mode = "argument";
-                } else {
-                    throw Base::BadFormatError("Badly formatted GCode command");
-                }
-                mode = "argument";
-            } else if (mode == "none") {
-                mode = "command";
-            } else if (mode == "argument") {
-                if (!key.empty() && !value.empty()) {
-                    double val = std::atof(value.c_str());
-                    boost::to_upper(key);
-                    Parameters[key] = val;
-                    key = "";
-                    value = "";
-                } else {
-                    throw Base::BadFormatError("Badly formatted GCode argument");
-                }
-            } else if (mode == "comment") {
-                value += str[i];
-            }
-            key = str[i];
-        } else if (str[i] == '(') {
-            mode = "comment";
-        } else if (str[i] == ')') {
-            key = "(";
-            value += ")";
-        } else {
-            // add non-ascii characters only if this is a comment
-            if (mode == "comment") {
-                value += str[i];
-            }
-        }
-    }
-    if (!key.empty() && !value.empty()) {
-        if ( (mode == "command") || (mode == "comment") ) {
-            std::string cmd = key + value;
-            if (mode == "command")
-                boost::to_upper(cmd);
-            Name = cmd;
-        } else {
-            double val = std::atof(value.c_str());
-            boost::to_upper(key);
-            Parameters[key] = val;
-        }
-    } else {
-        throw Base::BadFormatError("Badly formatted GCode argument");
-    }
+    CommandBuilder builder(*this);
+    GCodeParser parser(builder, false);
+    parser.parse(str);
+    parser.finish();
 }
 
 void Command::setFromPlacement (const Base::Placement &plac)
@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#endif
+
+#include <Base/Exception.h>
+
+#include "GCode.h"
+
+
+using namespace Path;
+
+namespace
+{
+
+bool isNumberChar(char ch)
+{
+    return std::isdigit(static_cast<unsigned char>(ch)) || ch == '-' || ch == '.';
+}
+
+bool isCommandStart(char ch)
+{
+    return ch == 'G' || ch == 'g' || ch == 'M' || ch == 'm';
+}
+
+char toUpper(char ch)
+{
+    return static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+GCodeParser::GCodeParser(GCodeHandler& handler, bool split)
+    : handler(handler)
+    , split(split)
+    , state(split ? State::Skip : State::Command)
+{}
+
+void GCodeParser::parse(const char* begin, const char* end)
+{
+    if (!split) {
+        for (const char* it = begin; it != end; ++it) {
+            addChar(*it);
+        }
+        return;
+    }
+
+    for (const char* it = begin; it != end; ++it) {
+        char ch = *it;
+        switch (state) {
+            case State::Skip:
+                if (ch == '(') {
+                    name.assign(1, '(');
+                    state = State::Comment;
+                }
+                else if (isCommandStart(ch)) {
+                    startCommand();
+                    addChar(ch);
+                    state = State::Command;
+                }
+                break;
+            case State::Command:
+                if (ch == '(') {
+                    endCommand();
+                    name.assign(1, '(');
+                    state = State::Comment;
+                }
+                else if (isCommandStart(ch)) {
+                    endCommand();
+                    startCommand();
+                    addChar(ch);
+                }
+                else {
+                    addChar(ch);
+                }
+                break;
+            case State::Comment:
+                // a comment ends at the first closing parenthesis
+                if (ch == ')') {
+                    name += ch;
+                    words.clear();
+                    handler.onCommand(name, words);
+                    state = State::Skip;
+                }
+                else if (ch != '(') {
+                    name += ch;
+                }
+                break;
+        }
+    }
+}
+
+void GCodeParser::parse(std::istream& in)
+{
+    char buffer[65536];
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        parse(buffer, buffer + in.gcount());
+    }
+}
+
+void GCodeParser::finish()
+{
+    // an unterminated comment is dropped
+    if (state == State::Command) {
+        endCommand();
+    }
+    state = split ? State::Skip : State::Command;
+    startCommand();
+}
+
+void GCodeParser::startCommand()
+{
+    mode = Mode::None;
+    key = 0;
+    value.clear();
+    words.clear();
+}
+
+void GCodeParser::addChar(char ch)
+{
+    if (isNumberChar(ch)) {
+        value += ch;
+    }
+    else if (std::isalpha(static_cast<unsigned char>(ch))) {
+        switch (mode) {
+            case Mode::None:
+                mode = Mode::Command;
+                break;
+            case Mode::Command:
+                if (!key || value.empty()) {
+                    throw Base::BadFormatError("Badly formatted GCode command");
+                }
+                name.assign(1, toUpper(key));
+                name += value;
+                value.clear();
+                mode = Mode::Argument;
+                break;
+            case Mode::Argument:
+                if (!key || value.empty()) {
+                    throw Base::BadFormatError("Badly formatted GCode argument");
+                }
+                words.push_back(GCodeWord {toUpper(key), std::atof(value.c_str())});
+                value.clear();
+                break;
+            case Mode::Comment:
+                value += ch;
+                break;
+        }
+        key = ch;
+    }
+    else if (ch == '(') {
+        mode = Mode::Comment;
+    }
+    else if (ch == ')') {
+        key = '(';
+        value += ch;
+    }
+    else if (mode == Mode::Comment) {
+        // other characters are only kept in a comment
+        value += ch;
+    }
+}
+
+void GCodeParser::endCommand()
+{
+    if (!key || value.empty()) {
+        throw Base::BadFormatError("Badly formatted GCode argument");
+    }
+    if (mode == Mode::Command || mode == Mode::Comment) {
+        name.assign(1, mode == Mode::Command ? toUpper(key) : key);
+        name += value;
+    }
+    else {
+        words.push_back(GCodeWord {toUpper(key), std::atof(value.c_str())});
+    }
+    handler.onCommand(name, words);
+    startCommand();
+}
+
+// ----------------------------------------------------------------------------
+
+GCodeWriter::GCodeWriter(std::ostream& out, int precision, bool padzero)
+    : GCodeWriter(buffer, precision, padzero)
+{
+    stream = &out;
+}
+
+GCodeWriter::GCodeWriter(std::string& out, int precision, bool padzero)
+    : target(out)
+    , precision(std::max(precision, 0))
+    , padzero(padzero)
+{
+    scale = std::pow(10.0, this->precision + 1);
+    iscale = static_cast<long long>(scale) / 10;
+}
+
+GCodeWriter::~GCodeWriter()
+{
+    flush();
+}
+
+void GCodeWriter::addWord(std::string_view key, double value)
+{
+    char digits[64];
+    char* end = digits;
+
+    // the value is rounded to the precision in fixed point
+    long long v = static_cast<long long>(value * scale);
+    if (v < 0) {
+        v = -v;
+        *end++ = '-';
+    }
+    v += 5;
+    v /= 10;
+    end = std::to_chars(end, digits + sizeof(digits), v / iscale).ptr;
+
+    if (precision) {
+        int width = precision;
+        long long fraction = v % iscale;
+        if (!padzero) {
+            while (fraction && fraction % 10 == 0) {
+                fraction /= 10;
+                --width;
+            }
+        }
+        if (padzero || fraction) {
+            char* point = end;
+            end = std::to_chars(point + 1, digits + sizeof(digits), fraction).ptr;
+            int count = static_cast<int>(end - point - 1);
+            if (count < width) {
+                // pad with zeros after the point
+                std::copy_backward(point + 1, end, end + width - count);
+                std::fill(point + 1, point + 1 + width - count, '0');
+                end += width - count;
+            }
+            *point = '.';
+        }
+    }
+
+    target += ' ';
+    target.append(key.data(), key.size());
+    target.append(digits, end - digits);
+}
+
+void GCodeWriter::endCommand()
+{
+    target += '\n';
+    if (stream && target.size() > 65536) {
+        flush();
+    }
+}
+
+void GCodeWriter::flush()
+{
+    if (stream && !target.empty()) {
+        stream->write(target.data(), static_cast<std::streamsize>(target.size()));
+        target.clear();
+    }
+}
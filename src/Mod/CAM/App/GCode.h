@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef PATH_GCODE_H
+#define PATH_GCODE_H
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Mod/CAM/PathGlobal.h>
+
+
+namespace Path
+{
+
+/// A parameter of a G-code command
+struct GCodeWord
+{
+    char key;  // upper case letter
+    double value;
+};
+
+/** Receives the commands found by GCodeParser */
+class PathExport GCodeHandler
+{
+public:
+    virtual ~GCodeHandler() = default;
+    /// name is the upper case command, or a comment including its parentheses
+    virtual void onCommand(const std::string& name, const std::vector<GCodeWord>& words) = 0;
+};
+
+/** Single pass G-code tokenizer
+ *
+ *  The text can be given in pieces of any size, e.g. while it is read from a
+ *  file. Only the current command is buffered and the buffers are reused, so
+ *  parsing does not allocate once they have grown.
+ *
+ *  A program is split into commands at every G, M and comment, the text
+ *  before the first of them is skipped. With splitting disabled the whole
+ *  text is one command, as for Command::setFromGCode(). Malformed commands
+ *  throw a Base::BadFormatError.
+ */
+class PathExport GCodeParser
+{
+public:
+    explicit GCodeParser(GCodeHandler& handler, bool split = true);
+
+    void parse(const char* begin, const char* end);
+    void parse(std::string_view text)
+    {
+        parse(text.data(), text.data() + text.size());
+    }
+    /// parses until the end of the stream, the parser is not finished
+    void parse(std::istream& in);
+    /// passes the last command to the handler
+    void finish();
+
+private:
+    enum class State
+    {
+        Skip,
+        Command,
+        Comment
+    };
+    enum class Mode
+    {
+        None,
+        Command,
+        Argument,
+        Comment
+    };
+
+    void startCommand();
+    void addChar(char ch);
+    void endCommand();
+
+    GCodeHandler& handler;
+    bool split;
+    State state;
+    Mode mode {Mode::None};
+    char key {0};
+    std::string value;
+    std::string name;
+    std::vector<GCodeWord> words;
+};
+
+/** Writes G-code without a temporary string per command or value
+ *
+ *  The text is appended to a string, or collected in a buffer that is
+ *  written to a stream whenever it gets large and on destruction.
+ */
+class PathExport GCodeWriter
+{
+public:
+    explicit GCodeWriter(std::ostream& out, int precision = 6, bool padzero = true);
+    explicit GCodeWriter(std::string& out, int precision = 6, bool padzero = true);
+    ~GCodeWriter();
+
+    GCodeWriter(const GCodeWriter&) = delete;
+    GCodeWriter& operator=(const GCodeWriter&) = delete;
+
+    void addName(std::string_view name)
+    {
+        target.append(name.data(), name.size());
+    }
+    void addWord(std::string_view key, double value);
+    void endCommand();
+    void flush();
+
+private:
+    std::string buffer;
+    std::string& target;
+    std::ostream* stream {nullptr};
+    int precision;
+    bool padzero;
+    double scale;
+    long long iscale;
+};
+
+}  // namespace Path
+
+#endif  // PATH_GCODE_H
@@ -21,6 +21,13 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cctype>
+# include <future>
+# include <istream>
+# include <thread>
+#endif
 
 #include <App/Application.h>
 #include <Base/Console.h>
@@ -37,34 +44,72 @@ using namespace Base;
 
 TYPESYSTEM_SOURCE(Path::Toolpath , Base::Persistence)
 
+namespace {
+
+// the moves getLength() and getCycleTime() account for
+enum class Motion {
+    None,
+    Rapid,
+    Feed,
+    Arc
+};
+
+Motion motionOf(const std::string &name)
+{
+    if ( (name == "G0") || (name == "G00") )
+        return Motion::Rapid;
+    if ( (name == "G1") || (name == "G01") )
+        return Motion::Feed;
+    if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") )
+        return Motion::Arc;
+    return Motion::None;
+}
+
+double arcLength(const Vector3d &last, const Vector3d &next, const Vector3d &center)
+{
+    double radius = (last - center).Length();
+    double angle = (next - center).GetAngle(last - center);
+    return angle * radius;
+}
+
+} // namespace
+
 Toolpath::Toolpath()
+    : extraBegin(1, 0)
 {
 }
 
 Toolpath::Toolpath(const Toolpath& otherPath)
-    : vpcCommands(otherPath.vpcCommands.size())
+    : codes(otherPath.codes)
+    , axes(otherPath.axes)
+    , positions(otherPath.positions)
+    , extraBegin(otherPath.extraBegin)
+    , extras(otherPath.extras)
+    , names(otherPath.names)
+    , keys(otherPath.keys)
+    , nameCodes(otherPath.nameCodes)
+    , keyCodes(otherPath.keyCodes)
     , center(otherPath.center)
 {
-    *this = otherPath;
     recalculate();
 }
 
-Toolpath::~Toolpath()
-{
-    clear();
-}
+Toolpath::~Toolpath() = default;
 
 Toolpath &Toolpath::operator=(const Toolpath& otherPath)
 {
     if (this == &otherPath)
         return *this;
 
-    clear();
-    vpcCommands.resize(otherPath.vpcCommands.size());
-    int i = 0;
-    for (std::vector<Command*>::const_iterator it=otherPath.vpcCommands.begin();it!=otherPath.vpcCommands.end();++it,i++) {
-        vpcCommands[i] = new Command(**it);
-    }
+    codes = otherPath.codes;
+    axes = otherPath.axes;
+    positions = otherPath.positions;
+    extraBegin = otherPath.extraBegin;
+    extras = otherPath.extras;
+    names = otherPath.names;
+    keys = otherPath.keys;
+    nameCodes = otherPath.nameCodes;
+    keyCodes = otherPath.keyCodes;
     center = otherPath.center;
     recalculate();
     return *this;
@@ -72,16 +117,108 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
 
 void Toolpath::clear()
 {
-    for(std::vector<Command*>::iterator it = vpcCommands.begin();it!=vpcCommands.end();++it)
-        delete ( *it );
-    vpcCommands.clear();
+    codes.clear();
+    axes.clear();
+    positions.clear();
+    extraBegin.assign(1, 0);
+    extras.clear();
+    names.clear();
+    keys.clear();
+    nameCodes.clear();
+    keyCodes.clear();
     recalculate();
 }
 
+std::uint32_t Toolpath::internName(const std::string &name)
+{
+    auto it = nameCodes.find(name);
+    if (it != nameCodes.end())
+        return it->second;
+    std::uint32_t code = names.size();
+    names.push_back(name);
+    nameCodes.emplace(name, code);
+    return code;
+}
+
+std::uint32_t Toolpath::internKey(const std::string &key)
+{
+    auto it = keyCodes.find(key);
+    if (it != keyCodes.end())
+        return it->second;
+    std::uint32_t code = keys.size();
+    keys.push_back(key);
+    keyCodes.emplace(key, code);
+    return code;
+}
+
+void Toolpath::insertRow(unsigned int pos, const Command &Cmd)
+{
+    std::uint8_t flags = 0;
+    Vector3d position;
+    std::uint32_t first = extraBegin[pos];
+    std::uint32_t count = 0;
+    // the map is sorted by key, so are the extras
+    for (const auto &it : Cmd.Parameters) {
+        switch (CommandView::axisFlag(it.first)) {
+        case AxisX:
+            flags |= AxisX;
+            position.x = it.second;
+            break;
+        case AxisY:
+            flags |= AxisY;
+            position.y = it.second;
+            break;
+        case AxisZ:
+            flags |= AxisZ;
+            position.z = it.second;
+            break;
+        default:
+            extras.insert(extras.begin() + first + count, Extra{internKey(it.first), it.second});
+            ++count;
+            break;
+        }
+    }
+
+    codes.insert(codes.begin() + pos, internName(Cmd.Name));
+    axes.insert(axes.begin() + pos, flags);
+    positions.insert(positions.begin() + pos, position);
+    extraBegin.insert(extraBegin.begin() + pos + 1, first + count);
+    for (std::size_t i = pos + 2; i < extraBegin.size(); i++)
+        extraBegin[i] += count;
+}
+
+void Toolpath::eraseRow(unsigned int pos)
+{
+    std::uint32_t first = extraBegin[pos];
+    std::uint32_t count = extraBegin[pos + 1] - first;
+    extras.erase(extras.begin() + first, extras.begin() + first + count);
+    extraBegin.erase(extraBegin.begin() + pos + 1);
+    for (std::size_t i = pos + 1; i < extraBegin.size(); i++)
+        extraBegin[i] -= count;
+
+    codes.erase(codes.begin() + pos);
+    axes.erase(axes.begin() + pos);
+    positions.erase(positions.begin() + pos);
+}
+
 void Toolpath::addCommand(const Command &Cmd)
 {
-    Command *tmp = new Command(Cmd);
-    vpcCommands.push_back(tmp);
+    insertRow(getSize(), Cmd);
+    recalculate();
+}
+
+void Toolpath::addCommand(const CommandView &Cmd)
+{
+    const Toolpath &other = *Cmd.path;
+    std::uint32_t first = other.extraBegin[Cmd.pos];
+    std::uint32_t last = other.extraBegin[Cmd.pos + 1];
+    for (std::uint32_t i = first; i < last; i++)
+        extras.push_back(Extra{internKey(other.keys[other.extras[i].key]), other.extras[i].value});
+
+    codes.push_back(internName(Cmd.getName()));
+    axes.push_back(other.axes[Cmd.pos]);
+    positions.push_back(other.positions[Cmd.pos]);
+    extraBegin.push_back(extras.size());
     recalculate();
 }
 
@@ -89,9 +226,8 @@ void Toolpath::insertCommand(const Command &Cmd, int pos)
 {
     if (pos == -1) {
         addCommand(Cmd);
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        Command *tmp = new Command(Cmd);
-        vpcCommands.insert(vpcCommands.begin()+pos,tmp);
+    } else if (pos <= static_cast<int>(getSize())) {
+        insertRow(pos, Cmd);
     } else {
         throw Base::IndexError("Index not in range");
     }
@@ -101,43 +237,133 @@ void Toolpath::insertCommand(const Command &Cmd, int pos)
 void Toolpath::deleteCommand(int pos)
 {
     if (pos == -1) {
-        //delete(*vpcCommands.rbegin()); // causes crash
-        vpcCommands.pop_back();
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        vpcCommands.erase (vpcCommands.begin()+pos);
+        if (getSize() > 0)
+            eraseRow(getSize() - 1);
+    } else if (pos >= 0 && pos < static_cast<int>(getSize())) {
+        eraseRow(pos);
     } else {
         throw Base::IndexError("Index not in range");
     }
     recalculate();
 }
 
-double Toolpath::getLength()
+Command Toolpath::getCommand(unsigned int pos) const
 {
-    if(vpcCommands.empty())
+    return getCommandView(pos).toCommand();
+}
+
+// CommandView
+
+int CommandView::axisFlag(std::string_view key)
+{
+    if (key.size() != 1)
+        return 0;
+    switch (key[0]) {
+    case 'X':
+        return Toolpath::AxisX;
+    case 'Y':
+        return Toolpath::AxisY;
+    case 'Z':
+        return Toolpath::AxisZ;
+    default:
         return 0;
+    }
+}
+
+bool CommandView::has(std::string_view key) const
+{
+    int flag = axisFlag(key);
+    if (flag)
+        return (path->axes[pos] & flag) != 0;
+    for (std::uint32_t i = path->extraBegin[pos]; i < path->extraBegin[pos + 1]; i++) {
+        if (path->keys[path->extras[i].key] == key)
+            return true;
+    }
+    return false;
+}
+
+double CommandView::getParam(std::string_view key, double fallback) const
+{
+    switch (axisFlag(key)) {
+    case Toolpath::AxisX:
+        return (path->axes[pos] & Toolpath::AxisX) ? path->positions[pos].x : fallback;
+    case Toolpath::AxisY:
+        return (path->axes[pos] & Toolpath::AxisY) ? path->positions[pos].y : fallback;
+    case Toolpath::AxisZ:
+        return (path->axes[pos] & Toolpath::AxisZ) ? path->positions[pos].z : fallback;
+    default:
+        break;
+    }
+    for (std::uint32_t i = path->extraBegin[pos]; i < path->extraBegin[pos + 1]; i++) {
+        if (path->keys[path->extras[i].key] == key)
+            return path->extras[i].value;
+    }
+    return fallback;
+}
+
+Vector3d CommandView::getPosition(const Vector3d &last) const
+{
+    std::uint8_t flags = path->axes[pos];
+    const Vector3d &position = path->positions[pos];
+    return Vector3d((flags & Toolpath::AxisX) ? position.x : last.x,
+                    (flags & Toolpath::AxisY) ? position.y : last.y,
+                    (flags & Toolpath::AxisZ) ? position.z : last.z);
+}
+
+Vector3d CommandView::getCenter() const
+{
+    return Vector3d(getParam("I"), getParam("J"), getParam("K"));
+}
+
+Command CommandView::toCommand() const
+{
+    Command cmd;
+    cmd.Name = getName();
+    std::uint8_t flags = path->axes[pos];
+    const Vector3d &position = path->positions[pos];
+    if (flags & Toolpath::AxisX)
+        cmd.Parameters["X"] = position.x;
+    if (flags & Toolpath::AxisY)
+        cmd.Parameters["Y"] = position.y;
+    if (flags & Toolpath::AxisZ)
+        cmd.Parameters["Z"] = position.z;
+    for (std::uint32_t i = path->extraBegin[pos]; i < path->extraBegin[pos + 1]; i++)
+        cmd.Parameters[path->keys[path->extras[i].key]] = path->extras[i].value;
+    return cmd;
+}
+
+// Toolpath
+
+double Toolpath::getLength() const
+{
+    if(codes.empty())
+        return 0;
+
+    std::vector<Motion> motions(names.size());
+    for (std::size_t i = 0; i < names.size(); i++)
+        motions[i] = motionOf(names[i]);
+
     double l = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        next = (*it)->getPlacement(last).getPosition();
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+    for (unsigned int i = 0; i < getSize(); i++) {
+        CommandView cmd(*this, i);
+        Motion motion = motions[codes[i]];
+        if (motion == Motion::None)
+            continue;
+        next = cmd.getPosition(last);
+        if (motion == Motion::Arc) {
+            l += arcLength(last, next, cmd.getCenter());
+        } else {
             // straight line
             l += (next - last).Length();
-            last = next;
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
-            // arc
-            Vector3d center = (*it)->getCenter();
-            double radius = (last - center).Length();
-            double angle = (next - center).GetAngle(last - center);
-            l += angle * radius;
-            last = next;
         }
+        last = next;
     }
     return l;
 }
 
-double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double vRapid)
+double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double vRapid) const
 {
     // check the feedrates are set
     if ((hFeed == 0) || (vFeed == 0)) {
@@ -156,44 +382,46 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
         vRapid = vFeed;
     }
 
-    if (vpcCommands.empty()) {
+    if (codes.empty()) {
         return 0;
     }
+
+    std::vector<Motion> motions(names.size());
+    for (std::size_t i = 0; i < names.size(); i++)
+        motions[i] = motionOf(names[i]);
+
     double l = 0;
     double time = 0;
     bool verticalMove = false;
     Vector3d last(0,0,0);
     Vector3d next;
-    for (std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        float feedrate = (*it)->getParam("F");
+    for (unsigned int i = 0; i < getSize(); i++) {
+        CommandView cmd(*this, i);
+        Motion motion = motions[codes[i]];
+        float feedrate = hFeed;
 
         l = 0;
         verticalMove = false;
-        feedrate = hFeed;
-        next = (*it)->getPlacement(last).getPosition();
+        next = cmd.getPosition(last);
 
         if (last.z != next.z){
             verticalMove = true;
             feedrate = vFeed;
         }
 
-        if ((name == "G0") || (name == "G00")){
+        if (motion == Motion::Rapid) {
             // Rapid Move
             l += (next - last).Length();
             feedrate = hRapid;
             if(verticalMove){
                 feedrate = vRapid;
             }
-        }else if ((name == "G1") || (name == "G01")) {
+        } else if (motion == Motion::Feed) {
             // Feed Move
             l += (next - last).Length();
-        }else if ((name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else if (motion == Motion::Arc) {
             // Arc Move
-            Vector3d center = (*it)->getCenter();
-            double radius = (last - center).Length();
-            double angle = (next - center).GetAngle(last - center);
-            l += angle * radius;
+            l += arcLength(last, next, cmd.getCenter());
         }
 
         time += l / feedrate;
@@ -274,91 +502,272 @@ Base::BoundBox3d Toolpath::getBoundBox() const
     return visitor.bb;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+namespace {
+
+// the parameters converted by G20 and G21, like Command::scaleBy()
+bool isLength(char key)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
-        inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
-        inches = false;
-        delete cmd;
-    } else {
-        if (inches) {
-            cmd->scaleBy(25.4);
-        }
-        commands.push_back(cmd);
+    switch (key) {
+    case 'X':
+    case 'Y':
+    case 'Z':
+    case 'I':
+    case 'J':
+    case 'R':
+    case 'Q':
+    case 'F':
+        return true;
+    default:
+        return false;
     }
 }
 
-void Toolpath::setFromGCode(const std::string instr)
+// adds the parsed commands to a path in millimeters
+class ToolpathBuilder : public GCodeHandler
 {
-    clear();
-
-    // remove comments
-    //boost::regex e("\\(.*?\\)");
-    //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
+public:
+    explicit ToolpathBuilder(Toolpath &path)
+        : path(path)
+    {}
 
-    // split input string by () or G or M commands
-    std::string mode = "command";
-    std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
-    bool inches = false;
-    while (found != std::string::npos)
+    void onCommand(const std::string &name, const std::vector<GCodeWord> &words) override
     {
-        if (str[found] == '(') {
-            // start of comment
-            if ( (last > -1) && (mode == "command") ) {
-                // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+        if (name == "G20" || name == "G21") {
+            if (!unitsSet) {
+                unitsSet = true;
+                firstUnitRow = path.getSize();
             }
-            mode = "comment";
-            last = found;
-            found = str.find_first_of(')', found+1);
-        } else if (str[found] == ')') {
-            // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
-            found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
-            // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+            inches = (name == "G20");
+        } else if (inches) {
+            scaled = words;
+            for (auto &word : scaled) {
+                if (isLength(word.key))
+                    word.value *= 25.4;
             }
-            last = found;
-            found = str.find_first_of("(gGmM", found+1);
+            path.addCommand(name, scaled);
+        } else {
+            path.addCommand(name, words);
         }
     }
-    // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
+
+    bool inches = false;
+    bool unitsSet = false; // whether G20 or G21 was found
+    unsigned int firstUnitRow = 0; // the number of commands before the first G20 or G21
+
+private:
+    Toolpath &path;
+    std::vector<GCodeWord> scaled;
+};
+
+// returns the offsets where a program can be split to be parsed in parts,
+// these are commands outside of comments
+std::vector<std::size_t> splitGCode(const std::string &str)
+{
+    const std::size_t minPartSize = 1 << 20;
+    std::size_t count = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U),
+                                              str.size() / minPartSize);
+
+    std::vector<std::size_t> bounds(1, 0);
+    std::size_t pos = 0;
+    for (std::size_t i = 1; i < count; i++) {
+        std::size_t target = std::max(str.size() / count * i, bounds.back() + 1);
+        // skip the comments before the target, the last one may contain it
+        for (;;) {
+            std::size_t open = str.find('(', pos);
+            if (open == std::string::npos || open >= target)
+                break;
+            std::size_t close = str.find(')', open + 1);
+            if (close == std::string::npos) {
+                target = std::string::npos;
+                break;
+            }
+            pos = close + 1;
+            target = std::max(target, pos);
+        }
+        if (target == std::string::npos)
+            break;
+        std::size_t start = str.find_first_of("gGmM(", target);
+        if (start == std::string::npos)
+            break;
+        bounds.push_back(start);
+    }
+    bounds.push_back(str.size());
+    return bounds;
+}
+
+} // namespace
+
+void Toolpath::addCommand(const std::string &name, const std::vector<GCodeWord> &words)
+{
+    std::uint8_t flags = 0;
+    Vector3d position;
+    std::uint32_t first = extras.size();
+    for (const auto &word : words) {
+        switch (word.key) {
+        case 'X':
+            flags |= AxisX;
+            position.x = word.value;
+            break;
+        case 'Y':
+            flags |= AxisY;
+            position.y = word.value;
+            break;
+        case 'Z':
+            flags |= AxisZ;
+            position.z = word.value;
+            break;
+        default: {
+            // keep the extras sorted, a repeated word replaces the value
+            std::uint32_t key = internKey(std::string(1, word.key));
+            auto it = extras.begin() + first;
+            while (it != extras.end() && keys[it->key] < keys[key])
+                ++it;
+            if (it != extras.end() && it->key == key)
+                it->value = word.value;
+            else
+                extras.insert(it, Extra{key, word.value});
+            break;
+        }
         }
     }
+
+    codes.push_back(internName(name));
+    axes.push_back(flags);
+    positions.push_back(position);
+    extraBegin.push_back(extras.size());
     recalculate();
 }
 
+void Toolpath::append(const Toolpath &other)
+{
+    std::vector<std::uint32_t> nameMap(other.names.size());
+    for (std::size_t i = 0; i < other.names.size(); i++)
+        nameMap[i] = internName(other.names[i]);
+    std::vector<std::uint32_t> keyMap(other.keys.size());
+    for (std::size_t i = 0; i < other.keys.size(); i++)
+        keyMap[i] = internKey(other.keys[i]);
+
+    std::uint32_t offset = extras.size();
+    for (std::uint32_t code : other.codes)
+        codes.push_back(nameMap[code]);
+    axes.insert(axes.end(), other.axes.begin(), other.axes.end());
+    positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+    for (const auto &extra : other.extras)
+        extras.push_back(Extra{keyMap[extra.key], extra.value});
+    for (std::size_t i = 1; i < other.extraBegin.size(); i++)
+        extraBegin.push_back(other.extraBegin[i] + offset);
+}
+
+void Toolpath::scaleRows(unsigned int begin, unsigned int end, double factor)
+{
+    for (unsigned int i = begin; i < end; i++)
+        positions[i] = positions[i] * factor;
+    for (std::uint32_t i = extraBegin[begin]; i < extraBegin[end]; i++) {
+        if (isLength(keys[extras[i].key][0]))
+            extras[i].value *= factor;
+    }
+}
+
+void Toolpath::setFromGCode(const std::string &str)
+{
+    clear();
+
+    std::vector<std::size_t> bounds = splitGCode(str);
+    if (bounds.size() <= 2) {
+        ToolpathBuilder builder(*this);
+        GCodeParser parser(builder);
+        parser.parse(str);
+        parser.finish();
+        recalculate();
+        return;
+    }
+
+    // parse the parts in parallel, the units of a part are only known once
+    // the previous parts are done
+    struct Units {
+        bool inches;
+        bool unitsSet;
+        unsigned int firstUnitRow;
+    };
+    std::vector<Toolpath> parts(bounds.size() - 1);
+    std::vector<std::future<Units>> futures;
+    for (std::size_t i = 0; i < parts.size(); i++) {
+        futures.push_back(std::async(std::launch::async, [&str, &bounds, &parts, i]() {
+            ToolpathBuilder builder(parts[i]);
+            GCodeParser parser(builder);
+            parser.parse(str.data() + bounds[i], str.data() + bounds[i + 1]);
+            parser.finish();
+            return Units{builder.inches, builder.unitsSet, builder.firstUnitRow};
+        }));
+    }
+
+    bool inches = false;
+    for (std::size_t i = 0; i < parts.size(); i++) {
+        Units units = futures[i].get();
+        if (inches)
+            parts[i].scaleRows(0, units.unitsSet ? units.firstUnitRow : parts[i].getSize(), 25.4);
+        if (units.unitsSet)
+            inches = units.inches;
+        append(parts[i]);
+    }
+    recalculate();
+}
+
+void Toolpath::setFromGCode(std::istream &str)
+{
+    clear();
+
+    ToolpathBuilder builder(*this);
+    GCodeParser parser(builder);
+    parser.parse(str);
+    parser.finish();
+    recalculate();
+}
+
+void Toolpath::writeGCode(GCodeWriter &writer) const
+{
+    static const std::string_view axisNames[] = {"X", "Y", "Z"};
+    for (unsigned int i = 0; i < getSize(); i++) {
+        const double values[3] = {positions[i].x, positions[i].y, positions[i].z};
+        auto writeAxis = [&](int axis) {
+            if (axes[i] & (1 << axis))
+                writer.addWord(axisNames[axis], values[axis]);
+        };
+
+        writer.addName(names[codes[i]]);
+        // merge the axes into the sorted extras, like the map of a Command
+        int axis = 0;
+        for (std::uint32_t e = extraBegin[i]; e < extraBegin[i + 1]; e++) {
+            const std::string &key = keys[extras[e].key];
+            for (; axis < 3 && !key.empty() && key[0] >= axisNames[axis][0]; axis++)
+                writeAxis(axis);
+            if (key != "N")
+                writer.addWord(key, extras[e].value);
+        }
+        for (; axis < 3; axis++)
+            writeAxis(axis);
+        writer.endCommand();
+    }
+}
+
 std::string Toolpath::toGCode() const
 {
     std::string result;
-    for (std::vector<Command*>::const_iterator it=vpcCommands.begin();it!=vpcCommands.end();++it) {
-        result += (*it)->toGCode();
-        result += "\n";
-    }
+    GCodeWriter writer(result);
+    writeGCode(writer);
     return result;
 }
 
+void Toolpath::toGCode(std::ostream &str) const
+{
+    GCodeWriter writer(str);
+    writeGCode(writer);
+}
+
 void Toolpath::recalculate() // recalculates the path cache
 {
 
-    if(vpcCommands.empty())
+    if(codes.empty())
         return;
 
     // TODO recalculate the KDL stuff. At the moment, this is unused.
@@ -422,7 +831,16 @@ void Toolpath::recalculate() // recalculates the path cache
 
 unsigned int Toolpath::getMemSize () const
 {
-    return toGCode().size();
+    std::size_t size = codes.capacity() * sizeof(std::uint32_t)
+        + axes.capacity() * sizeof(std::uint8_t)
+        + positions.capacity() * sizeof(Base::Vector3d)
+        + extraBegin.capacity() * sizeof(std::uint32_t)
+        + extras.capacity() * sizeof(Extra);
+    for (const auto &name : names)
+        size += name.capacity();
+    for (const auto &key : keys)
+        size += key.capacity();
+    return size;
 }
 
 void Toolpath::setCenter(const Base::Vector3d &c)
@@ -436,6 +854,17 @@ static void saveCenter(Writer &writer, const Base::Vector3d &center)
     writer.Stream() << writer.ind() << "<Center x=\"" << center.x << "\" y=\"" << center.y << "\" z=\"" << center.z << "\"/>" << std::endl;
 }
 
+// whether the commands are saved in binary form or as G-code, off by default
+// because versions without restoreBinary() would read the binary as G-code
+static bool binaryDocFile()
+{
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/CAM");
+    return hGrp->GetBool("SaveBinaryPath", false);
+}
+
+// the start of a binary file, G-code never starts with a digit
+static const char binaryMagic[8] = {'1', 'F', 'C', 'P', 'A', 'T', 'H', '\n'};
+
 void Toolpath::Save (Writer &writer) const
 {
     if (writer.isForceXML()) {
@@ -443,12 +872,13 @@ void Toolpath::Save (Writer &writer) const
         writer.incInd();
         saveCenter(writer, center);
         for(unsigned int i = 0; i < getSize(); i++) {
-            vpcCommands[i]->Save(writer);
+            getCommand(i).Save(writer);
         }
         writer.decInd();
     } else {
+        const char *extension = binaryDocFile() ? ".bin" : ".nc";
         writer.Stream() << writer.ind()
-            << "<Path file=\"" << writer.addFile((writer.ObjectName+".nc").c_str(), this) << "\" version=\"" << SchemaVersion << "\">" << std::endl;
+            << "<Path file=\"" << writer.addFile((writer.ObjectName+extension).c_str(), this) << "\" version=\"" << SchemaVersion << "\">" << std::endl;
         writer.incInd();
         saveCenter(writer, center);
         writer.decInd();
@@ -458,9 +888,95 @@ void Toolpath::Save (Writer &writer) const
 
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
+    if (codes.empty())
         return;
-    writer.Stream() << toGCode();
+    if (binaryDocFile())
+        saveBinary(writer.Stream());
+    else
+        toGCode(writer.Stream());
+}
+
+void Toolpath::saveBinary(std::ostream &out) const
+{
+    Base::OutputStream str(out);
+    str.setByteOrder(Base::Stream::LittleEndian);
+    str.write(binaryMagic, sizeof(binaryMagic));
+
+    auto writeStrings = [&str](const std::vector<std::string> &list) {
+        str << static_cast<std::uint32_t>(list.size());
+        for (const auto &it : list) {
+            str << static_cast<std::uint32_t>(it.size());
+            str.write(it.data(), static_cast<int>(it.size()));
+        }
+    };
+    writeStrings(names);
+    writeStrings(keys);
+
+    str << static_cast<std::uint32_t>(getSize());
+    for (unsigned int i = 0; i < getSize(); i++)
+        str << codes[i] << axes[i] << positions[i].x << positions[i].y << positions[i].z;
+    str << static_cast<std::uint32_t>(extras.size());
+    for (unsigned int i = 0; i < getSize(); i++)
+        str << extraBegin[i + 1] - extraBegin[i];
+    for (const auto &extra : extras)
+        str << extra.key << extra.value;
+}
+
+void Toolpath::restoreBinary(std::istream &in)
+{
+    Base::InputStream str(in);
+    str.setByteOrder(Base::Stream::LittleEndian);
+    auto check = [&in](bool valid) {
+        if (!in || !valid)
+            throw Base::BadFormatError("Invalid toolpath data");
+    };
+
+    auto readStrings = [&](std::vector<std::string> &list, std::unordered_map<std::string, std::uint32_t> &lookup) {
+        std::uint32_t count = 0;
+        str >> count;
+        check(true);
+        for (std::uint32_t i = 0; i < count; i++) {
+            std::uint32_t size = 0;
+            str >> size;
+            check(size <= (1U << 24));
+            std::string value(size, '\0');
+            str.read(&value[0], static_cast<int>(size));
+            check(lookup.emplace(value, i).second);
+            list.push_back(std::move(value));
+        }
+    };
+    readStrings(names, nameCodes);
+    readStrings(keys, keyCodes);
+
+    std::uint32_t count = 0;
+    str >> count;
+    check(true);
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::uint32_t code = 0;
+        std::uint8_t flags = 0;
+        Vector3d position;
+        str >> code >> flags >> position.x >> position.y >> position.z;
+        check(code < names.size());
+        codes.push_back(code);
+        axes.push_back(flags);
+        positions.push_back(position);
+    }
+
+    std::uint32_t extraCount = 0;
+    str >> extraCount;
+    check(true);
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::uint32_t size = 0;
+        str >> size;
+        check(size <= extraCount - extraBegin.back());
+        extraBegin.push_back(extraBegin.back() + size);
+    }
+    check(extraBegin.back() == extraCount);
+    extras.resize(extraCount);
+    for (auto &extra : extras) {
+        str >> extra.key >> extra.value;
+        check(extra.key < keys.size());
+    }
 }
 
 void Toolpath::Restore(XMLReader &reader)
@@ -476,17 +992,42 @@ void Toolpath::Restore(XMLReader &reader)
 
 void Toolpath::RestoreDocFile(Base::Reader &reader)
 {
-    std::string gcode;
-    std::string line;
-    while (reader >> line) {
-        gcode += line;
-        gcode += " ";
-    }
-    setFromGCode(gcode);
-
-}
-
-
+    clear();
 
+    // the format is known from the content, not from the file name
+    char magic[sizeof(binaryMagic)];
+    reader.read(magic, sizeof(magic));
+    std::size_t count = reader.gcount();
+    if (count == sizeof(binaryMagic) && std::equal(magic, magic + count, binaryMagic)) {
+        restoreBinary(reader);
+        recalculate();
+        return;
+    }
 
+    // G-code, white space was read as single spaces before
+    ToolpathBuilder builder(*this);
+    GCodeParser parser(builder);
+    bool space = true;
+    auto parseWords = [&](char *begin, char *end) {
+        char *out = begin;
+        for (char *it = begin; it != end; ++it) {
+            if (!std::isspace(static_cast<unsigned char>(*it))) {
+                *out++ = *it;
+                space = false;
+            } else if (!space) {
+                *out++ = ' ';
+                space = true;
+            }
+        }
+        parser.parse(begin, out);
+    };
 
+    parseWords(magic, magic + count);
+    std::vector<char> buffer(65536);
+    while (reader) {
+        reader.read(buffer.data(), buffer.size());
+        parseWords(buffer.data(), buffer.data() + reader.gcount());
+    }
+    parser.finish();
+    recalculate();
+}
@@ -23,17 +23,33 @@
 #ifndef PATH_Path_H
 #define PATH_Path_H
 
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <Base/BoundBox.h>
 #include <Base/Persistence.h>
 #include <Base/Vector3D.h>
 
 #include "Command.h"
+#include "GCode.h"
 
 
 namespace Path
 {
 
-    /** The representation of a CNC Toolpath */
+    class CommandView;
+
+    /** The representation of a CNC Toolpath
+     *
+     *  The commands are not kept as Command objects but column wise: an
+     *  interned code for the command name, the X, Y and Z axes in fixed
+     *  columns and all other parameters in a sparse table. Commands are read
+     *  through CommandView without allocating, getCommand() returns a copy.
+     *  G-code goes through GCodeParser and GCodeWriter, large programs are
+     *  parsed in parts in parallel.
+     */
 
     class PathExport Toolpath : public Base::Persistence
     {
@@ -56,19 +72,23 @@ namespace Path
             // interface
             void clear(); // clears the internal data
             void addCommand(const Command &Cmd); // adds a command at the end
+            void addCommand(const CommandView &Cmd); // adds a command of another path at the end
+            void addCommand(const std::string &name, const std::vector<GCodeWord> &words); // adds a parsed command at the end
             void insertCommand(const Command &Cmd, int); // inserts a command
             void deleteCommand(int); // deletes a command
-            double getLength(); // return the Length (mm) of the Path
-            double getCycleTime(double, double, double, double); // return the Cycle Time (s) of the Path
+            double getLength() const; // return the Length (mm) of the Path
+            double getCycleTime(double, double, double, double) const; // return the Cycle Time (s) of the Path
             void recalculate(); // recalculates the points
-            void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
+            void setFromGCode(const std::string&); // sets the path from the contents of the given GCode string
+            void setFromGCode(std::istream&); // sets the path from GCode read until the end of the stream
             std::string toGCode() const; // gets a gcode string representation from the Path
+            void toGCode(std::ostream&) const; // writes the gcode representation of the Path
             Base::BoundBox3d getBoundBox() const;
 
             // shortcut functions
-            unsigned int getSize() const { return vpcCommands.size(); }
-            const std::vector<Command*> &getCommands() const { return vpcCommands; }
-            const Command &getCommand(unsigned int pos)    const { return *vpcCommands[pos]; }
+            unsigned int getSize() const { return codes.size(); }
+            inline CommandView getCommandView(unsigned int pos) const;
+            Command getCommand(unsigned int pos) const; // returns a copy of the command
 
             // support for rotation
             const Base::Vector3d& getCenter() const { return center; }
@@ -77,7 +97,43 @@ namespace Path
             static const int SchemaVersion = 2;
 
         protected:
-            std::vector<Command*> vpcCommands;
+            // the parameters that have their own column
+            enum Axis : std::uint8_t {
+                AxisX = 1,
+                AxisY = 2,
+                AxisZ = 4
+            };
+
+            // a parameter without its own column
+            struct Extra {
+                std::uint32_t key; // index into keys
+                double value;
+            };
+
+            void insertRow(unsigned int pos, const Command &Cmd);
+            void eraseRow(unsigned int pos);
+            void append(const Toolpath &other);
+            void scaleRows(unsigned int begin, unsigned int end, double factor);
+            void writeGCode(GCodeWriter &writer) const;
+            void saveBinary(std::ostream &str) const;
+            void restoreBinary(std::istream &str);
+            std::uint32_t internName(const std::string &name);
+            std::uint32_t internKey(const std::string &key);
+
+            // one entry per command
+            std::vector<std::uint32_t> codes; // index into names
+            std::vector<std::uint8_t> axes; // the Axis flags set by the command
+            std::vector<Base::Vector3d> positions; // X, Y and Z, zero if not set
+            // the extras of command i are [extraBegin[i], extraBegin[i+1]), sorted by key
+            std::vector<std::uint32_t> extraBegin;
+            std::vector<Extra> extras;
+
+            // interned command names and parameter keys
+            std::vector<std::string> names;
+            std::vector<std::string> keys;
+            std::unordered_map<std::string, std::uint32_t> nameCodes;
+            std::unordered_map<std::string, std::uint32_t> keyCodes;
+
             Base::Vector3d center;
             //KDL::Path_Composite *pcPath;
 
@@ -96,8 +152,44 @@ namespace Path
             To.M.GetQuaternion(x,y,z,w);
             return Base::Placement(Base::Vector3d(To.p[0],To.p[1],To.p[2]),Base::Rotation(x,y,z,w));
         } */
+
+        friend class CommandView;
     };
 
+    /** Read-only access to a command stored in a Toolpath
+     *
+     *  The view reads the columns of the path and never allocates. It is only
+     *  valid as long as the path is not modified. Keys are expected in upper
+     *  case, as Command::getParam() does.
+     */
+    class PathExport CommandView
+    {
+        public:
+            CommandView(const Toolpath &path, unsigned int pos)
+                : path(&path), pos(pos) {}
+
+            const std::string &getName() const { return path->names[path->codes[pos]]; }
+            bool has(std::string_view key) const; // returns true if the command sets the parameter
+            double getParam(std::string_view key, double fallback = 0.0) const;
+            // returns the X, Y, Z position, the axes not set are taken from last
+            Base::Vector3d getPosition(const Base::Vector3d &last = Base::Vector3d()) const;
+            Base::Vector3d getCenter() const; // returns a 3d vector from the I, J, K parameters
+            Command toCommand() const; // returns a copy of the command
+
+        private:
+            static int axisFlag(std::string_view key);
+
+            const Toolpath *path;
+            unsigned int pos;
+
+            friend class Toolpath;
+    };
+
+    inline CommandView Toolpath::getCommandView(unsigned int pos) const
+    {
+        return CommandView(*this, pos);
+    }
+
 } //namespace Path
 
 
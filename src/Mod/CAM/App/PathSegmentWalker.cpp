@@ -141,9 +141,9 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
     for (unsigned int  i = 0; i < tp.getSize(); i++) {
         std::deque<Base::Vector3d> points;
 
-        const Path::Command &cmd = tp.getCommand(i);
-        const std::string &name = cmd.Name;
-        Base::Vector3d next = cmd.getPlacement().getPosition();
+        const Path::CommandView cmd = tp.getCommandView(i);
+        const std::string &name = cmd.getName();
+        Base::Vector3d next = cmd.getPosition();
         double a = A;
         double b = B;
         double c = C;
@@ -153,9 +153,9 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
         if (!cmd.has("X")) next.x = last.x;
         if (!cmd.has("Y")) next.y = last.y;
         if (!cmd.has("Z")) next.z = last.z;
-        if ( cmd.has("A")) a = cmd.getValue("A");
-        if ( cmd.has("B")) b = cmd.getValue("B");
-        if ( cmd.has("C")) c = cmd.getValue("C");
+        if ( cmd.has("A")) a = cmd.getParam("A");
+        if ( cmd.has("B")) b = cmd.getParam("B");
+        if ( cmd.has("C")) c = cmd.getParam("C");
 
         Base::Rotation nrot = yawPitchRoll(a, b, c);
 
@@ -279,7 +279,7 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             // drill,tap,bore
             double r = 0;
             if (cmd.has("R"))
-                r = cmd.getValue("R");
+                r = cmd.getParam("R");
 
             std::deque<Base::Vector3d> plist;
             std::deque<Base::Vector3d> qlist;
@@ -315,7 +315,7 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
 
             double q;
             if (cmd.has("Q")) {
-                q = cmd.getValue("Q");
+                q = cmd.getParam("Q");
                 if (q>0) {
                     Base::Vector3d temp(next);
                     for(temp.*pz=r;temp.*pz>next.*pz;temp.*pz-=q) {
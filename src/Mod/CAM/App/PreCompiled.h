@@ -43,11 +43,14 @@
 #ifdef _PreComp_
 
 // standard
+#include <atomic>
 #include <cinttypes>
+#include <future>
 #include <iomanip>
 #include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Boost
@@ -64,6 +67,7 @@
 #include <BRepAdaptor_Curve.hxx>
 #include <BRepAdaptor_Surface.hxx>
 #include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
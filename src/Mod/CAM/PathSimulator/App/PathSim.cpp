@@ -46,6 +46,9 @@ void PathSim::BeginSimulation(Part::TopoShape * stock, float resolution)
 
 void PathSim::SetToolShape(const TopoDS_Shape& toolShape, float resolution)
 {
+	// pending moves of the stock still refer to the current tool
+	if (m_stock)
+		m_stock->Flush();
 	m_tool = std::make_unique<cSimTool>(toolShape, resolution);
 }
 
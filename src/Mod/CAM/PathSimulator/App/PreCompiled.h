@@ -34,6 +34,9 @@
 
 // STL
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
 #include <iostream>
 #include <list>
 #include <map>
@@ -42,6 +45,8 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // Boost
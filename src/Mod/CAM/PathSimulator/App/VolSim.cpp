@@ -23,6 +23,11 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <unordered_map>
 #endif
 
 #include <BRepBndLib.hxx>
@@ -50,14 +55,46 @@ cStock::cStock(float px, float py, float pz, float lx, float ly, float lz, float
 			m_stock[x][y] = m_plane;
 			m_attr[x][y] = 0;
 		}
+
+	m_tx = (m_x + SIM_TILE_SIZE - 1) / SIM_TILE_SIZE;
+	m_ty = (m_y + SIM_TILE_SIZE - 1) / SIM_TILE_SIZE;
+	m_tiles.resize(m_tx * m_ty);
+	for (int ty = 0; ty < m_ty; ty++)
+		for (int tx = 0; tx < m_tx; tx++)
+		{
+			cStockTile & tile = m_tiles[ty * m_tx + tx];
+			tile.x0 = tx * SIM_TILE_SIZE;
+			tile.y0 = ty * SIM_TILE_SIZE;
+			tile.x1 = std::min(tile.x0 + SIM_TILE_SIZE, m_x);
+			tile.y1 = std::min(tile.y0 + SIM_TILE_SIZE, m_y);
+			tile.dirty = true;
+		}
 }
 
 cStock::~cStock()
 {
 }
 
+// call func for every tile in the list, spread over the available threads
+template <class Func>
+static void ForEachTile(std::vector<cStockTile *> & tiles, Func func)
+{
+	std::size_t numThreads = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), tiles.size());
+	std::atomic<std::size_t> next(0);
+	auto worker = [&]() {
+		for (std::size_t i = next++; i < tiles.size(); i = next++)
+			func(*tiles[i]);
+	};
+	std::vector<std::future<void>> futures;
+	for (std::size_t i = 1; i < numThreads; i++)
+		futures.push_back(std::async(std::launch::async, worker));
+	worker();
+	for (auto & future : futures)
+		future.get();
+}
+
 
-float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz)
+float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, cStockTile & tile)
 {
 	float z = m_stock[xp][yp];
 	bool xr_ok = true;
@@ -71,7 +108,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (xr_ok)
 		{
 			int tx = xp + x_size;
-			if (tx >= m_x)
+			if (tx >= tile.x1)
 				xr_ok = false;
 			else
 			{
@@ -92,7 +129,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (xl_ok)
 		{
 			int tx = xp - 1;
-			if (tx < 0)
+			if (tx < tile.x0)
 				xl_ok = false;
 			else
 			{
@@ -116,7 +153,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (yu_ok)
 		{
 			int ty = yp + y_size;
-			if (ty >= m_y)
+			if (ty >= tile.y1)
 				yu_ok = false;
 			else
 			{
@@ -137,7 +174,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (yd_ok)
 		{
 			int ty = yp - 1;
-			if (ty < 0)
+			if (ty < tile.y0)
 				yd_ok = false;
 			else
 			{
@@ -160,23 +197,23 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 	return z;
 }
 
-int cStock::TesselTop(int xp, int yp)
+int cStock::TesselTop(int xp, int yp, cStockTile & tile)
 {
 	int x_size, y_size;
-	float z = FindRectTop(xp, yp, x_size, y_size, true);
+	float z = FindRectTop(xp, yp, x_size, y_size, true, tile);
 	bool farRect = false;
 	while (y_size / x_size > 5)
 	{
 		farRect = true;
 		yp += x_size * 5;
-		z = FindRectTop(xp, yp, x_size, y_size, true);
+		z = FindRectTop(xp, yp, x_size, y_size, true, tile);
 	}
 
 	while (x_size / y_size > 5)
 	{
 		farRect = true;
 		xp += y_size * 5;
-		z = FindRectTop(xp, yp, x_size, y_size, false);
+		z = FindRectTop(xp, yp, x_size, y_size, false, tile);
 	}
 
 	// mark all points inside
@@ -192,9 +229,9 @@ int cStock::TesselTop(int xp, int yp)
 		Point3D ptl(xp, yp + y_size, z);
 		Point3D ptr(xp + x_size, yp + y_size, z);
 		if (fabs(m_pz + m_lz - z) < SIM_EPSILON)
-			AddQuad(pbl, pbr, ptr, ptl, facetsOuter);
+			AddQuad(pbl, pbr, ptr, ptl, tile.outer);
 		else
-			AddQuad(pbl, pbr, ptr, ptl, facetsInner);
+			AddQuad(pbl, pbr, ptr, ptl, tile.inner);
 	}
 
 	if (farRect)
@@ -204,7 +241,7 @@ int cStock::TesselTop(int xp, int yp)
 }
 
 
-void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz)
+void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, cStockTile & tile)
 {
 	bool xr_ok = true;
 	bool xl_ok = scanHoriz;
@@ -217,7 +254,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (xr_ok)
 		{
 			int tx = xp + x_size;
-			if (tx >= m_x)
+			if (tx >= tile.x1)
 				xr_ok = false;
 			else
 			{
@@ -238,7 +275,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (xl_ok)
 		{
 			int tx = xp - 1;
-			if (tx < 0)
+			if (tx < tile.x0)
 				xl_ok = false;
 			else
 			{
@@ -262,7 +299,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (yu_ok)
 		{
 			int ty = yp + y_size;
-			if (ty >= m_y)
+			if (ty >= tile.y1)
 				yu_ok = false;
 			else
 			{
@@ -283,7 +320,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (yd_ok)
 		{
 			int ty = yp - 1;
-			if (ty < 0)
+			if (ty < tile.y0)
 				yd_ok = false;
 			else
 			{
@@ -306,23 +343,23 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 }
 
 
-int cStock::TesselBot(int xp, int yp)
+int cStock::TesselBot(int xp, int yp, cStockTile & tile)
 {
 	int x_size, y_size;
-	FindRectBot(xp, yp, x_size, y_size, true);
+	FindRectBot(xp, yp, x_size, y_size, true, tile);
 	bool farRect = false;
 	while (y_size / x_size > 5)
 	{
 		farRect = true;
 		yp += x_size * 5;
-		FindRectTop(xp, yp, x_size, y_size, true);
+		FindRectTop(xp, yp, x_size, y_size, true, tile);
 	}
 
 	while (x_size / y_size > 5)
 	{
 		farRect = true;
 		xp += y_size * 5;
-		FindRectTop(xp, yp, x_size, y_size, false);
+		FindRectTop(xp, yp, x_size, y_size, false, tile);
 	}
 
 	// mark all points inside
@@ -335,7 +372,7 @@ int cStock::TesselBot(int xp, int yp)
 	Point3D pbr(xp + x_size, yp, m_pz);
 	Point3D ptl(xp, yp + y_size, m_pz);
 	Point3D ptr(xp + x_size, yp + y_size, m_pz);
-	AddQuad(pbl, ptl, ptr, pbr, facetsOuter);
+	AddQuad(pbl, ptl, ptr, pbr, tile.outer);
 
 	if (farRect)
 		return -1;
@@ -344,33 +381,34 @@ int cStock::TesselBot(int xp, int yp)
 }
 
 
-int cStock::TesselSidesX(int yp)
+// the walls along a row are cut at the tile borders
+int cStock::TesselSidesX(int yp, cStockTile & tile)
 {
 	float lastz1 = m_pz;
 	if (yp < m_y)
-		lastz1 = std::max(m_stock[0][yp], m_pz);
+		lastz1 = std::max(m_stock[tile.x0][yp], m_pz);
 	float lastz2 = m_pz;
 	if (yp > 0)
-		lastz2 = std::max(m_stock[0][yp - 1], m_pz);
+		lastz2 = std::max(m_stock[tile.x0][yp - 1], m_pz);
 
-	std::vector<MeshCore::MeshGeomFacet> *facets = &facetsInner;
+	cTileMesh *facets = &tile.inner;
 	if (yp == 0 || yp == m_y)
-		facets = &facetsOuter;
+		facets = &tile.outer;
 
 	//bool lastzclip = (lastz - m_pz) < m_res;
-	int lastpoint = 0;
-	for (int x = 1; x <= m_x; x++)
+	int lastpoint = tile.x0;
+	for (int x = tile.x0 + 1; x <= tile.x1; x++)
 	{
 		float newz1 = m_pz;
-		if (yp < m_y && x < m_x)
+		if (yp < m_y && x < tile.x1)
 			newz1 = std::max(m_stock[x][yp], m_pz);
 		float newz2 = m_pz;
-		if (yp > 0 && x < m_x)
+		if (yp > 0 && x < tile.x1)
 			newz2 = std::max(m_stock[x][yp - 1], m_pz);
 
 		if (fabs(lastz1 - lastz2) > m_res)
 		{
-			if (fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
+			if (x < tile.x1 && fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
 				continue;
 			Point3D pbl(lastpoint, yp, lastz1);
 			Point3D pbr(x, yp, lastz1);
@@ -385,33 +423,33 @@ int cStock::TesselSidesX(int yp)
 	return 0;
 }
 
-int cStock::TesselSidesY(int xp)
+int cStock::TesselSidesY(int xp, cStockTile & tile)
 {
 	float lastz1 = m_pz;
 	if (xp < m_x)
-		lastz1 = std::max(m_stock[xp][0], m_pz);
+		lastz1 = std::max(m_stock[xp][tile.y0], m_pz);
 	float lastz2 = m_pz;
 	if (xp > 0)
-		lastz2 = std::max(m_stock[xp - 1][0], m_pz);
+		lastz2 = std::max(m_stock[xp - 1][tile.y0], m_pz);
 
-	std::vector<MeshCore::MeshGeomFacet> *facets = &facetsInner;
+	cTileMesh *facets = &tile.inner;
 	if (xp == 0 || xp == m_x)
-		facets = &facetsOuter;
+		facets = &tile.outer;
 
 	//bool lastzclip = (lastz - m_pz) < m_res;
-	int lastpoint = 0;
-	for (int y = 1; y <= m_y; y++)
+	int lastpoint = tile.y0;
+	for (int y = tile.y0 + 1; y <= tile.y1; y++)
 	{
 		float newz1 = m_pz;
-		if (xp < m_x && y < m_y)
+		if (xp < m_x && y < tile.y1)
 			newz1 = std::max(m_stock[xp][y], m_pz);
 		float newz2 = m_pz;
-		if (xp > 0 && y < m_y)
+		if (xp > 0 && y < tile.y1)
 			newz2 = std::max(m_stock[xp - 1][y], m_pz);
 
 		if (fabs(lastz1 - lastz2) > m_res)
 		{
-			if (fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
+			if (y < tile.y1 && fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
 				continue;
 			Point3D pbr(xp, lastpoint, lastz1);
 			Point3D pbl(xp, y, lastz1);
@@ -426,77 +464,187 @@ int cStock::TesselSidesY(int xp)
 	return 0;
 }
 
-void cStock::SetFacetPoints(MeshCore::MeshGeomFacet & facet, Point3D & p1, Point3D & p2, Point3D & p3)
+void cStock::AddQuad(Point3D & p1, Point3D & p2, Point3D & p3, Point3D & p4, cTileMesh & mesh)
 {
-	facet._aclPoints[0][0] = p1.x * m_res + m_px;
-	facet._aclPoints[0][1] = p1.y * m_res + m_py;
-	facet._aclPoints[0][2] = p1.z;
-	facet._aclPoints[1][0] = p2.x * m_res + m_px;
-	facet._aclPoints[1][1] = p2.y * m_res + m_py;
-	facet._aclPoints[1][2] = p2.z;
-	facet._aclPoints[2][0] = p3.x * m_res + m_px;
-	facet._aclPoints[2][1] = p3.y * m_res + m_py;
-	facet._aclPoints[2][2] = p3.z;
-	facet.CalcNormal();
+	MeshCore::PointIndex i = mesh.points.size();
+	mesh.points.push_back(MeshCore::MeshPoint(p1.x, p1.y, p1.z));
+	mesh.points.push_back(MeshCore::MeshPoint(p2.x, p2.y, p2.z));
+	mesh.points.push_back(MeshCore::MeshPoint(p3.x, p3.y, p3.z));
+	mesh.points.push_back(MeshCore::MeshPoint(p4.x, p4.y, p4.z));
+	mesh.facets.push_back(MeshCore::MeshFacet(i, i + 1, i + 2));
+	mesh.facets.push_back(MeshCore::MeshFacet(i, i + 2, i + 3));
 }
 
-void cStock::AddQuad(Point3D & p1, Point3D & p2, Point3D & p3, Point3D & p4, std::vector<MeshCore::MeshGeomFacet> & facets)
+// let the facets of a tile share their equal points
+static void MergePoints(cTileMesh & mesh)
 {
-	MeshCore::MeshGeomFacet facet;
-	SetFacetPoints(facet, p1, p2, p3);
-	facets.push_back(facet);
-	SetFacetPoints(facet, p1, p3, p4);
-	facets.push_back(facet);
+	std::vector<MeshCore::PointIndex> order(mesh.points.size());
+	for (std::size_t i = 0; i < order.size(); i++)
+		order[i] = MeshCore::PointIndex(i);
+	auto & points = mesh.points;
+	std::sort(order.begin(), order.end(), [&points](MeshCore::PointIndex a, MeshCore::PointIndex b) {
+		const MeshCore::MeshPoint & pa = points[a];
+		const MeshCore::MeshPoint & pb = points[b];
+		if (pa.x != pb.x)
+			return pa.x < pb.x;
+		if (pa.y != pb.y)
+			return pa.y < pb.y;
+		return pa.z < pb.z;
+	});
+
+	MeshCore::MeshPointArray merged;
+	std::vector<MeshCore::PointIndex> index(points.size());
+	for (std::size_t i = 0; i < order.size(); i++)
+	{
+		const MeshCore::MeshPoint & p = points[order[i]];
+		if (merged.empty() || merged.back().x != p.x || merged.back().y != p.y || merged.back().z != p.z)
+			merged.push_back(p);
+		index[order[i]] = MeshCore::PointIndex(merged.size() - 1);
+	}
+	for (auto & facet : mesh.facets)
+		for (int j = 0; j < 3; j++)
+			facet._aulPoints[j] = index[facet._aulPoints[j]];
+	mesh.points.swap(merged);
 }
 
-void cStock::Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner)
+void cStock::TesselTile(cStockTile & tile)
 {
 	// reset attribs
-	for (int y = 0; y < m_y; y++)
-	for (int x = 0; x < m_x; x++)
+	for (int y = tile.y0; y < tile.y1; y++)
+	for (int x = tile.x0; x < tile.x1; x++)
 		m_attr[x][y] = 0;
 
-	facetsOuter.clear();
-	facetsInner.clear();
+	tile.outer.points.clear();
+	tile.outer.facets.clear();
+	tile.inner.points.clear();
+	tile.inner.facets.clear();
 
-	for (int y = 0; y < m_y; y++)
+	for (int y = tile.y0; y < tile.y1; y++)
 	{
-		for (int x = 0; x < m_x; x++)
+		for (int x = tile.x0; x < tile.x1; x++)
 		{
 			int attr = m_attr[x][y];
 			if ((attr & SIM_TESSEL_TOP) == 0)
-				x += TesselTop(x, y);
+				x += TesselTop(x, y, tile);
 		}
 	}
-	for (int y = 0; y < m_y; y++)
+	for (int y = tile.y0; y < tile.y1; y++)
 	{
-		for (int x = 0; x < m_x; x++)
+		for (int x = tile.x0; x < tile.x1; x++)
 		{
 			if ((m_stock[x][y] - m_pz) < m_res)
 				m_attr[x][y] |= SIM_TESSEL_BOT;
 			if ((m_attr[x][y] & SIM_TESSEL_BOT) == 0)
-				x += TesselBot(x, y);
+				x += TesselBot(x, y, tile);
 		}
 	}
-	for (int y = 0; y <= m_y; y++)
-		TesselSidesX(y);
-	for (int x = 0; x <= m_x; x++)
-		TesselSidesY(x);
-	meshOuter.addFacets(facetsOuter);
-	meshInner.addFacets(facetsInner);
-	facetsOuter.clear();
-	facetsInner.clear();
+
+	// a tile has the walls on its lower borders, the last tiles also those on the stock border
+	int ye = tile.y1 == m_y ? m_y : tile.y1 - 1;
+	for (int y = tile.y0; y <= ye; y++)
+		TesselSidesX(y, tile);
+	int xe = tile.x1 == m_x ? m_x : tile.x1 - 1;
+	for (int x = tile.x0; x <= xe; x++)
+		TesselSidesY(x, tile);
+
+	MergePoints(tile.outer);
+	MergePoints(tile.inner);
+}
+
+void cStock::Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner)
+{
+	Flush();
+
+	// the walls on the lower borders of a tile also depend on the tiles below and left of it
+	std::vector<cStockTile *> tiles;
+	for (int ty = 0; ty < m_ty; ty++)
+	{
+		for (int tx = 0; tx < m_tx; tx++)
+		{
+			int i = ty * m_tx + tx;
+			if (m_tiles[i].dirty || (tx > 0 && m_tiles[i - 1].dirty) || (ty > 0 && m_tiles[i - m_tx].dirty))
+				tiles.push_back(&m_tiles[i]);
+		}
+	}
+	ForEachTile(tiles, [this](cStockTile & tile) { TesselTile(tile); });
+	for (auto & tile : m_tiles)
+		tile.dirty = false;
+
+	BuildMesh(true, meshOuter);
+	BuildMesh(false, meshInner);
+}
+
+// point on a tile border in pixel units, compared exactly to share it with the neighbour tile
+struct cMeshVertex
+{
+	float x, y, z;
+	bool operator == (const cMeshVertex & v) const { return x == v.x && y == v.y && z == v.z; }
+};
+
+struct cMeshVertexHash
+{
+	std::size_t operator () (const cMeshVertex & v) const
+	{
+		std::size_t seed = std::hash<float>()(v.x);
+		seed ^= std::hash<float>()(v.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= std::hash<float>()(v.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		return seed;
+	}
+};
+
+void cStock::BuildMesh(bool outer, Mesh::MeshObject & mesh)
+{
+	// the tiles go into one point array, only their border points have to be looked up
+	std::size_t numPoints = 0, numFacets = 0;
+	for (auto & tile : m_tiles)
+	{
+		cTileMesh & tileMesh = outer ? tile.outer : tile.inner;
+		numPoints += tileMesh.points.size();
+		numFacets += tileMesh.facets.size();
+	}
+	MeshCore::MeshPointArray points;
+	MeshCore::MeshFacetArray facets;
+	points.reserve(numPoints);
+	facets.reserve(numFacets);
+	std::unordered_map<cMeshVertex, MeshCore::PointIndex, cMeshVertexHash> borderIndex;
+	std::vector<MeshCore::PointIndex> index;
+	for (auto & tile : m_tiles)
+	{
+		cTileMesh & tileMesh = outer ? tile.outer : tile.inner;
+		index.resize(tileMesh.points.size());
+		for (std::size_t i = 0; i < tileMesh.points.size(); i++)
+		{
+			const MeshCore::MeshPoint & p = tileMesh.points[i];
+			index[i] = MeshCore::PointIndex(points.size());
+			if (p.x == tile.x0 || p.x == tile.x1 || p.y == tile.y0 || p.y == tile.y1)
+			{
+				auto it = borderIndex.emplace(cMeshVertex{p.x, p.y, p.z}, index[i]);
+				if (!it.second)
+				{
+					index[i] = it.first->second;
+					continue;
+				}
+			}
+			points.push_back(MeshCore::MeshPoint(p.x * m_res + m_px, p.y * m_res + m_py, p.z));
+		}
+		for (auto & facet : tileMesh.facets)
+			facets.push_back(MeshCore::MeshFacet(index[facet._aulPoints[0]], index[facet._aulPoints[1]], index[facet._aulPoints[2]]));
+	}
+	MeshCore::MeshKernel kernel;
+	kernel.Adopt(points, facets, true);
+	mesh.swap(kernel);
 }
 
 
 void cStock::CreatePocket(float cxf, float cyf, float radf, float height)
 {
+	Flush();
 	int cx = (int)((cxf - m_px) / m_res);
 	int cy = (int)((cyf - m_py) / m_res);
 	int rad = (int)(radf / m_res);
 	int drad = rad * rad;
 	int ys = std::max(0, cy - rad);
-	int ye = std::min(m_x, cy + rad);
+	int ye = std::min(m_y, cy + rad);
 	int xs = std::max(0, cx - rad);
 	int xe = std::min(m_x, cx + rad);
 	for (int y = ys; y < ye; y++)
@@ -504,16 +652,119 @@ void cStock::CreatePocket(float cxf, float cyf, float radf, float height)
 		for (int x = xs; x < xe; x++)
 		{
 			if (((x - cx)*(x - cx) + (y - cy) * (y - cy)) < drad)
-				if (m_stock[x][y] > height) m_stock[x][y] = height;
+				CutPixel(x, y, height, m_tiles[(y / SIM_TILE_SIZE) * m_tx + x / SIM_TILE_SIZE]);
 		}
 	}
 }
 
 void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 {
-	// translate coordinates
-	Point3D pi1 = ToInner(p1);
-	Point3D pi2 = ToInner(p2);
+	cSimMove move;
+	move.p1 = ToInner(p1);
+	move.p2 = ToInner(p2);
+	move.tool = &tool;
+	move.isArc = false;
+	move.isCCW = false;
+	float rad = tool.radius / m_res + 1;
+	move.minX = (int)std::floor(std::min(move.p1.x, move.p2.x) - rad);
+	move.minY = (int)std::floor(std::min(move.p1.y, move.p2.y) - rad);
+	move.maxX = (int)std::ceil(std::max(move.p1.x, move.p2.x) + rad);
+	move.maxY = (int)std::ceil(std::max(move.p1.y, move.p2.y) + rad);
+	AddMove(move);
+}
+
+void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW)
+{
+	cSimMove move;
+	move.p1 = ToInner(p1);
+	move.p2 = ToInner(p2);
+	move.cent = Point3D(cent.x / m_res, cent.y / m_res, cent.z);
+	move.tool = &tool;
+	move.isArc = true;
+	move.isCCW = isCCW;
+	// the full circle and the end cup
+	float rad = tool.radius / m_res + 1;
+	float crad = sqrt(move.cent.x * move.cent.x + move.cent.y * move.cent.y) + rad;
+	float cx = move.p1.x + move.cent.x;
+	float cy = move.p1.y + move.cent.y;
+	move.minX = (int)std::floor(std::min(cx - crad, move.p2.x - rad));
+	move.minY = (int)std::floor(std::min(cy - crad, move.p2.y - rad));
+	move.maxX = (int)std::ceil(std::max(cx + crad, move.p2.x + rad));
+	move.maxY = (int)std::ceil(std::max(cy + crad, move.p2.y + rad));
+	AddMove(move);
+}
+
+void cStock::AddMove(cSimMove & move)
+{
+	if (move.maxX < 0 || move.maxY < 0 || move.minX >= m_x || move.minY >= m_y)
+		return; // outside of the stock
+	m_moves.push_back(move);
+	if (m_moves.size() >= SIM_MAX_PENDING)
+		Flush();
+}
+
+void cStock::Flush()
+{
+	if (m_moves.empty())
+		return;
+
+	// every tile is cut by one thread, the result does not depend on the order of the moves
+	std::vector<cStockTile *> tiles;
+	for (auto & tile : m_tiles)
+	{
+		for (auto & move : m_moves)
+		{
+			if (move.maxX >= tile.x0 && move.minX < tile.x1 && move.maxY >= tile.y0 && move.minY < tile.y1)
+			{
+				tiles.push_back(&tile);
+				break;
+			}
+		}
+	}
+	ForEachTile(tiles, [this](cStockTile & tile) {
+		for (auto & move : m_moves)
+		{
+			if (move.maxX < tile.x0 || move.minX >= tile.x1 || move.maxY < tile.y0 || move.minY >= tile.y1)
+				continue;
+			if (move.isArc)
+				CutCircular(move, tile);
+			else
+				CutLinear(move, tile);
+		}
+	});
+	m_moves.clear();
+}
+
+// narrow the steps [first, last] of pos + i * step to those that may end in pixels [lo, hi)
+static void ClipSteps(float pos, float step, int lo, int hi, int & first, int & last)
+{
+	// a pixel of margin, the pixels themselves are checked when cutting
+	if (fabs(step) < SIM_EPSILON)
+	{
+		if (pos < lo - 1 || pos > hi + 1)
+			last = first - 1;
+		return;
+	}
+	float a = (lo - 1 - pos) / step;
+	float b = (hi + 1 - pos) / step;
+	if (a > b)
+		std::swap(a, b);
+	if (a > last || b < first)
+	{
+		last = first - 1;
+		return;
+	}
+	if (a > first)
+		first = (int)std::floor(a);
+	if (b < last)
+		last = (int)std::ceil(b);
+}
+
+void cStock::CutLinear(cSimMove & move, cStockTile & tile)
+{
+	Point3D & pi1 = move.p1;
+	Point3D & pi2 = move.p2;
+	cSimTool & tool = *move.tool;
 	float rad = tool.radius;
 	rad /= m_res;
 	float cupAngle = 180;
@@ -531,33 +782,29 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 		Point3D sideWay(-perpDirX * SIM_WALK_RES, -perpDirY * SIM_WALK_RES, 0);
 		int lenSteps = (int)(path.len / SIM_WALK_RES) + 1;
 		int radSteps = (int)(rad * 2 / SIM_WALK_RES) + 1;
-		float zstep = (pi2.z - pi1.z) / radSteps;
 		float tstep = 2.0 / radSteps;
-		float t = -1;
 		for (int j = 0; j < radSteps; j++)
 		{
-			float z = pi1.z + tool.GetToolProfileAt(t);
-			Point3D p = start;
-			for (int i = 0; i < lenSteps; i++)
+			Point3D lineStart = start + sideWay * j;
+			float z = pi1.z + tool.GetToolProfileAt(tstep * j - 1);
+			// the tool bottom follows the slope of the move
+			int first = 0;
+			int last = lenSteps - 1;
+			ClipSteps(lineStart.x, mainWay.x, tile.x0, tile.x1, first, last);
+			ClipSteps(lineStart.y, mainWay.y, tile.y0, tile.y1, first, last);
+			for (int i = first; i <= last; i++)
 			{
-				int x = (int)p.x;
-				int y = (int)p.y;
-				if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-				{
-					if (m_stock[x][y] > z)
-						m_stock[x][y] = z;
-				}
-				p.Add(mainWay);
-				z += zstep;
+				Point3D p = lineStart + mainWay * i;
+				CutPixel((int)p.x, (int)p.y, z + mainWay.z * i, tile);
 			}
-			t += tstep;
-			start.Add(sideWay);
 		}
 	}
 	else
 		cupAngle = 360;
 
 	// end cup
+	if (pi2.x + rad < tile.x0 - 1 || pi2.x - rad > tile.x1 + 1 || pi2.y + rad < tile.y0 - 1 || pi2.y - rad > tile.y1 + 1)
+		return;
 	for (float r = 0.5f; r <= rad; r += (float)SIM_WALK_RES)
 	{
 		Point3D cupCirc(perpDirX * r, perpDirY * r, pi2.z);
@@ -566,24 +813,19 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 		float z = pi2.z + tool.GetToolProfileAt(r / rad);
 		for (float a = 0; a < cupAngle; a += rotang)
 		{
-			int x = (int)(pi2.x + cupCirc.x);
-			int y = (int)(pi2.y + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutPixel((int)(pi2.x + cupCirc.x), (int)(pi2.y + cupCirc.y), z, tile);
 			cupCirc.Rotate();
 		}
 	}
 }
 
-void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW)
+void cStock::CutCircular(cSimMove & move, cStockTile & tile)
 {
-	// translate coordinates
-	Point3D pi1 = ToInner(p1);
-	Point3D pi2 = ToInner(p2);
-	Point3D centi(cent.x / m_res, cent.y / m_res, cent.z);
+	Point3D & pi1 = move.p1;
+	Point3D & pi2 = move.p2;
+	Point3D & centi = move.cent;
+	cSimTool & tool = *move.tool;
+	bool isCCW = move.isCCW;
 	float rad = tool.radius;
 	rad /= m_res;
 	float cpx = centi.x;
@@ -610,37 +852,65 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 		ang += 2 * 3.1415926;
 	ang = fabs(ang);
 
-	// apply path
-	Point3D cupCirc;
+	// the tile with a pixel of margin as seen from the center: distance and wedge of angles
+	float tx0 = tile.x0 - 1, tx1 = tile.x1 + 1, ty0 = tile.y0 - 1, ty1 = tile.y1 + 1;
+	float dx = std::max(std::max(tx0 - cpx, cpx - tx1), 0.0f);
+	float dy = std::max(std::max(ty0 - cpy, cpy - ty1), 0.0f);
+	float tileDist = sqrt(dx * dx + dy * dy);
+	double dir = isCCW ? 1 : -1;
+	double wedgeMid = M_PI, wedgeHalf = M_PI; // whole circle if the center is inside
+	if (tileDist > 0)
+	{
+		double mid = atan2((ty0 + ty1) / 2 - cpy, (tx0 + tx1) / 2 - cpx);
+		wedgeHalf = 0;
+		float cornersX[] = { tx0, tx1, tx1, tx0 };
+		float cornersY[] = { ty0, ty0, ty1, ty1 };
+		for (int k = 0; k < 4; k++)
+			wedgeHalf = std::max(wedgeHalf, fabs(remainder(atan2(cornersY[k] - cpy, cornersX[k] - cpx) - mid, 2 * M_PI)));
+		// angle along the motion from the start
+		wedgeMid = remainder(dir * (mid - sang), 2 * M_PI);
+		if (wedgeMid < 0)
+			wedgeMid += 2 * M_PI;
+	}
+
+	// apply path, each range of steps starts from its computed angle and rotates on from there
 	float tstep = (float)SIM_WALK_RES / rad;
 	float t = -1;
-	for (float r = crad1; r <= crad2; r += (float)SIM_WALK_RES)
+	for (float r = crad1; r <= crad2; r += (float)SIM_WALK_RES, t += tstep)
 	{
-		cupCirc.x = xynorm.x * r;
-		cupCirc.y = xynorm.y * r;
-		float rotang = (float)SIM_WALK_RES / r;
+		if (r < tileDist)
+			continue;
+		double rotang = (float)SIM_WALK_RES / r;
 		int ndivs = (int)(ang / rotang) + 1;
-		if (!isCCW)
-			rotang = -rotang;
-		cupCirc.SetRotationAngleRad(rotang);
 		float z = pi1.z + tool.GetToolProfileAt(t);
 		float zstep = (pi2.z - pi1.z) / ndivs;
-		for (int i = 0; i< ndivs; i++)
+		double cosr = cos(rotang);
+		double sinr = dir * sin(rotang);
+		// the wedge may also appear one turn before or after
+		for (int turn = -1; turn <= 1; turn++)
 		{
-			int x = (int)(cpx + cupCirc.x);
-			int y = (int)(cpy + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
+			double lo = wedgeMid + turn * 2 * M_PI - wedgeHalf;
+			double hi = wedgeMid + turn * 2 * M_PI + wedgeHalf;
+			if (hi < 0 || lo > ang)
+				continue;
+			int first = std::max(0, (int)floor(lo / rotang) - 1);
+			int last = std::min(ndivs - 1, (int)ceil(hi / rotang) + 1);
+			double a = sang + dir * rotang * first;
+			double px = r * cos(a);
+			double py = r * sin(a);
+			for (int i = first; i <= last; i++)
 			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
+				CutPixel((int)(cpx + px), (int)(cpy + py), z + zstep * i, tile);
+				double tx = px;
+				px = px * cosr - py * sinr;
+				py = tx * sinr + py * cosr;
 			}
-			z += zstep;
-			cupCirc.Rotate();
 		}
-		t += tstep;
 	}
 
 	// apply end cup
+	if (pi2.x + rad < tile.x0 - 1 || pi2.x - rad > tile.x1 + 1 || pi2.y + rad < tile.y0 - 1 || pi2.y - rad > tile.y1 + 1)
+		return;
 	xynorm.SetRotationAngleRad(ang);
 	xynorm.Rotate();
 	for (float r = 0.5f; r <= rad; r += (float)SIM_WALK_RES)
@@ -654,13 +924,7 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 		float z = pi2.z + tool.GetToolProfileAt(r / rad);
 		for (int i = 0; i < ndivs; i++)
 		{
-			int x = (int)(pi2.x + cupCirc.x);
-			int y = (int)(pi2.y + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutPixel((int)(pi2.x + cupCirc.x), (int)(pi2.y + cupCirc.y), z, tile);
 			cupCirc.Rotate();
 		}
 	}
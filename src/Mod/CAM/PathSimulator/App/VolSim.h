@@ -29,12 +29,15 @@
 
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/CAM/App/Command.h>
+#include <Mod/CAM/PathGlobal.h>
 
 
 #define SIM_EPSILON 0.00001
 #define SIM_TESSEL_TOP		1
 #define SIM_TESSEL_BOT		2
 #define SIM_WALK_RES		0.6   // step size in pixel units (to make sure all pixels in the path are visited)
+#define SIM_TILE_SIZE		64    // stock is split in square tiles of this many pixels for cutting and tessellation
+#define SIM_MAX_PENDING		512   // tool moves collected before they are applied to the stock
 
 struct toolShapePoint {
   float radiusPos;
@@ -114,6 +117,34 @@ public:
 	float length;
 };
 
+// tool motion waiting to be applied, in stock pixel units
+struct cSimMove
+{
+	Point3D p1;
+	Point3D p2;
+	Point3D cent;       // arc center relative to p1
+	cSimTool *tool;
+	bool isArc;
+	bool isCCW;
+	int minX, minY, maxX, maxY;  // pixels that may be touched
+};
+
+// facets of a tile in pixel units, the points are shared inside the tile
+struct cTileMesh
+{
+	MeshCore::MeshPointArray points;
+	MeshCore::MeshFacetArray facets;
+};
+
+// a square part of the stock with its own share of the tessellation
+struct cStockTile
+{
+	int x0, y0, x1, y1;  // pixel range [x0, x1) x [y0, y1)
+	bool dirty;          // stock changed since last tessellation
+	cTileMesh outer;
+	cTileMesh inner;
+};
+
 template <class T>
 class Array2D
 {
@@ -139,28 +170,42 @@ private:
 	int height;
 };
 
-class cStock
+class PathSimulatorExport cStock
 {
 public:
 	cStock(float px, float py, float pz, float lx, float ly, float lz, float res);
 	~cStock();
 	void Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner);
     void CreatePocket(float x, float y, float rad, float height);
+    // the moves are collected and applied together, at the latest on Tessellate or Flush
     void ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool);
     void ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW);
+    void Flush();
     inline Point3D ToInner(Point3D & p) {
 		return Point3D((p.x - m_px) / m_res, (p.y - m_py) / m_res, p.z);
 	}
 
 private:
-	float FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
-	void FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
-	void SetFacetPoints(MeshCore::MeshGeomFacet & facet, Point3D & p1, Point3D & p2, Point3D & p3);
-	void AddQuad(Point3D & p1, Point3D & p2, Point3D & p3, Point3D & p4, std::vector<MeshCore::MeshGeomFacet> & facets);
-	int TesselTop(int x, int y);
-	int TesselBot(int x, int y);
-	int TesselSidesX(int yp);
-	int TesselSidesY(int xp);
+	void AddMove(cSimMove & move);
+	void CutLinear(cSimMove & move, cStockTile & tile);
+	void CutCircular(cSimMove & move, cStockTile & tile);
+	inline void CutPixel(int x, int y, float z, cStockTile & tile)
+	{
+		if (x >= tile.x0 && y >= tile.y0 && x < tile.x1 && y < tile.y1 && m_stock[x][y] > z)
+		{
+			m_stock[x][y] = z;
+			tile.dirty = true;
+		}
+	}
+	float FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, cStockTile & tile);
+	void FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, cStockTile & tile);
+	void AddQuad(Point3D & p1, Point3D & p2, Point3D & p3, Point3D & p4, cTileMesh & mesh);
+	void TesselTile(cStockTile & tile);
+	int TesselTop(int x, int y, cStockTile & tile);
+	int TesselBot(int x, int y, cStockTile & tile);
+	int TesselSidesX(int yp, cStockTile & tile);
+	int TesselSidesY(int xp, cStockTile & tile);
+	void BuildMesh(bool outer, Mesh::MeshObject & mesh);
 	Array2D<float>  m_stock;
 	Array2D<char> m_attr;
 	float m_px, m_py, m_pz;  // stock zero position
@@ -168,8 +213,9 @@ private:
 	float m_res;        // resoulution
 	float m_plane;		// stock plane height
 	int m_x, m_y;            // stock array size
-	std::vector<MeshCore::MeshGeomFacet> facetsOuter;
-	std::vector<MeshCore::MeshGeomFacet> facetsInner;
+	std::vector<cStockTile> m_tiles;
+	int m_tx, m_ty;          // tile array size
+	std::vector<cSimMove> m_moves;  // moves not applied yet
 };
 
 class cVolSim
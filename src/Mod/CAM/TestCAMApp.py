@@ -57,6 +57,7 @@ from Tests.TestPathProfile import TestPathProfile
 from Tests.TestPathPropertyBag import TestPathPropertyBag
 from Tests.TestPathRotationGenerator import TestPathRotationGenerator
 from Tests.TestPathSetupSheet import TestPathSetupSheet
+from Tests.TestPathSimulator import TestPathSimulator
 from Tests.TestPathStock import TestPathStock
 from Tests.TestPathThreadMilling import TestPathThreadMilling
 from Tests.TestPathThreadMillingGenerator import TestPathThreadMillingGenerator
@@ -109,6 +110,7 @@ False if TestPathProfile.__name__ else True
 False if TestPathPropertyBag.__name__ else True
 False if TestPathRotationGenerator.__name__ else True
 False if TestPathSetupSheet.__name__ else True
+False if TestPathSimulator.__name__ else True
 False if TestPathStock.__name__ else True
 False if TestPathThreadMilling.__name__ else True
 False if TestPathThreadMillingGenerator.__name__ else True
@@ -414,6 +414,61 @@ class TestPathAdaptive(PathTestBase):
                 break
         self.assertTrue(isInBox, "No paths originating within the inner hole.")
 
+    def test08(self):
+        """test08() Verify every separate region is cleared once, also when processed in parallel."""
+        import area
+
+        squares = [(x, 0.0, x + 10.0, 10.0 + x / 10.0) for x in (0.0, 20.0, 40.0, 60.0)]
+        paths = [
+            [[x0, y0], [x1, y0], [x1, y1], [x0, y1]] for (x0, y0, x1, y1) in squares
+        ]
+        stock = [[[-10.0, -10.0], [80.0, -10.0], [80.0, 20.0], [-10.0, 20.0]]]
+
+        def execute(stop, threadCount=0):
+            a2d = area.Adaptive2d()
+            a2d.toolDiameter = 2.0
+            a2d.stepOverFactor = 0.2
+            a2d.tolerance = 0.1
+            a2d.opType = area.AdaptiveOperationType.ClearingInside
+            a2d.threadCount = threadCount
+            return a2d.Execute(stock, paths, lambda tpaths: stop)
+
+        def countPoints(results):
+            return sum(len(path[1]) for result in results for path in result.AdaptivePaths)
+
+        results = execute(False)
+        self.assertEqual(len(results), len(squares))
+        cleared = set()
+        for result in results:
+            self.assertTrue(len(result.AdaptivePaths) > 0)
+            x, y = result.HelixCenterPoint
+            inside = [
+                i
+                for i, (x0, y0, x1, y1) in enumerate(squares)
+                if x0 < x < x1 and y0 < y < y1
+            ]
+            self.assertEqual(len(inside), 1)
+            cleared.add(inside[0])
+        self.assertEqual(len(cleared), len(squares))
+
+        # the same regions come out in the same order every time
+        again = execute(False)
+        self.assertEqual(
+            [r.HelixCenterPoint for r in results], [r.HelixCenterPoint for r in again]
+        )
+
+        # one thread and several threads give the same paths
+        single = execute(False, 1)
+        parallel = execute(False, len(squares))
+        self.assertEqual(
+            [r.AdaptivePaths for r in single], [r.AdaptivePaths for r in parallel]
+        )
+
+        # stopping from the progress callback ends the processing of all regions
+        for threadCount in (1, len(squares)):
+            stopped = execute(True, threadCount)
+            self.assertLess(countPoints(stopped), countPoints(results))
+
 
 # Eclass
 
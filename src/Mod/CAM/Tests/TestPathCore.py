@@ -20,6 +20,10 @@
 # *                                                                         *
 # ***************************************************************************
 
+import os
+import shutil
+import tempfile
+
 import FreeCAD
 import Path
 from Tests.PathTestUtils import PathTestBase
@@ -138,3 +142,141 @@ G0 Z0.500000
         path = Path.Path(commands)
 
         self.assertEqual(path.Length, 2)
+
+    def test60(self):
+        """Test Path command storage"""
+        c1 = Path.Command("G0", {"Z": 5})
+        c2 = Path.Command("G1", {"X": 1, "Y": 2, "F": 300, "Q": 0.5})
+        c3 = Path.Command("G2", {"X": 3, "Y": 2, "I": 1, "J": 0})
+        p = Path.Path([c1, c3])
+        p.insertCommand(c2, 1)
+        self.assertEqual(
+            str(p.Commands),
+            "[Command G0 [ Z:5 ], Command G1 [ F:300 Q:0.5 X:1 Y:2 ], "
+            "Command G2 [ I:1 J:0 X:3 Y:2 ]]",
+        )
+        self.assertEqual(
+            p.toGCode(),
+            "G0 Z5.000000\n"
+            "G1 F300.000000 Q0.500000 X1.000000 Y2.000000\n"
+            "G2 I1.000000 J0.000000 X3.000000 Y2.000000\n",
+        )
+
+        # the commands of a path are copies
+        cmd = p.Commands[1]
+        cmd.x = 7
+        self.assertEqual(p.Commands[1].x, 1)
+
+        p.deleteCommand(1)
+        self.assertEqual(str(p.Commands), "[Command G0 [ Z:5 ], Command G2 [ I:1 J:0 X:3 Y:2 ]]")
+        p.deleteCommand()
+        self.assertEqual(str(p.Commands), "[Command G0 [ Z:5 ]]")
+        self.assertRaises(IndexError, p.deleteCommand, 1)
+
+        # a copy does not share the commands
+        q = p.copy()
+        q.addCommands(c2)
+        self.assertEqual(p.Size, 1)
+        self.assertEqual(q.Size, 2)
+
+    def test70(self):
+        """Test G-code round trip"""
+        gcode = """%
+(Tool: 5mm endmill)
+T1 M6
+g0 x1 y2 z5 (move (up))
+G1 Z-1 F100 N20
+G20
+G1 X1 Y1 I0.5 J0.5 K2
+G21
+G2 X0 Y0 I-1 J0 F200
+M30
+"""
+        output = """(Tool: 5mm endmill)
+M6
+G0 X1.000000 Y2.000000 Z5.000000
+(move up)
+G1 F100.000000 Z-1.000000
+G1 I12.700000 J12.700000 K2.000000 X25.400000 Y25.400000
+G2 F200.000000 I-1.000000 J0.000000 X0.000000 Y0.000000
+M30
+"""
+        p = Path.Path(gcode)
+        self.assertEqual(p.toGCode(), output)
+        self.assertEqual(p.Commands[0].Name, "(Tool: 5mm endmill)")
+
+        # the output reads back unchanged, a command at a time as well
+        p.deleteCommand(0)
+        self.assertEqual(Path.Path(p.toGCode()).toGCode(), p.toGCode())
+        for cmd, line in zip(p.Commands, p.toGCode().splitlines()):
+            self.assertEqual(Path.Command(line).toGCode(), cmd.toGCode())
+
+        self.assertRaises(Exception, Path.Path, "G1 X")
+
+    def test80(self):
+        """Test saving and restoring paths"""
+        gcode = "G0 Z5\n(a  comment)\nG1 X1.5 Y-2 F300 S1000\nG2 X0 Y0 I-1 J0\n"
+        hGrp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/CAM")
+        binary = hGrp.GetBool("SaveBinaryPath", False)
+        folder = tempfile.mkdtemp()
+        try:
+            for saveBinary in (True, False):
+                hGrp.SetBool("SaveBinaryPath", saveBinary)
+                doc = FreeCAD.newDocument("TestPathCore")
+                obj = doc.addObject("Path::Feature", "Path")
+                obj.Path = Path.Path(gcode)
+                expected = obj.Path.toGCode()
+                fileName = os.path.join(folder, "path.FCStd")
+                doc.saveAs(fileName)
+                FreeCAD.closeDocument(doc.Name)
+
+                doc = FreeCAD.openDocument(fileName)
+                try:
+                    self.assertEqual(doc.Path.Path.toGCode(), expected)
+                finally:
+                    FreeCAD.closeDocument(doc.Name)
+        finally:
+            hGrp.SetBool("SaveBinaryPath", binary)
+            shutil.rmtree(folder)
+
+    def test90(self):
+        """Test sectioning and pocketing an area at many levels"""
+        import Part
+
+        solid = Part.makeBox(20, 10, 10).cut(Part.makeCylinder(2, 10, FreeCAD.Vector(10, 5, 0)))
+
+        def makeArea(**params):
+            area = Path.Area()
+            area.setPlane(Part.makeCircle(10))
+            area.add(solid)
+            area.setParams(
+                Fill=0, Coplanar=0, PocketMode=1, ToolRadius=0.5, PocketStepover=0.5, **params
+            )
+            return area
+
+        # the levels come back in order and match the ones made one at a time
+        heights = [9.75 - i * 0.5 for i in range(20)]
+        sections = makeArea().makeSections(mode=0, heights=heights)
+        self.assertEqual(len(sections), len(heights))
+        for z, section in zip(heights, sections):
+            shape = section.getShape()
+            self.assertRoughly(shape.BoundBox.ZMin, z)
+            single = makeArea().makeSections(mode=0, heights=[z])[0].getShape()
+            self.assertEqual(len(shape.Edges), len(single.Edges))
+            self.assertRoughly(shape.Length, single.Length)
+
+        # so do the levels of an area built with a section count
+        area = makeArea(SectionCount=-1, SectionMode=0, SectionOffset=9.75, Stepdown=0.5)
+        edges = sum(len(s.getShape().Edges) for s in sections)
+        length = sum(s.getShape().Length for s in sections)
+        for shape in (area.getShape(), area.makePocket(mode=1, tool_radius=0.5, stepover=0.5)):
+            self.assertEqual(len(shape.Edges), edges)
+            self.assertRoughly(shape.Length, length, 1e-3)
+
+        # an aborted operation starts no further level
+        Path.Area.abort(True)
+        try:
+            self.assertRaises(Exception, makeArea().makeSections, mode=0, heights=heights)
+        finally:
+            Path.Area.abort(False)
+        self.assertEqual(len(makeArea().makeSections(mode=0, heights=heights)), len(heights))
@@ -0,0 +1,115 @@
+# -*- coding: utf-8 -*-
+# ***************************************************************************
+# *   Copyright (c) 2026 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import math
+
+import FreeCAD
+import Part
+import Path
+import PathSimulator
+import Tests.PathTestUtils as PathTestUtils
+
+RESOLUTION = 0.1
+
+
+def makeTool(radius):
+    return Part.makeCylinder(radius, 20)
+
+
+def stockVolume(sim):
+    (outer, inner) = sim.GetResultMesh()
+    mesh = outer.copy()
+    mesh.addMesh(inner)
+    return mesh.Volume
+
+
+def simulate(commands, radius=2, meshEveryCommand=False):
+    sim = PathSimulator.PathSim()
+    sim.BeginSimulation(Part.makeBox(40, 30, 10), RESOLUTION)
+    sim.SetToolShape(makeTool(radius), RESOLUTION)
+    pos = FreeCAD.Placement(FreeCAD.Vector(5, 15, 20), FreeCAD.Rotation())
+    for cmd in commands:
+        pos = sim.ApplyCommand(pos, cmd)
+        if meshEveryCommand:
+            sim.GetResultMesh()
+    return sim
+
+
+def slot():
+    return [
+        Path.Command("G1", {"X": 5, "Y": 15, "Z": 8}),
+        Path.Command("G1", {"X": 35, "Y": 15, "Z": 8}),
+    ]
+
+
+def program():
+    cmds = [Path.Command("G0", {"X": 5, "Y": 5, "Z": 12})]
+    for i in range(5):
+        y = 5 + 4 * i
+        cmds.append(Path.Command("G1", {"X": 5, "Y": y, "Z": 9 - 0.5 * i}))
+        cmds.append(Path.Command("G1", {"X": 35, "Y": y, "Z": 8 - 0.5 * i}))
+    cmds.append(Path.Command("G2", {"X": 35, "Y": 25, "Z": 6, "I": 0, "J": 2}))
+    cmds.append(Path.Command("G3", {"X": 15, "Y": 15, "Z": 6, "I": -10, "J": -5}))
+    return cmds
+
+
+class TestPathSimulator(PathTestUtils.PathTestBase):
+    """Unit tests for the PathSimulator stock."""
+
+    def test00(self):
+        """Verify the volume removed by a straight slot."""
+        volume = stockVolume(simulate([]))
+        removed = volume - stockVolume(simulate(slot()))
+        expected = 30 * 4 * 2 + math.pi * 2 * 2 * 2
+        self.assertRoughly(removed, expected, expected * 0.05)
+
+    def test01(self):
+        """Verify the mesh does not depend on how often it is requested."""
+        once = simulate(program())
+        often = simulate(program(), meshEveryCommand=True)
+        (outer1, inner1) = once.GetResultMesh()
+        (outer2, inner2) = often.GetResultMesh()
+        self.assertEqual(outer1.CountFacets, outer2.CountFacets)
+        self.assertEqual(inner1.CountFacets, inner2.CountFacets)
+        self.assertRoughly(stockVolume(once), stockVolume(often), 1e-3)
+
+    def test02(self):
+        """Verify a tool change applies the pending moves with the previous tool."""
+        sim = simulate(slot())
+        expected = stockVolume(sim)
+
+        sim = simulate(slot())
+        sim.SetToolShape(makeTool(1), RESOLUTION)
+        self.assertRoughly(stockVolume(sim), expected, 1e-3)
+
+    def test03(self):
+        """Verify the volume removed by a linear ramp."""
+        volume = stockVolume(simulate([]))
+        ramp = [
+            Path.Command("G1", {"X": 5, "Y": 15, "Z": 10}),
+            Path.Command("G1", {"X": 35, "Y": 15, "Z": 6}),
+        ]
+        removed = volume - stockVolume(simulate(ramp))
+        # The depth grows linearly along the slot, so it removes half of a slot of the full depth.
+        # Every point of the circle around the end is passed at the full depth.
+        expected = 30 * 4 * 4 / 2 + math.pi * 2 * 2 * 4
+        self.assertRoughly(removed, expected, expected * 0.05)
@@ -26,6 +26,12 @@
 #include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <random>
+#include <thread>
 
 namespace ClipperLib
 {
@@ -946,6 +952,7 @@ class ClearedArea
 		clearedPaths = paths;
 		bboxPathsInvalid = true;
 		bboxClippedInvalid = true;
+		chunkIndexInvalid = true;
 	}
 	void ExpandCleared(const Path toClearToolPath)
 	{
@@ -963,6 +970,7 @@ class ClearedArea
 		CleanPolygons(clearedPaths);
 		bboxPathsInvalid = true;
 		bboxClippedInvalid = true;
+		chunkIndexInvalid = true;
 		Perf_ExpandCleared.Stop();
 	}
 
@@ -980,14 +988,28 @@ class ClearedArea
 
 		BoundBox bb(toolPos, focusBBFactor2 * toolRadiusScaled);
 		clearedBoundedPaths.clear();
-		for (const auto &pth : clearedPaths)
+		UpdateChunkIndex();
+		for (size_t j = 0; j < clearedPaths.size(); j++)
 		{
-			if (pth.size() < 2)
+			const Path &pth = clearedPaths[j];
+			if (pth.size() < 2 || !pathBoxes[j].CollidesWith(bb))
 				continue;
+			vector<BoundBox> &boxes = chunkBoxes[j];
 			Path bPath;
 			size_t size = pth.size();
 			for (size_t i = 0; i < size + 1; i++)
 			{
+				// none of the segments of a chunk outside the bounds can collide
+				if (i > 0 && (i - 1) % CHUNK_SIZE == 0 && !boxes[(i - 1) / CHUNK_SIZE].CollidesWith(bb))
+				{
+					if (!bPath.empty())
+					{
+						clearedBoundedPaths.push_back(bPath);
+						bPath.clear();
+					}
+					i += CHUNK_SIZE - 1;
+					continue;
+				}
 				IntPoint last = (i > 0 ? pth[i - 1] : pth.back());
 				IntPoint next = i < size ? pth[i] : pth.front();
 				BoundBox ptbox(last, next);
@@ -1035,9 +1057,33 @@ class ClearedArea
 		bbPath.push_back(IntPoint(toolPos.X + delta2, toolPos.Y - delta2));
 		bbPath.push_back(IntPoint(toolPos.X + delta2, toolPos.Y + delta2));
 		bbPath.push_back(IntPoint(toolPos.X - delta2, toolPos.Y + delta2));
+
+		// a chunk outside the box lies in a half plane away from it, so replacing it
+		// by its chord does not change the area inside the box
+		BoundBox bb(toolPos, delta2);
+		Paths nearPaths;
+		UpdateChunkIndex();
+		for (size_t j = 0; j < clearedPaths.size(); j++)
+		{
+			const Path &pth = clearedPaths[j];
+			if (pth.size() < 3 || !pathBoxes[j].CollidesWith(bb))
+				continue;
+			vector<BoundBox> &boxes = chunkBoxes[j];
+			Path nearPath;
+			for (size_t k = 0; k < boxes.size(); k++)
+			{
+				size_t first = k * CHUNK_SIZE;
+				if (boxes[k].CollidesWith(bb))
+					nearPath.insert(nearPath.end(), pth.begin() + first, pth.begin() + min(first + CHUNK_SIZE, pth.size()));
+				else
+					nearPath.push_back(pth[first]);
+			}
+			if (nearPath.size() > 2)
+				nearPaths.push_back(nearPath);
+		}
 		clip.Clear();
 		clip.AddPath(bbPath, PolyType::ptSubject, true);
-		clip.AddPaths(clearedPaths, PolyType::ptClip, true);
+		clip.AddPaths(nearPaths, PolyType::ptClip, true);
 		clip.Execute(ClipType::ctIntersection, clearedBoundedClipped);
 		bboxClippedInvalid = false;
 		return clearedBoundedClipped;
@@ -1050,6 +1096,41 @@ class ClearedArea
 	}
 
   private:
+	// bounding boxes of the cleared paths and of their chunks of CHUNK_SIZE segments,
+	// the last chunk of a path includes the closing segment
+	void UpdateChunkIndex()
+	{
+		if (!chunkIndexInvalid)
+			return;
+		pathBoxes.resize(clearedPaths.size());
+		chunkBoxes.resize(clearedPaths.size());
+		for (size_t j = 0; j < clearedPaths.size(); j++)
+		{
+			const Path &pth = clearedPaths[j];
+			size_t size = pth.size();
+			vector<BoundBox> &boxes = chunkBoxes[j];
+			boxes.clear();
+			for (size_t first = 0; first < size; first += CHUNK_SIZE)
+			{
+				size_t last = min(first + CHUNK_SIZE, size);
+				BoundBox box(pth[first]);
+				for (size_t i = first + 1; i <= last; i++)
+					box.AddPoint(pth[i < size ? i : 0]);
+				boxes.push_back(box);
+			}
+			if (!boxes.empty())
+			{
+				pathBoxes[j] = boxes.front();
+				for (const auto &box : boxes)
+				{
+					pathBoxes[j].AddPoint(IntPoint(box.minX, box.minY));
+					pathBoxes[j].AddPoint(IntPoint(box.maxX, box.maxY));
+				}
+			}
+		}
+		chunkIndexInvalid = false;
+	}
+
 	Clipper clip;
 	ClipperOffset clipof;
 	Paths clearedPaths;
@@ -1062,6 +1143,11 @@ class ClearedArea
 
 	bool bboxClippedInvalid = false;
 	bool bboxPathsInvalid = false;
+	bool chunkIndexInvalid = true;
+	vector<BoundBox> pathBoxes;
+	vector<vector<BoundBox>> chunkBoxes;
+	// number of segments per indexed chunk
+	const size_t CHUNK_SIZE = 32;
 	// size of the focus BB
 	const ClipperLib::cInt focusBBFactor1 = 8;
 	const ClipperLib::cInt focusBBFactor2 = 9;
@@ -1135,7 +1221,7 @@ class Interpolation
 
 	double getRandomAngle()
 	{
-		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(rand()) / double(RAND_MAX);
+		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(randomGenerator() - randomGenerator.min()) / double(randomGenerator.max() - randomGenerator.min());
 	}
 	size_t getPointCount()
 	{
@@ -1145,6 +1231,8 @@ class Interpolation
   private:
 	vector<double> angles;
 	vector<double> areas;
+	// own generator keeps the regions independent of each other when processed in parallel
+	minstd_rand randomGenerator;
 };
 
 //***************************************
@@ -1401,7 +1489,7 @@ double Adaptive2d::CalcCutArea(Clipper &clip, const IntPoint &c1, const IntPoint
 		BoundBox pathBB(path.front());
 		for (const auto &pt : path)
 			pathBB.AddPoint(pt);
-		if (!c2BB.CollidesWith(c2))
+		if (!pathBB.CollidesWith(c2BB))
 			continue; // this path cannot colide with tool
 		//** end of BB check
 
@@ -1801,6 +1889,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 	//	Resolve hierarchy and run processing
 	//***************************************
 	double cornerRoundingOffset = 0.15 * toolRadiusScaled / 2;
+	vector<pair<Paths, Paths>> regions; // bound paths and tool bound paths of the independent regions
 	if (opType == OperationType::otClearingInside || opType == OperationType::otClearingOutside)
 	{
 
@@ -1853,7 +1942,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 				clipof.Clear();
 				clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 				clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
-				ProcessPolyNode(boundPaths, toolBoundPaths);
+				regions.push_back(make_pair(boundPaths, toolBoundPaths));
 			}
 		}
 	}
@@ -1912,14 +2001,82 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 					clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 					clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
 
-					ProcessPolyNode(boundPaths, toolBoundPaths);
+					regions.push_back(make_pair(boundPaths, toolBoundPaths));
 				}
 			}
 		}
 	}
+	ProcessRegions(regions);
 	return results;
 }
 
+void Adaptive2d::ProcessRegions(const vector<pair<Paths, Paths>> &regions)
+{
+	size_t maxThreads = threadCount > 0 ? size_t(threadCount) : max(thread::hardware_concurrency(), 1U);
+	size_t count = min(maxThreads, regions.size());
+#ifdef DEV_MODE
+	count = 1; // perf counters and debug drawing are not thread safe
+#endif
+	if (count < 2)
+	{
+		for (const auto &region : regions)
+			ProcessPolyNode(region.first, region.second);
+		return;
+	}
+
+	// each thread works on its own copy of the state, the progress of the threads
+	// is gathered and reported from the calling thread as the callback may run python code
+	mutex progressMutex;
+	TPaths pendingProgress;
+	atomic<bool> stop(stopProcessing);
+	function<bool(TPaths)> gatherProgress = [&](TPaths progressPaths) {
+		lock_guard<mutex> lock(progressMutex);
+		pendingProgress.insert(pendingProgress.end(), progressPaths.begin(), progressPaths.end());
+		return stop.load();
+	};
+	auto reportProgress = [&]() {
+		TPaths progressPaths;
+		{
+			lock_guard<mutex> lock(progressMutex);
+			progressPaths.swap(pendingProgress);
+		}
+		if (!progressPaths.empty() && progressCallback && (*progressCallback)(progressPaths))
+			stop = true;
+	};
+
+	vector<Adaptive2d> engines(count, *this);
+	vector<std::list<AdaptiveOutput>> regionResults(regions.size());
+	atomic<size_t> nextRegion(0);
+	vector<future<void>> futures;
+	for (auto &engine : engines)
+	{
+		engine.progressCallback = &gatherProgress;
+		futures.push_back(async(launch::async, [&, worker = &engine]() {
+			for (size_t i = nextRegion++; i < regions.size(); i = nextRegion++)
+			{
+				worker->results.clear();
+				worker->current_region = current_region + int(i);
+				worker->stopProcessing = stop;
+				worker->ProcessPolyNode(regions[i].first, regions[i].second);
+				regionResults[i].swap(worker->results);
+			}
+		}));
+	}
+	auto interval = chrono::milliseconds(1000 * PROGRESS_TICKS / CLOCKS_PER_SEC);
+	for (auto &f : futures)
+	{
+		while (f.wait_for(interval) != future_status::ready)
+			reportProgress();
+	}
+	reportProgress();
+	stopProcessing = stop;
+	current_region += int(regions.size());
+	for (auto &f : futures)
+		f.get();
+	for (auto &regionResult : regionResults)
+		results.splice(results.end(), regionResult);
+}
+
 bool Adaptive2d::FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &boundPaths,
 								ClearedArea &clearedArea /*output-initial cleared area by helix*/,
 								IntPoint &entryPoint /*output*/,
@@ -2191,16 +2348,17 @@ bool Adaptive2d::ResolveLinkPath(const IntPoint &startPoint, const IntPoint &end
 	size_t sindex;
 	double par;
 
-	// put a time limit on the resolving the link path
-	clock_t time_limit = (clock_t)(max(keepToolDownDistRatio, 3.0) * CLOCKS_PER_SEC / 6);
+	// put a time limit on the resolving the link path, in wall time as clock() counts
+	// the processor time of all threads processing regions
+	chrono::duration<double> time_limit(max(keepToolDownDistRatio, 3.0) / 6);
 
-	clock_t time_out = clock() + time_limit;
+	auto time_out = chrono::steady_clock::now() + time_limit;
 
 	while (!queue.empty())
 	{
 		if (stopProcessing)
 			return false;
-		if (clock() > time_out)
+		if (chrono::steady_clock::now() > time_out)
 		{
 			cout << "Unable to resolve tool down linking path (limit reached)." << endl;
 			return false;
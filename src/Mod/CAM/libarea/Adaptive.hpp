@@ -23,6 +23,8 @@
 #include "clipper.hpp"
 #include <vector>
 #include <list>
+#include <functional>
+#include <utility>
 #include <time.h>
 
 #ifndef ADAPTIVE_HPP
@@ -96,6 +98,7 @@ class Adaptive2d
 	bool finishingProfile = true;
 	double keepToolDownDistRatio = 3.0; // keep tool down distance ratio
 	OperationType opType = OperationType::otClearingInside;
+	int threadCount = 0; // max. number of threads processing separate regions, 0 uses all cores
 
 	std::list<AdaptiveOutput> Execute(const DPaths &stockPaths, const DPaths &paths, std::function<bool(TPaths)> progressCallbackFn);
 
@@ -125,6 +128,7 @@ class Adaptive2d
 	std::function<bool(TPaths)> *progressCallback = NULL;
 	Path toolGeometry; // tool geometry at coord 0,0, should not be modified
 
+	void ProcessRegions(const std::vector<std::pair<Paths, Paths>> &regions);
 	void ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths);
 	bool FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &bound, ClearedArea &cleared /*output*/,
 						IntPoint &entryPoint /*output*/, IntPoint &toolPos, DoublePoint &toolDir);
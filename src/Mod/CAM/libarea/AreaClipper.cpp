@@ -12,7 +12,7 @@ using namespace ClipperLib;
 bool CArea::HolesLinked(){ return false; }
 
 //static const double PI = 3.1415926535897932;
-double CArea::m_clipper_scale = 10000.0;
+thread_local double CArea::m_clipper_scale = 10000.0;
 
 class DoubleAreaPoint
 {
@@ -24,7 +24,7 @@ public:
 	IntPoint int_point(){return IntPoint((long64)(X * CArea::m_clipper_scale), (long64)(Y * CArea::m_clipper_scale));}
 };
 
-static std::list<DoubleAreaPoint> pts_for_AddVertex;
+static thread_local std::list<DoubleAreaPoint> pts_for_AddVertex;
 
 static void AddPoint(const DoubleAreaPoint& p)
 {
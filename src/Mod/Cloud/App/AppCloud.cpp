@@ -1350,9 +1350,6 @@ bool Cloud::Module::cloudSave(const char* BucketName)
 {
     Document* doc = GetApplication().getActiveDocument();
 
-    auto hGrp = App::GetApplication().GetParameterGroupByPath(
-        "User parameter:BaseApp/Preferences/Document");
-
     // Save the name of the tip object in order to handle in Restore()
     if (doc->Tip.getValue()) {
         doc->TipName.setValue(doc->Tip.getValue()->getNameInDocument());
@@ -1385,7 +1382,7 @@ bool Cloud::Module::cloudSave(const char* BucketName)
 
     mywriter.putNextEntry("Document.xml");
 
-    if (hGrp->GetBool("SaveBinaryBrep", false)) {
+    if (doc->BinaryBrep.getValue()) {
         mywriter.setMode("BinaryBrep");
     }
     mywriter.Stream() << "<?xml version='1.0' encoding='utf-8'?>" << endl
@@ -23,14 +23,25 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <algorithm>
+#include <array>
 #include <boost/core/ignore_unused.hpp>
+#include <memory>
 #include <numeric>
 
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepGProp_Face.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
 #include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
 #include <gp_Pnt.hxx>
 
@@ -41,16 +52,21 @@
 #endif
 
 #include <Base/Console.h>
+#include <Base/FileInfo.h>
 #include <Base/FutureWatcherProgress.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
 
+#include <App/Application.h>
+
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Part/App/PartFeature.h>
+#include <Mod/Part/App/Tools.h>
 #include <Mod/Points/App/PointsFeature.h>
 #include <Mod/Points/App/PointsGrid.h>
 
@@ -199,7 +215,7 @@ protected:
         assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
     }
 
-    void AddFacet(const MeshCore::MeshGeomFacet& rclFacet, unsigned long ulFacetIndex)
+    void AddFacet(const MeshCore::MeshGeomFacet& rclFacet, std::vector<unsigned long>& cells) const
     {
         unsigned long ulX1;
         unsigned long ulY1;
@@ -222,21 +238,19 @@ protected:
                 for (unsigned long ulY = ulY1; ulY <= ulY2; ulY++) {
                     for (unsigned long ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
                         if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ))) {
-                            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+                            cells.push_back(GetIndexToPosition(ulX, ulY, ulZ));
                         }
                     }
                 }
             }
         }
         else {
-            _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
+            cells.push_back(GetIndexToPosition(ulX1, ulY1, ulZ1));
         }
     }
 
     void InitGrid() override
     {
-        unsigned long i, j;
-
         Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(_transform);
 
         float fLengthX = clBBMesh.LengthX();
@@ -251,15 +265,6 @@ protected:
 
         _fGridLenZ = (1.0f + fLengthZ) / float(_ulCtGridsZ);
         _fMinZ = clBBMesh.MinZ - 0.5f;
-
-        _aulGrid.clear();
-        _aulGrid.resize(_ulCtGridsX);
-        for (i = 0; i < _ulCtGridsX; i++) {
-            _aulGrid[i].resize(_ulCtGridsY);
-            for (j = 0; j < _ulCtGridsY; j++) {
-                _aulGrid[i][j].resize(_ulCtGridsZ);
-            }
-        }
     }
 
     void RebuildGrid() override
@@ -267,12 +272,12 @@ protected:
         _ulCtElements = _pclMesh->CountFacets();
         InitGrid();
 
-        unsigned long i = 0;
-        MeshCore::MeshFacetIterator clFIter(*_pclMesh);
-        clFIter.Transform(_transform);
-        for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-            AddFacet(*clFIter, i++);
-        }
+        FillGrid(_pclMesh->CountFacets(),
+                 [this](MeshCore::ElementIndex index, std::vector<unsigned long>& cells) {
+                     MeshCore::MeshGeomFacet facet = _pclMesh->GetFacet(index);
+                     facet.Transform(_transform);
+                     AddFacet(facet, cells);
+                 });
     }
 
 private:
@@ -471,8 +476,9 @@ float InspectNominalPoints::getDistance(const Base::Vector3f& point) const
 
 // ----------------------------------------------------------------
 
-InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radius*/)
+InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float radius)
     : _rShape(shape)
+    , searchRadius(radius)
 {
     distss = new BRepExtrema_DistShapeShape();
     distss->LoadS1(_rShape);
@@ -488,14 +494,95 @@ InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radi
         }
     }
     // distss->SetDeflection(radius);
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Mod/Inspection/Inspection");
+    if (!hGrp->GetBool("ExactShapeDistance", false)) {
+        initTessellation();
+    }
 }
 
 InspectNominalShape::~InspectNominalShape()
 {
+    delete bvh;
+    delete tessellation;
     delete distss;
 }
 
+bool InspectNominalShape::initTessellation()
+{
+    if (_rShape.IsNull()) {
+        return false;
+    }
+
+    // edges and vertices that don't belong to a face are not part of the tessellation
+    if (TopExp_Explorer(_rShape, TopAbs_EDGE, TopAbs_FACE).More()
+        || TopExp_Explorer(_rShape, TopAbs_VERTEX, TopAbs_EDGE).More()) {
+        return false;
+    }
+
+    Bnd_Box bounds;
+    BRepBndLib::Add(_rShape, bounds);
+    if (bounds.IsVoid()) {
+        return false;
+    }
+
+    // Mesh a copy so that the triangulation of the shape itself isn't changed. The copy shares
+    // the geometry with the shape.
+    BRepBuilderAPI_Copy copy(_rShape, Standard_False);
+    TopoDS_Shape shape = copy.Shape();
+    double linear = std::max(std::sqrt(bounds.SquareExtent()) * 0.001, Precision::Confusion());
+    BRepMesh_IncrementalMesh(shape, linear, false, 0.2, true);
+
+    MeshCore::MeshPointArray points;
+    MeshCore::MeshFacetArray facets;
+    for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+        TopoDS_Face face = TopoDS::Face(xp.Current());
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, loc);
+        std::vector<gp_Pnt> nodes;
+        std::vector<Poly_Triangle> triangles;
+        if (mesh.IsNull() || !Part::Tools::getTriangulation(face, nodes, triangles)) {
+            return false;
+        }
+
+        // the deflection is the maximum distance between the triangulation and the surface
+        deflection = std::max(deflection, mesh->Deflection() > 0 ? mesh->Deflection() : linear);
+
+        auto offset = static_cast<MeshCore::PointIndex>(points.size());
+        for (const auto& node : nodes) {
+            points.emplace_back(Base::Vector3f(float(node.X()), float(node.Y()), float(node.Z())));
+        }
+        for (const auto& triangle : triangles) {
+            Standard_Integer n1 {}, n2 {}, n3 {};
+            triangle.Get(n1, n2, n3);
+            facets.emplace_back(offset + n1, offset + n2, offset + n3);
+            facetFace.push_back(faces.size());
+        }
+        faces.push_back(face);
+    }
+
+    if (facets.empty()) {
+        facetFace.clear();
+        faces.clear();
+        return false;
+    }
+
+    tessellation = new MeshCore::MeshKernel();
+    tessellation->Adopt(points, facets);
+    bvh = new MeshCore::MeshFacetBVH(*tessellation);
+    return true;
+}
+
 float InspectNominalShape::getDistance(const Base::Vector3f& point) const
+{
+    if (bvh) {
+        return getFaceDistance(point);
+    }
+    return getShapeDistance(point);
+}
+
+float InspectNominalShape::getShapeDistance(const Base::Vector3f& point) const
 {
     gp_Pnt pnt3d(point.x, point.y, point.z);
     BRepBuilderAPI_MakeVertex mkVert(pnt3d);
@@ -512,7 +599,7 @@ float InspectNominalShape::getDistance(const Base::Vector3f& point) const
         }
         else if (fMinDist > 0) {
             // check if the distance was computed from a face
-            if (isBelowFace(pnt3d)) {
+            if (isBelowFace(*distss, pnt3d)) {
                 fMinDist = -fMinDist;
             }
         }
@@ -520,6 +607,77 @@ float InspectNominalShape::getDistance(const Base::Vector3f& point) const
     return fMinDist;
 }
 
+float InspectNominalShape::getFaceDistance(const Base::Vector3f& point) const
+{
+    // The distance to the tessellation differs from the distance to the faces by at most
+    // the deflection.
+    float distance {};
+    MeshCore::FacetIndex nearest = bvh->NearestFacet(point, FLT_MAX, distance);
+    if (nearest == MeshCore::FACET_INDEX_MAX) {
+        return FLT_MAX;
+    }
+
+    gp_Pnt pnt3d(point.x, point.y, point.z);
+    auto margin = static_cast<float>(2.0 * deflection + Precision::Confusion());
+    if (distance - margin > searchRadius) {
+        // the point is out of the search radius and thus only the sign matters
+        bool below = false;
+        if (isSolid) {
+            below = isInsideSolid(pnt3d);
+        }
+        else {
+            MeshCore::MeshGeomFacet facet = tessellation->GetFacet(nearest);
+            Base::Vector3f foot;
+            facet.DistanceToPoint(point, foot);
+            below = facet.GetNormal() * (point - foot) < 0.0F;
+        }
+        return below ? -distance : distance;
+    }
+
+    // Only faces with facets not farther away than the nearest facet plus twice the deflection
+    // can contain the nearest point
+    float radius = distance + margin;
+    Base::BoundBox3f box(point.x - radius,
+                         point.y - radius,
+                         point.z - radius,
+                         point.x + radius,
+                         point.y + radius,
+                         point.z + radius);
+    std::vector<MeshCore::FacetIndex> candidates;
+    bvh->Inside(box, candidates);
+    std::vector<std::size_t> candidateFaces;
+    for (MeshCore::FacetIndex index : candidates) {
+        if (tessellation->GetFacet(index).DistanceToPoint(point) <= radius) {
+            candidateFaces.push_back(facetFace[index]);
+        }
+    }
+    std::sort(candidateFaces.begin(), candidateFaces.end());
+    candidateFaces.erase(std::unique(candidateFaces.begin(), candidateFaces.end()),
+                         candidateFaces.end());
+
+    BRepBuilderAPI_MakeVertex mkVert(pnt3d);
+    float fMinDist = FLT_MAX;
+    bool below = false;
+    for (std::size_t index : candidateFaces) {
+        BRepExtrema_DistShapeShape dist(faces[index], mkVert.Vertex());
+        if (dist.IsDone() && dist.NbSolution() > 0 && dist.Value() < fMinDist) {
+            fMinDist = (float)dist.Value();
+            below = !isSolid && fMinDist > 0 && isBelowFace(dist, pnt3d);
+        }
+    }
+
+    if (fMinDist < FLT_MAX) {
+        // the shape is a solid, check if the vertex is inside
+        if (isSolid) {
+            below = isInsideSolid(pnt3d);
+        }
+        if (below) {
+            fMinDist = -fMinDist;
+        }
+    }
+    return fMinDist;
+}
+
 bool InspectNominalShape::isInsideSolid(const gp_Pnt& pnt3d) const
 {
     const Standard_Real tol = 0.001;
@@ -528,15 +686,15 @@ bool InspectNominalShape::isInsideSolid(const gp_Pnt& pnt3d) const
     return (classifier.State() == TopAbs_IN);
 }
 
-bool InspectNominalShape::isBelowFace(const gp_Pnt& pnt3d) const
+bool InspectNominalShape::isBelowFace(const BRepExtrema_DistShapeShape& dist, const gp_Pnt& pnt3d)
 {
     // check if the distance was computed from a face
-    for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
-        if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
-            TopoDS_Shape face = distss->SupportOnShape1(index);
+    for (Standard_Integer index = 1; index <= dist.NbSolution(); index++) {
+        if (dist.SupportTypeShape1(index) == BRepExtrema_IsInFace) {
+            TopoDS_Shape face = dist.SupportOnShape1(index);
             Standard_Real u, v;
-            distss->ParOnFaceS1(index, u, v);
-            // gp_Pnt pnt = distss->PointOnShape1(index);
+            dist.ParOnFaceS1(index, u, v);
+            // gp_Pnt pnt = dist.PointOnShape1(index);
             BRepGProp_Face props(TopoDS::Face(face));
             gp_Vec normal;
             gp_Pnt center;
@@ -737,26 +895,45 @@ struct DistanceInspection
 };
 
 // Helper internal class for QtConcurrent map operation. Holds sums-of-squares and counts for RMS
-// calculation
+// calculation, the range and the histogram of the distances
 class DistanceInspectionRMS
 {
 public:
+    static const int numBins = 20;
+
     DistanceInspectionRMS() = default;
     DistanceInspectionRMS& operator+=(const DistanceInspectionRMS& rhs)
     {
         this->m_numv += rhs.m_numv;
         this->m_sumsq += rhs.m_sumsq;
+        this->m_min = std::min(this->m_min, rhs.m_min);
+        this->m_max = std::max(this->m_max, rhs.m_max);
+        for (int i = 0; i < numBins; i++) {
+            this->m_histogram[i] += rhs.m_histogram[i];
+        }
         return *this;
     }
-    double getRMS()
+    void add(float dist, float radius)
+    {
+        this->m_numv++;
+        this->m_sumsq += dist * dist;
+        this->m_min = std::min(this->m_min, dist);
+        this->m_max = std::max(this->m_max, dist);
+        int bin = radius > 0 ? int((dist + radius) / (2 * radius) * numBins) : 0;
+        this->m_histogram[std::clamp(bin, 0, numBins - 1)]++;
+    }
+    double getRMS() const
     {
         if (this->m_numv == 0) {
             return 0.0;
         }
         return sqrt(this->m_sumsq / (double)this->m_numv);
     }
-    int m_numv {0};
+    std::size_t m_numv {0};
     double m_sumsq {0.0};
+    float m_min {FLT_MAX};
+    float m_max {-FLT_MAX};
+    std::array<long, numBins> m_histogram {};
 };
 }  // namespace Inspection
 
@@ -769,6 +946,21 @@ Feature::Feature()
     ADD_PROPERTY(Actual, (nullptr));
     ADD_PROPERTY(Nominals, (nullptr));
     ADD_PROPERTY(Distances, (0.0));
+    ADD_PROPERTY_TYPE(DistanceFile,
+                      (""),
+                      0,
+                      App::Prop_None,
+                      "Write the distances as 32-bit floats to this file instead of keeping them");
+
+    auto outputType = App::PropertyType(App::Prop_Output | App::Prop_ReadOnly);
+    ADD_PROPERTY_TYPE(RMS, (0.0), "Statistics", outputType, "Root mean square of the distances");
+    ADD_PROPERTY_TYPE(MinDistance, (0.0), "Statistics", outputType, "Minimum distance");
+    ADD_PROPERTY_TYPE(MaxDistance, (0.0), "Statistics", outputType, "Maximum distance");
+    ADD_PROPERTY_TYPE(Histogram,
+                      (0),
+                      "Statistics",
+                      outputType,
+                      "Number of distances in equally sized bins of the search range");
 }
 
 Feature::~Feature() = default;
@@ -787,6 +979,9 @@ short Feature::mustExecute() const
     if (Nominals.isTouched()) {
         return 1;
     }
+    if (DistanceFile.isTouched()) {
+        return 1;
+    }
     return 0;
 }
 
@@ -832,9 +1027,12 @@ App::DocumentObjectExecReturn* Feature::execute()
             nominal = new InspectNominalPoints(pts->Points.getValue(), this->SearchRadius.getValue());
         }
         else if (it->isDerivedFrom<Part::Feature>()) {
-            useMultithreading = false;
             Part::Feature* part = static_cast<Part::Feature*>(it);
-            nominal = new InspectNominalShape(part->Shape.getValue(), this->SearchRadius.getValue());
+            auto shape = new InspectNominalShape(part->Shape.getValue(), this->SearchRadius.getValue());
+            if (!shape->isThreadSafe()) {
+                useMultithreading = false;
+            }
+            nominal = shape;
         }
 
         if (nominal) {
@@ -898,70 +1096,127 @@ App::DocumentObjectExecReturn* Feature::execute()
     Base::Console().Message("RMS value for '%s' with search radius [%.4f,%.4f] is: %.4f\n",
         this->Label.getValue(), -this->SearchRadius.getValue(), this->SearchRadius.getValue(), fRMS);
 #else
+    // The points are processed in blocks. Each block is split into ranges that are mapped in
+    // parallel and reduced to the statistics of the distances. If a distance file is set the
+    // distances of a block are appended to it, so that the memory doesn't grow with the number
+    // of points.
+    const unsigned long blockSize = 1 << 20;
+    const unsigned long rangeSize = 4096;
+    float radius = static_cast<float>(this->SearchRadius.getValue());
     unsigned long count = actual->countPoints();
-    std::vector<float> vals(count);
-    std::function<DistanceInspectionRMS(int)> fMap = [&](unsigned int index) {
-        DistanceInspectionRMS res;
-        Base::Vector3f pnt = actual->getPoint(index);
 
-        float fMinDist = FLT_MAX;
-        for (auto it : inspectNominal) {
-            float fDist = it->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist)) {
-                fMinDist = fDist;
+    std::string fileName = DistanceFile.getValue();
+    bool streaming = !fileName.empty();
+    Base::ofstream file;
+    if (streaming) {
+        file.open(Base::FileInfo(fileName), std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file) {
+            delete actual;
+            for (auto it : inspectNominal) {
+                delete it;
             }
+            return new App::DocumentObjectExecReturn("Cannot open the distance file");
         }
+    }
 
-        if (fMinDist > this->SearchRadius.getValue()) {
-            fMinDist = FLT_MAX;
-        }
-        else if (-fMinDist > this->SearchRadius.getValue()) {
-            fMinDist = -FLT_MAX;
-        }
-        else {
-            res.m_sumsq += fMinDist * fMinDist;
-            res.m_numv++;
-        }
+    std::vector<float> vals;
+    std::vector<float> block;
+    if (streaming) {
+        block.resize(std::min(blockSize, count));
+    }
+    else {
+        vals.resize(count);
+    }
 
-        vals[index] = fMinDist;
+    unsigned long blockStart = 0;
+    using Range = std::pair<unsigned long, unsigned long>;
+    std::function<DistanceInspectionRMS(const Range&)> fMap = [&](const Range& range) {
+        DistanceInspectionRMS res;
+        for (unsigned long index = range.first; index < range.second; index++) {
+            Base::Vector3f pnt = actual->getPoint(index);
+
+            float fMinDist = FLT_MAX;
+            for (auto it : inspectNominal) {
+                float fDist = it->getDistance(pnt);
+                if (fabs(fDist) < fabs(fMinDist)) {
+                    fMinDist = fDist;
+                }
+            }
+
+            if (fMinDist > radius) {
+                fMinDist = FLT_MAX;
+            }
+            else if (-fMinDist > radius) {
+                fMinDist = -FLT_MAX;
+            }
+            else {
+                res.add(fMinDist, radius);
+            }
+
+            if (streaming) {
+                block[index - blockStart] = fMinDist;
+            }
+            else {
+                vals[index] = fMinDist;
+            }
+        }
         return res;
     };
 
     DistanceInspectionRMS res;
+    unsigned long numRanges = (count + rangeSize - 1) / rangeSize;
+    unsigned long doneRanges = 0;
 
+    std::stringstream str;
+    str << "Inspecting " << this->Label.getValue() << "...";
+    std::unique_ptr<Base::FutureWatcherProgress> progress;
+    std::unique_ptr<Base::SequencerLauncher> seq;
     if (useMultithreading) {
-        // Build vector of increasing indices
-        std::vector<unsigned long> index(count);
-        std::iota(index.begin(), index.end(), 0);
-        // Perform map-reduce operation : compute distances and update sum of squares for RMS
-        // computation
-        QFuture<DistanceInspectionRMS> future =
-            QtConcurrent::mappedReduced(index, fMap, &DistanceInspectionRMS::operator+=);
-        // Setup progress bar
-        Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-        QFutureWatcher<DistanceInspectionRMS> watcher;
-        QObject::connect(&watcher,
-                         &QFutureWatcher<DistanceInspectionRMS>::progressValueChanged,
-                         &progress,
-                         &Base::FutureWatcherProgress::progressValueChanged);
-        // Keep UI responsive during computation
-        QEventLoop loop;
-        QObject::connect(&watcher,
-                         &QFutureWatcher<DistanceInspectionRMS>::finished,
-                         &loop,
-                         &QEventLoop::quit);
-        watcher.setFuture(future);
-        loop.exec();
-        res = future.result();
+        progress = std::make_unique<Base::FutureWatcherProgress>(str.str().c_str(), numRanges);
     }
     else {
-        // Single-threaded operation
-        std::stringstream str;
-        str << "Inspecting " << this->Label.getValue() << "...";
-        Base::SequencerLauncher seq(str.str().c_str(), count);
+        seq = std::make_unique<Base::SequencerLauncher>(str.str().c_str(), numRanges);
+    }
 
-        for (unsigned int i = 0; i < count; i++) {
-            res += fMap(i);
+    for (blockStart = 0; blockStart < count; blockStart += blockSize) {
+        unsigned long blockEnd = std::min(blockStart + blockSize, count);
+        std::vector<Range> ranges;
+        for (unsigned long first = blockStart; first < blockEnd; first += rangeSize) {
+            ranges.emplace_back(first, std::min(first + rangeSize, blockEnd));
+        }
+
+        if (useMultithreading) {
+            // Perform map-reduce operation : compute distances and update the statistics
+            QFuture<DistanceInspectionRMS> future =
+                QtConcurrent::mappedReduced(ranges, fMap, &DistanceInspectionRMS::operator+=);
+            QFutureWatcher<DistanceInspectionRMS> watcher;
+            QObject::connect(&watcher,
+                             &QFutureWatcher<DistanceInspectionRMS>::progressValueChanged,
+                             [&progress, doneRanges](int value) {
+                                 progress->progressValueChanged(int(doneRanges) + value);
+                             });
+            // Keep UI responsive during computation
+            QEventLoop loop;
+            QObject::connect(&watcher,
+                             &QFutureWatcher<DistanceInspectionRMS>::finished,
+                             &loop,
+                             &QEventLoop::quit);
+            watcher.setFuture(future);
+            loop.exec();
+            res += future.result();
+        }
+        else {
+            // Single-threaded operation
+            for (const auto& range : ranges) {
+                res += fMap(range);
+                seq->next();
+            }
+        }
+        doneRanges += ranges.size();
+
+        if (streaming) {
+            file.write(reinterpret_cast<const char*>(block.data()),
+                       std::streamsize((blockEnd - blockStart) * sizeof(float)));
         }
     }
 
@@ -971,6 +1226,17 @@ App::DocumentObjectExecReturn* Feature::execute()
                             this->SearchRadius.getValue(),
                             res.getRMS());
     Distances.setValues(vals);
+    if (streaming) {
+        file.close();
+        if (file.fail()) {
+            Base::Console().Error("Failed to write the distances to '%s'\n", fileName.c_str());
+        }
+    }
+
+    RMS.setValue(res.getRMS());
+    MinDistance.setValue(res.m_numv > 0 ? res.m_min : 0.0F);
+    MaxDistance.setValue(res.m_numv > 0 ? res.m_max : 0.0F);
+    Histogram.setValues(std::vector<long>(res.m_histogram.begin(), res.m_histogram.end()));
 #endif
 
     delete actual;
@@ -23,8 +23,11 @@
 #ifndef INSPECTION_FEATURE_H
 #define INSPECTION_FEATURE_H
 
+#include <TopoDS_Face.hxx>
+
 #include <App/DocumentObject.h>
 #include <App/DocumentObjectGroup.h>
+#include <App/PropertyFile.h>
 
 #include <Mod/Inspection/InspectionGlobal.h>
 #include <Mod/Points/App/Points.h>
@@ -38,6 +41,7 @@ namespace MeshCore
 {
 class MeshKernel;
 class MeshGrid;
+class MeshFacetBVH;
 }  // namespace MeshCore
 
 namespace Mesh
@@ -159,21 +163,42 @@ private:
     Points::PointsGrid* _pGrid;
 };
 
+/** Calculates the distance of a point to a shape.
+ * By default the faces near to a point are searched for with the help of a tessellation of the
+ * shape, and then only the distance to these faces is computed exactly. If the shape cannot be
+ * tessellated, has edges or vertices that don't belong to a face or the parameter
+ * ExactShapeDistance is set, the distance to the whole shape is computed.
+ */
 class InspectionExport InspectNominalShape: public InspectNominalGeometry
 {
 public:
     InspectNominalShape(const TopoDS_Shape&, float offset);
     ~InspectNominalShape() override;
     float getDistance(const Base::Vector3f&) const override;
+    /// Returns true if getDistance() can be called by several threads at the same time
+    bool isThreadSafe() const
+    {
+        return bvh != nullptr;
+    }
 
 private:
+    bool initTessellation();
+    float getShapeDistance(const Base::Vector3f&) const;
+    float getFaceDistance(const Base::Vector3f&) const;
     bool isInsideSolid(const gp_Pnt&) const;
-    bool isBelowFace(const gp_Pnt&) const;
+    static bool isBelowFace(const BRepExtrema_DistShapeShape&, const gp_Pnt&);
 
 private:
     BRepExtrema_DistShapeShape* distss;
     const TopoDS_Shape& _rShape;
     bool isSolid {false};
+    float searchRadius;
+    // the tessellation of all faces and the index of the face of each facet
+    std::vector<TopoDS_Face> faces;
+    std::vector<std::size_t> facetFace;
+    MeshCore::MeshKernel* tessellation {nullptr};
+    MeshCore::MeshFacetBVH* bvh {nullptr};
+    double deflection {0.0};
 };
 
 class InspectionExport PropertyDistanceList: public App::PropertyLists
@@ -255,6 +280,17 @@ public:
     App::PropertyLink Actual;
     App::PropertyLinkList Nominals;
     PropertyDistanceList Distances;
+    /// If set the distances are written to this file instead of Distances
+    App::PropertyFile DistanceFile;
+    //@}
+
+    /** @name Statistics of the distances within the search radius */
+    //@{
+    App::PropertyFloat RMS;
+    App::PropertyFloat MinDistance;
+    App::PropertyFloat MaxDistance;
+    /// Number of distances in equally sized bins from -SearchRadius to SearchRadius
+    App::PropertyIntegerList Histogram;
     //@}
 
     /** @name Actions */
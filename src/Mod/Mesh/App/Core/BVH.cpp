@@ -0,0 +1,548 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <numeric>
+#include <thread>
+#endif
+
+#include <Base/Sequencer.h>
+
+#include "BVH.h"
+#include "MeshKernel.h"
+
+
+using namespace MeshCore;
+
+namespace
+{
+// maximum number of facets of a leaf
+const std::size_t maxLeafSize = 4;
+// meshes with fewer facets are searched by the calling thread only
+const std::size_t minParallelSize = 10000;
+// nodes farther away than this multiple of their radius are approximated by their dipole
+const double farField = 2.0;
+
+// The solid angle of the triangle a, b, c seen from the origin
+double solidAngle(const Base::Vector3d& a, const Base::Vector3d& b, const Base::Vector3d& c)
+{
+    double la = a.Length();
+    double lb = b.Length();
+    double lc = c.Length();
+    double det = a * (b % c);
+    double div = la * lb * lc + (a * b) * lc + (b * c) * la + (c * a) * lb;
+    return 2.0 * std::atan2(det, div);
+}
+
+Base::Vector3d toVector3d(const Base::Vector3f& v)
+{
+    return Base::Vector3d(v.x, v.y, v.z);
+}
+}  // namespace
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& mesh)
+    : _rclMesh(mesh)
+{
+    std::size_t ctFacets = mesh.CountFacets();
+    std::vector<Base::Vector3f> centers(ctFacets);
+    _boxes.resize(ctFacets);
+    for (std::size_t index = 0; index < ctFacets; index++) {
+        MeshGeomFacet facet = mesh.GetFacet(index);
+        _boxes[index] = facet.GetBoundBox();
+        centers[index] = facet.GetGravityPoint();
+    }
+
+    _facets.resize(ctFacets);
+    std::iota(_facets.begin(), _facets.end(), 0);
+    if (ctFacets > 0) {
+        _nodes.reserve(2 * ctFacets / maxLeafSize + 1);
+        Build(0, ctFacets, centers);
+    }
+}
+
+std::size_t
+MeshFacetBVH::Build(std::size_t first, std::size_t last, std::vector<Base::Vector3f>& centers)
+{
+    std::size_t index = _nodes.size();
+    _nodes.emplace_back();
+
+    Base::BoundBox3f box;
+    Base::BoundBox3f centerBox;
+    for (std::size_t pos = first; pos < last; pos++) {
+        box.Add(_boxes[_facets[pos]]);
+        centerBox.Add(centers[_facets[pos]]);
+    }
+    _nodes[index].box = box;
+
+    if (last - first <= maxLeafSize) {
+        _nodes[index].first = first;
+        _nodes[index].count = last - first;
+        return index;
+    }
+
+    // split at the median of the facet centers along the longest axis
+    unsigned short axis = 0;
+    if (centerBox.LengthY() > centerBox.LengthX()) {
+        axis = 1;
+    }
+    if (centerBox.LengthZ() > std::max(centerBox.LengthX(), centerBox.LengthY())) {
+        axis = 2;
+    }
+    std::size_t mid = first + (last - first) / 2;
+    std::nth_element(_facets.begin() + std::ptrdiff_t(first),
+                     _facets.begin() + std::ptrdiff_t(mid),
+                     _facets.begin() + std::ptrdiff_t(last),
+                     [&centers, axis](FacetIndex f1, FacetIndex f2) {
+                         return centers[f1][axis] < centers[f2][axis];
+                     });
+
+    Build(first, mid, centers);
+    std::size_t right = Build(mid, last, centers);
+    _nodes[index].right = right;
+    return index;
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox() const
+{
+    if (_nodes.empty()) {
+        return Base::BoundBox3f();
+    }
+    return _nodes.front().box;
+}
+
+void MeshFacetBVH::Inside(const Base::BoundBox3f& box, std::vector<FacetIndex>& facets) const
+{
+    if (_nodes.empty()) {
+        return;
+    }
+
+    std::size_t ctFacets = facets.size();
+    std::vector<std::size_t> stack {0};
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        std::size_t index = stack.back();
+        stack.pop_back();
+        if (!(node.box && box)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            for (std::size_t pos = node.first; pos < node.first + node.count; pos++) {
+                if (_boxes[_facets[pos]] && box) {
+                    facets.push_back(_facets[pos]);
+                }
+            }
+        }
+        else {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+        }
+    }
+
+    std::sort(facets.begin() + std::ptrdiff_t(ctFacets), facets.end());
+}
+
+float MeshFacetBVH::Distance(const Base::BoundBox3f& box, const Base::Vector3f& point)
+{
+    float dx = std::max({box.MinX - point.x, 0.0F, point.x - box.MaxX});
+    float dy = std::max({box.MinY - point.y, 0.0F, point.y - box.MaxY});
+    float dz = std::max({box.MinZ - point.z, 0.0F, point.z - box.MaxZ});
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+FacetIndex
+MeshFacetBVH::NearestFacet(const Base::Vector3f& point, float maxDistance, float& distance) const
+{
+    FacetIndex nearest = FACET_INDEX_MAX;
+    distance = maxDistance;
+    if (_nodes.empty()) {
+        return nearest;
+    }
+
+    // depth-first search that visits the closer child first and skips nodes that are
+    // farther away than the nearest facet found so far
+    std::vector<std::pair<float, std::size_t>> stack {{Distance(_nodes[0].box, point), 0}};
+    while (!stack.empty()) {
+        auto [nodeDistance, index] = stack.back();
+        stack.pop_back();
+        if (nodeDistance > distance) {
+            continue;
+        }
+
+        const Node& node = _nodes[index];
+        if (node.IsLeaf()) {
+            for (std::size_t pos = node.first; pos < node.first + node.count; pos++) {
+                FacetIndex facet = _facets[pos];
+                if (Distance(_boxes[facet], point) > distance) {
+                    continue;
+                }
+                float facetDistance = _rclMesh.GetFacet(facet).DistanceToPoint(point);
+                if (facetDistance <= distance) {
+                    distance = facetDistance;
+                    nearest = facet;
+                }
+            }
+        }
+        else {
+            float leftDistance = Distance(_nodes[index + 1].box, point);
+            float rightDistance = Distance(_nodes[node.right].box, point);
+            if (leftDistance < rightDistance) {
+                stack.emplace_back(rightDistance, node.right);
+                stack.emplace_back(leftDistance, index + 1);
+            }
+            else {
+                stack.emplace_back(leftDistance, index + 1);
+                stack.emplace_back(rightDistance, node.right);
+            }
+        }
+    }
+
+    return nearest;
+}
+
+// ----------------------------------------------------------------------------
+
+/**
+ * The Traversal class searches for overlapping facets of two hierarchies. If both are the same
+ * hierarchy it searches for overlapping facets within the mesh.
+ * The top of the traversal is split into independent tasks that are processed by several threads.
+ */
+class MeshFacetBVH::Traversal
+{
+public:
+    Traversal(const MeshFacetBVH& bvh1,
+              const MeshFacetBVH& bvh2,
+              const PairFilter& filter,
+              bool stopAtFirst,
+              Base::SequencerLauncher* seq)
+        : bvh1(bvh1)
+        , bvh2(bvh2)
+        , filter(filter)
+        , seq(seq)
+        , stopAtFirst(stopAtFirst)
+        , self(&bvh1 == &bvh2)
+    {}
+
+    std::vector<FacetPair> Run()
+    {
+        std::vector<FacetPair> pairs;
+        if (bvh1._nodes.empty() || bvh2._nodes.empty()) {
+            return pairs;
+        }
+
+        std::size_t numThreads = 1;
+        int depth = 0;
+        if (std::max(bvh1._facets.size(), bvh2._facets.size()) > minParallelSize) {
+            numThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            // enough tasks to balance the load between the threads
+            depth = 4;
+            for (std::size_t num = numThreads; num > 1; num /= 2) {
+                depth++;
+            }
+        }
+
+        std::vector<Task> tasks;
+        Split(Task {0, 0}, depth, tasks);
+
+        std::atomic<std::size_t> next {0};
+        auto work = [this, &tasks, &next](Base::SequencerLauncher* progress) {
+            std::vector<FacetPair> found;
+            while (!stop) {
+                if (progress) {
+                    progress->next(true);  // allow to cancel
+                }
+                std::size_t index = next++;
+                if (index >= tasks.size()) {
+                    break;
+                }
+                Visit(tasks[index], found);
+            }
+            return found;
+        };
+
+        std::vector<std::future<std::vector<FacetPair>>> futures;
+        for (std::size_t thread = 1; thread < numThreads; thread++) {
+            futures.push_back(std::async(std::launch::async, work, nullptr));
+        }
+        try {
+            // only the calling thread may advance the sequencer
+            pairs = work(seq);
+        }
+        catch (...) {
+            stop = true;
+            for (auto& future : futures) {
+                future.wait();
+            }
+            throw;
+        }
+        for (auto& future : futures) {
+            std::vector<FacetPair> found = future.get();
+            pairs.insert(pairs.end(), found.begin(), found.end());
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+private:
+    struct Task
+    {
+        std::size_t node1;
+        std::size_t node2;
+    };
+
+    bool IsSelfTask(const Task& task) const
+    {
+        return self && task.node1 == task.node2;
+    }
+
+    // Appends the sub-tasks of a task, or pushes the task itself if the pair of nodes must be
+    // visited. Returns false if the nodes don't overlap.
+    template<typename Func>
+    bool Descend(const Task& task, Func&& func) const
+    {
+        const Node& node1 = bvh1._nodes[task.node1];
+        const Node& node2 = bvh2._nodes[task.node2];
+        if (IsSelfTask(task)) {
+            if (node1.IsLeaf()) {
+                return false;
+            }
+            std::size_t left = task.node1 + 1;
+            std::size_t right = node1.right;
+            func(Task {left, left});
+            func(Task {right, right});
+            func(Task {left, right});
+            return true;
+        }
+
+        if (node1.IsLeaf() && node2.IsLeaf()) {
+            return false;
+        }
+        // descend into the larger node
+        if (node2.IsLeaf()
+            || (!node1.IsLeaf()
+                && node1.box.CalcDiagonalLength() >= node2.box.CalcDiagonalLength())) {
+            func(Task {task.node1 + 1, task.node2});
+            func(Task {node1.right, task.node2});
+        }
+        else {
+            func(Task {task.node1, task.node2 + 1});
+            func(Task {task.node1, node2.right});
+        }
+        return true;
+    }
+
+    bool Overlap(const Task& task) const
+    {
+        return IsSelfTask(task) || (bvh1._nodes[task.node1].box && bvh2._nodes[task.node2].box);
+    }
+
+    void Split(const Task& task, int depth, std::vector<Task>& tasks) const
+    {
+        if (!Overlap(task)) {
+            return;
+        }
+        if (depth == 0 || !Descend(task, [&](const Task& sub) {
+                Split(sub, depth - 1, tasks);
+            })) {
+            tasks.push_back(task);
+        }
+    }
+
+    void Visit(const Task& task, std::vector<FacetPair>& pairs)
+    {
+        std::vector<Task> stack {task};
+        while (!stack.empty() && !stop) {
+            Task top = stack.back();
+            stack.pop_back();
+            if (!Overlap(top)) {
+                continue;
+            }
+            if (!Descend(top, [&stack](const Task& sub) {
+                    stack.push_back(sub);
+                })) {
+                TestLeaves(top, pairs);
+            }
+        }
+    }
+
+    void TestLeaves(const Task& task, std::vector<FacetPair>& pairs)
+    {
+        const Node& leaf1 = bvh1._nodes[task.node1];
+        const Node& leaf2 = bvh2._nodes[task.node2];
+        bool sameLeaf = IsSelfTask(task);
+        for (std::size_t pos1 = leaf1.first; pos1 < leaf1.first + leaf1.count; pos1++) {
+            FacetIndex facet1 = bvh1._facets[pos1];
+            const Base::BoundBox3f& box1 = bvh1._boxes[facet1];
+            std::size_t start = sameLeaf ? pos1 + 1 : leaf2.first;
+            for (std::size_t pos2 = start; pos2 < leaf2.first + leaf2.count; pos2++) {
+                FacetIndex facet2 = bvh2._facets[pos2];
+                if (!(box1 && bvh2._boxes[facet2])) {
+                    continue;
+                }
+
+                FacetPair pair(facet1, facet2);
+                if (self && facet2 < facet1) {
+                    std::swap(pair.first, pair.second);
+                }
+                if (filter(pair.first, pair.second)) {
+                    pairs.push_back(pair);
+                    if (stopAtFirst) {
+                        stop = true;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const MeshFacetBVH& bvh1;
+    const MeshFacetBVH& bvh2;
+    const PairFilter& filter;
+    Base::SequencerLauncher* seq;
+    bool stopAtFirst;
+    bool self;
+    std::atomic<bool> stop {false};
+};
+
+std::vector<MeshFacetBVH::FacetPair> MeshFacetBVH::FindPairs(const PairFilter& filter,
+                                                             bool stopAtFirst,
+                                                             Base::SequencerLauncher* seq) const
+{
+    Traversal traversal(*this, *this, filter, stopAtFirst, seq);
+    return traversal.Run();
+}
+
+std::vector<MeshFacetBVH::FacetPair> MeshFacetBVH::FindPairs(const MeshFacetBVH& other,
+                                                             const PairFilter& filter,
+                                                             bool stopAtFirst,
+                                                             Base::SequencerLauncher* seq) const
+{
+    Traversal traversal(*this, other, filter, stopAtFirst, seq);
+    return traversal.Run();
+}
+
+// ----------------------------------------------------------------------------
+
+MeshFacetBVH::WindingNumber::WindingNumber(const MeshFacetBVH& bvh)
+    : _bvh(bvh)
+    , _dipoles(bvh._nodes.size())
+{
+    const MeshPointArray& points = bvh._rclMesh.GetPoints();
+    const MeshFacetArray& facets = bvh._rclMesh.GetFacets();
+
+    // the children of a node follow the node, so they are done before it
+    for (std::size_t index = bvh._nodes.size(); index-- > 0;) {
+        const Node& node = bvh._nodes[index];
+        Dipole& dipole = _dipoles[index];
+        if (node.IsLeaf()) {
+            for (std::size_t pos = node.first; pos < node.first + node.count; pos++) {
+                const MeshFacet& facet = facets[bvh._facets[pos]];
+                Base::Vector3d p0 = toVector3d(points[facet._aulPoints[0]]);
+                Base::Vector3d p1 = toVector3d(points[facet._aulPoints[1]]);
+                Base::Vector3d p2 = toVector3d(points[facet._aulPoints[2]]);
+                Base::Vector3d normal = ((p1 - p0) % (p2 - p0)) * 0.5;
+                double area = normal.Length();
+                dipole.normal += normal;
+                dipole.center += (p0 + p1 + p2) * (area / 3.0);
+                dipole.area += area;
+            }
+        }
+        else {
+            for (std::size_t child : {index + 1, node.right}) {
+                const Dipole& part = _dipoles[child];
+                dipole.normal += part.normal;
+                dipole.center += part.center * part.area;
+                dipole.area += part.area;
+            }
+        }
+
+        if (dipole.area > 0.0) {
+            dipole.center /= dipole.area;
+        }
+        else {
+            dipole.center = toVector3d(node.box.GetCenter());
+        }
+
+        if (node.IsLeaf()) {
+            for (std::size_t pos = node.first; pos < node.first + node.count; pos++) {
+                for (PointIndex point : facets[bvh._facets[pos]]._aulPoints) {
+                    double distance = Base::Distance(toVector3d(points[point]), dipole.center);
+                    dipole.radius = std::max(dipole.radius, distance);
+                }
+            }
+        }
+        else {
+            for (std::size_t child : {index + 1, node.right}) {
+                const Dipole& part = _dipoles[child];
+                double distance = Base::Distance(part.center, dipole.center) + part.radius;
+                dipole.radius = std::max(dipole.radius, distance);
+            }
+        }
+    }
+}
+
+double MeshFacetBVH::WindingNumber::Evaluate(const Base::Vector3d& point) const
+{
+    if (_dipoles.empty()) {
+        return 0.0;
+    }
+
+    const MeshPointArray& points = _bvh._rclMesh.GetPoints();
+    const MeshFacetArray& facets = _bvh._rclMesh.GetFacets();
+
+    double sum = 0.0;
+    std::vector<std::size_t> stack {0};
+    while (!stack.empty()) {
+        std::size_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _bvh._nodes[index];
+        const Dipole& dipole = _dipoles[index];
+
+        Base::Vector3d dir = dipole.center - point;
+        double distance = dir.Length();
+        if (distance > farField * dipole.radius) {
+            sum += (dipole.normal * dir) / (distance * distance * distance);
+        }
+        else if (node.IsLeaf()) {
+            for (std::size_t pos = node.first; pos < node.first + node.count; pos++) {
+                const MeshFacet& facet = facets[_bvh._facets[pos]];
+                sum += solidAngle(toVector3d(points[facet._aulPoints[0]]) - point,
+                                  toVector3d(points[facet._aulPoints[1]]) - point,
+                                  toVector3d(points[facet._aulPoints[2]]) - point);
+            }
+        }
+        else {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+        }
+    }
+
+    return sum / (4.0 * Mathd::PI);
+}
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <Base/BoundBox.h>
+
+#include "Definitions.h"
+
+
+namespace Base
+{
+class SequencerLauncher;
+}
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy of the facets of a mesh.
+ * Unlike the uniform MeshFacetGrid it adapts to meshes with very different facet sizes.
+ * The search for facet pairs with overlapping bounding boxes is done by several threads.
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+    using FacetPair = std::pair<FacetIndex, FacetIndex>;
+    /** Decides whether a pair of facets with overlapping bounding boxes is kept.
+     * The filter is called concurrently and thus must not modify shared data.
+     */
+    using PairFilter = std::function<bool(FacetIndex, FacetIndex)>;
+
+    /// Builds the hierarchy of the facets of \a mesh
+    explicit MeshFacetBVH(const MeshKernel& mesh);
+
+    /// Returns the mesh the hierarchy is built of
+    const MeshKernel& GetMesh() const
+    {
+        return _rclMesh;
+    }
+    /// Returns the number of nodes
+    std::size_t CountNodes() const
+    {
+        return _nodes.size();
+    }
+    /// Returns the bounding box of all facets
+    Base::BoundBox3f GetBoundBox() const;
+    /// Collects the facets whose bounding boxes overlap with \a box
+    void Inside(const Base::BoundBox3f& box, std::vector<FacetIndex>& facets) const;
+    /** Returns the facet nearest to \a point if its distance is not greater than \a maxDistance,
+     * and FACET_INDEX_MAX otherwise. \a distance is set to the distance of the found facet.
+     */
+    FacetIndex
+    NearestFacet(const Base::Vector3f& point, float maxDistance, float& distance) const;
+    /** Returns all pairs of different facets of the mesh with overlapping bounding boxes that pass
+     * \a filter. The first index of a pair is always lower than the second index and the pairs are
+     * sorted. If \a stopAtFirst is true the search ends after the first found pair.
+     * If \a seq is given the calling thread advances it after each part of the search, so the
+     * user can cancel it. Then a Base::AbortException is thrown.
+     */
+    std::vector<FacetPair> FindPairs(const PairFilter& filter,
+                                     bool stopAtFirst = false,
+                                     Base::SequencerLauncher* seq = nullptr) const;
+    /** Returns all pairs of a facet of this mesh and a facet of the mesh of \a other with
+     * overlapping bounding boxes that pass \a filter. The pairs are sorted.
+     * If \a stopAtFirst is true the search ends after the first found pair.
+     * \a seq is advanced like in the method above.
+     */
+    std::vector<FacetPair> FindPairs(const MeshFacetBVH& other,
+                                     const PairFilter& filter,
+                                     bool stopAtFirst = false,
+                                     Base::SequencerLauncher* seq = nullptr) const;
+
+    /**
+     * The WindingNumber class computes the generalized winding number of the mesh of a
+     * hierarchy, which is about 1 inside and 0 outside of a closed mesh. A node that is far from
+     * the point is approximated by the dipole of its facets and only the facets near the point
+     * are summed up exactly, see Barill et al. "Fast winding numbers for soups and clouds".
+     * So a point costs about O(log n) instead of O(n).
+     */
+    class MeshExport WindingNumber
+    {
+    public:
+        /// Computes the dipoles of the nodes of \a bvh
+        explicit WindingNumber(const MeshFacetBVH& bvh);
+        /// Returns the winding number at \a point, it can be called concurrently
+        double Evaluate(const Base::Vector3d& point) const;
+
+    private:
+        struct Dipole
+        {
+            // sum of the area weighted normals
+            Base::Vector3d normal;
+            // area weighted center of the facets
+            Base::Vector3d center;
+            double area {0.0};
+            // the distance of the farthest vertex to the center
+            double radius {0.0};
+        };
+
+        const MeshFacetBVH& _bvh;
+        std::vector<Dipole> _dipoles;
+    };
+
+private:
+    struct Node
+    {
+        Base::BoundBox3f box;
+        // index into _facets of the first facet of a leaf
+        std::size_t first {0};
+        // number of facets of a leaf, 0 for an inner node
+        std::size_t count {0};
+        // the left child follows the node, this is the index of the right child
+        std::size_t right {0};
+
+        bool IsLeaf() const
+        {
+            return count > 0;
+        }
+    };
+
+    class Traversal;
+
+    std::size_t Build(std::size_t first, std::size_t last, std::vector<Base::Vector3f>& centers);
+    static float Distance(const Base::BoundBox3f& box, const Base::Vector3f& point);
+
+private:
+    const MeshKernel& _rclMesh;
+    std::vector<Node> _nodes;
+    std::vector<FacetIndex> _facets;
+    std::vector<Base::BoundBox3f> _boxes;
+};
+
+}  // namespace MeshCore
+
+#endif  // MESH_BVH_H
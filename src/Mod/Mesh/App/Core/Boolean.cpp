@@ -0,0 +1,914 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <numeric>
+#include <tuple>
+#endif
+
+#include "BVH.h"
+#include "Boolean.h"
+#include "Elements.h"
+#include "Functional.h"
+#include "MeshKernel.h"
+#include "Predicates.h"
+
+
+using namespace MeshCore;
+using Base::Vector3d;
+
+namespace
+{
+// loops over fewer elements are run by the calling thread only
+const std::size_t minParallelSize = 1000;
+
+using Triangle = std::array<PointIndex, 3>;
+using Edge = std::pair<PointIndex, PointIndex>;
+
+Edge makeEdge(PointIndex a, PointIndex b)
+{
+    return a < b ? Edge(a, b) : Edge(b, a);
+}
+
+// A point where an edge of one mesh crosses a facet of the other mesh. As the key only depends on
+// the edge and the facet every facet pair computes the same point for it.
+struct CrossingKey
+{
+    int side;
+    PointIndex p, q;
+    FacetIndex facet;
+
+    bool operator<(const CrossingKey& other) const
+    {
+        return std::tie(side, p, q, facet) < std::tie(other.side, other.p, other.q, other.facet);
+    }
+    bool operator==(const CrossingKey& other) const
+    {
+        return side == other.side && p == other.p && q == other.q && facet == other.facet;
+    }
+};
+
+struct Crossing
+{
+    CrossingKey key;
+    Vector3d point;
+};
+
+struct Segment
+{
+    FacetIndex facet[2];
+    Crossing ends[2];
+    PointIndex id[2];
+};
+
+// The predicates below decide as if the second mesh was translated by the infinitesimal vector
+// (e, e^2, e^3). This resolves all degenerate configurations of a facet of one mesh and a point
+// of the other one, e.g. touching or coplanar facets. Only for parallel edges a tie remains,
+// which is consistently counted as positive.
+double firstNonZero(double x, double y, double z)
+{
+    return x != 0.0 ? x : (y != 0.0 ? y : z);
+}
+
+// The sign of the normal of t in the direction of the translation
+double normalSign(const std::array<Vector3d, 3>& t)
+{
+    return firstNonZero(Predicates::orient2d(t[0], t[1], t[2], 0),
+                        Predicates::orient2d(t[0], t[1], t[2], 1),
+                        Predicates::orient2d(t[0], t[1], t[2], 2));
+}
+
+// orient3d(t0, t1, t2, p) where t belongs to the first mesh if pointShifted is true, otherwise p
+bool isBelow(const std::array<Vector3d, 3>& t, const Vector3d& p, bool pointShifted)
+{
+    double det = Predicates::orient3d(t[0], t[1], t[2], p);
+    if (det == 0.0) {
+        // orient3d(a, b, c, d) = (a - d) * ((b - a) x (c - a))
+        det = pointShifted ? -normalSign(t) : normalSign(t);
+    }
+    return det >= 0.0;
+}
+
+// orient3d(p, q, a, b) where the edge p, q belongs to the first mesh if edgeShifted is false
+bool isLeft(const Vector3d& p, const Vector3d& q, const Vector3d& a, const Vector3d& b, bool edgeShifted)
+{
+    double det = Predicates::orient3d(p, q, a, b);
+    if (det == 0.0) {
+        // translating a and b by v changes it by -v * ((q - p) x (a - b))
+        double sign = firstNonZero(Predicates::cross(p, q, b, a, 0),
+                                   Predicates::cross(p, q, b, a, 1),
+                                   Predicates::cross(p, q, b, a, 2));
+        det = edgeShifted ? sign : -sign;
+    }
+    return det >= 0.0;
+}
+
+// The axis along which the normal of a facet has its largest component
+int dominantAxis(const Vector3d& normal)
+{
+    int axis = 0;
+    if (std::fabs(normal.y) > std::fabs(normal[axis])) {
+        axis = 1;
+    }
+    if (std::fabs(normal.z) > std::fabs(normal[axis])) {
+        axis = 2;
+    }
+    return axis;
+}
+
+// Returns true if the points of s lie exactly in the plane of t
+bool coplanar(const std::array<Vector3d, 3>& t, const std::array<Vector3d, 3>& s)
+{
+    return Predicates::orient3d(t[0], t[1], t[2], s[0]) == 0.0
+        && Predicates::orient3d(t[0], t[1], t[2], s[1]) == 0.0
+        && Predicates::orient3d(t[0], t[1], t[2], s[2]) == 0.0;
+}
+
+// Returns true if p projected onto the plane of t lies inside t or on its boundary
+bool contains(const std::array<Vector3d, 3>& t, const Vector3d& p)
+{
+    int axis = dominantAxis((t[1] - t[0]) % (t[2] - t[0]));
+    double s0 = Predicates::orient2d(t[0], t[1], p, axis);
+    double s1 = Predicates::orient2d(t[1], t[2], p, axis);
+    double s2 = Predicates::orient2d(t[2], t[0], p, axis);
+    return (s0 >= 0.0 && s1 >= 0.0 && s2 >= 0.0) || (s0 <= 0.0 && s1 <= 0.0 && s2 <= 0.0);
+}
+
+// Returns true if the points of u are not all on the same side of the plane of t
+bool straddles(const std::array<Vector3d, 3>& t, const std::array<Vector3d, 3>& u, bool uShifted)
+{
+    bool s0 = isBelow(t, u[0], uShifted);
+    bool s1 = isBelow(t, u[1], uShifted);
+    bool s2 = isBelow(t, u[2], uShifted);
+    return s0 != s1 || s1 != s2;
+}
+
+// Checks whether the edge from p to q crosses the triangle t and computes the crossing point
+bool crosses(const Vector3d& p,
+             const Vector3d& q,
+             const std::array<Vector3d, 3>& t,
+             bool edgeShifted,
+             Vector3d& point)
+{
+    if (isBelow(t, p, edgeShifted) == isBelow(t, q, edgeShifted)) {
+        return false;
+    }
+    bool s0 = isLeft(p, q, t[0], t[1], edgeShifted);
+    bool s1 = isLeft(p, q, t[1], t[2], edgeShifted);
+    bool s2 = isLeft(p, q, t[2], t[0], edgeShifted);
+    if (s0 != s1 || s1 != s2) {
+        return false;
+    }
+    double dp = Predicates::orient3d(t[0], t[1], t[2], p);
+    double dq = Predicates::orient3d(t[0], t[1], t[2], q);
+    double param = dp == dq ? 0.0 : std::clamp(dp / (dp - dq), 0.0, 1.0);
+    point = p + (q - p) * param;
+    return true;
+}
+
+/**
+ * Triangulation of a facet cut by intersection segments. The points on the facet edges are
+ * inserted by splitting the boundary, the inner points are located with exact orientation tests
+ * and the segments are recovered by flipping the edges crossing them.
+ */
+class FacetTriangulation
+{
+public:
+    FacetTriangulation(const std::vector<Vector3d>& coords, const Triangle& corners, int axis)
+        : coords(coords)
+        , axis(axis)
+    {
+        sign = Predicates::orient2d(coords[corners[0]], coords[corners[1]], coords[corners[2]], axis)
+                > 0.0
+            ? 1.0
+            : -1.0;
+        for (PointIndex corner : corners) {
+            Add(corner);
+        }
+        AddTriangle(0, 1, 2);
+    }
+
+    /** Inserts points on the edge from corner \a side to the next corner, sorted from the start. */
+    void InsertOnEdge(int side, const std::vector<PointIndex>& ids)
+    {
+        int prev = side;
+        int end = (side + 1) % 3;
+        for (PointIndex id : ids) {
+            if (local.find(id) != local.end()) {
+                continue;
+            }
+            int vertex = Coincident(id);
+            if (vertex >= 0) {
+                local[id] = vertex;
+                continue;
+            }
+            int point = Add(id);
+            SplitEdge(prev, end, point);
+            prev = point;
+        }
+    }
+
+    /** Inserts a point inside the facet. */
+    void Insert(PointIndex id)
+    {
+        if (local.find(id) != local.end()) {
+            return;
+        }
+        int vertex = Coincident(id);
+        if (vertex >= 0) {
+            local[id] = vertex;
+            return;
+        }
+
+        int point = Add(id);
+        int best = -1;
+        int bestSide = -1;
+        double bestValue = -HUGE_VAL;
+        for (int tri = 0; tri < int(triangles.size()); tri++) {
+            if (!alive[tri]) {
+                continue;
+            }
+            const auto& t = triangles[tri];
+            if (Orient(t[0], t[1], t[2]) == 0.0) {
+                continue;
+            }
+            std::array<double, 3> value {Orient(t[1], t[2], point),
+                                         Orient(t[2], t[0], point),
+                                         Orient(t[0], t[1], point)};
+            int negative = -1;
+            int zero = -1;
+            double minimum = HUGE_VAL;
+            for (int i = 0; i < 3; i++) {
+                if (value[i] < minimum) {
+                    minimum = value[i];
+                    negative = i;
+                }
+                if (value[i] == 0.0) {
+                    zero = i;
+                }
+            }
+            if (minimum > 0.0) {
+                SplitTriangle(tri, point);
+                return;
+            }
+            if (minimum == 0.0) {
+                // A point on the boundary of the facet lies inside for the perturbed meshes, keep
+                // the boundary edge to avoid a T-junction with the neighbour facet
+                int u = t[(zero + 1) % 3];
+                int v = t[(zero + 2) % 3];
+                if (edges.find({v, u}) == edges.end()) {
+                    SplitTriangle(tri, point);
+                }
+                else {
+                    SplitEdge(u, v, point);
+                }
+                return;
+            }
+            if (minimum > bestValue) {
+                bestValue = minimum;
+                best = tri;
+                bestSide = negative;
+            }
+        }
+
+        // The rounded point lies slightly outside of the facet, add it to the nearest edge
+        if (best >= 0) {
+            const auto& t = triangles[best];
+            SplitEdge(t[(bestSide + 1) % 3], t[(bestSide + 2) % 3], point);
+        }
+    }
+
+    /** Makes the segment between the two points an edge of the triangulation. */
+    void Recover(PointIndex id1, PointIndex id2, std::vector<Edge>& constraints)
+    {
+        auto it1 = local.find(id1);
+        auto it2 = local.find(id2);
+        if (it1 == local.end() || it2 == local.end()) {
+            return;
+        }
+
+        std::vector<std::pair<int, int>> stack {{it1->second, it2->second}};
+        while (!stack.empty()) {
+            auto [a, b] = stack.back();
+            stack.pop_back();
+            if (a == b) {
+                continue;
+            }
+
+            int between = Between(a, b);
+            if (between >= 0) {
+                stack.emplace_back(a, between);
+                stack.emplace_back(between, b);
+                continue;
+            }
+
+            if (!HasEdge(a, b)) {
+                FlipCrossingEdges(a, b);
+            }
+            if (HasEdge(a, b)) {
+                constraints.push_back(makeEdge(vertices[a], vertices[b]));
+            }
+        }
+    }
+
+    /** Appends the triangles with the orientation of the facet. */
+    void GetTriangles(std::vector<Triangle>& result) const
+    {
+        for (std::size_t tri = 0; tri < triangles.size(); tri++) {
+            if (alive[tri]) {
+                const auto& t = triangles[tri];
+                result.push_back({vertices[t[0]], vertices[t[1]], vertices[t[2]]});
+            }
+        }
+    }
+
+private:
+    double Orient(int a, int b, int c) const
+    {
+        return sign
+            * Predicates::orient2d(coords[vertices[a]], coords[vertices[b]], coords[vertices[c]], axis);
+    }
+
+    int Add(PointIndex id)
+    {
+        int index = int(vertices.size());
+        vertices.push_back(id);
+        local[id] = index;
+        return index;
+    }
+
+    int Coincident(PointIndex id) const
+    {
+        for (std::size_t index = 0; index < vertices.size(); index++) {
+            if (coords[vertices[index]] == coords[id]) {
+                return int(index);
+            }
+        }
+        return -1;
+    }
+
+    // Returns a vertex lying on the open segment from a to b
+    int Between(int a, int b) const
+    {
+        const Vector3d& pa = coords[vertices[a]];
+        Vector3d dir = coords[vertices[b]] - pa;
+        double length = dir.Sqr();
+        for (int v = 0; v < int(vertices.size()); v++) {
+            if (v == a || v == b || Orient(a, b, v) != 0.0) {
+                continue;
+            }
+            double param = (coords[vertices[v]] - pa) * dir;
+            if (param > 0.0 && param < length) {
+                return v;
+            }
+        }
+        return -1;
+    }
+
+    bool HasEdge(int a, int b) const
+    {
+        return edges.find({a, b}) != edges.end() || edges.find({b, a}) != edges.end();
+    }
+
+    bool ProperlyCrosses(int a, int b, int c, int d) const
+    {
+        return Orient(a, b, c) * Orient(a, b, d) < 0.0 && Orient(c, d, a) * Orient(c, d, b) < 0.0;
+    }
+
+    int Third(int tri, int a, int b) const
+    {
+        for (int v : triangles[tri]) {
+            if (v != a && v != b) {
+                return v;
+            }
+        }
+        return -1;
+    }
+
+    void AddTriangle(int a, int b, int c)
+    {
+        int tri = int(triangles.size());
+        triangles.push_back({a, b, c});
+        alive.push_back(1);
+        edges[{a, b}] = tri;
+        edges[{b, c}] = tri;
+        edges[{c, a}] = tri;
+    }
+
+    void RemoveTriangle(int tri)
+    {
+        const auto& t = triangles[tri];
+        edges.erase({t[0], t[1]});
+        edges.erase({t[1], t[2]});
+        edges.erase({t[2], t[0]});
+        alive[tri] = 0;
+    }
+
+    void SplitTriangle(int tri, int point)
+    {
+        auto t = triangles[tri];
+        RemoveTriangle(tri);
+        AddTriangle(t[0], t[1], point);
+        AddTriangle(t[1], t[2], point);
+        AddTriangle(t[2], t[0], point);
+    }
+
+    // Splits the triangles on both sides of the edge from a to b
+    void SplitEdge(int a, int b, int point)
+    {
+        for (auto [u, v] : {std::make_pair(a, b), std::make_pair(b, a)}) {
+            auto it = edges.find({u, v});
+            if (it == edges.end()) {
+                continue;
+            }
+            int tri = it->second;
+            int c = Third(tri, u, v);
+            RemoveTriangle(tri);
+            AddTriangle(u, point, c);
+            AddTriangle(point, v, c);
+        }
+    }
+
+    void FlipCrossingEdges(int a, int b)
+    {
+        std::deque<std::pair<int, int>> crossing;
+        for (const auto& it : edges) {
+            auto [u, v] = it.first;
+            if (u < v && edges.find({v, u}) != edges.end() && u != a && u != b && v != a
+                && v != b && ProperlyCrosses(a, b, u, v)) {
+                crossing.emplace_back(u, v);
+            }
+        }
+
+        // the quadrilateral of an edge may be concave for a while, give up in degenerate cases
+        std::size_t maxSteps = 100 + 10 * crossing.size() * crossing.size();
+        for (std::size_t step = 0; step < maxSteps && !crossing.empty(); step++) {
+            auto [u, v] = crossing.front();
+            crossing.pop_front();
+            auto it1 = edges.find({u, v});
+            auto it2 = edges.find({v, u});
+            if (it1 == edges.end() || it2 == edges.end()) {
+                continue;
+            }
+            int tri1 = it1->second;
+            int tri2 = it2->second;
+            int c = Third(tri1, u, v);
+            int d = Third(tri2, v, u);
+            if (!ProperlyCrosses(c, d, u, v)) {
+                crossing.emplace_back(u, v);
+                continue;
+            }
+
+            RemoveTriangle(tri1);
+            RemoveTriangle(tri2);
+            AddTriangle(c, u, d);
+            AddTriangle(d, v, c);
+            if (c != a && c != b && d != a && d != b && ProperlyCrosses(a, b, c, d)) {
+                crossing.emplace_back(std::min(c, d), std::max(c, d));
+            }
+        }
+    }
+
+private:
+    const std::vector<Vector3d>& coords;
+    int axis;
+    double sign {1.0};
+    std::vector<PointIndex> vertices;
+    std::map<PointIndex, int> local;
+    std::vector<std::array<int, 3>> triangles;
+    std::vector<char> alive;
+    std::map<std::pair<int, int>, int> edges;
+};
+
+struct UnionFind
+{
+    explicit UnionFind(std::size_t size)
+        : parent(size)
+    {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    std::size_t Find(std::size_t index)
+    {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    }
+
+    void Unite(std::size_t a, std::size_t b)
+    {
+        a = Find(a);
+        b = Find(b);
+        if (a != b) {
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    std::vector<std::size_t> parent;
+};
+
+}  // namespace
+
+MeshBoolean::MeshBoolean(const MeshKernel& mesh1,
+                         const MeshKernel& mesh2,
+                         MeshKernel& result,
+                         Operation op)
+    : mesh1(mesh1)
+    , mesh2(mesh2)
+    , result(result)
+    , operation(op)
+{}
+
+void MeshBoolean::Do()
+{
+    const MeshKernel* meshes[2] = {&mesh1, &mesh2};
+    PointIndex offset[2] = {0, mesh1.CountPoints()};
+
+    // All points in double precision, the points of the second mesh follow the first ones and
+    // the crossing points follow later
+    std::vector<Vector3d> coords;
+    coords.reserve(mesh1.CountPoints() + mesh2.CountPoints());
+    std::vector<Triangle> original[2];
+    for (int side = 0; side < 2; side++) {
+        for (const auto& point : meshes[side]->GetPoints()) {
+            coords.emplace_back(point.x, point.y, point.z);
+        }
+        for (const auto& facet : meshes[side]->GetFacets()) {
+            original[side].push_back({facet._aulPoints[0] + offset[side],
+                                      facet._aulPoints[1] + offset[side],
+                                      facet._aulPoints[2] + offset[side]});
+        }
+    }
+    auto triangle = [&](int side, FacetIndex facet) {
+        const Triangle& t = original[side][facet];
+        return std::array<Vector3d, 3> {coords[t[0]], coords[t[1]], coords[t[2]]};
+    };
+
+    // Find the facet pairs whose planes are crossed by the other facet
+    MeshFacetBVH bvh1(mesh1);
+    MeshFacetBVH bvh2(mesh2);
+    auto pairs = bvh1.FindPairs(bvh2, [&triangle](FacetIndex f1, FacetIndex f2) {
+        auto t1 = triangle(0, f1);
+        auto t2 = triangle(1, f2);
+        return straddles(t1, t2, true) && straddles(t2, t1, false);
+    });
+
+    // Compute the intersection segment of each pair
+    std::vector<Segment> segments(pairs.size());
+    std::vector<char> valid(pairs.size(), 0);
+    parallel_for(pairs.size(), minParallelSize, [&](std::size_t begin, std::size_t end) {
+        std::vector<Crossing> found;
+        for (std::size_t index = begin; index < end; index++) {
+            FacetIndex facet[2] = {pairs[index].first, pairs[index].second};
+            found.clear();
+            for (int side = 0; side < 2; side++) {
+                const Triangle& t = original[side][facet[side]];
+                auto other = triangle(1 - side, facet[1 - side]);
+                for (int i = 0; i < 3; i++) {
+                    Edge edge = makeEdge(t[i], t[(i + 1) % 3]);
+                    Vector3d point;
+                    if (crosses(coords[edge.first], coords[edge.second], other, side == 1, point)) {
+                        found.push_back({{side, edge.first, edge.second, facet[1 - side]}, point});
+                    }
+                }
+            }
+            if (found.size() < 2) {
+                continue;
+            }
+
+            // In degenerate cases more than two crossings may be found, use the outermost
+            std::size_t first = 0, second = 1;
+            double distance = -1.0;
+            for (std::size_t i = 0; i < found.size(); i++) {
+                for (std::size_t j = i + 1; j < found.size(); j++) {
+                    double dist = Base::DistanceP2(found[i].point, found[j].point);
+                    if (dist > distance) {
+                        distance = dist;
+                        first = i;
+                        second = j;
+                    }
+                }
+            }
+            Segment& segment = segments[index];
+            segment.facet[0] = facet[0];
+            segment.facet[1] = facet[1];
+            segment.ends[0] = found[first];
+            segment.ends[1] = found[second];
+            valid[index] = 1;
+        }
+    });
+
+    // Number the crossing points
+    std::vector<Crossing> crossings;
+    for (std::size_t index = 0; index < segments.size(); index++) {
+        if (valid[index]) {
+            crossings.push_back(segments[index].ends[0]);
+            crossings.push_back(segments[index].ends[1]);
+        }
+    }
+    auto lessKey = [](const Crossing& c1, const Crossing& c2) {
+        return c1.key < c2.key;
+    };
+    std::sort(crossings.begin(), crossings.end(), lessKey);
+    crossings.erase(std::unique(crossings.begin(),
+                                crossings.end(),
+                                [](const Crossing& c1, const Crossing& c2) {
+                                    return c1.key == c2.key;
+                                }),
+                    crossings.end());
+    PointIndex firstCrossing = coords.size();
+    for (const auto& crossing : crossings) {
+        coords.push_back(crossing.point);
+    }
+
+    // Assign the segments to the facets of both meshes
+    std::vector<std::pair<FacetIndex, std::size_t>> cutFacets[2];
+    numSegments = 0;
+    for (std::size_t index = 0; index < segments.size(); index++) {
+        if (!valid[index]) {
+            continue;
+        }
+        Segment& segment = segments[index];
+        for (int end = 0; end < 2; end++) {
+            auto it =
+                std::lower_bound(crossings.begin(), crossings.end(), segment.ends[end], lessKey);
+            segment.id[end] = firstCrossing + PointIndex(it - crossings.begin());
+        }
+        cutFacets[0].emplace_back(segment.facet[0], index);
+        cutFacets[1].emplace_back(segment.facet[1], index);
+        numSegments++;
+    }
+
+    // Triangulate the cut facets, for each triangle keep the facet it lies in
+    std::vector<Triangle> triangles[2];
+    std::vector<FacetIndex> sources[2];
+    std::vector<Edge> constraints;
+    for (int side = 0; side < 2; side++) {
+        auto& cut = cutFacets[side];
+        std::sort(cut.begin(), cut.end());
+        std::vector<std::size_t> groups;
+        for (std::size_t index = 0; index < cut.size(); index++) {
+            if (index == 0 || cut[index].first != cut[index - 1].first) {
+                groups.push_back(index);
+            }
+        }
+        groups.push_back(cut.size());
+
+        std::vector<char> isCut(original[side].size(), 0);
+        for (const auto& it : cut) {
+            isCut[it.first] = 1;
+        }
+        for (std::size_t facet = 0; facet < original[side].size(); facet++) {
+            if (!isCut[facet]) {
+                triangles[side].push_back(original[side][facet]);
+                sources[side].push_back(facet);
+            }
+        }
+
+        std::size_t numGroups = groups.size() - 1;
+        std::vector<std::vector<Triangle>> split(numGroups);
+        std::vector<std::vector<Edge>> recovered(numGroups);
+        parallel_for(numGroups, minParallelSize, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t group = begin; group < end; group++) {
+                FacetIndex facet = cut[groups[group]].first;
+                const Triangle& corners = original[side][facet];
+                int axis = dominantAxis((coords[corners[1]] - coords[corners[0]])
+                                        % (coords[corners[2]] - coords[corners[0]]));
+                if (Predicates::orient2d(coords[corners[0]],
+                                         coords[corners[1]],
+                                         coords[corners[2]],
+                                         axis)
+                    == 0.0) {
+                    // degenerated facet
+                    split[group].push_back(corners);
+                    continue;
+                }
+
+                // Sort the crossings on the facet edges and the inner ones
+                std::vector<std::pair<double, PointIndex>> onEdge[3];
+                std::vector<PointIndex> inner;
+                for (std::size_t pos = groups[group]; pos < groups[group + 1]; pos++) {
+                    const Segment& segment = segments[cut[pos].second];
+                    for (int end = 0; end < 2; end++) {
+                        const CrossingKey& key = segment.ends[end].key;
+                        PointIndex id = segment.id[end];
+                        int edge = -1;
+                        for (int i = 0; i < 3 && key.side == side; i++) {
+                            if (makeEdge(corners[i], corners[(i + 1) % 3]) == Edge(key.p, key.q)) {
+                                edge = i;
+                            }
+                        }
+                        if (edge < 0) {
+                            inner.push_back(id);
+                            continue;
+                        }
+                        const Vector3d& start = coords[corners[edge]];
+                        Vector3d dir = coords[corners[(edge + 1) % 3]] - start;
+                        onEdge[edge].emplace_back((coords[id] - start) * dir, id);
+                    }
+                }
+
+                FacetTriangulation triangulation(coords, corners, axis);
+                for (int edge = 0; edge < 3; edge++) {
+                    std::sort(onEdge[edge].begin(), onEdge[edge].end());
+                    std::vector<PointIndex> ids;
+                    for (const auto& it : onEdge[edge]) {
+                        ids.push_back(it.second);
+                    }
+                    triangulation.InsertOnEdge(edge, ids);
+                }
+                for (PointIndex id : inner) {
+                    triangulation.Insert(id);
+                }
+                for (std::size_t pos = groups[group]; pos < groups[group + 1]; pos++) {
+                    const Segment& segment = segments[cut[pos].second];
+                    triangulation.Recover(segment.id[0], segment.id[1], recovered[group]);
+                }
+                triangulation.GetTriangles(split[group]);
+            }
+        });
+
+        for (std::size_t group = 0; group < numGroups; group++) {
+            triangles[side].insert(triangles[side].end(), split[group].begin(), split[group].end());
+            sources[side].insert(sources[side].end(), split[group].size(), cut[groups[group]].first);
+            constraints.insert(constraints.end(), recovered[group].begin(), recovered[group].end());
+        }
+    }
+    std::sort(constraints.begin(), constraints.end());
+    constraints.erase(std::unique(constraints.begin(), constraints.end()), constraints.end());
+
+    // Classify the patches between the intersection curves, for a patch on the surface of the
+    // other mesh the orientation of the surfaces decides. A patch is on the surface if the facet
+    // it lies in is exactly coplanar with a facet of the other mesh that covers it.
+    const MeshFacetBVH* bvh[2] = {&bvh1, &bvh2};
+    Base::BoundBox3f box = mesh1.GetBoundBox();
+    box.Add(mesh2.GetBoundBox());
+    float tolerance = box.CalcDiagonalLength() * 1.0e-6F;
+
+    std::vector<Triangle> selected;
+    for (int side = 0; side < 2; side++) {
+        const auto& tris = triangles[side];
+        std::vector<std::pair<Edge, std::size_t>> edgeList;
+        edgeList.reserve(3 * tris.size());
+        for (std::size_t tri = 0; tri < tris.size(); tri++) {
+            for (int i = 0; i < 3; i++) {
+                edgeList.emplace_back(makeEdge(tris[tri][i], tris[tri][(i + 1) % 3]), tri);
+            }
+        }
+        std::sort(edgeList.begin(), edgeList.end());
+        UnionFind patches(tris.size());
+        for (std::size_t index = 1; index < edgeList.size(); index++) {
+            const Edge& edge = edgeList[index].first;
+            if (edge == edgeList[index - 1].first
+                && !std::binary_search(constraints.begin(), constraints.end(), edge)) {
+                patches.Unite(edgeList[index - 1].second, edgeList[index].second);
+            }
+        }
+
+        // The largest triangle represents its patch
+        std::map<std::size_t, std::pair<double, std::size_t>> representative;
+        for (std::size_t tri = 0; tri < tris.size(); tri++) {
+            const auto& t = tris[tri];
+            double area = ((coords[t[1]] - coords[t[0]]) % (coords[t[2]] - coords[t[0]])).Sqr();
+            auto& rep = representative[patches.Find(tri)];
+            if (area > rep.first || rep.first == 0.0) {
+                rep = {area, tri};
+            }
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>> reps;
+        for (const auto& it : representative) {
+            reps.emplace_back(it.first, it.second.second);
+        }
+        std::vector<char> keep(reps.size(), 0);
+        int other = 1 - side;
+        MeshFacetBVH::WindingNumber winding(*bvh[other]);
+        parallel_for(reps.size(), minParallelSize, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                const auto& t = tris[reps[index].second];
+                Vector3d center = (coords[t[0]] + coords[t[1]] + coords[t[2]]) / 3.0;
+                auto source = triangle(side, sources[side][reps[index].second]);
+
+                // the tolerance only limits the candidates, the decision is exact
+                Base::BoundBox3f around(float(center.x) - tolerance,
+                                        float(center.y) - tolerance,
+                                        float(center.z) - tolerance,
+                                        float(center.x) + tolerance,
+                                        float(center.y) + tolerance,
+                                        float(center.z) + tolerance);
+                std::vector<FacetIndex> candidates;
+                bvh[other]->Inside(around, candidates);
+                FacetIndex nearest = FACET_INDEX_MAX;
+                for (FacetIndex facet : candidates) {
+                    auto u = triangle(other, facet);
+                    if (coplanar(u, source) && contains(u, center)) {
+                        nearest = facet;
+                        break;
+                    }
+                }
+                bool onSurface = nearest != FACET_INDEX_MAX;
+
+                bool inside {};
+                if (onSurface) {
+                    // Relative to the other mesh the patch is translated by -v on the first mesh
+                    // and by v on the second one
+                    double sign = normalSign(triangle(other, nearest));
+                    inside = side == 0 ? sign > 0.0 : sign < 0.0;
+                }
+                else {
+                    inside = winding.Evaluate(center) > 0.5;
+                }
+
+                bool result {};
+                if (side == 0) {
+                    result = operation == Intersection ? inside : !inside;
+                }
+                else {
+                    result = operation == Union ? !inside : inside;
+                }
+                keep[index] = result ? 1 : 0;
+            }
+        });
+
+        std::map<std::size_t, bool> keepPatch;
+        for (std::size_t index = 0; index < reps.size(); index++) {
+            keepPatch[reps[index].first] = keep[index] != 0;
+        }
+        bool flip = side == 1 && operation == Difference;
+        for (std::size_t tri = 0; tri < tris.size(); tri++) {
+            if (keepPatch[patches.Find(tri)]) {
+                Triangle t = tris[tri];
+                if (flip) {
+                    std::swap(t[0], t[1]);
+                }
+                selected.push_back(t);
+            }
+        }
+    }
+
+    // Build the result, points rounded to the same position are merged
+    std::vector<PointIndex> used;
+    for (const auto& t : selected) {
+        used.insert(used.end(), t.begin(), t.end());
+    }
+    auto lessPoint = [&coords](PointIndex a, PointIndex b) {
+        Base::Vector3f pa(float(coords[a].x), float(coords[a].y), float(coords[a].z));
+        Base::Vector3f pb(float(coords[b].x), float(coords[b].y), float(coords[b].z));
+        return std::tie(pa.x, pa.y, pa.z) < std::tie(pb.x, pb.y, pb.z);
+    };
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+    std::sort(used.begin(), used.end(), lessPoint);
+
+    MeshPointArray points;
+    std::map<PointIndex, PointIndex> index;
+    for (std::size_t pos = 0; pos < used.size(); pos++) {
+        if (pos == 0 || lessPoint(used[pos - 1], used[pos])) {
+            const Vector3d& p = coords[used[pos]];
+            points.push_back(MeshPoint(Base::Vector3f(float(p.x), float(p.y), float(p.z))));
+        }
+        index[used[pos]] = points.size() - 1;
+    }
+
+    MeshFacetArray facets;
+    facets.reserve(selected.size());
+    for (const auto& t : selected) {
+        PointIndex p0 = index[t[0]];
+        PointIndex p1 = index[t[1]];
+        PointIndex p2 = index[t[2]];
+        if (p0 != p1 && p1 != p2 && p2 != p0) {
+            facets.push_back(MeshFacet(p0, p1, p2));
+        }
+    }
+
+    result.Adopt(points, facets, true);
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef MESH_BOOLEAN_H
+#define MESH_BOOLEAN_H
+
+#include "Definitions.h"
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshBoolean class computes the union, intersection or difference of two closed and
+ * consistently oriented meshes.
+ *
+ * Unlike SetOperations the decisions are made with exact predicates: the facets intersecting each
+ * other are found with a MeshFacetBVH, cut along the intersection segments in parallel and the
+ * connected patches between the intersection curves are classified as inside or outside with the
+ * generalized winding number of the other mesh. Coplanar facets are not cut against each other, a
+ * patch lying on the surface of the other mesh is kept or removed depending on the orientation of
+ * the two surfaces.
+ */
+class MeshExport MeshBoolean
+{
+public:
+    enum Operation
+    {
+        Union,
+        Intersection,
+        Difference
+    };
+
+    MeshBoolean(const MeshKernel& mesh1, const MeshKernel& mesh2, MeshKernel& result, Operation op);
+
+    /** Computes the result mesh. */
+    void Do();
+    /** Returns the number of intersection segments found by the last call of Do(). */
+    std::size_t CountSegments() const
+    {
+        return numSegments;
+    }
+
+private:
+    const MeshKernel& mesh1;
+    const MeshKernel& mesh2;
+    MeshKernel& result;
+    Operation operation;
+    std::size_t numSegments {0};
+};
+
+}  // namespace MeshCore
+
+#endif  // MESH_BOOLEAN_H
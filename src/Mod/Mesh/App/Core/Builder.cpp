@@ -24,6 +24,8 @@
 
 #ifndef _PreComp_
 #include <algorithm>
+#include <thread>
+#include <vector>
 #endif
 
 #include <Base/Exception.h>
@@ -32,7 +34,6 @@
 #include "Builder.h"
 #include "Functional.h"
 #include "MeshKernel.h"
-#include <QVector>
 
 
 using namespace MeshCore;
@@ -301,6 +302,8 @@ struct MeshFastBuilder::Private
         {
             return x != rhs.x || y != rhs.y || z != rhs.z;
         }
+        // Equal points are ordered by their index so that the merged point
+        // is the same whatever order the facets have been added in
         bool operator<(const Vertex& rhs) const
         {
             if (x != rhs.x) {
@@ -313,13 +316,13 @@ struct MeshFastBuilder::Private
                 return z < rhs.z;
             }
             else {
-                return false;
+                return i < rhs.i;
             }
         }
     };
 
-    // Hint: Using a QVector instead of std::vector is a bit faster
-    QVector<Vertex> verts;
+    // A QVector cannot hold more than 2 GB
+    std::vector<Vertex> verts;
 };
 
 MeshFastBuilder::MeshFastBuilder(MeshKernel& rclM)
@@ -344,6 +347,7 @@ void MeshFastBuilder::AddFacet(const Base::Vector3f* facetPoints)
         v.x = facetPoints[i].x;
         v.y = facetPoints[i].y;
         v.z = facetPoints[i].z;
+        v.i = p->verts.size();
         p->verts.push_back(v);
     }
 }
@@ -355,49 +359,63 @@ void MeshFastBuilder::AddFacet(const MeshGeomFacet& facetPoints)
         v.x = pnt.x;
         v.y = pnt.y;
         v.z = pnt.z;
+        v.i = p->verts.size();
         p->verts.push_back(v);
     }
 }
 
+void MeshFastBuilder::Resize(size_type ctFacets)
+{
+    p->verts.resize(ctFacets * 3);
+}
+
+void MeshFastBuilder::SetFacet(size_type index, const Base::Vector3f* facetPoints)
+{
+    Private::Vertex* v = &p->verts[3 * index];
+    for (int i = 0; i < 3; i++, v++) {
+        v->x = facetPoints[i].x;
+        v->y = facetPoints[i].y;
+        v->z = facetPoints[i].z;
+        v->i = 3 * index + i;
+    }
+}
+
 void MeshFastBuilder::Finish()
 {
-    using size_type = QVector<Private::Vertex>::size_type;
-    QVector<Private::Vertex>& verts = p->verts;
+    std::vector<Private::Vertex>& verts = p->verts;
     size_type ulCtPts = verts.size();
-    for (size_type i = 0; i < ulCtPts; ++i) {
-        verts[i].i = i;
-    }
 
     // std::sort(verts.begin(), verts.end());
     int threads = int(std::thread::hardware_concurrency());
     MeshCore::parallel_sort(verts.begin(), verts.end(), std::less<>(), threads);
 
-    QVector<FacetIndex> indices(ulCtPts);
+    std::vector<PointIndex> indices(ulCtPts);
 
     size_type vertex_count = 0;
-    for (QVector<Private::Vertex>::iterator v = verts.begin(); v != verts.end(); ++v) {
-        if (!vertex_count || *v != verts[vertex_count - 1]) {
-            verts[vertex_count++] = *v;
+    for (const Private::Vertex& v : verts) {
+        if (!vertex_count || v != verts[vertex_count - 1]) {
+            verts[vertex_count++] = v;
         }
 
-        indices[v->i] = static_cast<FacetIndex>(vertex_count - 1);
+        indices[v.i] = static_cast<PointIndex>(vertex_count - 1);
     }
 
-    size_type ulCt = verts.size() / 3;
-    MeshFacetArray rFacets(static_cast<FacetIndex>(ulCt));
+    size_type ulCt = ulCtPts / 3;
+    MeshFacetArray rFacets(ulCt);
     for (size_type i = 0; i < ulCt; ++i) {
-        rFacets[static_cast<size_t>(i)]._aulPoints[0] = indices[3 * i];
-        rFacets[static_cast<size_t>(i)]._aulPoints[1] = indices[3 * i + 1];
-        rFacets[static_cast<size_t>(i)]._aulPoints[2] = indices[3 * i + 2];
+        rFacets[i]._aulPoints[0] = indices[3 * i];
+        rFacets[i]._aulPoints[1] = indices[3 * i + 1];
+        rFacets[i]._aulPoints[2] = indices[3 * i + 2];
     }
 
     verts.resize(vertex_count);
 
     MeshPointArray rPoints;
-    rPoints.reserve(static_cast<size_t>(vertex_count));
+    rPoints.reserve(vertex_count);
     for (const auto& v : verts) {
         rPoints.push_back(MeshPoint(v.x, v.y, v.z));
     }
+    std::vector<Private::Vertex>().swap(verts);
 
     _meshKernel.Adopt(rPoints, rFacets, true);
 }
@@ -199,7 +199,7 @@ private:
     MeshKernel& _meshKernel;
 
 public:
-    using size_type = int;
+    using size_type = std::size_t;
     explicit MeshFastBuilder(MeshKernel& rclM);
     ~MeshFastBuilder();
 
@@ -218,6 +218,14 @@ public:
     /** Add new facet
      */
     void AddFacet(const MeshGeomFacet& facetPoints);
+    /** Sets the number of facets, which then must be set with SetFacet() instead of
+     * being added with AddFacet().
+     */
+    void Resize(size_type ctFacets);
+    /** Sets the facet with index \a index. Different facets can be set from different threads
+     * at the same time.
+     */
+    void SetFacet(size_type index, const Base::Vector3f* facetPoints);
 
     /** Finishes building up the mesh structure. Must be done after adding facets.
      */
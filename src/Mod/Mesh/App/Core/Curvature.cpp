@@ -23,327 +23,318 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
-#include <functional>
+#include <array>
+#include <cmath>
 #endif
 
-#include <QFuture>
-#include <QFutureWatcher>
-#include <QtConcurrentMap>
-
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
 
-// #define OPTIMIZE_CURVATURE
-#ifdef OPTIMIZE_CURVATURE
-#include <Eigen/Eigenvalues>
-#else
-#include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
-#endif
-
 #include "Approximation.h"
 #include "Curvature.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
 #include "Tools.h"
 
 
 using namespace MeshCore;
-namespace sp = std::placeholders;
 
-MeshCurvature::MeshCurvature(const MeshKernel& kernel)
-    : myKernel(kernel)
-    , myMinPoints(20)
-    , myRadius(0.5f)
+namespace
 {
-    mySegment.resize(kernel.CountFacets());
-    std::generate(mySegment.begin(), mySegment.end(), Base::iotaGen<FacetIndex>(0));
-}
 
-MeshCurvature::MeshCurvature(const MeshKernel& kernel, std::vector<FacetIndex> segm)
-    : myKernel(kernel)
-    , myMinPoints(20)
-    , myRadius(0.5f)
-    , mySegment(std::move(segm))
-{}
+// Below this number of elements the work isn't split into threads
+const std::size_t minParallelSize = 10000;
 
-void MeshCurvature::ComputePerFace(bool parallel)
-{
-    myCurvature.clear();
-    MeshRefPointToFacets search(myKernel);
-    FacetCurvature face(myKernel, search, myRadius, myMinPoints);
+// The tolerance of Wm4::Math<double> so that the results don't differ from Wm4::MeshCurvature
+const double zeroTolerance = 1.0e-08;
 
-    if (!parallel) {
-        Base::SequencerLauncher seq("Curvature estimation", mySegment.size());
-        for (FacetIndex it : mySegment) {
-            CurvatureInfo info = face.Compute(it);
-            myCurvature.push_back(info);
-            seq.next();
-        }
+void normalize(double& x, double& y, double& z)
+{
+    double length = std::sqrt(x * x + y * y + z * z);
+    if (length > zeroTolerance) {
+        x /= length;
+        y /= length;
+        z /= length;
     }
     else {
-        // NOLINTBEGIN
-        QFuture<CurvatureInfo> future =
-            QtConcurrent::mapped(mySegment, std::bind(&FacetCurvature::Compute, &face, sp::_1));
-        // NOLINTEND
-        QFutureWatcher<CurvatureInfo> watcher;
-        watcher.setFuture(future);
-        watcher.waitForFinished();
-        for (const auto& it : future) {
-            myCurvature.push_back(it);
-        }
+        x = y = z = 0.0;
     }
 }
 
-#ifdef OPTIMIZE_CURVATURE
-namespace MeshCore
+void normalize(double& x, double& y)
 {
-void GenerateComplementBasis(Eigen::Vector3f& rkU, Eigen::Vector3f& rkV, const Eigen::Vector3f& rkW)
-{
-    float fInvLength;
-
-    if (fabs(rkW[0]) >= fabs(rkW[1])) {
-        // W.x or W.z is the largest magnitude component, swap them
-        fInvLength = 1.0 / sqrt(rkW[0] * rkW[0] + rkW[2] * rkW[2]);
-        rkU[0] = -rkW[2] * fInvLength;
-        rkU[1] = 0.0;
-        rkU[2] = +rkW[0] * fInvLength;
-        rkV[0] = rkW[1] * rkU[2];
-        rkV[1] = rkW[2] * rkU[0] - rkW[0] * rkU[2];
-        rkV[2] = -rkW[1] * rkU[0];
+    double length = std::sqrt(x * x + y * y);
+    if (length > zeroTolerance) {
+        x /= length;
+        y /= length;
     }
     else {
-        // W.y or W.z is the largest magnitude component, swap them
-        fInvLength = 1.0 / sqrt(rkW[1] * rkW[1] + rkW[2] * rkW[2]);
-        rkU[0] = 0.0;
-        rkU[1] = +rkW[2] * fInvLength;
-        rkU[2] = -rkW[1] * fInvLength;
-        rkV[0] = rkW[1] * rkU[2] - rkW[2] * rkU[1];
-        rkV[1] = -rkW[0] * rkU[2];
-        rkV[2] = rkW[0] * rkU[1];
+        x = y = 0.0;
     }
 }
-}  // namespace MeshCore
 
-void MeshCurvature::ComputePerVertex()
+/*
+ * The flat data shared by all threads: per point its coordinates and normal in one record and
+ * the one-ring as the two other corners of every adjacent facet, in the orientation of the facet.
+ */
+struct VertexData
 {
-    // get all points
-    const MeshPointArray& pts = myKernel.GetPoints();
-
-    MeshCore::MeshRefPointToFacets pt2f(myKernel);
-    MeshCore::MeshRefPointToPoints pt2p(myKernel);
-    unsigned long numPoints = myKernel.CountPoints();
+    struct Vertex
+    {
+        double x, y, z;
+        double nx, ny, nz;
+    };
+    std::vector<Vertex> vertices;
+    std::vector<std::size_t> offset;
+    std::vector<std::array<PointIndex, 2>> ring;
+
+    VertexData(const MeshPointArray& points, const MeshFacetArray& facets)
+    {
+        std::size_t numPoints = points.size();
+        vertices.resize(numPoints);
+        parallel_for(numPoints, minParallelSize, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                vertices[index] = {points[index].x, points[index].y, points[index].z, 0, 0, 0};
+            }
+        });
 
-    myCurvature.clear();
-    myCurvature.reserve(numPoints);
-
-    std::vector<Eigen::Vector3f> akNormal(numPoints);
-    std::vector<Eigen::Vector3f> akVertex(numPoints);
-    for (unsigned long i = 0; i < numPoints; i++) {
-        Base::Vector3f n = pt2f.GetNormal(i);
-        akNormal[i][0] = n.x;
-        akNormal[i][1] = n.y;
-        akNormal[i][2] = n.z;
-        const Base::Vector3f& p = pts[i];
-        akVertex[i][0] = p.x;
-        akVertex[i][1] = p.y;
-        akVertex[i][2] = p.z;
+        offset.assign(numPoints + 1, 0);
+        for (const auto& facet : facets) {
+            for (PointIndex point : facet._aulPoints) {
+                offset[point + 1]++;
+            }
+        }
+        for (std::size_t index = 0; index < numPoints; index++) {
+            offset[index + 1] += offset[index];
+        }
+        ring.resize(offset.back());
+        std::vector<std::size_t> next(offset.begin(), offset.end() - 1);
+        for (const auto& facet : facets) {
+            const PointIndex* pt = facet._aulPoints;
+            ring[next[pt[0]]++] = {pt[1], pt[2]};
+            ring[next[pt[1]]++] = {pt[2], pt[0]};
+            ring[next[pt[2]]++] = {pt[0], pt[1]};
+        }
     }
 
-    // One could iterate over the triangles and then for each vertex of a triangle compute the
-    // derivates. One could also iterate over the points and then for each adjacent point calculate
-    // the derivates. Both methods must lead to the same values in the above matrices.
-    //
-    // Iterate over the vertexes
-    for (unsigned long i = 0; i < numPoints; i++) {
-        Eigen::Matrix3f akDNormal;
-        akDNormal.setZero();
-        Eigen::Matrix3f akWWTrn;
-        akWWTrn.setZero();
-        Eigen::Matrix3f akDWTrn;
-        akDWTrn.setZero();
-
-        int iV0 = i;
-        int iV1;
-        const std::set<unsigned long>& nb = pt2p[i];
-        for (std::set<unsigned long>::const_iterator it = nb.begin(); it != nb.end(); ++it) {
-            iV1 = *it;
-
-            // Compute edge from V0 to V1, project to tangent plane of vertex,
-            // and compute difference of adjacent normals.
-            Eigen::Vector3f kE = akVertex[iV1] - akVertex[iV0];
-            Eigen::Vector3f kW = kE - (kE.dot(akNormal[iV0])) * akNormal[iV0];
-            Eigen::Vector3f kD = akNormal[iV1] - akNormal[iV0];
-            for (int iRow = 0; iRow < 3; iRow++) {
-                for (int iCol = 0; iCol < 3; iCol++) {
-                    akWWTrn(iRow, iCol) += 2 * kW[iRow] * kW[iCol];
-                    akDWTrn(iRow, iCol) += 2 * kD[iRow] * kW[iCol];
+    // The area weighted normals of the adjacent facets
+    void computeNormals()
+    {
+        parallel_for(vertices.size(), minParallelSize, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                const Vertex& p = vertices[index];
+                double sx = 0.0, sy = 0.0, sz = 0.0;
+                for (std::size_t pos = offset[index]; pos < offset[index + 1]; pos++) {
+                    const Vertex& q = vertices[ring[pos][0]];
+                    const Vertex& r = vertices[ring[pos][1]];
+                    double e1x = q.x - p.x, e1y = q.y - p.y, e1z = q.z - p.z;
+                    double e2x = r.x - p.x, e2y = r.y - p.y, e2z = r.z - p.z;
+                    sx += e1y * e2z - e1z * e2y;
+                    sy += e1z * e2x - e1x * e2z;
+                    sz += e1x * e2y - e1y * e2x;
                 }
+                normalize(sx, sy, sz);
+                Vertex& v = vertices[index];
+                v.nx = sx;
+                v.ny = sy;
+                v.nz = sz;
             }
-        }
+        });
+    }
+};
 
-        // Add in N*N^T to W*W^T for numerical stability.  In theory 0*0^T gets
-        // added to D*W^T, but of course no update needed in the implementation.
-        // Compute the matrix of normal derivatives.
-        for (int iRow = 0; iRow < 3; iRow++) {
-            for (int iCol = 0; iCol < 3; iCol++) {
-                akWWTrn(iRow, iCol) =
-                    0.5 * akWWTrn(iRow, iCol) + akNormal[i][iRow] * akNormal[i][iCol];
-                akDWTrn(iRow, iCol) *= 0.5;
-            }
-        }
+// The same estimation as Wm4::MeshCurvature: the derivative of the normal field is fitted to the
+// differences of the normals along the edges projected into the tangent plane of the vertex.
+CurvatureInfo computeVertexCurvature(const VertexData& data, std::size_t index)
+{
+    CurvatureInfo info;
+    info.fMaxCurvature = 0.0F;
+    info.fMinCurvature = 0.0F;
+    const VertexData::Vertex& p = data.vertices[index];
+    const double n[3] = {p.nx, p.ny, p.nz};
+    if (n[0] == 0.0 && n[1] == 0.0 && n[2] == 0.0) {
+        return info;
+    }
 
-        akDNormal = akDWTrn * akWWTrn.inverse();
-
-        // If N is a unit-length normal at a vertex, let U and V be unit-length
-        // tangents so that {U, V, N} is an orthonormal set.  Define the matrix
-        // J = [U | V], a 3-by-2 matrix whose columns are U and V.  Define J^T
-        // to be the transpose of J, a 2-by-3 matrix.  Let dN/dX denote the
-        // matrix of first-order derivatives of the normal vector field.  The
-        // shape matrix is
-        //   S = (J^T * J)^{-1} * J^T * dN/dX * J = J^T * dN/dX * J
-        // where the superscript of -1 denotes the inverse.  (The formula allows
-        // for J built from non-perpendicular vectors.) The matrix S is 2-by-2.
-        // The principal curvatures are the eigenvalues of S.  If k is a principal
-        // curvature and W is the 2-by-1 eigenvector corresponding to it, then
-        // S*W = k*W (by definition).  The corresponding 3-by-1 tangent vector at
-        // the vertex is called the principal direction for k, and is J*W.
-        // compute U and V given N
-        float minCurvature;
-        float maxCurvature;
-        Base::Vector3f minDirection;
-        Base::Vector3f maxDirection;
-
-        Eigen::Vector3f kU, kV;
-        Eigen::Vector3f kN = akNormal[i];
-        float len = kN.squaredNorm();
-        if (len == 0) {
-            continue;  // skip
-        }
-        MeshCore::GenerateComplementBasis(kU, kV, kN);
-
-        // Compute S = J^T * dN/dX * J.  In theory S is symmetric, but
-        // because we have estimated dN/dX, we must slightly adjust our
-        // calculations to make sure S is symmetric.
-        float fS01 = kU.dot(akDNormal * kV);
-        float fS10 = kV.dot(akDNormal * kU);
-        float fSAvr = 0.5 * (fS01 + fS10);
-        Eigen::Matrix2f kS;
-        kS(0, 0) = kU.dot(akDNormal * kU);
-        kS(0, 1) = fSAvr;
-        kS(1, 0) = fSAvr;
-        kS(1, 1) = kV.dot(akDNormal * kV);
-
-        // compute the eigenvalues of S (min and max curvatures)
-        float fTrace = kS(0, 0) + kS(1, 1);
-        float fDet = kS(0, 0) * kS(1, 1) - kS(0, 1) * kS(1, 0);
-        float fDiscr = fTrace * fTrace - (4.0) * fDet;
-        float fRootDiscr = sqrt(fabs(fDiscr));
-        minCurvature = (0.5) * (fTrace - fRootDiscr);
-        maxCurvature = (0.5) * (fTrace + fRootDiscr);
-
-        // compute the eigenvectors of S
-        Eigen::Vector2f kW0(kS(0, 1), minCurvature - kS(0, 0));
-        Eigen::Vector2f kW1(minCurvature - kS(1, 1), kS(1, 0));
-        if (kW0.squaredNorm() >= kW1.squaredNorm()) {
-            float len = kW0.squaredNorm();
-            if (len > 0 && len != 1) {
-                kW0.normalize();
+    // W*W^T (symmetric, upper part) and D*W^T summed over both edges of every adjacent facet
+    double w00 = 0, w01 = 0, w02 = 0, w11 = 0, w12 = 0, w22 = 0;
+    double dw[3][3] = {};
+    const std::array<PointIndex, 2>* ring = data.ring.data();
+    for (std::size_t pos = data.offset[index]; pos < data.offset[index + 1]; pos++) {
+        for (PointIndex other : ring[pos]) {
+            const VertexData::Vertex& q = data.vertices[other];
+            double ex = q.x - p.x, ey = q.y - p.y, ez = q.z - p.z;
+            double dot = ex * n[0] + ey * n[1] + ez * n[2];
+            double w[3] = {ex - dot * n[0], ey - dot * n[1], ez - dot * n[2]};
+            double d[3] = {q.nx - n[0], q.ny - n[1], q.nz - n[2]};
+            w00 += w[0] * w[0];
+            w01 += w[0] * w[1];
+            w02 += w[0] * w[2];
+            w11 += w[1] * w[1];
+            w12 += w[1] * w[2];
+            w22 += w[2] * w[2];
+            for (int row = 0; row < 3; row++) {
+                dw[row][0] += d[row] * w[0];
+                dw[row][1] += d[row] * w[1];
+                dw[row][2] += d[row] * w[2];
             }
-            Eigen::Vector3f v = kU * kW0[0] + kV * kW0[1];
-            minDirection.Set(v[0], v[1], v[2]);
         }
-        else {
-            float len = kW1.squaredNorm();
-            if (len > 0 && len != 1) {
-                kW1.normalize();
+    }
+
+    // Add in N*N^T to W*W^T for numerical stability
+    double ww[3][3] = {{0.5 * w00 + n[0] * n[0], 0.5 * w01 + n[0] * n[1], 0.5 * w02 + n[0] * n[2]},
+                       {0, 0.5 * w11 + n[1] * n[1], 0.5 * w12 + n[1] * n[2]},
+                       {0, 0, 0.5 * w22 + n[2] * n[2]}};
+    ww[1][0] = ww[0][1];
+    ww[2][0] = ww[0][2];
+    ww[2][1] = ww[1][2];
+
+    // dN/dX = D*W^T * (W*W^T)^-1
+    double inv[3][3] = {{ww[1][1] * ww[2][2] - ww[1][2] * ww[2][1],
+                         ww[0][2] * ww[2][1] - ww[0][1] * ww[2][2],
+                         ww[0][1] * ww[1][2] - ww[0][2] * ww[1][1]},
+                        {ww[1][2] * ww[2][0] - ww[1][0] * ww[2][2],
+                         ww[0][0] * ww[2][2] - ww[0][2] * ww[2][0],
+                         ww[0][2] * ww[1][0] - ww[0][0] * ww[1][2]},
+                        {ww[1][0] * ww[2][1] - ww[1][1] * ww[2][0],
+                         ww[0][1] * ww[2][0] - ww[0][0] * ww[2][1],
+                         ww[0][0] * ww[1][1] - ww[0][1] * ww[1][0]}};
+    double det = ww[0][0] * inv[0][0] + ww[0][1] * inv[1][0] + ww[0][2] * inv[2][0];
+    double dn[3][3] = {};
+    if (std::fabs(det) > zeroTolerance) {
+        double scale = 0.5 / det;
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                dn[row][col] = (dw[row][0] * inv[0][col] + dw[row][1] * inv[1][col]
+                                + dw[row][2] * inv[2][col])
+                    * scale;
             }
-            Eigen::Vector3f v = kU * kW1[0] + kV * kW1[1];
-            minDirection.Set(v[0], v[1], v[2]);
         }
+    }
 
-        kW0 = Eigen::Vector2f(kS(0, 1), maxCurvature - kS(0, 0));
-        kW1 = Eigen::Vector2f(maxCurvature - kS(1, 1), kS(1, 0));
-        if (kW0.squaredNorm() >= kW1.squaredNorm()) {
-            float len = kW0.squaredNorm();
-            if (len > 0 && len != 1) {
-                kW0.normalize();
-            }
-            Eigen::Vector3f v = kU * kW0[0] + kV * kW0[1];
-            maxDirection.Set(v[0], v[1], v[2]);
+    // The tangents U and V so that {U, V, N} is an orthonormal set
+    double u[3] {}, v[3] {};
+    if (std::fabs(n[0]) >= std::fabs(n[1])) {
+        double invLength = 1.0 / std::sqrt(n[0] * n[0] + n[2] * n[2]);
+        u[0] = -n[2] * invLength;
+        u[2] = n[0] * invLength;
+        v[0] = n[1] * u[2];
+        v[1] = n[2] * u[0] - n[0] * u[2];
+        v[2] = -n[1] * u[0];
+    }
+    else {
+        double invLength = 1.0 / std::sqrt(n[1] * n[1] + n[2] * n[2]);
+        u[1] = n[2] * invLength;
+        u[2] = -n[1] * invLength;
+        v[0] = n[1] * u[2] - n[2] * u[1];
+        v[1] = -n[0] * u[2];
+        v[2] = n[0] * u[1];
+    }
+
+    // The shape matrix S = J^T * dN/dX * J with J = [U | V], made symmetric. Its eigenvalues are
+    // the principal curvatures, the eigenvectors give the principal directions.
+    auto form = [&dn](const double* a, const double* b) {
+        double sum = 0.0;
+        for (int row = 0; row < 3; row++) {
+            sum += a[row] * (dn[row][0] * b[0] + dn[row][1] * b[1] + dn[row][2] * b[2]);
         }
-        else {
-            float len = kW1.squaredNorm();
-            if (len > 0 && len != 1) {
-                kW1.normalize();
-            }
-            Eigen::Vector3f v = kU * kW1[0] + kV * kW1[1];
-            maxDirection.Set(v[0], v[1], v[2]);
+        return sum;
+    };
+    double s00 = form(u, u);
+    double s01 = 0.5 * (form(u, v) + form(v, u));
+    double s11 = form(v, v);
+
+    double trace = s00 + s11;
+    double discr = trace * trace - 4.0 * (s00 * s11 - s01 * s01);
+    double rootDiscr = std::sqrt(std::fabs(discr));
+    double curvature[2] = {0.5 * (trace - rootDiscr), 0.5 * (trace + rootDiscr)};
+    Base::Vector3f direction[2];
+    for (int i = 0; i < 2; i++) {
+        double w0x = s01, w0y = curvature[i] - s00;
+        double w1x = curvature[i] - s11, w1y = s01;
+        if (w0x * w0x + w0y * w0y < w1x * w1x + w1y * w1y) {
+            w0x = w1x;
+            w0y = w1y;
         }
-
-        CurvatureInfo ci;
-        ci.fMaxCurvature = maxCurvature;
-        ci.cMaxCurvDir = maxDirection;
-        ci.fMinCurvature = minCurvature;
-        ci.cMinCurvDir = minDirection;
-        myCurvature.push_back(ci);
+        normalize(w0x, w0y);
+        direction[i].Set(float(w0x * u[0] + w0y * v[0]),
+                         float(w0x * u[1] + w0y * v[1]),
+                         float(w0x * u[2] + w0y * v[2]));
     }
+
+    info.fMinCurvature = float(curvature[0]);
+    info.fMaxCurvature = float(curvature[1]);
+    info.cMinCurvDir = direction[0];
+    info.cMaxCurvDir = direction[1];
+    return info;
 }
-#else
-void MeshCurvature::ComputePerVertex()
+
+}  // namespace
+
+MeshCurvature::MeshCurvature(const MeshKernel& kernel)
+    : myKernel(kernel)
+    , myMinPoints(20)
+    , myRadius(0.5f)
 {
-    myCurvature.clear();
+    mySegment.resize(kernel.CountFacets());
+    std::generate(mySegment.begin(), mySegment.end(), Base::iotaGen<FacetIndex>(0));
+}
 
-    // get all points
-    std::vector<Wm4::Vector3<double>> aPnts;
-    aPnts.reserve(myKernel.CountPoints());
-    MeshPointIterator cPIt(myKernel);
-    for (cPIt.Init(); cPIt.More(); cPIt.Next()) {
-        Wm4::Vector3<double> cP(cPIt->x, cPIt->y, cPIt->z);
-        aPnts.push_back(cP);
-    }
+MeshCurvature::MeshCurvature(const MeshKernel& kernel, std::vector<FacetIndex> segm)
+    : myKernel(kernel)
+    , myMinPoints(20)
+    , myRadius(0.5f)
+    , mySegment(std::move(segm))
+{}
 
-    // get all point connections
-    std::vector<int> aIdx;
-    aIdx.reserve(3 * myKernel.CountFacets());
-    const MeshFacetArray& raFts = myKernel.GetFacets();
-    for (const auto& it : raFts) {
-        for (PointIndex point : it._aulPoints) {
-            aIdx.push_back(int(point));
+void MeshCurvature::ComputePerFace(bool parallel)
+{
+    myCurvature.clear();
+    MeshRefPointToFacets search(myKernel);
+    FacetCurvature face(myKernel, search, myRadius, myMinPoints);
+
+    if (!parallel) {
+        Base::SequencerLauncher seq("Curvature estimation", mySegment.size());
+        for (FacetIndex it : mySegment) {
+            CurvatureInfo info = face.Compute(it);
+            myCurvature.push_back(info);
+            seq.next();
         }
     }
+    else {
+        myCurvature.resize(mySegment.size());
+        parallel_for(mySegment.size(),
+                     minParallelSize,
+                     [this, &face](std::size_t begin, std::size_t end) {
+                         for (std::size_t index = begin; index < end; index++) {
+                             myCurvature[index] = face.Compute(mySegment[index]);
+                         }
+                     });
+    }
+}
+
+void MeshCurvature::ComputePerVertex()
+{
+    myCurvature.clear();
 
     // in case of an empty mesh no curvature can be calculated
-    if (myKernel.CountPoints() == 0 || myKernel.CountFacets() == 0) {
+    const MeshPointArray& points = myKernel.GetPoints();
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    if (points.empty() || facets.empty()) {
         return;
     }
 
-    // compute vertex based curvatures
-    Wm4::MeshCurvature<double> meshCurv(myKernel.CountPoints(),
-                                        &(aPnts[0]),
-                                        myKernel.CountFacets(),
-                                        &(aIdx[0]));
-
-    // get curvature information now
-    const Wm4::Vector3<double>* aMaxCurvDir = meshCurv.GetMaxDirections();
-    const Wm4::Vector3<double>* aMinCurvDir = meshCurv.GetMinDirections();
-    const double* aMaxCurv = meshCurv.GetMaxCurvatures();
-    const double* aMinCurv = meshCurv.GetMinCurvatures();
-
-    myCurvature.reserve(myKernel.CountPoints());
-    for (unsigned long i = 0; i < myKernel.CountPoints(); i++) {
-        CurvatureInfo ci;
-        ci.cMaxCurvDir = Base::Vector3f((float)aMaxCurvDir[i].X(),
-                                        (float)aMaxCurvDir[i].Y(),
-                                        (float)aMaxCurvDir[i].Z());
-        ci.cMinCurvDir = Base::Vector3f((float)aMinCurvDir[i].X(),
-                                        (float)aMinCurvDir[i].Y(),
-                                        (float)aMinCurvDir[i].Z());
-        ci.fMaxCurvature = (float)aMaxCurv[i];
-        ci.fMinCurvature = (float)aMinCurv[i];
-        myCurvature.push_back(ci);
-    }
+    VertexData data(points, facets);
+    data.computeNormals();
+
+    myCurvature.resize(points.size());
+    parallel_for(points.size(), minParallelSize, [this, &data](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            myCurvature[index] = computeVertexCurvature(data, index);
+        }
+    });
 }
-#endif  // OPTIMIZE_CURVATURE
 
 // --------------------------------------------------------
 
@@ -70,6 +70,10 @@ public:
         myRadius = r;
     }
     void ComputePerFace(bool parallel);
+    /** Computes the principal curvatures and directions per point from the derivative of the
+     * normal field over the one-ring (see Wm4::MeshCurvature). The points are processed in
+     * parallel on flat arrays.
+     */
     void ComputePerVertex();
     const std::vector<CurvatureInfo>& GetCurvature() const
     {
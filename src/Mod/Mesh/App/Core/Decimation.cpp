@@ -22,6 +22,16 @@
 
 #include "PreCompiled.h"
 
+#ifndef _PreComp_
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#endif
+
 #include "Decimation.h"
 #include "MeshKernel.h"
 #include "Simplify.h"
@@ -29,125 +39,284 @@
 
 using namespace MeshCore;
 
+namespace
+{
+// meshes with fewer facets are decimated by the calling thread only
+const std::size_t minParallelSize = 100000;
+// resolution of the histogram used to split the mesh into slabs
+const std::size_t numBins = 1024;
+
+enum VertexFlag : char
+{
+    Locked = 1,
+    Feature = 2
+};
+
+Simplify::Vertex makeVertex(const Base::Vector3f& point, int id, char flags)
+{
+    Simplify::Vertex v;
+    v.tstart = 0;
+    v.tcount = 0;
+    v.border = 0;
+    v.p = point;
+    v.id = id;
+    v.locked = (flags & Locked) ? 1 : 0;
+    v.feature = (flags & Feature) ? 1 : 0;
+    return v;
+}
+
+Simplify::Triangle makeTriangle(int v0, int v1, int v2)
+{
+    Simplify::Triangle t;
+    t.deleted = 0;
+    t.dirty = 0;
+    for (double& err : t.err) {
+        err = 0.0;
+    }
+    t.v[0] = v0;
+    t.v[1] = v1;
+    t.v[2] = v2;
+    return t;
+}
+}  // namespace
+
 MeshSimplify::MeshSimplify(MeshKernel& mesh)
     : myKernel(mesh)
 {}
 
+void MeshSimplify::setKeepBoundary(bool on)
+{
+    keepBoundary = on;
+}
+
+void MeshSimplify::setFeatureAngle(float angle)
+{
+    featureAngle = angle;
+}
+
+void MeshSimplify::setNumThreads(int num)
+{
+    numThreads = num;
+}
+
+double MeshSimplify::getMaxError() const
+{
+    return maxError;
+}
+
 void MeshSimplify::simplify(float tolerance, float reduction)
 {
-    Simplify alg;
+    int target_count =
+        static_cast<int>(static_cast<float>(myKernel.CountFacets()) * (1.0f - reduction));
+    decimate(target_count, tolerance);
+}
 
+void MeshSimplify::simplify(int targetSize)
+{
+    decimate(targetSize, FLT_MAX);
+}
+
+std::vector<char> MeshSimplify::vertexFlags() const
+{
     const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.tstart = 0;
-        v.tcount = 0;
-        v.border = 0;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    std::vector<char> flags(points.size(), 0);
+    if (!keepBoundary && featureAngle <= 0.0F) {
+        return flags;
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        t.deleted = 0;
-        t.dirty = 0;
-        for (double& j : t.err) {
-            j = 0.0;
+    std::vector<Base::Vector3f> normals;
+    if (featureAngle > 0.0F) {
+        normals.reserve(facets.size());
+        for (const auto& facet : facets) {
+            const Base::Vector3f& p0 = points[facet._aulPoints[0]];
+            const Base::Vector3f& p1 = points[facet._aulPoints[1]];
+            const Base::Vector3f& p2 = points[facet._aulPoints[2]];
+            normals.push_back(((p1 - p0) % (p2 - p0)).Normalize());
         }
-        for (int j = 0; j < 3; j++) {
-            t.v[j] = facets[i]._aulPoints[j];
-        }
-        alg.triangles.push_back(t);
     }
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0f - reduction));
+    float cosAngle = std::cos(featureAngle);
+    for (std::size_t index = 0; index < facets.size(); index++) {
+        const MeshFacet& facet = facets[index];
+        for (int side = 0; side < 3; side++) {
+            FacetIndex neighbour = facet._aulNeighbours[side];
+            char flag = 0;
+            if (neighbour == FACET_INDEX_MAX) {
+                flag = keepBoundary ? Locked : 0;
+            }
+            else if (neighbour > index && !normals.empty()
+                     && normals[index] * normals[neighbour] < cosAngle) {
+                flag = Feature;
+            }
+            flags[facet._aulPoints[side]] |= flag;
+            flags[facet._aulPoints[(side + 1) % 3]] |= flag;
+        }
+    }
+    return flags;
+}
 
-    // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
+void MeshSimplify::decimate(int targetSize, double tolerance)
+{
+    maxError = 0.0;
+    const MeshPointArray& points = myKernel.GetPoints();
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    std::vector<char> flags = vertexFlags();
 
-    // Simplification done
-    MeshPointArray new_points;
-    new_points.reserve(alg.vertices.size());
-    for (const auto& vertex : alg.vertices) {
-        new_points.push_back(vertex.p);
+    std::size_t numParts = numThreads > 0 ? static_cast<std::size_t>(numThreads)
+                                          : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    if (facets.size() < minParallelSize) {
+        numParts = 1;
     }
 
-    std::size_t numFacets = 0;
-    for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            numFacets++;
+    // The vertices and facets passed to the final pass
+    std::vector<Simplify::Vertex> vertices;
+    std::vector<Simplify::Triangle> triangles;
+
+    if (numParts == 1) {
+        vertices.reserve(points.size());
+        for (std::size_t i = 0; i < points.size(); i++) {
+            vertices.push_back(makeVertex(points[i], static_cast<int>(i), flags[i]));
         }
-    }
-    MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
-    for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = triangle.v[0];
-            face._aulPoints[1] = triangle.v[1];
-            face._aulPoints[2] = triangle.v[2];
-            new_facets.push_back(face);
+        triangles.reserve(facets.size());
+        for (const auto& facet : facets) {
+            triangles.push_back(makeTriangle(static_cast<int>(facet._aulPoints[0]),
+                                             static_cast<int>(facet._aulPoints[1]),
+                                             static_cast<int>(facet._aulPoints[2])));
         }
     }
+    else {
+        // Split the mesh into slabs along its longest side, each with about the same number of
+        // facets
+        Base::BoundBox3f box = myKernel.GetBoundBox();
+        unsigned short axis = 0;
+        if (box.LengthY() > box.LengthX()) {
+            axis = 1;
+        }
+        if (box.LengthZ() > std::max(box.LengthX(), box.LengthY())) {
+            axis = 2;
+        }
+        float minimum = box.GetMinimum()[axis];
+        float length = std::max(box.GetMaximum()[axis] - minimum, FLT_EPSILON);
+        auto binOf = [&](const MeshFacet& facet) {
+            float center = (points[facet._aulPoints[0]][axis] + points[facet._aulPoints[1]][axis]
+                            + points[facet._aulPoints[2]][axis])
+                / 3.0F;
+            auto bin = static_cast<std::size_t>((center - minimum) / length * float(numBins));
+            return std::min(bin, numBins - 1);
+        };
 
-    myKernel.Adopt(new_points, new_facets, true);
-}
+        std::vector<std::size_t> histogram(numBins, 0);
+        for (const auto& facet : facets) {
+            histogram[binOf(facet)]++;
+        }
+        std::vector<std::size_t> partOfBin(numBins);
+        std::size_t sum = 0;
+        for (std::size_t bin = 0; bin < numBins; bin++) {
+            partOfBin[bin] = std::min(sum * numParts / facets.size(), numParts - 1);
+            sum += histogram[bin];
+        }
 
-void MeshSimplify::simplify(int targetSize)
-{
-    Simplify alg;
+        std::vector<std::vector<FacetIndex>> parts(numParts);
+        std::vector<int> owner(points.size(), -1);
+        const int seam = -2;
+        for (std::size_t index = 0; index < facets.size(); index++) {
+            const MeshFacet& facet = facets[index];
+            std::size_t part = partOfBin[binOf(facet)];
+            parts[part].push_back(index);
+            for (PointIndex point : facet._aulPoints) {
+                if (owner[point] == -1) {
+                    owner[point] = static_cast<int>(part);
+                }
+                else if (owner[point] != static_cast<int>(part)) {
+                    owner[point] = seam;
+                }
+            }
+        }
 
-    const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.tstart = 0;
-        v.tcount = 0;
-        v.border = 0;
-        v.p = points[i];
-        alg.vertices.push_back(v);
-    }
+        // Decimate the slabs independently, with the vertices on their seams locked. Every vertex
+        // not on a seam belongs to a single slab, so the slabs can share one index map for them.
+        std::vector<int> localIndex(points.size(), -1);
+        double ratio = double(targetSize) / double(facets.size());
+        auto decimatePart = [&](std::size_t part) {
+            auto alg = std::make_unique<Simplify>();
+            std::unordered_map<PointIndex, int> seamIndex;
+            auto local = [&](PointIndex point) {
+                int& index = owner[point] == seam ? seamIndex.emplace(point, -1).first->second
+                                                  : localIndex[point];
+                if (index < 0) {
+                    index = static_cast<int>(alg->vertices.size());
+                    char flag = flags[point] | (owner[point] == seam ? Locked : 0);
+                    alg->vertices.push_back(makeVertex(points[point], int(point), flag));
+                }
+                return index;
+            };
+            alg->triangles.reserve(parts[part].size());
+            for (FacetIndex index : parts[part]) {
+                const MeshFacet& facet = facets[index];
+                int v0 = local(facet._aulPoints[0]);
+                int v1 = local(facet._aulPoints[1]);
+                int v2 = local(facet._aulPoints[2]);
+                alg->triangles.push_back(makeTriangle(v0, v1, v2));
+            }
+            alg->simplify_mesh(static_cast<int>(ratio * double(parts[part].size())), tolerance);
+            return alg;
+        };
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        t.deleted = 0;
-        t.dirty = 0;
-        for (double& j : t.err) {
-            j = 0.0;
+        std::vector<std::future<std::unique_ptr<Simplify>>> futures;
+        for (std::size_t part = 1; part < numParts; part++) {
+            futures.push_back(std::async(std::launch::async, decimatePart, part));
+        }
+        std::vector<std::unique_ptr<Simplify>> results;
+        results.push_back(decimatePart(0));
+        for (auto& future : futures) {
+            results.push_back(future.get());
         }
-        for (int j = 0; j < 3; j++) {
-            t.v[j] = facets[i]._aulPoints[j];
+
+        // Merge the slabs, the locked vertices are shared by their id
+        std::vector<int> mergedIndex(points.size(), -1);
+        std::vector<int> indices;
+        double partError = 0.0;
+        for (const auto& alg : results) {
+            partError = std::max(partError, alg->max_error);
+            indices.resize(alg->vertices.size());
+            for (std::size_t i = 0; i < alg->vertices.size(); i++) {
+                const Simplify::Vertex& v = alg->vertices[i];
+                int& index = v.locked ? mergedIndex[v.id] : indices[i];
+                if (!v.locked || index < 0) {
+                    index = static_cast<int>(vertices.size());
+                    vertices.push_back(makeVertex(v.p, v.id, flags[v.id]));
+                }
+                indices[i] = index;
+            }
+            for (const auto& t : alg->triangles) {
+                triangles.push_back(makeTriangle(indices[t.v[0]], indices[t.v[1]], indices[t.v[2]]));
+            }
         }
-        alg.triangles.push_back(t);
+        maxError = std::sqrt(partError);
     }
 
-    // Simplification starts
-    alg.simplify_mesh(targetSize, FLT_MAX);
+    // Decimate the whole mesh, this mostly affects the seams of the slabs
+    Simplify alg;
+    alg.vertices.swap(vertices);
+    alg.triangles.swap(triangles);
+    alg.simplify_mesh(targetSize, tolerance);
+    maxError += std::sqrt(alg.max_error);
 
-    // Simplification done
     MeshPointArray new_points;
     new_points.reserve(alg.vertices.size());
     for (const auto& vertex : alg.vertices) {
         new_points.push_back(vertex.p);
     }
 
-    std::size_t numFacets = 0;
-    for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            numFacets++;
-        }
-    }
     MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
+    new_facets.reserve(alg.triangles.size());
     for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = triangle.v[0];
-            face._aulPoints[1] = triangle.v[1];
-            face._aulPoints[2] = triangle.v[2];
-            new_facets.push_back(face);
-        }
+        MeshFacet face;
+        face._aulPoints[0] = triangle.v[0];
+        face._aulPoints[1] = triangle.v[1];
+        face._aulPoints[2] = triangle.v[2];
+        new_facets.push_back(face);
     }
 
     myKernel.Adopt(new_points, new_facets, true);
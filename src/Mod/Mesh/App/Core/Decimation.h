@@ -24,21 +24,51 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <vector>
+
 #include <Mod/Mesh/MeshGlobal.h>
 
 namespace MeshCore
 {
 class MeshKernel;
 
+/**
+ * Decimates a mesh by collapsing the edges with the smallest quadric error.
+ *
+ * Large meshes are split into slabs of about the same number of facets that
+ * are decimated in parallel. The vertices shared by several slabs stay where
+ * they are, and a final pass over the whole mesh decimates along the seams.
+ */
 class MeshExport MeshSimplify
 {
 public:
     MeshSimplify(MeshKernel&);  // explicit bombs
+    /// Keep the vertices of the mesh boundary unchanged. By default they can
+    /// only be collapsed with each other.
+    void setKeepBoundary(bool on);
+    /// Treat the edges whose adjacent facets enclose an angle (in radians)
+    /// above \a angle like the mesh boundary. 0 disables this.
+    void setFeatureAngle(float angle);
+    /// The number of threads, 0 uses all cores and 1 doesn't split the mesh.
+    void setNumThreads(int num);
     void simplify(float tolerance, float reduction);
     void simplify(int targetSize);
+    /// Returns an estimate of the largest distance of the new vertices to the
+    /// planes of the original facets they replace, of the last simplify() call.
+    /// It is the root of the largest quadric error, which only approximately
+    /// bounds the distance as the quadrics of merged vertices are summed up.
+    double getMaxError() const;
+
+private:
+    void decimate(int targetSize, double tolerance);
+    std::vector<char> vertexFlags() const;
 
 private:
     MeshKernel& myKernel;
+    bool keepBoundary {false};
+    float featureAngle {0.0F};
+    int numThreads {0};
+    double maxError {0.0};
 };
 
 }  // namespace MeshCore
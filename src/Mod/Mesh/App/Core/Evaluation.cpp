@@ -24,6 +24,8 @@
 
 #ifndef _PreComp_
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <vector>
 #endif
 
@@ -34,7 +36,6 @@
 #include "Approximation.h"
 #include "Evaluation.h"
 #include "Functional.h"
-#include "Grid.h"
 #include "Iterator.h"
 #include "TopoAlgorithm.h"
 
@@ -598,83 +599,50 @@ bool MeshFixSingleFacet::Fixup()
 
 // ----------------------------------------------------------------
 
-bool MeshEvalSelfIntersection::Evaluate()
+// the intersection lines found by the concurrently called filter
+struct MeshEvalSelfIntersection::Lines
 {
-    // Contains bounding boxes for every facet
-    std::vector<Base::BoundBox3f> boxes;
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX {}, ulGridY {}, ulGridZ {};
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
-
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX * ulGridY * ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        // Get the facet indices, belonging to the current grid unit
-        std::vector<FacetIndex> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
+    std::mutex mutex;
+    std::map<std::pair<FacetIndex, FacetIndex>, std::pair<Base::Vector3f, Base::Vector3f>> lines;
+};
 
-        seq.next();
-        if (aulGridElements.empty()) {
-            continue;
+MeshFacetBVH::PairFilter MeshEvalSelfIntersection::IntersectionFilter(Lines* lines) const
+{
+    return [this, lines](FacetIndex index1, FacetIndex index2) {
+        // If the facets share a common vertex we do not check for self-intersections
+        // because they could but usually do not intersect each other and the algorithm
+        // below would detect false-positives, otherwise
+        const MeshFacetArray& rFaces = _rclMesh.GetFacets();
+        const MeshFacet& rface1 = rFaces[index1];
+        const MeshFacet& rface2 = rFaces[index2];
+        for (PointIndex point : rface1._aulPoints) {
+            if (rface2.HasPoint(point)) {
+                return false;  // ignore facets sharing a common vertex
+            }
         }
 
-        MeshGeomFacet facet1, facet2;
         Base::Vector3f pt1, pt2;
-        for (std::vector<FacetIndex>::iterator it = aulGridElements.begin();
-             it != aulGridElements.end();
-             ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<FacetIndex>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) {  // the identical facet
-                    continue;
-                }
-                // If the facets share a common vertex we do not check for self-intersections
-                // because they could but usually do not intersect each other and the algorithm
-                // below would detect false-positives, otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0]
-                    || rface1._aulPoints[0] == rface2._aulPoints[1]
-                    || rface1._aulPoints[0] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[1] == rface2._aulPoints[0]
-                    || rface1._aulPoints[1] == rface2._aulPoints[1]
-                    || rface1._aulPoints[1] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[2] == rface2._aulPoints[0]
-                    || rface1._aulPoints[2] == rface2._aulPoints[1]
-                    || rface1._aulPoints[2] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        // abort after the first detected self-intersection
-                        return false;
-                    }
-                }
-            }
+        MeshGeomFacet facet1 = _rclMesh.GetFacet(rface1);
+        MeshGeomFacet facet2 = _rclMesh.GetFacet(rface2);
+        if (facet1.IntersectWithFacet(facet2, pt1, pt2) != 2) {
+            return false;
         }
-    }
+        if (lines) {
+            std::lock_guard<std::mutex> lock(lines->mutex);
+            lines->lines[std::make_pair(index1, index2)] = std::make_pair(pt1, pt2);
+        }
+        return true;
+    };
+}
 
-    return true;
+bool MeshEvalSelfIntersection::Evaluate()
+{
+    // Splits the mesh using a bounding volume hierarchy for speeding up the calculation
+    Base::SequencerLauncher seq("Checking for self-intersections...", 0);
+    MeshFacetBVH bvh(_rclMesh);
+
+    // abort after the first detected self-intersection
+    return bvh.FindPairs(IntersectionFilter(), true, &seq).empty();
 }
 
 void MeshEvalSelfIntersection::GetIntersections(
@@ -705,78 +673,30 @@ void MeshEvalSelfIntersection::GetIntersections(
 void MeshEvalSelfIntersection::GetIntersections(
     std::vector<std::pair<FacetIndex, FacetIndex>>& intersection) const
 {
-    // Contains bounding boxes for every facet
-    std::vector<Base::BoundBox3f> boxes;
-    // intersection.clear();
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX {}, ulGridY {}, ulGridZ {};
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
-
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX * ulGridY * ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        // Get the facet indices, belonging to the current grid unit
-        std::vector<FacetIndex> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next(true);
-        if (aulGridElements.empty()) {
-            continue;
-        }
+    // Splits the mesh using a bounding volume hierarchy for speeding up the calculation
+    Base::SequencerLauncher seq("Checking for self-intersections...", 0);
+    MeshFacetBVH bvh(_rclMesh);
 
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<FacetIndex>::iterator it = aulGridElements.begin();
-             it != aulGridElements.end();
-             ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<FacetIndex>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) {  // the identical facet
-                    continue;
-                }
-                // If the facets share a common vertex we do not check for self-intersections
-                // because they could but usually do not intersect each other and the algorithm
-                // below would detect false-positives, otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0]
-                    || rface1._aulPoints[0] == rface2._aulPoints[1]
-                    || rface1._aulPoints[0] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[1] == rface2._aulPoints[0]
-                    || rface1._aulPoints[1] == rface2._aulPoints[1]
-                    || rface1._aulPoints[1] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[2] == rface2._aulPoints[0]
-                    || rface1._aulPoints[2] == rface2._aulPoints[1]
-                    || rface1._aulPoints[2] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
+    std::vector<MeshFacetBVH::FacetPair> pairs = bvh.FindPairs(IntersectionFilter(), false, &seq);
+    intersection.insert(intersection.end(), pairs.begin(), pairs.end());
+}
 
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.emplace_back(*it, *jt);
-                    }
-                }
-            }
-        }
+void MeshEvalSelfIntersection::GetIntersectionsAndLines(
+    std::vector<std::pair<FacetIndex, FacetIndex>>& intersection,
+    std::vector<std::pair<Base::Vector3f, Base::Vector3f>>& lines) const
+{
+    // Splits the mesh using a bounding volume hierarchy for speeding up the calculation
+    Base::SequencerLauncher seq("Checking for self-intersections...", 0);
+    MeshFacetBVH bvh(_rclMesh);
+
+    // keep the lines computed by the filter instead of intersecting the pairs again
+    Lines found;
+    std::vector<MeshFacetBVH::FacetPair> pairs =
+        bvh.FindPairs(IntersectionFilter(&found), false, &seq);
+    intersection.insert(intersection.end(), pairs.begin(), pairs.end());
+    lines.reserve(lines.size() + pairs.size());
+    for (const auto& it : pairs) {
+        lines.push_back(found.lines[it]);
     }
 }
 
@@ -26,6 +26,7 @@
 #include <cmath>
 #include <list>
 
+#include "BVH.h"
 #include "MeshKernel.h"
 #include "Visitor.h"
 
@@ -337,6 +338,13 @@ public:
                           std::vector<std::pair<Base::Vector3f, Base::Vector3f>>&) const;
     /// collect the index of all facets with self intersections
     void GetIntersections(std::vector<std::pair<FacetIndex, FacetIndex>>&) const;
+    /// collect the index of all facets with self intersections and their intersection lines
+    void GetIntersectionsAndLines(std::vector<std::pair<FacetIndex, FacetIndex>>&,
+                                  std::vector<std::pair<Base::Vector3f, Base::Vector3f>>&) const;
+
+private:
+    struct Lines;
+    MeshFacetBVH::PairFilter IntersectionFilter(Lines* lines = nullptr) const;
 };
 
 /**
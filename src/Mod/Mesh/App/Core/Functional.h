@@ -24,7 +24,10 @@
 #define MESH_FUNCTIONAL_H
 
 #include <algorithm>
+#include <cstddef>
 #include <future>
+#include <thread>
+#include <vector>
 
 
 namespace MeshCore
@@ -62,6 +65,30 @@ static void parallel_sort(Iter begin, Iter end, Pred comp, int threads)
     }
 }
 
+/// Calls func(begin, end) for consecutive chunks of [0, count), one per thread. If count
+/// doesn't exceed minParallelSize the calling thread does all the work.
+template<class Func>
+void parallel_for(std::size_t count, std::size_t minParallelSize, Func&& func)
+{
+    std::size_t numThreads = 1;
+    if (count > minParallelSize) {
+        numThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    std::size_t chunk = (count + numThreads - 1) / numThreads;
+    std::vector<std::future<void>> futures;
+    for (std::size_t begin = chunk; begin < count; begin += chunk) {
+        std::size_t end = std::min(begin + chunk, count);
+        futures.push_back(std::async(std::launch::async, [&func, begin, end]() {
+            func(begin, end);
+        }));
+    }
+    func(0, std::min(chunk, count));
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 }  // namespace MeshCore
 
 
@@ -24,6 +24,10 @@
 
 #ifndef _PreComp_
 #include <algorithm>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <thread>
 #endif
 
 #include "Algorithm.h"
@@ -70,7 +74,8 @@ void MeshGrid::Attach(const MeshKernel& rclM)
 
 void MeshGrid::Clear()
 {
-    _aulGrid.clear();
+    _aulGridOffsets.clear();
+    _aulGridElements.clear();
     _pclMesh = nullptr;
 }
 
@@ -128,14 +133,66 @@ void MeshGrid::InitGrid()
     }
 
     // Create data structure
-    _aulGrid.clear();
-    _aulGrid.resize(_ulCtGridsX);
-    for (unsigned long i = 0; i < _ulCtGridsX; i++) {
-        _aulGrid[i].resize(_ulCtGridsY);
-        for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-            _aulGrid[i][j].resize(_ulCtGridsZ);
+    _aulGridOffsets.assign(std::size_t(_ulCtGridsX) * _ulCtGridsY * _ulCtGridsZ + 1, 0);
+    _aulGridElements.clear();
+}
+
+void MeshGrid::FillGrid(
+    ElementIndex ulCtElements,
+    const std::function<void(ElementIndex, std::vector<unsigned long>&)>& cellsOf)
+{
+    using CellEntry = std::pair<unsigned long, ElementIndex>;
+
+    // Collect the grid of each element in consecutive chunks of elements. Processing the
+    // chunks in order keeps the element indices of each grid sorted.
+    std::size_t ulCtChunks = 1;
+    if (ulCtElements > 10000) {
+        ulCtChunks = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    std::vector<std::vector<CellEntry>> chunks(ulCtChunks);
+    auto collect = [&](std::size_t chunk) {
+        auto first = static_cast<ElementIndex>(std::uint64_t(ulCtElements) * chunk / ulCtChunks);
+        auto last =
+            static_cast<ElementIndex>(std::uint64_t(ulCtElements) * (chunk + 1) / ulCtChunks);
+        std::vector<unsigned long> cells;
+        std::vector<CellEntry>& entries = chunks[chunk];
+        entries.reserve(last - first);
+        for (ElementIndex index = first; index < last; index++) {
+            cells.clear();
+            cellsOf(index, cells);
+            for (unsigned long cell : cells) {
+                entries.emplace_back(cell, index);
+            }
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t chunk = 1; chunk < ulCtChunks; chunk++) {
+        futures.push_back(std::async(std::launch::async, collect, chunk));
+    }
+    collect(0);
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    // Counting sort of the entries by their grid
+    std::size_t ulCtCells = std::size_t(_ulCtGridsX) * _ulCtGridsY * _ulCtGridsZ;
+    _aulGridOffsets.assign(ulCtCells + 1, 0);
+    for (const auto& entries : chunks) {
+        for (const auto& entry : entries) {
+            _aulGridOffsets[entry.first + 1]++;
         }
     }
+    std::partial_sum(_aulGridOffsets.begin(), _aulGridOffsets.end(), _aulGridOffsets.begin());
+
+    _aulGridElements.resize(_aulGridOffsets.back());
+    std::vector<std::size_t> position(_aulGridOffsets.begin(), _aulGridOffsets.end() - 1);
+    for (auto& entries : chunks) {
+        for (const auto& entry : entries) {
+            _aulGridElements[position[entry.first]++] = entry.second;
+        }
+        std::vector<CellEntry>().swap(entries);
+    }
 }
 
 unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
@@ -158,9 +215,8 @@ unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
     for (auto i = ulMinX; i <= ulMaxX; i++) {
         for (auto j = ulMinY; j <= ulMaxY; j++) {
             for (auto k = ulMinZ; k <= ulMaxZ; k++) {
-                raulElements.insert(raulElements.end(),
-                                    _aulGrid[i][j][k].begin(),
-                                    _aulGrid[i][j][k].end());
+                MeshGridCell cell = GetCell(i, j, k);
+                raulElements.insert(raulElements.end(), cell.begin(), cell.end());
             }
         }
     }
@@ -200,9 +256,8 @@ unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
         for (auto j = ulMinY; j <= ulMaxY; j++) {
             for (auto k = ulMinZ; k <= ulMaxZ; k++) {
                 if (Base::DistanceP2(GetBoundBox(i, j, k).GetCenter(), rclOrg) < fMinDistP2) {
-                    raulElements.insert(raulElements.end(),
-                                        _aulGrid[i][j][k].begin(),
-                                        _aulGrid[i][j][k].end());
+                    MeshGridCell cell = GetCell(i, j, k);
+                    raulElements.insert(raulElements.end(), cell.begin(), cell.end());
                 }
             }
         }
@@ -237,7 +292,8 @@ unsigned long MeshGrid::Inside(const Base::BoundBox3f& rclBB,
     for (auto i = ulMinX; i <= ulMaxX; i++) {
         for (auto j = ulMinY; j <= ulMaxY; j++) {
             for (auto k = ulMinZ; k <= ulMaxZ; k++) {
-                raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+                MeshGridCell cell = GetCell(i, j, k);
+                raulElements.insert(cell.begin(), cell.end());
             }
         }
     }
@@ -461,7 +517,7 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nX < _ulCtGridsX) {
                     for (unsigned long i = 0; i < _ulCtGridsY; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+                            GetElements(nX, i, j, indices);
                         }
                     }
                     nX++;
@@ -473,7 +529,7 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nX < _ulCtGridsX) {
                     for (unsigned long i = 0; i < _ulCtGridsY; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+                            GetElements(nX, i, j, indices);
                         }
                     }
                     nX++;
@@ -485,7 +541,7 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nY < _ulCtGridsY) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+                            GetElements(i, nY, j, indices);
                         }
                     }
                     nY++;
@@ -497,7 +553,7 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nY < _ulCtGridsY) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsZ; j++) {
-                            indices.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+                            GetElements(i, nY, j, indices);
                         }
                     }
                     nY--;
@@ -509,7 +565,7 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nZ < _ulCtGridsZ) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-                            indices.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+                            GetElements(i, j, nZ, indices);
                         }
                     }
                     nZ++;
@@ -521,7 +577,7 @@ void MeshGrid::SearchNearestFromPoint(const Base::Vector3f& pnt,
                 while (indices.empty() && nZ < _ulCtGridsZ) {
                     for (unsigned long i = 0; i < _ulCtGridsX; i++) {
                         for (unsigned long j = 0; j < _ulCtGridsY; j++) {
-                            indices.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+                            GetElements(i, j, nZ, indices);
                         }
                     }
                     nZ--;
@@ -609,10 +665,10 @@ unsigned long MeshGrid::GetElements(unsigned long ulX,
                                     unsigned long ulZ,
                                     std::set<ElementIndex>& raclInd) const
 {
-    const std::set<ElementIndex>& rclSet = _aulGrid[ulX][ulY][ulZ];
-    if (!rclSet.empty()) {
-        raclInd.insert(rclSet.begin(), rclSet.end());
-        return rclSet.size();
+    MeshGridCell cell = GetCell(ulX, ulY, ulZ);
+    if (!cell.empty()) {
+        raclInd.insert(cell.begin(), cell.end());
+        return static_cast<unsigned long>(cell.size());
     }
 
     return 0;
@@ -628,9 +684,8 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f& rclPoint,
         return 0;
     }
 
-    aulFacets.resize(_aulGrid[ulX][ulY][ulZ].size());
-
-    std::copy(_aulGrid[ulX][ulY][ulZ].begin(), _aulGrid[ulX][ulY][ulZ].end(), aulFacets.begin());
+    MeshGridCell cell = GetCell(ulX, ulY, ulZ);
+    aulFacets.assign(cell.begin(), cell.end());
     return aulFacets.size();
 }
 
@@ -747,13 +802,9 @@ void MeshFacetGrid::RebuildGrid()
     InitGrid();
 
     // Fill data structure
-    MeshFacetIterator clFIter(*_pclMesh);
-
-    unsigned long i = 0;
-    for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-        //    AddFacet(*clFIter, i++, 2.0f);
-        AddFacet(*clFIter, i++);
-    }
+    FillGrid(_pclMesh->CountFacets(), [this](ElementIndex index, std::vector<unsigned long>& cells) {
+        AddFacet(_pclMesh->GetFacet(index), cells);
+    });
 }
 
 unsigned long MeshFacetGrid::SearchNearestFromPoint(const Base::Vector3f& rclPt) const
@@ -984,8 +1035,7 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX,
                                              float& rfMinDist,
                                              ElementIndex& rulFacetInd) const
 {
-    const std::set<ElementIndex>& rclSet = _aulGrid[ulX][ulY][ulZ];
-    for (ElementIndex pI : rclSet) {
+    for (ElementIndex pI : GetCell(ulX, ulY, ulZ)) {
         float fDist = _pclMesh->GetFacet(pI).DistanceToPoint(rclPt);
         if (fDist < rfMinDist) {
             rfMinDist = fDist;
@@ -1028,7 +1078,9 @@ MeshPointGrid::MeshPointGrid(const MeshKernel& rclM, float fGridLen)
             std::max<unsigned long>(static_cast<unsigned long>(clBBMesh.LengthZ() / fGridLen), 1));
 }
 
-void MeshPointGrid::AddPoint(const MeshPoint& rclPt, ElementIndex ulPtIndex, float fEpsilon)
+void MeshPointGrid::AddPoint(const MeshPoint& rclPt,
+                             std::vector<unsigned long>& raulCells,
+                             float fEpsilon) const
 {
     (void)fEpsilon;
     unsigned long ulX {};
@@ -1036,7 +1088,7 @@ void MeshPointGrid::AddPoint(const MeshPoint& rclPt, ElementIndex ulPtIndex, flo
     unsigned long ulZ {};
     Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
     if ((ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ)) {
-        _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+        raulCells.push_back(GetIndexToPosition(ulX, ulY, ulZ));
     }
 }
 
@@ -1093,13 +1145,10 @@ void MeshPointGrid::RebuildGrid()
     InitGrid();
 
     // Fill data structure
-
-    MeshPointIterator cPIter(*_pclMesh);
-
-    unsigned long i = 0;
-    for (cPIter.Init(); cPIter.More(); cPIter.Next()) {
-        AddPoint(*cPIter, i++);
-    }
+    const MeshPointArray& points = _pclMesh->GetPoints();
+    FillGrid(points.size(), [this, &points](ElementIndex index, std::vector<unsigned long>& cells) {
+        AddPoint(points[index], cells);
+    });
 }
 
 void MeshPointGrid::Pos(const Base::Vector3f& rclPoint,
@@ -1164,9 +1213,8 @@ bool MeshGridIterator::InitOnRay(const Base::Vector3f& rclPt,
     // point lies within global BB
     if (_rclGrid.GetBoundBox().IsInBox(rclPt)) {  // Determine the voxel by the starting point
         _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        MeshGridCell cell = _rclGrid.GetCell(_ulX, _ulY, _ulZ);
+        raulElements.insert(raulElements.end(), cell.begin(), cell.end());
         _bValidRay = true;
     }
     else {  // Start point outside
@@ -1181,9 +1229,8 @@ bool MeshGridIterator::InitOnRay(const Base::Vector3f& rclPt,
                 _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
             }
 
-            raulElements.insert(raulElements.end(),
-                                _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                                _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+            MeshGridCell cell = _rclGrid.GetCell(_ulX, _ulY, _ulZ);
+            raulElements.insert(raulElements.end(), cell.begin(), cell.end());
             _bValidRay = true;
         }
     }
@@ -1247,9 +1294,8 @@ bool MeshGridIterator::NextOnRay(std::vector<ElementIndex>& raulElements)
     if (_bValidRay && _rclGrid.CheckPos(_ulX, _ulY, _ulZ)) {
         GridElement pos(_ulX, _ulY, _ulZ);
         _cSearchPositions.insert(pos);
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        MeshGridCell cell = _rclGrid.GetCell(_ulX, _ulY, _ulZ);
+        raulElements.insert(raulElements.end(), cell.begin(), cell.end());
     }
     else {
         _bValidRay = false;  // Beam leaked
@@ -23,6 +23,7 @@
 #ifndef MESH_GRID_H
 #define MESH_GRID_H
 
+#include <functional>
 #include <set>
 
 #include <Base/BoundBox.h>
@@ -44,6 +45,39 @@ class MeshGrid;
 
 #define MESHGRID_BBOX_EXTENSION 10.0f
 
+/**
+ * The MeshGridCell class gives access to the indices of the elements stored
+ * in one grid element. The indices are sorted in ascending order.
+ */
+class MeshGridCell
+{
+public:
+    MeshGridCell(const ElementIndex* first, const ElementIndex* last)
+        : _first(first)
+        , _last(last)
+    {}
+    const ElementIndex* begin() const
+    {
+        return _first;
+    }
+    const ElementIndex* end() const
+    {
+        return _last;
+    }
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(_last - _first);
+    }
+    bool empty() const
+    {
+        return _first == _last;
+    }
+
+private:
+    const ElementIndex* _first;
+    const ElementIndex* _last;
+};
+
 /**
  * The MeshGrid allows to divide a global mesh object into smaller regions
  * of elements (e.g. facets, points or edges) depending on the resolution
@@ -109,6 +143,13 @@ public:
                               std::set<ElementIndex>& raclInd) const;
     unsigned long GetElements(const Base::Vector3f& rclPoint,
                               std::vector<ElementIndex>& aulFacets) const;
+    /** Returns the indices of the elements in the given grid without copying them. */
+    MeshGridCell GetCell(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+    {
+        std::size_t id = (std::size_t(ulZ) * _ulCtGridsY + ulY) * _ulCtGridsX + ulX;
+        const ElementIndex* data = _aulGridElements.data();
+        return {data + _aulGridOffsets[id], data + _aulGridOffsets[id + 1]};
+    }
     //@}
 
     /** Returns the lengths of the grid elements in x,y and z direction. */
@@ -151,7 +192,7 @@ public:
     /** Returns the number of elements in a given grid. */
     unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
     {
-        return static_cast<unsigned long>(_aulGrid[ulX][ulY][ulZ].size());
+        return static_cast<unsigned long>(GetCell(ulX, ulY, ulZ).size());
     }
     /** Validates the grid structure and rebuilds it if needed. Must be implemented in sub-classes.
      */
@@ -192,11 +233,19 @@ protected:
     virtual void RebuildGrid() = 0;
     /** Returns the number of stored elements. Must be implemented in sub-classes. */
     virtual unsigned long HasElements() const = 0;
+    /** Fills the grid structure with \a ulCtElements elements. For each element index \a
+     * cellsOf must append the indices (see GetIndexToPosition()) of the grid elements the element
+     * belongs to, each of them once. \a cellsOf is called from several threads at the same time.
+     */
+    void FillGrid(ElementIndex ulCtElements,
+                  const std::function<void(ElementIndex, std::vector<unsigned long>&)>& cellsOf);
 
 protected:
     // NOLINTBEGIN
-    std::vector<std::vector<std::vector<std::set<ElementIndex>>>>
-        _aulGrid;                /**< Grid data structure. */
+    /** Grid data structure: the elements of the grid with index i (see GetIndexToPosition())
+     * are stored in _aulGridElements from _aulGridOffsets[i] to _aulGridOffsets[i+1]. */
+    std::vector<std::size_t> _aulGridOffsets;
+    std::vector<ElementIndex> _aulGridElements;
     const MeshKernel* _pclMesh;  /**< The mesh kernel. */
     unsigned long _ulCtElements; /**< Number of grid elements for validation issues. */
     unsigned long _ulCtGridsX;   /**< Number of grid elements in z. */
@@ -284,11 +333,11 @@ protected:
                              unsigned long& rulX,
                              unsigned long& rulY,
                              unsigned long& rulZ) const;
-    /** Adds a new facet element to the grid structure. \a rclFacet is the geometric facet and \a
-     * ulFacetIndex the corresponding index in the mesh kernel. The facet is added to each grid
-     * element that intersects the facet. */
-    inline void
-    AddFacet(const MeshGeomFacet& rclFacet, ElementIndex ulFacetIndex, float fEpsilon = 0.0F);
+    /** Appends the indices of all grid elements that intersect the facet \a rclFacet to \a
+     * raulCells. */
+    inline void AddFacet(const MeshGeomFacet& rclFacet,
+                         std::vector<unsigned long>& raulCells,
+                         float fEpsilon = 0.0F) const;
     /** Returns the number of stored elements. */
     unsigned long HasElements() const override
     {
@@ -336,9 +385,11 @@ public:
     bool Verify() const override;
 
 protected:
-    /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a
-     * ulPtIndex the corresponding index in the mesh kernel. */
-    void AddPoint(const MeshPoint& rclPt, ElementIndex ulPtIndex, float fEpsilon = 0.0F);
+    /** Appends the index of the grid element that contains the point \a rclPt to \a raulCells.
+     */
+    void AddPoint(const MeshPoint& rclPt,
+                  std::vector<unsigned long>& raulCells,
+                  float fEpsilon = 0.0F) const;
     /** Returns the grid numbers to the given point \a rclPoint. */
     void Pos(const Base::Vector3f& rclPoint,
              unsigned long& rulX,
@@ -370,9 +421,8 @@ public:
     /** Returns indices of the elements in the current grid. */
     void GetElements(std::vector<ElementIndex>& raulElements) const
     {
-        raulElements.insert(raulElements.end(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(),
-                            _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+        MeshGridCell cell = _rclGrid.GetCell(_ulX, _ulY, _ulZ);
+        raulElements.insert(raulElements.end(), cell.begin(), cell.end());
     }
     /** Returns the number of elements in the current grid. */
     unsigned long GetCtElements() const
@@ -561,8 +611,8 @@ inline void MeshFacetGrid::PosWithCheck(const Base::Vector3f& rclPoint,
 }
 
 inline void MeshFacetGrid::AddFacet(const MeshGeomFacet& rclFacet,
-                                    ElementIndex ulFacetIndex,
-                                    float /*fEpsilon*/)
+                                    std::vector<unsigned long>& raulCells,
+                                    float /*fEpsilon*/) const
 {
     unsigned long ulX {};
     unsigned long ulY {};
@@ -604,14 +654,14 @@ inline void MeshFacetGrid::AddFacet(const MeshGeomFacet& rclFacet,
             for (ulY = ulY1; ulY <= ulY2; ulY++) {
                 for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
                     if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ))) {
-                        _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+                        raulCells.push_back(GetIndexToPosition(ulX, ulY, ulZ));
                     }
                 }
             }
         }
     }
     else {
-        _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
+        raulCells.push_back(GetIndexToPosition(ulX1, ulY1, ulZ1));
     }
 }
 
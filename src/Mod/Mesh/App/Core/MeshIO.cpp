@@ -24,12 +24,18 @@
 
 #ifndef _PreComp_
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <future>
 #include <iomanip>
 #include <sstream>
 #include <string_view>
+#include <thread>
 #endif
 
+#include <QFile>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/convert.hpp>
 #include <boost/convert/spirit.hpp>
@@ -49,6 +55,7 @@
 #include <Base/Reader.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Swap.h>
 #include <Base/Tools.h>
 #include <Base/Writer.h>
 #include <zipios++/gzipoutputstream.h>
@@ -210,7 +217,7 @@ bool MeshInput::LoadAny(const char* FileName)
         // read file
         bool ok = false;
         if (fi.hasExtension({"stl", "ast"})) {
-            ok = LoadSTL(str);
+            ok = LoadMappedBinarySTL(FileName) || LoadSTL(str);
         }
         else if (fi.hasExtension("iv")) {
             ok = LoadInventor(str);
@@ -649,6 +656,65 @@ struct Property
         return x.first == y;
     }
 };
+
+std::size_t sizeOf(Number type)
+{
+    switch (type) {
+        case int8:
+        case uint8:
+            return 1;
+        case int16:
+        case uint16:
+            return 2;
+        case int32:
+        case uint32:
+        case float32:
+            return 4;
+        case float64:
+            return 8;
+    }
+    return 0;
+}
+
+template<typename T>
+float toFloat(const char* data, bool swap)
+{
+    char bytes[sizeof(T)];
+    if (swap) {
+        std::reverse_copy(data, data + sizeof(T), bytes);
+    }
+    else {
+        std::copy(data, data + sizeof(T), bytes);
+    }
+    T value {};
+    std::memcpy(&value, bytes, sizeof(T));
+    return static_cast<float>(value);
+}
+
+/** Converts the binary value of the given type to float. If \a swap is true the value is
+ * stored in the other byte order. */
+float toFloat(const char* data, Number type, bool swap)
+{
+    switch (type) {
+        case int8:
+            return toFloat<int8_t>(data, swap);
+        case uint8:
+            return toFloat<uint8_t>(data, swap);
+        case int16:
+            return toFloat<int16_t>(data, swap);
+        case uint16:
+            return toFloat<uint16_t>(data, swap);
+        case int32:
+            return toFloat<int32_t>(data, swap);
+        case uint32:
+            return toFloat<uint32_t>(data, swap);
+        case float32:
+            return toFloat<float>(data, swap);
+        case float64:
+            return toFloat<double>(data, swap);
+    }
+    return 0.0F;
+}
 }  // namespace Ply
 using namespace Ply;
 }  // namespace MeshCore
@@ -1003,67 +1069,76 @@ bool MeshInput::LoadPLY(std::istream& inp)
             is.setByteOrder(Base::Stream::BigEndian);
         }
 
-        for (std::size_t i = 0; i < v_count; i++) {
-            // go through the vertex properties
-            std::map<std::string, float> prop_values;
-            for (const auto& it : vertex_props) {
-                switch (it.second) {
-                    case int8: {
-                        int8_t v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    case uint8: {
-                        uint8_t v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    case int16: {
-                        int16_t v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    case uint16: {
-                        uint16_t v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    case int32: {
-                        int32_t v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    case uint32: {
-                        uint32_t v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    case float32: {
-                        float v {};
-                        is >> v;
-                        prop_values[it.first] = v;
-                    } break;
-                    case float64: {
-                        double v {};
-                        is >> v;
-                        prop_values[it.first] = static_cast<float>(v);
-                    } break;
-                    default:
-                        return false;
-                }
+        // All vertex properties are scalars, so the vertices have a fixed size. They are read
+        // block-wise and converted on all cores.
+        std::vector<std::size_t> offsets;
+        std::size_t vertex_size = 0;
+        for (const auto& it : vertex_props) {
+            offsets.push_back(vertex_size);
+            vertex_size += sizeOf(it.second);
+        }
+        auto column = [&vertex_props](const char* name) {
+            auto it = std::find_if(vertex_props.begin(),
+                                   vertex_props.end(),
+                                   [name](const std::pair<std::string, Ply::Number>& prop) {
+                                       return prop.first == name;
+                                   });
+            return static_cast<std::size_t>(it - vertex_props.begin());
+        };
+        std::array<std::size_t, 6> columns {column("x"),
+                                            column("y"),
+                                            column("z"),
+                                            column("red"),
+                                            column("green"),
+                                            column("blue")};
+        // swap the values if the file and the machine differ in byte order
+        bool swap = (format == binary_little_endian) != (Base::SwapOrder() == LOW_ENDIAN);
+        bool colors = _material && (rgb_value == MeshIO::PER_VERTEX);
+        auto value = [&](const char* vertex, int index) {
+            std::size_t col = columns[index];
+            if (col >= vertex_props.size()) {
+                return 0.0F;  // a missing property counts as zero
             }
+            return toFloat(vertex + offsets[col], vertex_props[col].second, swap);
+        };
 
-            Base::Vector3f pt;
-            pt.x = (prop_values["x"]);
-            pt.y = (prop_values["y"]);
-            pt.z = (prop_values["z"]);
-            meshPoints.push_back(pt);
+        meshPoints.resize(v_count);
+        if (colors) {
+            _material->diffuseColor.resize(v_count);
+        }
 
-            if (_material && (rgb_value == MeshIO::PER_VERTEX)) {
-                float r = (prop_values["red"]) / 255.0f;
-                float g = (prop_values["green"]) / 255.0f;
-                float b = (prop_values["blue"]) / 255.0f;
-                _material->diffuseColor.emplace_back(r, g, b);
+        const std::size_t block_count = 0x100000;
+        std::vector<char> block;
+        for (std::size_t first = 0; first < v_count; first += block_count) {
+            std::size_t count = std::min(block_count, v_count - first);
+            block.resize(count * vertex_size);
+            if (!inp.read(block.data(), static_cast<std::streamsize>(block.size()))) {
+                return false;
+            }
+
+            auto convert = [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    const char* vertex = block.data() + i * vertex_size;
+                    meshPoints[first + i].Set(value(vertex, 0), value(vertex, 1), value(vertex, 2));
+                    if (colors) {
+                        _material->diffuseColor[first + i].set(value(vertex, 3) / 255.0F,
+                                                               value(vertex, 4) / 255.0F,
+                                                               value(vertex, 5) / 255.0F);
+                    }
+                }
+            };
+
+            std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            std::vector<std::future<void>> futures;
+            for (std::size_t t = 1; t < threads; t++) {
+                futures.push_back(std::async(std::launch::async,
+                                             convert,
+                                             count * t / threads,
+                                             count * (t + 1) / threads));
+            }
+            convert(0, count / threads);
+            for (auto& future : futures) {
+                future.get();
             }
         }
 
@@ -1332,6 +1407,89 @@ bool MeshInput::LoadBinarySTL(std::istream& rstrIn)
     return true;
 }
 
+/** Loads a binary STL file by mapping it into memory. The facets are decoded by several threads.
+ * If the file cannot be mapped or isn't a binary STL file false is returned. The counts and floats
+ * are read as they are stored, in little endian, so false is also returned on big endian machines.
+ */
+bool MeshInput::LoadMappedBinarySTL(const char* FileName)
+{
+    const qint64 headerSize = 80 + sizeof(uint32_t);
+    const qint64 facetSize = 50;
+
+    if (Base::SwapOrder() != LOW_ENDIAN) {
+        return false;
+    }
+
+    QFile file(QString::fromUtf8(FileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    if (fileSize < headerSize + facetSize) {
+        return false;
+    }
+
+    const uchar* data = file.map(0, fileSize);
+    if (!data) {
+        return false;
+    }
+
+    uint32_t ulCt {};
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+
+    // same check for keywords of an ASCII file as in LoadSTL()
+    std::size_t ulBytes = 50;
+    if (ulCt > 1 && fileSize >= headerSize + 100) {
+        ulBytes = 100;
+    }
+    std::string header(reinterpret_cast<const char*>(data) + headerSize, ulBytes);
+    header.resize(std::strlen(header.c_str()));
+    boost::algorithm::to_upper(header);
+    for (const char* keyword : {"SOLID", "FACET", "NORMAL", "VERTEX", "ENDFACET", "ENDLOOP"}) {
+        if (header.find(keyword) != std::string::npos) {
+            file.unmap(const_cast<uchar*>(data));
+            return false;
+        }
+    }
+
+    // compare the calculated with the read value
+    if (ulCt == 0 || ulCt > (fileSize - headerSize) / facetSize) {
+        file.unmap(const_cast<uchar*>(data));
+        return false;
+    }
+
+    MeshFastBuilder builder(this->_rclMesh);
+    builder.Resize(ulCt);
+
+    const uchar* facets = data + headerSize;
+    auto readFacets = [&builder, facets](std::size_t first, std::size_t last) {
+        Base::Vector3f clVects[4];
+        for (std::size_t i = first; i < last; i++) {
+            // normal and points, the 2 bytes attribute are skipped
+            std::memcpy(&clVects, facets + i * facetSize, sizeof(clVects));
+            std::swap(clVects[0], clVects[3]);
+            builder.SetFacet(i, clVects);
+        }
+    };
+
+    std::size_t numThreads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    std::size_t chunkSize = (ulCt + numThreads - 1) / numThreads;
+    std::vector<std::future<void>> futures;
+    for (std::size_t first = 0; first < ulCt; first += chunkSize) {
+        std::size_t last = std::min<std::size_t>(first + chunkSize, ulCt);
+        futures.push_back(std::async(std::launch::async, readFacets, first, last));
+    }
+    for (auto& it : futures) {
+        it.get();
+    }
+
+    file.unmap(const_cast<uchar*>(data));
+    builder.Finish();
+
+    return true;
+}
+
 /** Loads the mesh object from an XML file. */
 void MeshInput::LoadXML(Base::XMLReader& reader)
 {
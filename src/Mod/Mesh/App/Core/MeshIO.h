@@ -131,6 +131,10 @@ public:
     bool LoadAsciiSTL(std::istream& rstrIn);
     /** Loads a binary STL file. */
     bool LoadBinarySTL(std::istream& rstrIn);
+    /** Loads a binary STL file by mapping it into memory and decoding the facets in parallel.
+     * Returns false if the file cannot be mapped or is not a binary STL file.
+     */
+    bool LoadMappedBinarySTL(const char* FileName);
     /** Loads an OBJ Mesh file. */
     bool LoadOBJ(std::istream& rstrIn);
     /** Loads an OBJ Mesh file. */
@@ -56,7 +56,7 @@ MeshKernel::MeshKernel(const MeshKernel& rclMesh)
 
 MeshKernel::MeshKernel(MeshKernel&& rclMesh)
 {
-    *this = rclMesh;
+    *this = std::move(rclMesh);
 }
 
 MeshKernel& MeshKernel::operator=(const MeshKernel& rclMesh)
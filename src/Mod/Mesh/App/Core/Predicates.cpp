@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <cmath>
+#include <limits>
+#include <vector>
+#endif
+
+#include "Predicates.h"
+
+
+using namespace MeshCore;
+
+namespace
+{
+// An expansion is a sum of non-overlapping doubles ordered by increasing magnitude
+using Expansion = std::vector<double>;
+
+const double epsilon = std::numeric_limits<double>::epsilon() / 2.0;
+const double orient2dBound = (3.0 + 16.0 * epsilon) * epsilon;
+const double orient3dBound = (7.0 + 56.0 * epsilon) * epsilon;
+
+void twoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bvirt = x - a;
+    double avirt = x - bvirt;
+    y = (a - avirt) + (b - bvirt);
+}
+
+void twoProduct(double a, double b, double& x, double& y)
+{
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+Expansion difference(double a, double b)
+{
+    double x {}, y {};
+    twoSum(a, -b, x, y);
+    return {y, x};
+}
+
+Expansion sum(const Expansion& e, const Expansion& f)
+{
+    // Shewchuk's EXPANSION-SUM, every component of f is added to the growing result
+    Expansion h(e);
+    for (double b : f) {
+        double q = b;
+        for (double& component : h) {
+            double x {}, y {};
+            twoSum(q, component, x, y);
+            component = y;
+            q = x;
+        }
+        h.push_back(q);
+    }
+    return h;
+}
+
+Expansion scale(const Expansion& e, double b)
+{
+    // Shewchuk's SCALE-EXPANSION
+    Expansion h;
+    if (e.empty()) {
+        return h;
+    }
+    h.reserve(2 * e.size());
+    double q {}, low {};
+    twoProduct(e[0], b, q, low);
+    h.push_back(low);
+    for (std::size_t i = 1; i < e.size(); i++) {
+        double product {}, productLow {};
+        twoProduct(e[i], b, product, productLow);
+        double sum {}, sumLow {};
+        twoSum(q, productLow, sum, sumLow);
+        h.push_back(sumLow);
+        double x {}, y {};
+        twoSum(product, sum, x, y);
+        h.push_back(y);
+        q = x;
+    }
+    h.push_back(q);
+    return h;
+}
+
+Expansion product(const Expansion& e, const Expansion& f)
+{
+    Expansion h;
+    for (double b : f) {
+        h = sum(h, scale(e, b));
+    }
+    return h;
+}
+
+Expansion negate(Expansion e)
+{
+    for (double& component : e) {
+        component = -component;
+    }
+    return e;
+}
+
+double sign(const Expansion& e)
+{
+    // the component of the largest magnitude determines the sign
+    for (auto it = e.rbegin(); it != e.rend(); ++it) {
+        if (*it != 0.0) {
+            return *it;
+        }
+    }
+    return 0.0;
+}
+
+// The determinant |a b; c d| of expansions
+Expansion det2(const Expansion& a, const Expansion& b, const Expansion& c, const Expansion& d)
+{
+    return sum(product(a, d), negate(product(b, c)));
+}
+}  // namespace
+
+double Predicates::orient2d(const Base::Vector3d& a,
+                            const Base::Vector3d& b,
+                            const Base::Vector3d& c,
+                            int axis)
+{
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    double detLeft = (a[u] - c[u]) * (b[v] - c[v]);
+    double detRight = (a[v] - c[v]) * (b[u] - c[u]);
+    double det = detLeft - detRight;
+    double bound = orient2dBound * (std::fabs(detLeft) + std::fabs(detRight));
+    if (det > bound || -det > bound) {
+        return det;
+    }
+
+    Expansion acu = difference(a[u], c[u]);
+    Expansion acv = difference(a[v], c[v]);
+    Expansion bcu = difference(b[u], c[u]);
+    Expansion bcv = difference(b[v], c[v]);
+    return sign(det2(acu, acv, bcu, bcv));
+}
+
+double Predicates::cross(const Base::Vector3d& a1,
+                         const Base::Vector3d& a2,
+                         const Base::Vector3d& b1,
+                         const Base::Vector3d& b2,
+                         int axis)
+{
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    double detLeft = (a2[u] - a1[u]) * (b2[v] - b1[v]);
+    double detRight = (a2[v] - a1[v]) * (b2[u] - b1[u]);
+    double det = detLeft - detRight;
+    double bound = orient2dBound * (std::fabs(detLeft) + std::fabs(detRight));
+    if (det > bound || -det > bound) {
+        return det;
+    }
+
+    Expansion au = difference(a2[u], a1[u]);
+    Expansion av = difference(a2[v], a1[v]);
+    Expansion bu = difference(b2[u], b1[u]);
+    Expansion bv = difference(b2[v], b1[v]);
+    return sign(det2(au, av, bu, bv));
+}
+
+double Predicates::orient3d(const Base::Vector3d& a,
+                            const Base::Vector3d& b,
+                            const Base::Vector3d& c,
+                            const Base::Vector3d& d)
+{
+    double adx = a.x - d.x, bdx = b.x - d.x, cdx = c.x - d.x;
+    double ady = a.y - d.y, bdy = b.y - d.y, cdy = c.y - d.y;
+    double adz = a.z - d.z, bdz = b.z - d.z, cdz = c.z - d.z;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+        + (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+        + (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+    double bound = orient3dBound * permanent;
+    if (det > bound || -det > bound) {
+        return det;
+    }
+
+    Expansion eadx = difference(a.x, d.x), ebdx = difference(b.x, d.x), ecdx = difference(c.x, d.x);
+    Expansion eady = difference(a.y, d.y), ebdy = difference(b.y, d.y), ecdy = difference(c.y, d.y);
+    Expansion eadz = difference(a.z, d.z), ebdz = difference(b.z, d.z), ecdz = difference(c.z, d.z);
+    Expansion result = product(eadz, det2(ebdx, ebdy, ecdx, ecdy));
+    result = sum(result, product(ebdz, det2(ecdx, ecdy, eadx, eady)));
+    result = sum(result, product(ecdz, det2(eadx, eady, ebdx, ebdy)));
+    return sign(result);
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef MESH_PREDICATES_H
+#define MESH_PREDICATES_H
+
+#include <Base/Vector3D.h>
+#include <Mod/Mesh/MeshGlobal.h>
+
+
+namespace MeshCore
+{
+
+/**
+ * Adaptive precision geometric predicates. The sign of the result is always correct: the value is
+ * first computed in floating point and, only if its error bound doesn't exclude a wrong sign,
+ * computed again with exact expansion arithmetic (J. R. Shewchuk, Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates).
+ */
+namespace Predicates
+{
+
+/** Returns a positive value if \a a, \a b and \a c are in counterclockwise order when looking
+ * along the \a axis coordinate axis (the points are projected onto the plane of the two other
+ * coordinates), a negative value if they are in clockwise order and zero if they are collinear.
+ */
+MeshExport double
+orient2d(const Base::Vector3d& a, const Base::Vector3d& b, const Base::Vector3d& c, int axis);
+
+/** Returns the \a axis coordinate of the cross product (\a a2 - \a a1) x (\a b2 - \a b1). */
+MeshExport double cross(const Base::Vector3d& a1,
+                        const Base::Vector3d& a2,
+                        const Base::Vector3d& b1,
+                        const Base::Vector3d& b2,
+                        int axis);
+
+/** Returns a positive value if \a d lies below the plane through \a a, \a b and \a c, i.e. \a a,
+ * \a b and \a c appear in counterclockwise order when viewed from above the plane, a negative
+ * value if it lies above and zero if the four points are coplanar.
+ */
+MeshExport double orient3d(const Base::Vector3d& a,
+                           const Base::Vector3d& b,
+                           const Base::Vector3d& c,
+                           const Base::Vector3d& d);
+
+}  // namespace Predicates
+
+}  // namespace MeshCore
+
+#endif  // MESH_PREDICATES_H
@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <algorithm>
 #include <fstream>
 #include <ios>
 #endif
@@ -637,104 +638,54 @@ void MeshIntersection::getIntersection(std::list<MeshIntersection::Tuple>& intsc
     const MeshKernel& k1 = kernel1;
     const MeshKernel& k2 = kernel2;
 
-    // Contains bounding boxes for every facet of 'k1'
-    std::vector<Base::BoundBox3f> boxes1;
-    MeshFacetIterator cMFI1(k1);
-    for (cMFI1.Begin(); cMFI1.More(); cMFI1.Next()) {
-        boxes1.push_back((*cMFI1).GetBoundBox());
-    }
+    // Splits the meshes using bounding volume hierarchies for speeding up the calculation
+    MeshFacetBVH bvh1(k1);
+    MeshFacetBVH bvh2(k2);
 
-    // Contains bounding boxes for every facet of 'k2'
-    std::vector<Base::BoundBox3f> boxes2;
-    MeshFacetIterator cMFI2(k2);
-    for (cMFI2.Begin(); cMFI2.More(); cMFI2.Next()) {
-        boxes2.push_back((*cMFI2).GetBoundBox());
-    }
+    Base::SequencerLauncher seq("Checking for intersections...", 0);
+    std::vector<MeshFacetBVH::FacetPair> pairs =
+        bvh1.FindPairs(bvh2, isIntersecting(k1, k2), false, &seq);
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(k1);
+    // keep the order of the facets of the 2nd mesh
+    std::stable_sort(pairs.begin(),
+                     pairs.end(),
+                     [](const MeshFacetBVH::FacetPair& p1, const MeshFacetBVH::FacetPair& p2) {
+                         return p1.second < p2.second;
+                     });
 
-    const MeshFacetArray& rFaces2 = k2.GetFacets();
-    Base::SequencerLauncher seq("Checking for intersections...", rFaces2.size());
-    int index = 0;
-    MeshGeomFacet facet1, facet2;
     Base::Vector3f pt1, pt2;
-
-    // Iterate over the facets of the 2nd mesh and find the grid elements of the 1st mesh
-    for (MeshFacetArray::_TConstIterator it = rFaces2.begin(); it != rFaces2.end(); ++it, index++) {
-        seq.next();
-        std::vector<FacetIndex> elements;
-        cMeshFacetGrid.Inside(boxes2[index], elements, true);
-
-        cMFI2.Set(index);
-        facet2 = *cMFI2;
-
-        for (FacetIndex element : elements) {
-            if (boxes2[index] && boxes1[element]) {
-                cMFI1.Set(element);
-                facet1 = *cMFI1;
-                int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                if (ret == 2) {
-                    Tuple d;
-                    d.p1 = pt1;
-                    d.p2 = pt2;
-                    d.f1 = element;
-                    d.f2 = index;
-                    intsct.push_back(d);
-                }
-            }
-        }
+    for (const auto& it : pairs) {
+        MeshGeomFacet facet1 = k1.GetFacet(it.first);
+        MeshGeomFacet facet2 = k2.GetFacet(it.second);
+        facet1.IntersectWithFacet(facet2, pt1, pt2);
+        Tuple d;
+        d.p1 = pt1;
+        d.p2 = pt2;
+        d.f1 = it.first;
+        d.f2 = it.second;
+        intsct.push_back(d);
     }
 }
 
 bool MeshIntersection::testIntersection(const MeshKernel& k1, const MeshKernel& k2)
 {
-    // Contains bounding boxes for every facet of 'k1'
-    std::vector<Base::BoundBox3f> boxes1;
-    MeshFacetIterator cMFI1(k1);
-    for (cMFI1.Begin(); cMFI1.More(); cMFI1.Next()) {
-        boxes1.push_back((*cMFI1).GetBoundBox());
-    }
-
-    // Contains bounding boxes for every facet of 'k2'
-    std::vector<Base::BoundBox3f> boxes2;
-    MeshFacetIterator cMFI2(k2);
-    for (cMFI2.Begin(); cMFI2.More(); cMFI2.Next()) {
-        boxes2.push_back((*cMFI2).GetBoundBox());
-    }
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(k1);
+    // Splits the meshes using bounding volume hierarchies for speeding up the calculation
+    MeshFacetBVH bvh1(k1);
+    MeshFacetBVH bvh2(k2);
 
-    const MeshFacetArray& rFaces2 = k2.GetFacets();
-    Base::SequencerLauncher seq("Checking for intersections...", rFaces2.size());
-    int index = 0;
-    MeshGeomFacet facet1, facet2;
-    Base::Vector3f pt1, pt2;
-
-    // Iterate over the facets of the 2nd mesh and find the grid elements of the 1st mesh
-    for (MeshFacetArray::_TConstIterator it = rFaces2.begin(); it != rFaces2.end(); ++it, index++) {
-        seq.next();
-        std::vector<FacetIndex> elements;
-        cMeshFacetGrid.Inside(boxes2[index], elements, true);
-
-        cMFI2.Set(index);
-        facet2 = *cMFI2;
-
-        for (FacetIndex element : elements) {
-            if (boxes2[index] && boxes1[element]) {
-                cMFI1.Set(element);
-                facet1 = *cMFI1;
-                int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                if (ret == 2) {
-                    // abort after the first detected self-intersection
-                    return true;
-                }
-            }
-        }
-    }
+    // abort after the first detected intersection
+    return !bvh1.FindPairs(bvh2, isIntersecting(k1, k2), true).empty();
+}
 
-    return false;
+MeshFacetBVH::PairFilter MeshIntersection::isIntersecting(const MeshKernel& k1,
+                                                          const MeshKernel& k2)
+{
+    return [&k1, &k2](FacetIndex index1, FacetIndex index2) {
+        Base::Vector3f pt1, pt2;
+        MeshGeomFacet facet1 = k1.GetFacet(index1);
+        MeshGeomFacet facet2 = k2.GetFacet(index2);
+        return facet1.IntersectWithFacet(facet2, pt1, pt2) == 2;
+    };
 }
 
 void MeshIntersection::connectLines(bool onlyclosed,
@@ -29,6 +29,7 @@
 
 #include <Base/Builder3D.h>
 
+#include "BVH.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
 #include "Visitor.h"
@@ -233,6 +234,7 @@ public:
 
 private:
     static bool testIntersection(const MeshKernel& k1, const MeshKernel& k2);
+    static MeshFacetBVH::PairFilter isIntersecting(const MeshKernel& k1, const MeshKernel& k2);
 
 private:
     const MeshKernel& kernel1;
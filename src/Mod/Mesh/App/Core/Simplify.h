@@ -10,6 +10,10 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add locked vertices that are neither moved nor removed
+// * Add feature vertices that are handled like border vertices
+// * Keep the id and the flags of the vertices in compact_mesh()
+// * Track the largest error of all collapses in max_error
 
 #include <vector>
 
@@ -85,11 +89,12 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int feature,locked;int id; };
     struct Ref { int tid,tvertex; };
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
     std::vector<Ref> refs;
+    double max_error = 0;
 
     void simplify_mesh(int target_count, double tolerance, double aggressiveness=7);
 
@@ -198,10 +203,12 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     // Border check
                     if (v0.border != v1.border)
                         continue;
+                    if (v0.locked || v1.locked)
+                        continue;
 
                     // Compute vertex to collapse to
                     vec3f p;
-                    calculate_error(i0,i1,p);
+                    double error = calculate_error(i0,i1,p);
 
                     deleted0.resize(v0.tcount); // normals temporarily
                     deleted1.resize(v1.tcount); // normals temporarily
@@ -213,6 +220,7 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                         continue;
 
                     // not flipped, so remove edge
+                    max_error=std::max(max_error,error);
                     v0.p=p;
                     v0.q=v1.q+v0.q;
                     int tstart=refs.size();
@@ -412,7 +420,7 @@ void Simplify::update_mesh(int iteration)
         std::vector<int> vcount,vids;
 
         for (std::size_t i=0;i<vertices.size();++i)
-            vertices[i].border=0;
+            vertices[i].border=vertices[i].feature;
 
         for (std::size_t i=0;i<vertices.size();++i)
         {
@@ -479,6 +487,9 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].feature=vertices[i].feature;
+            vertices[dst].locked=vertices[i].locked;
+            vertices[dst].id=vertices[i].id;
             dst++;
         }
     }
@@ -22,10 +22,18 @@
 
 #include "PreCompiled.h"
 
+#ifndef _PreComp_
+#include <algorithm>
+#endif
+
 #include <Base/Tools.h>
 
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
 #include "Smoothing.h"
@@ -33,6 +41,12 @@
 
 using namespace MeshCore;
 
+namespace
+{
+// meshes with fewer points are smoothed by the calling thread only
+const std::size_t minParallelSize = 10000;
+}  // namespace
+
 
 AbstractSmoothing::AbstractSmoothing(MeshKernel& m)
     : kernel(m)
@@ -162,133 +176,259 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations,
     }
 }
 
-LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
-    : AbstractSmoothing(m)
-{}
-
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it,
-                                double stepsize)
+LaplaceOperator::LaplaceOperator(const MeshKernel& kernel)
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it, v_beg = points.begin(), v_end = points.end();
-
-    PointIndex pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it, ++pos) {
-        const std::set<PointIndex>& cv = vv_it[pos];
-        if (cv.size() < 3) {
-            continue;
-        }
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
+    const MeshFacetArray& facets = kernel.GetFacets();
+    std::size_t numPoints = kernel.CountPoints();
+
+    // Each facet adds its two other points to the row of a point, mostly twice
+    std::vector<std::size_t> numFacets(numPoints, 0);
+    for (const auto& facet : facets) {
+        for (PointIndex point : facet._aulPoints) {
+            numFacets[point]++;
         }
+    }
 
-        size_t n_count = cv.size();
-        double w {};
-        w = 1.0 / double(n_count);
+    rowStart.resize(numPoints + 1, 0);
+    for (std::size_t index = 0; index < numPoints; index++) {
+        rowStart[index + 1] = rowStart[index] + 2 * numFacets[index];
+    }
+    columns.resize(rowStart.back());
+    std::vector<std::size_t> rowEnd(rowStart.begin(), rowStart.end() - 1);
+    for (const auto& facet : facets) {
+        for (int side = 0; side < 3; side++) {
+            PointIndex point = facet._aulPoints[side];
+            columns[rowEnd[point]++] = facet._aulPoints[(side + 1) % 3];
+            columns[rowEnd[point]++] = facet._aulPoints[(side + 2) % 3];
+        }
+    }
 
-        double delx = 0.0, dely = 0.0, delz = 0.0;
-        std::set<PointIndex>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
-            delx += w * static_cast<double>((v_beg[*cv_it]).x - v_it->x);
-            dely += w * static_cast<double>((v_beg[*cv_it]).y - v_it->y);
-            delz += w * static_cast<double>((v_beg[*cv_it]).z - v_it->z);
+    // Remove the duplicates of each row. Like MeshRefPointToPoints a point is inside the
+    // mesh if it has as many neighbour points as adjacent facets.
+    movable.resize(numPoints, 0);
+    parallel_for(numPoints,
+                 minParallelSize,
+                 [this, &numFacets, &rowEnd](std::size_t begin, std::size_t end) {
+                     for (std::size_t index = begin; index < end; index++) {
+                         auto first = columns.begin() + std::ptrdiff_t(rowStart[index]);
+                         auto last = columns.begin() + std::ptrdiff_t(rowEnd[index]);
+                         std::sort(first, last);
+                         last = std::unique(first, last);
+                         std::size_t count = std::size_t(last - first);
+                         rowEnd[index] = rowStart[index] + count;
+                         movable[index] = count >= 3 && count == numFacets[index] ? 1 : 0;
+                     }
+                 });
+
+    std::size_t size = 0;
+    for (std::size_t index = 0; index < numPoints; index++) {
+        std::size_t first = rowStart[index];
+        rowStart[index] = size;
+        for (std::size_t pos = first; pos < rowEnd[index]; pos++) {
+            columns[size++] = columns[pos];
         }
+    }
+    rowStart[numPoints] = size;
+    columns.resize(size);
+    columns.shrink_to_fit();
+}
 
-        float x = static_cast<float>(static_cast<double>(v_it->x) + stepsize * delx);
-        float y = static_cast<float>(static_cast<double>(v_it->y) + stepsize * dely);
-        float z = static_cast<float>(static_cast<double>(v_it->z) + stepsize * delz);
-        kernel.SetPoint(pos, x, y, z);
+void LaplaceOperator::Restrict(const std::vector<PointIndex>& indices)
+{
+    std::vector<char> selected(movable.size(), 0);
+    for (PointIndex index : indices) {
+        selected[index] = movable[index];
     }
+    movable.swap(selected);
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it,
-                                double stepsize,
-                                const std::vector<PointIndex>& point_indices)
+void LaplaceOperator::Apply(double stepsize,
+                            const MeshPointArray& input,
+                            MeshPointArray& output) const
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
+    output.resize(input.size());
+    parallel_for(input.size(), minParallelSize, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            const MeshPoint& point = input[index];
+            output[index] = point;
+            if (!movable[index]) {
+                continue;
+            }
 
-    for (PointIndex it : point_indices) {
-        const std::set<PointIndex>& cv = vv_it[it];
-        if (cv.size() < 3) {
-            continue;
+            double w = 1.0 / double(rowStart[index + 1] - rowStart[index]);
+            double delx = 0.0, dely = 0.0, delz = 0.0;
+            for (std::size_t pos = rowStart[index]; pos < rowStart[index + 1]; pos++) {
+                const MeshPoint& neighbour = input[columns[pos]];
+                delx += w * static_cast<double>(neighbour.x - point.x);
+                dely += w * static_cast<double>(neighbour.y - point.y);
+                delz += w * static_cast<double>(neighbour.z - point.z);
+            }
+
+            output[index].x = static_cast<float>(static_cast<double>(point.x) + stepsize * delx);
+            output[index].y = static_cast<float>(static_cast<double>(point.y) + stepsize * dely);
+            output[index].z = static_cast<float>(static_cast<double>(point.z) + stepsize * delz);
         }
-        if (cv.size() != vf_it[it].size()) {
-            // do nothing for border points
+    });
+}
+
+bool LaplaceOperator::Solve(double stepsize,
+                            unsigned int iterations,
+                            MeshPointArray& points) const
+{
+    // Multiplied with the valence of the points the system (I - t * L) x' = x becomes
+    // ((1 + t) * D - t * A) x' = D * x with the symmetric positive definite matrix on the left.
+    // The fixed neighbours are moved to the right-hand side.
+    std::vector<Eigen::Index> unknown(points.size(), -1);
+    Eigen::Index numUnknowns = 0;
+    for (std::size_t index = 0; index < points.size(); index++) {
+        if (movable[index]) {
+            unknown[index] = numUnknowns++;
+        }
+    }
+    if (numUnknowns == 0) {
+        return true;
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(columns.size() + std::size_t(numUnknowns));
+    for (std::size_t index = 0; index < points.size(); index++) {
+        Eigen::Index row = unknown[index];
+        if (row < 0) {
             continue;
         }
+        auto valence = double(rowStart[index + 1] - rowStart[index]);
+        triplets.emplace_back(row, row, (1.0 + stepsize) * valence);
+        for (std::size_t pos = rowStart[index]; pos < rowStart[index + 1]; pos++) {
+            Eigen::Index col = unknown[columns[pos]];
+            if (col >= 0) {
+                triplets.emplace_back(row, col, -stepsize);
+            }
+        }
+    }
 
-        size_t n_count = cv.size();
-        double w {};
-        w = 1.0 / double(n_count);
+    Eigen::SparseMatrix<double> matrix(numUnknowns, numUnknowns);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(matrix);
+    if (solver.info() != Eigen::Success) {
+        return false;
+    }
 
-        double delx = 0.0, dely = 0.0, delz = 0.0;
-        std::set<PointIndex>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
-            delx += w * static_cast<double>((v_beg[*cv_it]).x - (v_beg[it]).x);
-            dely += w * static_cast<double>((v_beg[*cv_it]).y - (v_beg[it]).y);
-            delz += w * static_cast<double>((v_beg[*cv_it]).z - (v_beg[it]).z);
-        }
+    Eigen::MatrixX3d rhs(numUnknowns, 3);
+    for (unsigned int iter = 0; iter < iterations; iter++) {
+        parallel_for(points.size(), minParallelSize, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                Eigen::Index row = unknown[index];
+                if (row < 0) {
+                    continue;
+                }
+                auto valence = double(rowStart[index + 1] - rowStart[index]);
+                Eigen::Vector3d value(points[index].x, points[index].y, points[index].z);
+                value *= valence;
+                for (std::size_t pos = rowStart[index]; pos < rowStart[index + 1]; pos++) {
+                    const MeshPoint& neighbour = points[columns[pos]];
+                    if (unknown[columns[pos]] < 0) {
+                        value += stepsize * Eigen::Vector3d(neighbour.x, neighbour.y, neighbour.z);
+                    }
+                }
+                rhs.row(row) = value;
+            }
+        });
 
-        float x = static_cast<float>(static_cast<double>((v_beg[it]).x) + stepsize * delx);
-        float y = static_cast<float>(static_cast<double>((v_beg[it]).y) + stepsize * dely);
-        float z = static_cast<float>(static_cast<double>((v_beg[it]).z) + stepsize * delz);
-        kernel.SetPoint(it, x, y, z);
+        Eigen::MatrixX3d solution = solver.solve(rhs);
+        if (solver.info() != Eigen::Success) {
+            return false;
+        }
+        for (std::size_t index = 0; index < points.size(); index++) {
+            Eigen::Index row = unknown[index];
+            if (row >= 0) {
+                points[index].Set(static_cast<float>(solution(row, 0)),
+                                  static_cast<float>(solution(row, 1)),
+                                  static_cast<float>(solution(row, 2)));
+            }
+        }
     }
+
+    return true;
 }
 
-void LaplaceSmoothing::Smooth(unsigned int iterations)
+LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
+    : AbstractSmoothing(m)
+{}
+
+void LaplaceSmoothing::Umbrella(const LaplaceOperator& laplace,
+                                double stepsize,
+                                MeshPointArray& points,
+                                MeshPointArray& buffer)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    laplace.Apply(stepsize, points, buffer);
+    points.swap(buffer);
+}
 
+void LaplaceSmoothing::Iterate(const LaplaceOperator& laplace,
+                               unsigned int iterations,
+                               MeshPointArray& points)
+{
+    MeshPointArray buffer;
     for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
+        Umbrella(laplace, lambda, points, buffer);
+    }
+}
+
+void LaplaceSmoothing::Run(const LaplaceOperator& laplace, unsigned int iterations)
+{
+    MeshPointArray points = kernel.GetPoints();
+    Iterate(laplace, iterations, points);
+    for (PointIndex index = 0; index < points.size(); index++) {
+        if (laplace.IsMovable(index)) {
+            kernel.SetPoint(index, points[index]);
+        }
     }
 }
 
+void LaplaceSmoothing::Smooth(unsigned int iterations)
+{
+    LaplaceOperator laplace(kernel);
+    Run(laplace, iterations);
+}
+
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations,
                                     const std::vector<PointIndex>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
-
-    for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
-    }
+    LaplaceOperator laplace(kernel);
+    laplace.Restrict(point_indices);
+    Run(laplace, iterations);
 }
 
 TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
     : LaplaceSmoothing(m)
 {}
 
-void TaubinSmoothing::Smooth(unsigned int iterations)
+void TaubinSmoothing::Iterate(const LaplaceOperator& laplace,
+                              unsigned int iterations,
+                              MeshPointArray& points)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshPointArray buffer;
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations + 1) / 2;  // two steps per iteration
     for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, GetLambda());
-        Umbrella(vv_it, vf_it, -(GetLambda() + micro));
+        Umbrella(laplace, GetLambda(), points, buffer);
+        Umbrella(laplace, -(GetLambda() + micro), points, buffer);
     }
 }
 
-void TaubinSmoothing::SmoothPoints(unsigned int iterations,
-                                   const std::vector<PointIndex>& point_indices)
-{
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+ImplicitLaplaceSmoothing::ImplicitLaplaceSmoothing(MeshKernel& m)
+    : LaplaceSmoothing(m)
+{}
 
-    // Theoretically Taubin does not shrink the surface
-    iterations = (iterations + 1) / 2;  // two steps per iteration
-    for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, GetLambda(), point_indices);
-        Umbrella(vv_it, vf_it, -(GetLambda() + micro), point_indices);
+void ImplicitLaplaceSmoothing::Iterate(const LaplaceOperator& laplace,
+                                       unsigned int iterations,
+                                       MeshPointArray& points)
+{
+    if (!laplace.Solve(GetLambda(), iterations, points)) {
+        // fall back to the explicit steps
+        points = kernel.GetPoints();
+        LaplaceSmoothing::Iterate(laplace, iterations, points);
     }
 }
 
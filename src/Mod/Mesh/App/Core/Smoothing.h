@@ -32,9 +32,43 @@
 namespace MeshCore
 {
 class MeshKernel;
-class MeshRefPointToPoints;
-class MeshRefPointToFacets;
+class MeshPointArray;
 class MeshRefFacetToFacets;
+class MeshRefPointToFacets;
+
+/**
+ * The uniform Laplace (umbrella) operator of a mesh, stored as a sparse matrix
+ * in compressed row format. It is built once and then applied to the points as
+ * often as needed. Border points and points with fewer than three neighbours
+ * are never moved.
+ */
+class MeshExport LaplaceOperator
+{
+public:
+    explicit LaplaceOperator(const MeshKernel&);
+
+    /** Fixes all points that are not in \a indices. */
+    void Restrict(const std::vector<PointIndex>& indices);
+    /** Computes \a output = \a input + \a stepsize * L(\a input). Large meshes
+     * are processed by several threads.
+     */
+    void Apply(double stepsize, const MeshPointArray& input, MeshPointArray& output) const;
+    /** Performs \a iterations backward Euler steps, i.e. solves
+     * (I - \a stepsize * L) x' = x for each of them. The matrix is factorized
+     * only once. Returns false if the factorization fails.
+     */
+    bool Solve(double stepsize, unsigned int iterations, MeshPointArray& points) const;
+    /** Returns true if the point can be moved. */
+    bool IsMovable(PointIndex index) const
+    {
+        return movable[index] != 0;
+    }
+
+private:
+    std::vector<std::size_t> rowStart;
+    std::vector<PointIndex> columns;
+    std::vector<char> movable;
+};
 
 /** Base class for smoothing algorithms. */
 class MeshExport AbstractSmoothing
@@ -107,13 +141,13 @@ public:
     }
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&, const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&,
-                  double,
-                  const std::vector<PointIndex>&);
+    /** Runs the iterations on a copy of the points. */
+    virtual void Iterate(const LaplaceOperator&, unsigned int, MeshPointArray&);
+    void Umbrella(const LaplaceOperator&, double, MeshPointArray&, MeshPointArray&);
 
 private:
+    void Run(const LaplaceOperator&, unsigned int);
+
     double lambda {0.6307};
 };
 
@@ -121,17 +155,32 @@ class MeshExport TaubinSmoothing: public LaplaceSmoothing
 {
 public:
     explicit TaubinSmoothing(MeshKernel&);
-    void Smooth(unsigned int) override;
-    void SmoothPoints(unsigned int, const std::vector<PointIndex>&) override;
     void SetMicro(double m)
     {
         micro = m;
     }
 
+protected:
+    void Iterate(const LaplaceOperator&, unsigned int, MeshPointArray&) override;
+
 private:
     double micro {0.0424};
 };
 
+/**
+ * Laplace smoothing with implicit (backward Euler) steps. Each step solves a
+ * sparse linear system, which keeps it stable for large values of lambda where
+ * the explicit steps of LaplaceSmoothing oscillate.
+ */
+class MeshExport ImplicitLaplaceSmoothing: public LaplaceSmoothing
+{
+public:
+    explicit ImplicitLaplaceSmoothing(MeshKernel&);
+
+protected:
+    void Iterate(const LaplaceOperator&, unsigned int, MeshPointArray&) override;
+};
+
 /*!
  * \brief The MedianFilterSmoothing class
  * Smoothing based on median filter from the paper:
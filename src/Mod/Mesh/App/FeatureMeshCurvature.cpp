@@ -57,11 +57,8 @@ App::DocumentObjectExecReturn* Curvature::execute()
         return new App::DocumentObjectExecReturn("No mesh object attached.");
     }
 
-    // get all points
-    const MeshCore::MeshKernel& rMesh = pcFeat->Mesh.getValue().getKernel();
-    MeshCore::MeshCurvature meshCurv(rMesh);
-    meshCurv.ComputePerVertex();
-    const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
+    // the source mesh keeps the result until it gets modified
+    const std::vector<MeshCore::CurvatureInfo>& curv = pcFeat->Mesh.getCurvature();
 
     std::vector<CurvatureInfo> values;
     values.reserve(curv.size());
@@ -86,10 +86,10 @@ MeshObject::MeshObject(const MeshObject& mesh)
 
 MeshObject::MeshObject(MeshObject&& mesh)
     : _Mtrx(mesh._Mtrx)
-    , _kernel(mesh._kernel)
+    , _kernel(std::move(mesh._kernel))
 {
-    // copy the mesh structure
-    copySegments(mesh);
+    // take over the mesh structure
+    swapSegments(mesh);
 }
 
 MeshObject::~MeshObject() = default;
@@ -230,10 +230,11 @@ MeshObject& MeshObject::operator=(const MeshObject& mesh)
 MeshObject& MeshObject::operator=(MeshObject&& mesh)
 {
     if (this != &mesh) {
-        // copy the mesh structure
+        // take over the mesh structure
         setTransform(mesh._Mtrx);
-        this->_kernel = mesh._kernel;
-        copySegments(mesh);
+        this->_kernel = std::move(mesh._kernel);
+        this->_segments.clear();
+        swapSegments(mesh);
     }
 
     return *this;
@@ -1092,6 +1093,16 @@ void MeshObject::decimate(int targetSize)
     dm.simplify(targetSize);
 }
 
+double MeshObject::decimate(int targetSize, float featureAngle, bool keepBoundary, int numThreads)
+{
+    MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setFeatureAngle(featureAngle);
+    dm.setKeepBoundary(keepBoundary);
+    dm.setNumThreads(numThreads);
+    dm.simplify(targetSize);
+    return dm.getMaxError();
+}
+
 Base::Vector3d MeshObject::getPointNormal(PointIndex index) const
 {
     std::vector<Base::Vector3f> temp = _kernel.CalcVertexNormals();
@@ -1301,6 +1312,19 @@ MeshObject* MeshObject::outer(const MeshObject& mesh) const
     return new MeshObject(result);
 }
 
+MeshObject* MeshObject::boolean(const MeshObject& mesh,
+                                MeshCore::MeshBoolean::Operation op) const
+{
+    MeshCore::MeshKernel result;
+    MeshCore::MeshKernel kernel1(this->_kernel);
+    kernel1.Transform(this->_Mtrx);
+    MeshCore::MeshKernel kernel2(mesh._kernel);
+    kernel2.Transform(mesh._Mtrx);
+    MeshCore::MeshBoolean boolOp(kernel1, kernel2, result, op);
+    boolOp.Do();
+    return new MeshObject(result);
+}
+
 std::vector<std::vector<Base::Vector3f>>
 MeshObject::section(const MeshObject& mesh, bool connectLines, float fMinDist) const
 {
@@ -1571,6 +1595,26 @@ MeshObject::getSelfIntersections(const MeshObject::TFacePairs& facets) const
     return lines;
 }
 
+void MeshObject::getSelfIntersections(MeshObject::TFacePairs& facets,
+                                      std::vector<Base::Line3d>& lines) const
+{
+    MeshCore::MeshEvalSelfIntersection eval(getKernel());
+    using Section = std::pair<Base::Vector3f, Base::Vector3f>;
+    std::vector<Section> selfPoints;
+    eval.GetIntersectionsAndLines(facets, selfPoints);
+
+    lines.reserve(lines.size() + selfPoints.size());
+
+    Base::Matrix4D mat(getTransform());
+    std::transform(selfPoints.begin(),
+                   selfPoints.end(),
+                   std::back_inserter(lines),
+                   [&mat](const Section& l) {
+                       return Base::Line3d(mat * Base::convertTo<Base::Vector3d>(l.first),
+                                           mat * Base::convertTo<Base::Vector3d>(l.second));
+                   });
+}
+
 void MeshObject::removeSelfIntersections()
 {
     std::vector<std::pair<FacetIndex, FacetIndex>> selfIntersections;
@@ -35,6 +35,7 @@
 #include <Base/Matrix.h>
 #include <Base/Tools3D.h>
 
+#include "Core/Boolean.h"
 #include "Core/Iterator.h"
 #include "Core/MeshIO.h"
 #include "Core/MeshKernel.h"
@@ -264,6 +265,10 @@ public:
     void smooth(int iterations, float d_max);
     void decimate(float fTolerance, float fReduction);
     void decimate(int targetSize);
+    /// Decimates the mesh to \a targetSize facets in parallel. The vertices of edges with a
+    /// dihedral angle above \a featureAngle (in radians) only move along these edges.
+    /// Returns an upper bound of the approximation error.
+    double decimate(int targetSize, float featureAngle, bool keepBoundary, int numThreads = 0);
     Base::Vector3d getPointNormal(PointIndex) const;
     std::vector<Base::Vector3d> getPointNormals() const;
     void crossSections(const std::vector<TPlane>&,
@@ -300,6 +305,8 @@ public:
     MeshObject* subtract(const MeshObject&) const;
     MeshObject* inner(const MeshObject&) const;
     MeshObject* outer(const MeshObject&) const;
+    /// Boolean operation with exact predicates, see MeshCore::MeshBoolean
+    MeshObject* boolean(const MeshObject&, MeshCore::MeshBoolean::Operation) const;
     std::vector<std::vector<Base::Vector3f>>
     section(const MeshObject&, bool connectLines, float fMinDist) const;
     //@}
@@ -342,6 +349,7 @@ public:
     bool hasSelfIntersections() const;
     TFacePairs getSelfIntersections() const;
     std::vector<Base::Line3d> getSelfIntersections(const TFacePairs&) const;
+    void getSelfIntersections(TFacePairs&, std::vector<Base::Line3d>&) const;
     void removeSelfIntersections();
     void removeSelfIntersections(const std::vector<FacetIndex>&);
     void removeFoldsOnSurface();
@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 
+#include <Base/Console.h>
 #include <Base/Converter.h>
 #include <Base/Exception.h>
 #include <Base/Reader.h>
@@ -29,6 +30,7 @@
 #include <Base/VectorPy.h>
 #include <Base/Writer.h>
 
+#include "Core/Curvature.h"
 #include "Core/Iterator.h"
 #include "Core/MeshKernel.h"
 #include "Core/MeshIO.h"
@@ -742,72 +744,98 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
 {
     // use the tmp. object to guarantee that the referenced mesh is not destroyed
     // before calling hasSetValue()
-    Base::Reference<MeshObject> tmp(_meshObject);
+    Base::Reference<MeshObject> tmp(_meshObject.get());
     aboutToSetValue();
-    _meshObject = mesh;
+    _deferred.reset();
+    _meshObject.reset(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
-    *_meshObject = mesh;
+    _deferred.reset();
+    // the whole content gets replaced, so copies may take it over
+    *_meshObject.detach(&mesh == _meshObject.get()) = mesh;
     hasSetValue();
 }
 
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
-    _meshObject->setKernel(mesh);
+    _deferred.reset();
+    // the kernel gets replaced, so copies may take it over
+    _meshObject.detach(&mesh == &_meshObject->getKernel())->setKernel(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
+    loadDeferred();
     aboutToSetValue();
-    _meshObject->swap(mesh);
+    // the caller gets the old content, so it must be kept
+    _meshObject.detach()->swap(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
+    loadDeferred();
     aboutToSetValue();
-    _meshObject->swap(mesh);
+    _meshObject.detach()->swap(mesh);
     hasSetValue();
 }
 
 const MeshObject& PropertyMeshKernel::getValue() const
 {
+    loadDeferred();
     return *_meshObject;
 }
 
 const MeshObject* PropertyMeshKernel::getValuePtr() const
 {
-    return static_cast<MeshObject*>(_meshObject);
+    loadDeferred();
+    return _meshObject.get();
 }
 
 const Data::ComplexGeoData* PropertyMeshKernel::getComplexData() const
 {
-    return static_cast<MeshObject*>(_meshObject);
+    loadDeferred();
+    return _meshObject.get();
 }
 
 Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 {
+    loadDeferred();
     return _meshObject->getBoundBox();
 }
 
 unsigned int PropertyMeshKernel::getMemSize() const
 {
     unsigned int size = 0;
-    size += _meshObject->getMemSize();
+    size += _meshObject->getMemSize() / static_cast<unsigned int>(_meshObject.useCount());
+    size += static_cast<unsigned int>(_deferred.getCompressedSize());
 
     return size;
 }
 
+const std::vector<MeshCore::CurvatureInfo>& PropertyMeshKernel::getCurvature() const
+{
+    loadDeferred();
+    if (!_curvature) {
+        MeshCore::MeshCurvature meshCurv(_meshObject->getKernel());
+        meshCurv.ComputePerVertex();
+        _curvature = std::make_shared<const std::vector<MeshCore::CurvatureInfo>>(
+            meshCurv.GetCurvature());
+    }
+    return *_curvature;
+}
+
 MeshObject* PropertyMeshKernel::startEditing()
 {
+    loadDeferred();
     aboutToSetValue();
-    return static_cast<MeshObject*>(_meshObject);
+    return _meshObject.detach();
 }
 
 void PropertyMeshKernel::finishEditing()
@@ -817,16 +845,18 @@ void PropertyMeshKernel::finishEditing()
 
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D& rclMat)
 {
+    loadDeferred();
     aboutToSetValue();
-    _meshObject->transformGeometry(rclMat);
+    _meshObject.detach()->transformGeometry(rclMat);
     hasSetValue();
 }
 
 void PropertyMeshKernel::setPointIndices(
     const std::vector<std::pair<PointIndex, Base::Vector3f>>& inds)
 {
+    loadDeferred();
     aboutToSetValue();
-    MeshCore::MeshKernel& kernel = _meshObject->getKernel();
+    MeshCore::MeshKernel& kernel = _meshObject.detach()->getKernel();
     for (const auto& it : inds) {
         kernel.SetPoint(it.first, it.second);
     }
@@ -835,19 +865,22 @@ void PropertyMeshKernel::setPointIndices(
 
 void PropertyMeshKernel::setTransform(const Base::Matrix4D& rclTrf)
 {
-    _meshObject->setTransform(rclTrf);
+    loadDeferred();
+    _meshObject.detach()->setTransform(rclTrf);
 }
 
 Base::Matrix4D PropertyMeshKernel::getTransform() const
 {
+    loadDeferred();
     return _meshObject->getTransform();
 }
 
 PyObject* PropertyMeshKernel::getPyObject()
 {
+    loadDeferred();
     if (!meshPyObject) {
         meshPyObject = new MeshPy(
-            &*_meshObject);  // Lgtm[cpp/resource-not-released-in-destructor] ** Not destroyed in
+            _meshObject.get());  // Lgtm[cpp/resource-not-released-in-destructor] ** Not destroyed in
                              // this class because it is reference-counted and destroyed elsewhere
         meshPyObject->setConst();  // set immutable
         meshPyObject->parentProperty = this;
@@ -862,7 +895,7 @@ void PropertyMeshKernel::setPyObject(PyObject* value)
     if (PyObject_TypeCheck(value, &(MeshPy::Type))) {
         MeshPy* mesh = static_cast<MeshPy*>(value);
         // Do not allow to reassign the same instance
-        if (&(*this->_meshObject) != mesh->getMeshObjectPtr()) {
+        if (this->_meshObject.get() != mesh->getMeshObjectPtr()) {
             // Note: Copy the content, do NOT reference the same mesh object
             setValue(*(mesh->getMeshObjectPtr()));
         }
@@ -882,6 +915,7 @@ void PropertyMeshKernel::setPyObject(PyObject* value)
 
 void PropertyMeshKernel::Save(Base::Writer& writer) const
 {
+    loadDeferred();
     if (writer.isForceXML()) {
         writer.Stream() << writer.ind() << "<Mesh>" << std::endl;
         MeshCore::MeshOutput saver(_meshObject->getKernel());
@@ -910,7 +944,8 @@ void PropertyMeshKernel::Restore(Base::XMLReader& reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
-        _meshObject->getKernel().Adopt(points, facets);
+        _deferred.reset();
+        _meshObject.detach()->getKernel().Adopt(points, facets);
         hasSetValue();
     }
     else {
@@ -921,21 +956,78 @@ void PropertyMeshKernel::Restore(Base::XMLReader& reader)
 
 void PropertyMeshKernel::SaveDocFile(Base::Writer& writer) const
 {
+    loadDeferred();
     _meshObject->save(writer.Stream());
 }
 
 void PropertyMeshKernel::RestoreDocFile(Base::Reader& reader)
 {
     aboutToSetValue();
-    _meshObject->load(reader);
+    _meshObject.detach(false)->load(reader);
     hasSetValue();
 }
 
+void PropertyMeshKernel::deferRestoreDocFile(const std::shared_ptr<Base::DeferredDocFile>& file)
+{
+    _deferred.setFile(file);
+}
+
+void PropertyMeshKernel::loadDeferred() const
+{
+    if (!_deferred.hasFile()) {
+        return;
+    }
+
+    auto self = const_cast<PropertyMeshKernel*>(this);
+    try {
+        _deferred.load([self](Base::Reader& reader) {
+            // Do not signal a change, the mesh is the restored one. Copies sharing the
+            // still empty mesh load it on their own.
+            self->_meshObject.detach()->load(reader);
+        });
+    }
+    catch (const Base::Exception& e) {
+        Base::Console().Error("Failed to load mesh of %s: %s\n", getFullName().c_str(), e.what());
+    }
+    catch (const std::exception& e) {
+        Base::Console().Error("Failed to load mesh of %s: %s\n", getFullName().c_str(), e.what());
+    }
+}
+
+std::string PropertyMeshKernel::getArchivedDocFile(const std::string& archive) const
+{
+    if (archive != _archiveId) {
+        return {};
+    }
+    return _archiveFile;
+}
+
+void PropertyMeshKernel::setArchivedDocFile(const std::string& archive,
+                                            const std::string& file) const
+{
+    _archiveId = archive;
+    _archiveFile = file;
+}
+
+void PropertyMeshKernel::hasSetValue()
+{
+    // the mesh is not the same as in the archive any more
+    _archiveId.clear();
+    _archiveFile.clear();
+    _curvature.reset();
+    PropertyComplexGeoData::hasSetValue();
+}
+
 App::Property* PropertyMeshKernel::Copy() const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: Share the mesh object, it is copied as soon as either property modifies it
     PropertyMeshKernel* prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject = this->_meshObject;
+    // share the still compressed data instead of loading it
+    prop->_deferred.setFile(_deferred.getFile());
+    prop->_archiveId = this->_archiveId;
+    prop->_archiveFile = this->_archiveFile;
+    prop->_curvature = this->_curvature;
     return prop;
 }
 
@@ -944,6 +1036,13 @@ void PropertyMeshKernel::Paste(const App::Property& from)
     // Note: Copy the content, do NOT reference the same mesh object
     aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    prop.loadDeferred();
+    _deferred.reset();
+    if (this->_meshObject.get() != prop._meshObject.get()) {
+        *(this->_meshObject.detach(false)) = *(prop._meshObject);
+    }
     hasSetValue();
+    _archiveId = prop._archiveId;
+    _archiveFile = prop._archiveFile;
+    _curvature = prop._curvature;
 }
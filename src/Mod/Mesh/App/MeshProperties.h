@@ -25,13 +25,17 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include <Base/CopyOnWrite.h>
 #include <Base/Handle.h>
 #include <Base/Matrix.h>
+#include <Base/Reader.h>
 
+#include <Mod/Mesh/App/Core/Curvature.h>
 #include <Mod/Mesh/App/Core/MeshIO.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 
@@ -267,7 +271,15 @@ public:
      */
     const MeshObject& getValue() const;
     const MeshObject* getValuePtr() const;
+    /** The size of the mesh is shared out among all copies of this property
+     * that still reference it, see Copy().
+     */
     unsigned int getMemSize() const override;
+    /** Returns the principal curvatures per point of the mesh, see
+     * MeshCore::MeshCurvature::ComputePerVertex(). They are computed on first use and
+     * kept until the mesh gets modified.
+     */
+    const std::vector<MeshCore::CurvatureInfo>& getCurvature() const;
     //@}
 
     /** @name Getting basic geometric entities */
@@ -315,14 +327,42 @@ public:
 
     void SaveDocFile(Base::Writer& writer) const override;
     void RestoreDocFile(Base::Reader& reader) override;
+    bool isSaveDocFileThreadSafe(const Base::Writer& /*writer*/) const override
+    {
+        return true;
+    }
+    bool isRestoreDocFileDeferrable() const override
+    {
+        return true;
+    }
+    /** The mesh is loaded from \a file as soon as it is accessed. */
+    void deferRestoreDocFile(const std::shared_ptr<Base::DeferredDocFile>& file) override;
+    std::string getArchivedDocFile(const std::string& archive) const override;
+    void setArchivedDocFile(const std::string& archive, const std::string& file) const override;
 
+    /** The copy references the same mesh object until either of them gets
+     * modified, so that taking snapshots for undo/redo is cheap.
+     */
     App::Property* Copy() const override;
     void Paste(const App::Property& from) override;
     //@}
 
+protected:
+    void hasSetValue() override;
+
+private:
+    /// restore the mesh if its file has been deferred by a lazy restore
+    void loadDeferred() const;
+
 private:
-    Base::Reference<MeshObject> _meshObject;
+    Base::CopyOnWrite<MeshObject> _meshObject;
     MeshPy* meshPyObject {nullptr};
+    mutable Base::DeferredDocFileHandle _deferred;
+    // the file of an archive holding the current mesh, see getArchivedDocFile()
+    mutable std::string _archiveId;
+    mutable std::string _archiveFile;
+    // the curvature of the current mesh, see getCurvature()
+    mutable std::shared_ptr<const std::vector<MeshCore::CurvatureInfo>> _curvature;
 };
 
 }  // namespace Mesh
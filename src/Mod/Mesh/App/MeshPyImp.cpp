@@ -69,6 +69,19 @@ private:
     FC_DISABLE_COPY_MOVE(MeshPropertyLock)
 };
 
+// Uses the curvature kept by the property of the mesh or computes it with meshCurv
+static const std::vector<MeshCore::CurvatureInfo>&
+getCurvature(const PropertyMeshKernel* prop,
+             const MeshObject* mesh,
+             MeshCore::MeshCurvature& meshCurv)
+{
+    if (prop && prop->getValuePtr() == mesh) {
+        return prop->getCurvature();
+    }
+    meshCurv.ComputePerVertex();
+    return meshCurv.GetCurvature();
+}
+
 int MeshPy::PyInit(PyObject* args, PyObject*)
 {
     PyObject* pcObj = nullptr;
@@ -553,6 +566,50 @@ PyObject* MeshPy::outer(PyObject* args)
     Py_Return;
 }
 
+PyObject* MeshPy::boolean(PyObject* args, PyObject* kwds)
+{
+    PyObject* pcObj {};
+    const char* operation = "Union";
+
+    static const std::array<const char*, 3> keywords_boolean {"Mesh", "Operation", nullptr};
+    if (!Base::Wrapped_ParseTupleAndKeywords(args,
+                                             kwds,
+                                             "O!|s",
+                                             keywords_boolean,
+                                             &(MeshPy::Type),
+                                             &pcObj,
+                                             &operation)) {
+        return nullptr;
+    }
+
+    MeshCore::MeshBoolean::Operation op {};
+    if (strcmp(operation, "Union") == 0) {
+        op = MeshCore::MeshBoolean::Union;
+    }
+    else if (strcmp(operation, "Intersection") == 0) {
+        op = MeshCore::MeshBoolean::Intersection;
+    }
+    else if (strcmp(operation, "Difference") == 0) {
+        op = MeshCore::MeshBoolean::Difference;
+    }
+    else {
+        PyErr_SetString(PyExc_ValueError,
+                        "Operation must be 'Union', 'Intersection' or 'Difference'");
+        return nullptr;
+    }
+
+    MeshPy* pcObject = static_cast<MeshPy*>(pcObj);
+
+    PY_TRY
+    {
+        MeshObject* mesh = getMeshObjectPtr()->boolean(*pcObject->getMeshObjectPtr(), op);
+        return new MeshPy(mesh);
+    }
+    PY_CATCH;
+
+    Py_Return;
+}
+
 PyObject* MeshPy::section(PyObject* args, PyObject* kwds)
 {
     PyObject* pcObj {};
@@ -1188,8 +1245,7 @@ PyObject* MeshPy::getSelfIntersections(PyObject* args)
     std::vector<std::pair<FacetIndex, FacetIndex>> selfIndices;
     std::vector<Base::Line3d> selfLines;
 
-    selfIndices = getMeshObjectPtr()->getSelfIntersections();
-    selfLines = getMeshObjectPtr()->getSelfIntersections(selfIndices);
+    getMeshObjectPtr()->getSelfIntersections(selfIndices, selfLines);
 
     Py::Tuple tuple(selfIndices.size());
     if (selfIndices.size() == selfLines.size()) {
@@ -2036,6 +2092,13 @@ PyObject* MeshPy::smooth(PyObject* args, PyObject* kwds)
             }
             smooth.Smooth(iter);
         }
+        else if (strcmp(method, "ImplicitLaplace") == 0) {
+            MeshCore::ImplicitLaplaceSmoothing smooth(kernel);
+            if (lambda > 0) {
+                smooth.SetLambda(lambda);
+            }
+            smooth.Smooth(iter);
+        }
         else if (strcmp(method, "Taubin") == 0) {
             MeshCore::TaubinSmoothing smooth(kernel);
             if (lambda > 0) {
@@ -2065,11 +2128,11 @@ PyObject* MeshPy::smooth(PyObject* args, PyObject* kwds)
     Py_Return;
 }
 
-PyObject* MeshPy::decimate(PyObject* args)
+PyObject* MeshPy::decimate(PyObject* args, PyObject* kwds)
 {
     float fTol {};
     float fRed {};
-    if (PyArg_ParseTuple(args, "ff", &fTol, &fRed)) {
+    if (!kwds && PyArg_ParseTuple(args, "ff", &fTol, &fRed)) {
         PY_TRY
         {
             getMeshObjectPtr()->decimate(fTol, fRed);
@@ -2081,7 +2144,7 @@ PyObject* MeshPy::decimate(PyObject* args)
 
     PyErr_Clear();
     int targetSize {};
-    if (PyArg_ParseTuple(args, "i", &targetSize)) {
+    if (!kwds && PyArg_ParseTuple(args, "i", &targetSize)) {
         PY_TRY
         {
             getMeshObjectPtr()->decimate(targetSize);
@@ -2091,8 +2154,39 @@ PyObject* MeshPy::decimate(PyObject* args)
         Py_Return;
     }
 
+    PyErr_Clear();
+    float featureAngle = 0.0F;
+    PyObject* keepBoundary = Py_False;
+    int numThreads = 0;
+    static const std::array<const char*, 5> keywords {"TargetSize",
+                                                      "FeatureAngle",
+                                                      "KeepBoundary",
+                                                      "Threads",
+                                                      nullptr};
+    if (Base::Wrapped_ParseTupleAndKeywords(args,
+                                            kwds,
+                                            "i|fO!i",
+                                            keywords,
+                                            &targetSize,
+                                            &featureAngle,
+                                            &PyBool_Type,
+                                            &keepBoundary,
+                                            &numThreads)) {
+        PY_TRY
+        {
+            double error = getMeshObjectPtr()->decimate(targetSize,
+                                                        featureAngle,
+                                                        Base::asBoolean(keepBoundary),
+                                                        numThreads);
+            return Py::new_reference_to(Py::Float(error));
+        }
+        PY_CATCH;
+    }
+
     PyErr_SetString(PyExc_ValueError,
-                    "decimate(tolerance=float, reduction=float) or decimate(targetSize=int)");
+                    "decimate(tolerance=float, reduction=float) or decimate(targetSize=int) or "
+                    "decimate(TargetSize=int, [FeatureAngle=float, KeepBoundary=bool, "
+                    "Threads=int])");
     return nullptr;
 }
 
@@ -2202,7 +2296,8 @@ PyObject* MeshPy::getSegmentsByCurvature(PyObject* args)
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
     MeshCore::MeshSegmentAlgorithm finder(kernel);
     MeshCore::MeshCurvature meshCurv(kernel);
-    meshCurv.ComputePerVertex();
+    const std::vector<MeshCore::CurvatureInfo>& curv =
+        getCurvature(parentProperty, getMeshObjectPtr(), meshCurv);
 
     Py::Sequence func(l);
     std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
@@ -2214,7 +2309,7 @@ PyObject* MeshPy::getSegmentsByCurvature(PyObject* args)
         float tol2 = Py::Float(t[3]);
         int num = (int)Py::Long(t[4]);
         segm.emplace_back(
-            std::make_shared<MeshCore::MeshCurvatureFreeformSegment>(meshCurv.GetCurvature(),
+            std::make_shared<MeshCore::MeshCurvatureFreeformSegment>(curv,
                                                                      num,
                                                                      tol1,
                                                                      tol2,
@@ -2247,9 +2342,8 @@ PyObject* MeshPy::getCurvaturePerVertex(PyObject* args)
 
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
     MeshCore::MeshCurvature meshCurv(kernel);
-    meshCurv.ComputePerVertex();
-
-    const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
+    const std::vector<MeshCore::CurvatureInfo>& curv =
+        getCurvature(parentProperty, getMeshObjectPtr(), meshCurv);
     Base::Placement plm = getMeshObjectPtr()->getPlacement();
     plm.setPosition(Base::Vector3d());
 
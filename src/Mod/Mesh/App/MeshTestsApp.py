@@ -479,6 +479,40 @@ endsolid Simple"""
         mesh.read(Stream=data, Format="AST")
         self.assertTrue(mesh.hasSelfIntersections())
 
+    def testDecimateKeepBoundary(self):
+        def point(i, j):
+            return FreeCAD.Vector(i, j, math.sin(i * 0.2))
+
+        triangles = []
+        for i in range(20):
+            for j in range(20):
+                triangles.append([point(i, j), point(i + 1, j), point(i + 1, j + 1)])
+                triangles.append([point(i, j), point(i + 1, j + 1), point(i, j + 1)])
+        mesh = Mesh.Mesh(triangles)
+
+        def border(mesh):
+            return len([p for p in mesh.Points if p.x in (0, 20) or p.y in (0, 20)])
+
+        count = border(mesh)
+        error = mesh.decimate(TargetSize=300, KeepBoundary=True, Threads=2)
+        self.assertLessEqual(mesh.CountFacets, 300)
+        self.assertGreaterEqual(error, 0.0)
+        self.assertEqual(border(mesh), count)
+
+    def testBooleanSharedFaces(self):
+        box1 = Mesh.createBox(1.0, 1.0, 1.0)
+        box2 = box1.copy()
+        box2.translate(0.5, 0.0, 0.0)
+
+        expected = {"Union": 1.5, "Intersection": 0.5, "Difference": 0.5}
+        for operation, volume in expected.items():
+            res = box1.boolean(box2, Operation=operation)
+            self.assertAlmostEqual(res.Volume, volume, places=5)
+            self.assertTrue(res.isSolid())
+
+        with self.assertRaises(ValueError):
+            box1.boolean(box2, Operation="Xor")
+
 
 class PivyTestCases(unittest.TestCase):
     def setUp(self):
@@ -80,12 +80,18 @@ void Segmentation::accept()
 
     MeshCore::MeshSegmentAlgorithm finder(kernel);
     MeshCore::MeshCurvature meshCurv(kernel);
-    meshCurv.ComputePerVertex();
+    // the curvature of the unchanged mesh is kept by its property
+    bool smooth = ui->checkBoxSmooth->isChecked();
+    if (smooth) {
+        meshCurv.ComputePerVertex();
+    }
+    const std::vector<MeshCore::CurvatureInfo>& curv =
+        smooth ? meshCurv.GetCurvature() : myMesh->Mesh.getCurvature();
 
     std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
     if (ui->groupBoxFree->isChecked()) {
         segm.emplace_back(
-            std::make_shared<MeshCore::MeshCurvatureFreeformSegment>(meshCurv.GetCurvature(),
+            std::make_shared<MeshCore::MeshCurvatureFreeformSegment>(curv,
                                                                      ui->numFree->value(),
                                                                      ui->tol1Free->value(),
                                                                      ui->tol2Free->value(),
@@ -94,7 +100,7 @@ void Segmentation::accept()
     }
     if (ui->groupBoxCyl->isChecked()) {
         segm.emplace_back(
-            std::make_shared<MeshCore::MeshCurvatureCylindricalSegment>(meshCurv.GetCurvature(),
+            std::make_shared<MeshCore::MeshCurvatureCylindricalSegment>(curv,
                                                                         ui->numCyl->value(),
                                                                         ui->tol1Cyl->value(),
                                                                         ui->tol2Cyl->value(),
@@ -102,14 +108,14 @@ void Segmentation::accept()
     }
     if (ui->groupBoxSph->isChecked()) {
         segm.emplace_back(
-            std::make_shared<MeshCore::MeshCurvatureSphericalSegment>(meshCurv.GetCurvature(),
+            std::make_shared<MeshCore::MeshCurvatureSphericalSegment>(curv,
                                                                       ui->numSph->value(),
                                                                       ui->tolSph->value(),
                                                                       ui->crvSph->value()));
     }
     if (ui->groupBoxPln->isChecked()) {
         segm.emplace_back(
-            std::make_shared<MeshCore::MeshCurvaturePlanarSegment>(meshCurv.GetCurvature(),
+            std::make_shared<MeshCore::MeshCurvaturePlanarSegment>(curv,
                                                                    ui->numPln->value(),
                                                                    ui->tolPln->value()));
     }
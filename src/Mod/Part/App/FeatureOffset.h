@@ -57,6 +57,9 @@ public:
     }
     //@}
 
+protected:
+    bool isResultCacheable() const override {return true;}
+
 private:
     static const char* ModeEnums[];
     static const char* JoinEnums[];
@@ -57,6 +57,8 @@ public:
     }
 
 protected:
+    bool isResultCacheable() const override {return true;}
+    std::vector<App::Property*> getResultOutputs() override {return {&History};}
     virtual BRepAlgoAPI_BooleanOperation* makeOperation(const TopoDS_Shape&, const TopoDS_Shape&) const = 0;
     virtual const char *opCode() const = 0;
 };
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <sstream>
+#include <Standard_Failure.hxx>
+#endif
+
+#include <QCryptographicHash>
+
+#include <App/Application.h>
+#include <App/PropertyLinks.h>
+#include <Base/Parameter.h>
+#include <Base/Writer.h>
+
+#include "FeatureResultCache.h"
+#include "PartFeature.h"
+
+
+FC_LOG_LEVEL_INIT("Part", true, true)
+
+using namespace Part;
+
+namespace
+{
+
+ParameterGrp::handle getParameterGroup()
+{
+    return App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Mod/Part/ResultCache");
+}
+
+void addData(QCryptographicHash& hash, const std::string& data)
+{
+    hash.addData(data.c_str(), static_cast<int>(data.size()));
+    // separator so that consecutive values cannot be confused
+    hash.addData("\0", 1);
+}
+
+// Returns a string identifying the shape provided by obj
+std::string getShapeKey(const App::DocumentObject* obj)
+{
+    // The key of a cached feature already identifies its shape including
+    // its own placement
+    if (auto feature = Base::freecad_dynamic_cast<const Feature>(obj)) {
+        const std::string& key = feature->Shape.getCacheKey();
+        if (!key.empty()) {
+            return key;
+        }
+    }
+
+    TopoShape shape = Feature::getTopoShape(obj);
+    if (shape.isNull()) {
+        return "null";
+    }
+    std::ostringstream str;
+    shape.exportBinary(str);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addData(hash, str.str());
+    return hash.result().toHex().toStdString();
+}
+
+}  // namespace
+
+FeatureResultCache::FeatureResultCache()
+{
+    // in MB
+    maxMemSize = static_cast<std::size_t>(getParameterGroup()->GetUnsigned("MaxMemSize", 256))
+        * 1024 * 1024;
+}
+
+FeatureResultCache& FeatureResultCache::instance()
+{
+    static FeatureResultCache cache;
+    return cache;
+}
+
+bool FeatureResultCache::isEnabled()
+{
+    return getParameterGroup()->GetBool("Enable", false);
+}
+
+std::string FeatureResultCache::computeKey(const Feature* feature)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addData(hash, feature->getTypeId().getName());
+    if (feature->isAttachedToDocument()) {
+        addData(hash, feature->getNameInDocument());
+    }
+
+    try {
+        std::vector<std::pair<const char*, App::Property*>> props;
+        feature->getPropertyNamedList(props);
+        for (const auto& v : props) {
+            auto prop = v.second;
+            // Skip the result and the properties not affecting the result
+            if (prop == &feature->Shape || prop == &feature->ShapeMaterial
+                || prop == &feature->Label || prop == &feature->Label2
+                || prop == &feature->ExpressionEngine || prop == &feature->Visibility) {
+                continue;
+            }
+            if ((prop->getType() & (App::Prop_Output | App::Prop_Transient | App::Prop_NoRecompute))
+                || prop->testStatus(App::Property::Output)
+                || prop->testStatus(App::Property::Transient)) {
+                continue;
+            }
+
+            Base::StringWriter writer;
+            writer.setForceXML(true);
+            prop->Save(writer);
+            addData(hash, v.first);
+            addData(hash, writer.getString());
+
+            if (auto link = Base::freecad_dynamic_cast<App::PropertyLinkBase>(prop)) {
+                std::vector<App::DocumentObject*> objs;
+                link->getLinks(objs, true);
+                for (auto obj : objs) {
+                    if (obj) {
+                        addData(hash, getShapeKey(obj));
+                    }
+                }
+            }
+        }
+    }
+    catch (Base::Exception& e) {
+        FC_LOG("Cannot compute result key of " << feature->getFullName() << ": " << e.what());
+        return {};
+    }
+    catch (Standard_Failure& e) {
+        FC_LOG("Cannot compute result key of " << feature->getFullName() << ": "
+                                               << e.GetMessageString());
+        return {};
+    }
+    return hash.result().toHex().toStdString();
+}
+
+bool FeatureResultCache::find(const std::string& key, TopoShape& shape, Outputs* outputs)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    lru.splice(lru.begin(), lru, it->second.lru);
+    shape = it->second.shape;
+    if (outputs) {
+        *outputs = it->second.outputs;
+    }
+    return true;
+}
+
+void FeatureResultCache::add(const std::string& key, const TopoShape& shape, Outputs outputs)
+{
+    if (key.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto res = entries.emplace(key, Entry());
+    Entry& entry = res.first->second;
+    if (res.second) {
+        lru.push_front(key);
+        entry.lru = lru.begin();
+    }
+    else {
+        totalMemSize -= entry.memSize;
+        lru.splice(lru.begin(), lru, entry.lru);
+    }
+    entry.shape = shape;
+    entry.memSize = shape.getMemSize();
+    for (const auto& prop : outputs) {
+        entry.memSize += prop->getMemSize();
+    }
+    entry.outputs = std::move(outputs);
+    totalMemSize += entry.memSize;
+    evict();
+}
+
+void FeatureResultCache::evict()
+{
+    // Always keep the most recent entry
+    while (totalMemSize > maxMemSize && lru.size() > 1) {
+        auto it = entries.find(lru.back());
+        totalMemSize -= it->second.memSize;
+        entries.erase(it);
+        lru.pop_back();
+    }
+}
+
+void FeatureResultCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+    totalMemSize = 0;
+}
+
+std::size_t FeatureResultCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+std::size_t FeatureResultCache::memSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalMemSize;
+}
+
+void FeatureResultCache::setMaxMemSize(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    maxMemSize = bytes;
+    evict();
+}
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************
+ *                                                                          *
+ *   Copyright (c) 2024 The FreeCAD Project Association AISBL               *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef PART_FEATURERESULTCACHE_H
+#define PART_FEATURERESULTCACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Mod/Part/PartGlobal.h>
+
+#include "TopoShape.h"
+
+
+namespace App
+{
+class Property;
+}
+
+namespace Part
+{
+
+class Feature;
+
+/** Content addressed cache of the shapes computed by Part::Feature::execute()
+ *
+ * The key of a feature is a hash of its type, its name, the values of all its
+ * input properties and the keys (or content) of all the shapes it links to.
+ * When the key of a feature matches an entry the cached shape and copies of
+ * the other outputs of the feature are reused and execute() is skipped. The key is also kept in the Shape property and saved
+ * with the document, so that a recompute right after reopening a document
+ * skips the features whose inputs did not change.
+ *
+ * The cache is disabled by default. See the parameter group
+ * "User parameter:BaseApp/Preferences/Mod/Part/ResultCache".
+ */
+class PartExport FeatureResultCache
+{
+public:
+    static FeatureResultCache& instance();
+
+    /// Returns true if the cache is enabled in the preferences
+    static bool isEnabled();
+    /// Compute the key of \a feature, returns an empty string on failure
+    static std::string computeKey(const Feature* feature);
+
+    using Outputs = std::vector<std::shared_ptr<const App::Property>>;
+
+    /// Look up \a key, and copy the shape into \a shape and the other outputs into \a outputs
+    bool find(const std::string& key, TopoShape& shape, Outputs* outputs = nullptr);
+    /// Add \a shape under \a key, evicting the least recently used entries if needed
+    void add(const std::string& key, const TopoShape& shape, Outputs outputs = {});
+    /// Remove all entries
+    void clear();
+
+    /// Number of cached shapes
+    std::size_t size() const;
+    /// Approximate memory used by the cached shapes in bytes
+    std::size_t memSize() const;
+    void setMaxMemSize(std::size_t bytes);
+
+private:
+    FeatureResultCache();
+    void evict();
+
+    struct Entry
+    {
+        TopoShape shape;
+        Outputs outputs;
+        std::size_t memSize = 0;
+        std::list<std::string>::iterator lru;
+    };
+    std::unordered_map<std::string, Entry> entries;
+    // most recently used keys first
+    std::list<std::string> lru;
+    std::size_t totalMemSize = 0;
+    std::size_t maxMemSize;
+    mutable std::mutex mutex;
+};
+
+}  // namespace Part
+
+#endif  // PART_FEATURERESULTCACHE_H
@@ -70,6 +70,7 @@
 #include <Base/Stream.h>
 #include <Mod/Material/App/MaterialManager.h>
 
+#include "FeatureResultCache.h"
 #include "Geometry.h"
 #include "PartFeature.h"
 #include "PartFeaturePy.h"
@@ -103,7 +104,45 @@ short Feature::mustExecute() const
 App::DocumentObjectExecReturn *Feature::recompute()
 {
     try {
-        return App::GeoFeature::recompute();
+        std::string key;
+        std::vector<App::Property*> outputs;
+        if (isResultCacheable() && FeatureResultCache::isEnabled()) {
+            key = FeatureResultCache::computeKey(this);
+            outputs = getResultOutputs();
+            // The shape may already be the result of these inputs, e.g. when
+            // recomputing right after the document has been restored. The
+            // other outputs are not saved, so they must come from the cache.
+            if (!key.empty() && key == Shape.getCacheKey() && outputs.empty()) {
+                FC_LOG("Skip recompute of " << getFullName() << ", inputs unchanged");
+                return App::DocumentObject::StdReturn;
+            }
+            TopoShape shape;
+            FeatureResultCache::Outputs values;
+            // Do not reuse element maps hashed by another document
+            if (!key.empty() && FeatureResultCache::instance().find(key, shape, &values)
+                && values.size() == outputs.size()
+                && (shape.Hasher.isNull() || shape.Hasher == getDocument()->getStringHasher())) {
+                FC_LOG("Reuse cached result of " << getFullName());
+                // in the same order as execute()
+                Shape.setValue(shape);
+                Shape.setCacheKey(key);
+                for (std::size_t i = 0; i < outputs.size(); i++) {
+                    outputs[i]->Paste(*values[i]);
+                }
+                return App::DocumentObject::StdReturn;
+            }
+        }
+
+        auto ret = App::GeoFeature::recompute();
+        if (ret == App::DocumentObject::StdReturn && !key.empty()) {
+            FeatureResultCache::Outputs values;
+            for (auto prop : outputs) {
+                values.emplace_back(prop->Copy());
+            }
+            FeatureResultCache::instance().add(key, Shape.getShape(), std::move(values));
+            Shape.setCacheKey(key);
+        }
+        return ret;
     }
     catch (Standard_Failure& e) {
 
@@ -162,6 +162,14 @@ public:
                                                        double atol = 1e-10) const override;
 #endif
 protected:
+    /** Return true if the result of execute() only depends on the input
+     * properties and the linked shapes, so it can be stored in the
+     * FeatureResultCache. On a cache hit the Shape property and the
+     * properties of getResultOutputs() are restored.
+     */
+    virtual bool isResultCacheable() const {return false;}
+    /// Return the properties other than Shape that execute() sets
+    virtual std::vector<App::Property*> getResultOutputs() {return {};}
     /// recompute only this object
     App::DocumentObjectExecReturn *recompute() override;
     /// recalculate the feature
@@ -213,6 +221,11 @@ public:
     void onUpdateElementReference(const App::Property *prop) override;
 
 protected:
+#ifdef FC_USE_TNP_FIX
+    // Without the element maps execute() signals the shape history to the
+    // view provider as well, which a cache hit cannot repeat
+    bool isResultCacheable() const override {return true;}
+#endif
     void onDocumentRestored() override;
     void onChanged(const App::Property *) override;
     void syncEdgeLink();
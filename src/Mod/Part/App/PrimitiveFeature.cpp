@@ -87,6 +87,12 @@ App::DocumentObjectExecReturn* Primitive::execute() {
     return Part::Feature::execute();
 }
 
+bool Primitive::isExecuteThreadSafe() const
+{
+    // placing by the attachment may change the links to the support
+    return isShapeThreadSafe() && AttachmentSupport.getSize() == 0;
+}
+
 // suppress warning about tp_print for Py3.8
 #if defined(__clang__)
 # pragma clang diagnostic push
@@ -44,12 +44,18 @@ public:
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
     PyObject* getPyObject() override;
+    /// true if the shape is thread safe and the primitive is not attached to other objects
+    bool isExecuteThreadSafe() const override;
     //@}
 
 protected:
     void Restore(Base::XMLReader &reader) override;
     void onChanged (const App::Property* prop) override;
     void handleChangedPropertyType(Base::XMLReader &reader, const char * TypeName, App::Property * prop) override;
+    /// Return true if execute() makes the shape by OCC from the own properties only
+    virtual bool isShapeThreadSafe() const {
+        return false;
+    }
 };
 
 class PartExport Vertex : public Part::Primitive
@@ -144,6 +150,9 @@ public:
     /// recalculate the feature
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
+    bool isShapeThreadSafe() const override {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName() const override {
         return "PartGui::ViewProviderSphereParametric";
@@ -193,6 +202,9 @@ public:
     /// recalculate the feature
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
+    bool isShapeThreadSafe() const override {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName() const override {
         return "PartGui::ViewProviderCylinderParametric";
@@ -267,6 +279,9 @@ public:
     /// recalculate the feature
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
+    bool isShapeThreadSafe() const override {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName() const override {
         return "PartGui::ViewProviderConeParametric";
@@ -292,6 +307,9 @@ public:
     /// recalculate the feature
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
+    bool isShapeThreadSafe() const override {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName() const override {
         return "PartGui::ViewProviderTorusParametric";
@@ -46,6 +46,9 @@
 #include <Base/Stream.h>
 #include <Base/Writer.h>
 
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
 #include "PartFeature.h"
 #include "PartPyCXX.h"
 #include "PropertyTopoShape.h"
@@ -54,6 +57,42 @@
 
 FC_LOG_LEVEL_INIT("App", true, true)
 
+namespace {
+
+// Reads a shape written by TopoShape::exportBrep() or TopoShape::exportBinary().
+// The format is told by the versioned header of the data and not by the file
+// name. The data is read into memory first because parsing straight from the
+// inflating archive stream is much slower. Returns false for an empty file.
+bool readShapeData(std::istream& in, TopoDS_Shape& shape)
+{
+    std::string data;
+    char buffer[0x10000];
+    while (in.read(buffer, sizeof(buffer)), in.gcount() > 0) {
+        data.append(buffer, static_cast<std::size_t>(in.gcount()));
+    }
+    auto pos = data.find_first_not_of(" \t\r\n");
+    if (pos == std::string::npos) {
+        return false;
+    }
+
+    boost::iostreams::stream<boost::iostreams::array_source> str(data.data(), data.size());
+    // BinTools_ShapeSet writes 'Open CASCADE Topology V<n> (c)' while the
+    // text format starts with 'CASCADE Topology V<n>, (c) Matra-Datavision'
+    static const std::string binaryHeader("Open CASCADE Topology V");
+    if (data.compare(pos, binaryHeader.size(), binaryHeader) == 0) {
+        TopoShape binary;
+        binary.importBinary(str);
+        shape = binary.getShape();
+    }
+    else {
+        BRep_Builder builder;
+        BRepTools::Read(shape, str, builder);
+    }
+    return true;
+}
+
+}
+
 namespace sp = std::placeholders;
 using namespace Part;
 
@@ -66,6 +105,7 @@ PropertyPartShape::~PropertyPartShape() = default;
 void PropertyPartShape::setValue(const TopoShape& sh)
 {
     aboutToSetValue();
+    dropDeferred();
     _Shape = sh;
     auto obj = Base::freecad_dynamic_cast<App::DocumentObject>(getContainer());
     if(obj) {
@@ -82,26 +122,31 @@ void PropertyPartShape::setValue(const TopoShape& sh)
     }
     hasSetValue();
     _Ver.clear();
+    _CacheKey.clear();
 }
 
 void PropertyPartShape::setValue(const TopoDS_Shape& sh, bool resetElementMap)
 {
     aboutToSetValue();
+    dropDeferred();
     auto obj = dynamic_cast<App::DocumentObject*>(getContainer());
     if(obj)
         _Shape.Tag = obj->getID();
     _Shape.setShape(sh,resetElementMap);
     hasSetValue();
     _Ver.clear();
+    _CacheKey.clear();
 }
 
 const TopoDS_Shape& PropertyPartShape::getValue() const
 {
+    loadDeferred();
     return _Shape.getShape();
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    loadDeferred();
     _Shape.initCache(-1);
     // March, 2024 Toponaming project:  There was originally an unused feature to disable
     // elementMapping that has not been kept:
@@ -118,6 +163,7 @@ const TopoShape& PropertyPartShape::getShape() const
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    loadDeferred();
     _Shape.initCache(-1);
     return &(this->_Shape);
 }
@@ -125,6 +171,7 @@ const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
     Base::BoundBox3d box;
+    loadDeferred();
     if (_Shape.getShape().IsNull())
         return box;
     try {
@@ -150,23 +197,31 @@ Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 
 void PropertyPartShape::setTransform(const Base::Matrix4D &rclTrf)
 {
+    loadDeferred();
     _Shape.setTransform(rclTrf);
+    // the location is saved with the shape
+    _ArchiveId.clear();
+    _ArchiveFile.clear();
 }
 
 Base::Matrix4D PropertyPartShape::getTransform() const
 {
+    loadDeferred();
     return _Shape.getTransform();
 }
 
 void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 {
+    loadDeferred();
     aboutToSetValue();
     _Shape.transformGeometry(rclTrf);
     hasSetValue();
+    _CacheKey.clear();
 }
 
 PyObject *PropertyPartShape::getPyObject()
 {
+    loadDeferred();
     Base::PyObjectBase* prop = static_cast<Base::PyObjectBase*>(_Shape.getPyObject());
     if (prop)
         prop->setConst();
@@ -214,6 +269,11 @@ App::Property *PropertyPartShape::Copy() const
 //        prop->_Shape = this->_Shape;
     prop->_Shape = this->_Shape;
     prop->_Ver = this->_Ver;
+    prop->_CacheKey = this->_CacheKey;
+    prop->_ArchiveId = this->_ArchiveId;
+    prop->_ArchiveFile = this->_ArchiveFile;
+    // share the still compressed data instead of loading it
+    prop->_Deferred.setFile(_Deferred.getFile());
     return prop;
 }
 
@@ -221,14 +281,18 @@ void PropertyPartShape::Paste(const App::Property &from)
 {
     auto prop = Base::freecad_dynamic_cast<const PropertyPartShape>(&from);
     if(prop) {
+        prop->loadDeferred();
         setValue(prop->_Shape);
         _Ver = prop->_Ver;
+        _CacheKey = prop->_CacheKey;
+        _ArchiveId = prop->_ArchiveId;
+        _ArchiveFile = prop->_ArchiveFile;
     }
 }
 
 unsigned int PropertyPartShape::getMemSize () const
 {
-    return _Shape.getMemSize();
+    return _Shape.getMemSize() + static_cast<unsigned int>(_Deferred.getCompressedSize());
 }
 
 void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) const
@@ -247,6 +311,7 @@ void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) cons
 
 void PropertyPartShape::beforeSave() const
 {
+    loadDeferred();
     _HasherIndex = 0;
     _SaveHasher = false;
     auto owner = Base::freecad_dynamic_cast<App::DocumentObject>(getContainer());
@@ -262,13 +327,16 @@ void PropertyPartShape::Save (Base::Writer &writer) const
 {
     if(!writer.isForceXML()) {
         //See SaveDocFile(), RestoreDocFile()
+        writer.Stream() << writer.ind() << "<Part";
+        if (!_CacheKey.empty())
+            writer.Stream() << " CacheKey=\"" << _CacheKey << '"';
         if (writer.getMode("BinaryBrep")) {
-            writer.Stream() << writer.ind() << "<Part file=\""
+            writer.Stream() << " file=\""
                             << writer.addFile("PartShape.bin", this)
                             << "\"/>" << std::endl;
         }
         else {
-            writer.Stream() << writer.ind() << "<Part file=\""
+            writer.Stream() << " file=\""
                             << writer.addFile("PartShape.brp", this)
                             << "\"/>" << std::endl;
         }
@@ -278,6 +346,7 @@ void PropertyPartShape::Save (Base::Writer &writer) const
 #else
 void PropertyPartShape::Save (Base::Writer &writer) const
 {
+    loadDeferred();
     //See SaveDocFile(), RestoreDocFile()
     writer.Stream() << writer.ind() << "<Part";
     auto owner = dynamic_cast<App::DocumentObject*>(getContainer());
@@ -296,6 +365,8 @@ void PropertyPartShape::Save (Base::Writer &writer) const
     }else
         version = _Ver.size()?_Ver:_Shape.getElementMapVersion();
     writer.Stream() << " ElementMap=\"" << version << '"';
+    if(!_CacheKey.empty())
+        writer.Stream() << " CacheKey=\"" << _CacheKey << '"';
 
     bool binary = writer.getMode("BinaryBrep");
     bool toXML = writer.isForceXML();
@@ -341,6 +412,12 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
 {
     reader.readElement("Part");
     std::string file (reader.getAttribute("file") );
+    dropDeferred();
+    _ArchiveId.clear();
+    _ArchiveFile.clear();
+    _CacheKey.clear();
+    if (reader.hasAttribute("CacheKey"))
+        _CacheKey = reader.getAttribute("CacheKey");
 
     if (!file.empty()) {
         // initiate a file read
@@ -352,6 +429,9 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
 void PropertyPartShape::Restore(Base::XMLReader &reader)
 {
     reader.readElement("Part");
+    dropDeferred();
+    _ArchiveId.clear();
+    _ArchiveFile.clear();
 
     auto owner = Base::freecad_dynamic_cast<App::DocumentObject>(getContainer());
     _Ver = "?";
@@ -367,6 +447,10 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
     if ( reader.hasAttribute("SaveHasher") ) {
         save_hasher = reader.getAttributeAsInteger("SaveHasher");
     }
+    std::string key;
+    if (reader.hasAttribute("CacheKey")) {
+        key = reader.getAttribute("CacheKey");
+    }
     TopoDS_Shape sh;
 
     if(reader.hasAttribute("file")) {
@@ -438,6 +522,14 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
         _Shape.setShape(sh,false);
         hasSetValue();
     }
+
+    // Only trust the key if the element map is restored as well, otherwise
+    // the object has to be recomputed to regenerate it
+    _CacheKey.clear();
+    if (!key.empty() && has_ver && _Ver != "?" && !_Ver.empty()
+        && !(owner ? owner->checkElementMapVersion(this, _Ver.c_str())
+                   : _Shape.checkElementMapVersion(_Ver.c_str())))
+        _CacheKey = key;
 }
 
 // void PropertyPartShape::afterRestore()
@@ -454,6 +546,22 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
 // }
 #endif
 
+void PropertyPartShape::afterRestore()
+{
+    // Same as PropertyComplexGeoData::afterRestore() but without going through
+    // getComplexData(), which would load a deferred shape. The restore failure
+    // only concerns the element map.
+    if (_Shape.isRestoreFailed()) {
+        _Shape.resetRestoreFailure();
+        auto owner = Base::freecad_dynamic_cast<App::DocumentObject>(getContainer());
+        if (owner && owner->getDocument()
+                  && !owner->getDocument()->testStatus(App::Document::PartialDoc)) {
+            owner->getDocument()->addRecomputeObject(owner);
+        }
+    }
+    App::PropertyGeometry::afterRestore();
+}
+
 // The following function is copied from OCCT BRepTools.cxx and modified
 // to disable saving of triangulation
 //
@@ -582,15 +690,19 @@ void PropertyPartShape::loadFromFile(Base::Reader &reader)
 void PropertyPartShape::loadFromStream(Base::Reader &reader)
 {
     try {
-        reader.exceptions(std::istream::failbit | std::istream::badbit);
-        BRep_Builder builder;
+        reader.exceptions(std::istream::goodbit);
         TopoDS_Shape shape;
-        BRepTools::Read(shape, reader, builder);
-        setValue(shape);
+        if (readShapeData(reader, shape))
+            setValue(shape);
+    }
+    catch (const Base::Exception&) {
+        Base::Console().Warning("Failed to load BRep file %s\n", reader.getFileName().c_str());
     }
     catch (const std::exception&) {
-        if (!reader.eof())
-            Base::Console().Warning("Failed to load BRep file %s\n", reader.getFileName().c_str());
+        Base::Console().Warning("Failed to load BRep file %s\n", reader.getFileName().c_str());
+    }
+    catch (const Standard_Failure&) {
+        Base::Console().Warning("Failed to load BRep file %s\n", reader.getFileName().c_str());
     }
 }
 
@@ -598,6 +710,7 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
+    loadDeferred();
     if (_Shape.getShape().IsNull())
         return;
     TopoDS_Shape myShape = _Shape.getShape();
@@ -620,8 +733,97 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     }
 }
 
+bool PropertyPartShape::isSaveDocFileThreadSafe(const Base::Writer &writer) const
+{
+    // The BRep text format reads the DirectAccess parameter and may go
+    // through a temporary file, so only the binary format is thread safe
+    return writer.getMode("BinaryBrep");
+}
+
+std::string PropertyPartShape::getArchivedDocFile(const std::string &archive) const
+{
+    if (archive != _ArchiveId)
+        return {};
+    return _ArchiveFile;
+}
+
+void PropertyPartShape::setArchivedDocFile(const std::string &archive, const std::string &file) const
+{
+    _ArchiveId = archive;
+    _ArchiveFile = file;
+}
+
+void PropertyPartShape::hasSetValue()
+{
+    // the shape is not the same as in the archive any more
+    _ArchiveId.clear();
+    _ArchiveFile.clear();
+    PropertyComplexGeoData::hasSetValue();
+}
+
+bool PropertyPartShape::isRestoreDocFileDeferrable() const
+{
+    return true;
+}
+
+void PropertyPartShape::deferRestoreDocFile(const std::shared_ptr<Base::DeferredDocFile> &file)
+{
+    // RestoreDocFile() clears it by setValue() as well
+    _Ver.clear();
+    _Deferred.setFile(file);
+}
+
+void PropertyPartShape::loadDeferred() const
+{
+    if (!_Deferred.hasFile())
+        return;
+
+    auto self = const_cast<PropertyPartShape*>(this);
+    try {
+        _Deferred.load([self](Base::Reader &reader) {
+            TopoDS_Shape shape;
+            readShapeData(reader, shape);
+            // Keep the element map that has been restored with the document,
+            // and do not signal a change, the shape is the restored one.
+            self->_Shape.setShape(shape, false);
+        });
+    }
+    catch (const Base::Exception &e) {
+        FC_ERR("Failed to load shape of " << getFullName() << ": " << e.what());
+    }
+    catch (const std::exception &e) {
+        FC_ERR("Failed to load shape of " << getFullName() << ": " << e.what());
+    }
+    catch (Standard_Failure &e) {
+        FC_ERR("Failed to load shape of " << getFullName() << ": " << e.GetMessageString());
+    }
+}
+
+void PropertyPartShape::dropDeferred()
+{
+    _Deferred.reset();
+}
+
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
+    // setValue() clears the key restored by Restore()
+    std::string key = _CacheKey;
+    restoreShapeFile(reader);
+    _CacheKey = key;
+}
+
+void PropertyPartShape::restoreShapeFile(Base::Reader &reader)
+{
+    bool direct = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+    if (direct) {
+        // detects binary and text BRep
+        auto iostate = reader.exceptions();
+        loadFromStream(reader);
+        reader.exceptions(iostate);
+        return;
+    }
+
     Base::FileInfo brep(reader.getFileName());
     if (brep.hasExtension("bin")) {
         TopoShape shape;
@@ -629,16 +831,7 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
         setValue(shape);
     }
     else {
-        bool direct = App::GetApplication().GetParameterGroupByPath
-            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
-        if (!direct) {
-            loadFromFile(reader);
-        }
-        else {
-            auto iostate = reader.exceptions();
-            loadFromStream(reader);
-            reader.exceptions(iostate);
-        }
+        loadFromFile(reader);
     }
 }
 
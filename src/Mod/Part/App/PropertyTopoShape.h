@@ -24,9 +24,11 @@
 #define PART_PROPERTYTOPOSHAPE_H
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <App/PropertyGeo.h>
+#include <Base/Reader.h>
 
 #include "TopoShape.h"
 #include <TopAbs_ShapeEnum.hxx>
@@ -90,6 +92,11 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const override;
     void RestoreDocFile(Base::Reader &reader) override;
+    bool isSaveDocFileThreadSafe(const Base::Writer &writer) const override;
+    bool isRestoreDocFileDeferrable() const override;
+    void deferRestoreDocFile(const std::shared_ptr<Base::DeferredDocFile> &file) override;
+    std::string getArchivedDocFile(const std::string &archive) const override;
+    void setArchivedDocFile(const std::string &archive, const std::string &file) const override;
 
     App::Property *Copy() const override;
     void Paste(const App::Property &from) override;
@@ -102,20 +109,37 @@ public:
     virtual std::string getElementMapVersion(bool restored=false) const override;
     void resetElementMapVersion() {_Ver.clear();}
 
-//    virtual void afterRestore() override;
+    /// Key of the inputs this shape was computed from, see FeatureResultCache
+    const std::string &getCacheKey() const {return _CacheKey;}
+    /// Set the key of the inputs, it is cleared on any change of the shape
+    void setCacheKey(const std::string &key) {_CacheKey = key;}
+
+    void afterRestore() override;
 
     friend class Feature;
 
+protected:
+    void hasSetValue() override;
+
 private:
     void saveToFile(Base::Writer &writer) const;
     void loadFromFile(Base::Reader &reader);
     void loadFromStream(Base::Reader &reader);
+    void restoreShapeFile(Base::Reader &reader);
+    /// restore the shape if its file has been deferred by a lazy restore
+    void loadDeferred() const;
+    void dropDeferred();
 
 private:
     TopoShape _Shape;
     std::string _Ver;
+    std::string _CacheKey;
     mutable int _HasherIndex = 0;
     mutable bool _SaveHasher = false;
+    mutable Base::DeferredDocFileHandle _Deferred;
+    // the file of an archive holding the current shape, see getArchivedDocFile()
+    mutable std::string _ArchiveId;
+    mutable std::string _ArchiveFile;
 };
 
 struct PartExport ShapeHistory {
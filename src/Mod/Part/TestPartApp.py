@@ -23,6 +23,7 @@
 import FreeCAD, unittest, Part
 import copy
 import math
+import threading
 from FreeCAD import Units
 from FreeCAD import Base
 App = FreeCAD
@@ -75,6 +76,73 @@ class PartTestCases(unittest.TestCase):
         FreeCAD.closeDocument("PartTest")
         #print ("omit closing document for debugging")
 
+class PartTestParallelRecompute(unittest.TestCase):
+    class Observer:
+        def __init__(self):
+            self.signals = []
+
+        def slotBeforeChangeObject(self, obj, prop):
+            if prop == "Shape":
+                self.signals.append(("before", obj.Name, obj.Shape.Volume,
+                                     threading.current_thread() is threading.main_thread()))
+
+        def slotChangedObject(self, obj, prop):
+            if prop == "Shape":
+                self.signals.append(("changed", obj.Name, obj.Shape.Volume,
+                                     threading.current_thread() is threading.main_thread()))
+
+    def setUp(self):
+        self.Param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+        self.Parallel = self.Param.GetBool("ParallelRecompute", False)
+        self.Threads = self.Param.GetInt("RecomputeThreads", 0)
+        self.Param.SetBool("ParallelRecompute", True)
+        self.Param.SetInt("RecomputeThreads", 4)
+        self.Doc = FreeCAD.newDocument("PartParallelTest")
+
+    def testPrimitives(self):
+        boxes = [self.Doc.addObject("Part::Box", "Box") for i in range(8)]
+        self.Doc.recompute()
+        for box in boxes:
+            self.assertTrue(box.isValid())
+            self.assertAlmostEqual(box.Shape.Volume, 1000.0)
+
+        observer = self.Observer()
+        FreeCAD.addDocumentObserver(observer)
+        try:
+            for box in boxes:
+                box.Length = 20
+            self.Doc.recompute()
+        finally:
+            FreeCAD.removeDocumentObserver(observer)
+
+        for box in boxes:
+            self.assertTrue(box.isValid())
+            self.assertAlmostEqual(box.Shape.Volume, 2000.0)
+            signals = [s for s in observer.signals if s[1] == box.Name]
+            # the observers get the old shape before and the new one after the change
+            self.assertEqual([s[0] for s in signals], ["before", "changed"])
+            self.assertAlmostEqual(signals[0][2], 1000.0)
+            self.assertAlmostEqual(signals[1][2], 2000.0)
+        self.assertTrue(all(s[3] for s in observer.signals))
+
+    def testAttached(self):
+        box = self.Doc.addObject("Part::Box", "Box")
+        cylinders = []
+        for i in range(4):
+            cyl = self.Doc.addObject("Part::Cylinder", "Cylinder")
+            cyl.AttachmentSupport = [(box, "Vertex8")]
+            cyl.MapMode = "Translate"
+            cylinders.append(cyl)
+        self.Doc.recompute()
+        for cyl in cylinders:
+            self.assertTrue(cyl.isValid())
+            self.assertEqual(cyl.Placement.Base, box.Shape.Vertexes[7].Point)
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)
+        self.Param.SetBool("ParallelRecompute", self.Parallel)
+        self.Param.SetInt("RecomputeThreads", self.Threads)
+
 class PartTestBSplineCurve(unittest.TestCase):
     def setUp(self):
         self.Doc = FreeCAD.newDocument("PartTest")
@@ -28,6 +28,7 @@
 #include <iostream>
 #endif
 
+#include <Base/Console.h>
 #include <Base/Matrix.h>
 #include <Base/Writer.h>
 
@@ -46,38 +47,46 @@ PropertyPointKernel::PropertyPointKernel()
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
-    *_cPoints = m;
+    _deferred.reset();
+    // the whole content gets replaced, so copies may take it over
+    *_cPoints.detach(&m == _cPoints.get()) = m;
     hasSetValue();
 }
 
 const PointKernel& PropertyPointKernel::getValue() const
 {
+    loadDeferred();
     return *_cPoints;
 }
 
 const Data::ComplexGeoData* PropertyPointKernel::getComplexData() const
 {
-    return _cPoints;
+    loadDeferred();
+    return _cPoints.get();
 }
 
 void PropertyPointKernel::setTransform(const Base::Matrix4D& rclTrf)
 {
-    _cPoints->setTransform(rclTrf);
+    loadDeferred();
+    _cPoints.detach()->setTransform(rclTrf);
 }
 
 Base::Matrix4D PropertyPointKernel::getTransform() const
 {
+    loadDeferred();
     return _cPoints->getTransform();
 }
 
 Base::BoundBox3d PropertyPointKernel::getBoundingBox() const
 {
+    loadDeferred();
     return _cPoints->getBoundBox();
 }
 
 PyObject* PropertyPointKernel::getPyObject()
 {
-    PointsPy* points = new PointsPy(&*_cPoints);
+    loadDeferred();
+    PointsPy* points = new PointsPy(_cPoints.get());
     points->setConst();  // set immutable
     return points;
 }
@@ -97,6 +106,8 @@ void PropertyPointKernel::setPyObject(PyObject* value)
 
 void PropertyPointKernel::Save(Base::Writer& writer) const
 {
+    // the file is written by the point kernel itself
+    loadDeferred();
     _cPoints->Save(writer);
 }
 
@@ -115,7 +126,7 @@ void PropertyPointKernel::Restore(Base::XMLReader& reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
-        _cPoints->setTransform(mtrx);
+        _cPoints.detach()->setTransform(mtrx);
         hasSetValue();
     }
 }
@@ -129,14 +140,48 @@ void PropertyPointKernel::SaveDocFile(Base::Writer& writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader& reader)
 {
     aboutToSetValue();
-    _cPoints->RestoreDocFile(reader);
+    // the whole content gets replaced
+    _cPoints.detach(false)->RestoreDocFile(reader);
     hasSetValue();
 }
 
+void PropertyPointKernel::deferRestoreDocFile(const std::shared_ptr<Base::DeferredDocFile>& file)
+{
+    _deferred.setFile(file);
+}
+
+void PropertyPointKernel::loadDeferred() const
+{
+    if (!_deferred.hasFile()) {
+        return;
+    }
+
+    auto self = const_cast<PropertyPointKernel*>(this);
+    try {
+        _deferred.load([self](Base::Reader& reader) {
+            // Do not signal a change, the points are the restored ones. Copies sharing
+            // the still empty kernel load it on their own.
+            self->_cPoints.detach()->RestoreDocFile(reader);
+        });
+    }
+    catch (const Base::Exception& e) {
+        Base::Console().Error("Failed to load points of %s: %s\n",
+                              getFullName().c_str(),
+                              e.what());
+    }
+    catch (const std::exception& e) {
+        Base::Console().Error("Failed to load points of %s: %s\n",
+                              getFullName().c_str(),
+                              e.what());
+    }
+}
+
 App::Property* PropertyPointKernel::Copy() const
 {
     PropertyPointKernel* prop = new PropertyPointKernel();
-    (*prop->_cPoints) = (*this->_cPoints);
+    prop->_cPoints = this->_cPoints;
+    // share the still compressed data instead of loading it
+    prop->_deferred.setFile(_deferred.getFile());
     return prop;
 }
 
@@ -144,19 +189,26 @@ void PropertyPointKernel::Paste(const App::Property& from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
-    *(this->_cPoints) = *(prop._cPoints);
+    prop.loadDeferred();
+    _deferred.reset();
+    if (this->_cPoints.get() != prop._cPoints.get()) {
+        *(this->_cPoints.detach(false)) = *(prop._cPoints);
+    }
     hasSetValue();
 }
 
 unsigned int PropertyPointKernel::getMemSize() const
 {
-    return sizeof(Base::Vector3f) * this->_cPoints->size();
+    return sizeof(Base::Vector3f) * this->_cPoints->size()
+        / static_cast<unsigned int>(this->_cPoints.useCount())
+        + static_cast<unsigned int>(_deferred.getCompressedSize());
 }
 
 PointKernel* PropertyPointKernel::startEditing()
 {
+    loadDeferred();
     aboutToSetValue();
-    return static_cast<PointKernel*>(_cPoints);
+    return _cPoints.detach();
 }
 
 void PropertyPointKernel::finishEditing()
@@ -167,6 +219,7 @@ void PropertyPointKernel::finishEditing()
 void PropertyPointKernel::removeIndices(const std::vector<unsigned long>& uIndices)
 {
     // We need a sorted array
+    loadDeferred();
     std::vector<unsigned long> uSortedInds = uIndices;
     std::sort(uSortedInds.begin(), uSortedInds.end());
 
@@ -198,7 +251,8 @@ void PropertyPointKernel::removeIndices(const std::vector<unsigned long>& uIndic
 
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D& rclMat)
 {
+    loadDeferred();
     aboutToSetValue();
-    _cPoints->transformGeometry(rclMat);
+    _cPoints.detach()->transformGeometry(rclMat);
     hasSetValue();
 }
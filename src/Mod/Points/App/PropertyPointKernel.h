@@ -24,6 +24,9 @@
 #ifndef POINTS_PROPERTYPOINTKERNEL_H
 #define POINTS_PROPERTYPOINTKERNEL_H
 
+#include <Base/CopyOnWrite.h>
+#include <Base/Reader.h>
+
 #include "Points.h"
 
 namespace Points
@@ -64,9 +67,11 @@ public:
     /** @name Undo/Redo */
     //@{
     /// returns a new copy of the property (mainly for Undo/Redo and transactions)
+    /// that shares the points until either of them gets modified
     App::Property* Copy() const override;
     /// paste the value from the property (mainly for Undo/Redo and transactions)
     void Paste(const App::Property& from) override;
+    /// the size of shared points is split among the copies sharing them
     unsigned int getMemSize() const override;
     //@}
 
@@ -76,6 +81,12 @@ public:
     void Restore(Base::XMLReader& reader) override;
     void SaveDocFile(Base::Writer& writer) const override;
     void RestoreDocFile(Base::Reader& reader) override;
+    bool isRestoreDocFileDeferrable() const override
+    {
+        return true;
+    }
+    /// the points are loaded from \a file as soon as they are accessed
+    void deferRestoreDocFile(const std::shared_ptr<Base::DeferredDocFile>& file) override;
     //@}
 
     /** @name Modification */
@@ -88,7 +99,12 @@ public:
     //@}
 
 private:
-    Base::Reference<PointKernel> _cPoints;
+    /// restore the points if their file has been deferred by a lazy restore
+    void loadDeferred() const;
+
+private:
+    Base::CopyOnWrite<PointKernel> _cPoints;
+    mutable Base::DeferredDocFileHandle _deferred;
 };
 
 }  // namespace Points
@@ -92,13 +92,19 @@ void Segmentation::accept()
 
     MeshCore::MeshSegmentAlgorithm finder(kernel);
     MeshCore::MeshCurvature meshCurv(kernel);
-    meshCurv.ComputePerVertex();
+    // the curvature of the unchanged mesh is kept by its property
+    bool smooth = ui->checkBoxSmooth->isChecked();
+    if (smooth) {
+        meshCurv.ComputePerVertex();
+    }
+    const std::vector<MeshCore::CurvatureInfo>& curv =
+        smooth ? meshCurv.GetCurvature() : myMesh.get<Mesh::Feature>()->Mesh.getCurvature();
 
     // First create segments by curavture to get the surface type
     std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
     if (ui->groupBoxPln->isChecked()) {
         segm.emplace_back(
-            std::make_shared<MeshCore::MeshCurvaturePlanarSegment>(meshCurv.GetCurvature(),
+            std::make_shared<MeshCore::MeshCurvaturePlanarSegment>(curv,
                                                                    ui->numPln->value(),
                                                                    ui->curvTolPln->value()));
     }
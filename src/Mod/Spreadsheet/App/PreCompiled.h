@@ -38,13 +38,17 @@
 
 // STL
 #include <algorithm>
+#include <atomic>
 #include <deque>
+#include <future>
 #include <iomanip>
 #include <map>
 #include <memory>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 // boost
 #include <boost/algorithm/string/predicate.hpp>
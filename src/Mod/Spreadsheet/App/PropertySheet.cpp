@@ -29,6 +29,7 @@
 #include <boost/regex.hpp>
 #endif
 
+#include <App/CompiledExpression.h>
 #include <App/Document.h>
 #include <App/DocumentObject.h>
 #include <App/DocumentObserver.h>
@@ -756,8 +757,7 @@ void PropertySheet::setAlias(CellAddress address, const std::string& alias)
      * disappears */
     std::string fullName = owner->getFullName() + "." + address.toString();
 
-    std::map<std::string, std::set<CellAddress>>::const_iterator j =
-        propertyNameToCellMap.find(fullName);
+    auto j = propertyNameToCellMap.find(fullName);
     if (j != propertyNameToCellMap.end()) {
         std::set<CellAddress>::const_iterator k = j->second.begin();
 
@@ -771,6 +771,9 @@ void PropertySheet::setAlias(CellAddress address, const std::string& alias)
     cell->getAlias(oldAlias);
     cell->setAlias(alias);
 
+    // Compiled expressions may have resolved the alias to a cell property
+    App::CompiledExpression::invalidate();
+
     if (!oldAlias.empty()) {
         std::map<App::ObjectIdentifier, App::ObjectIdentifier> m;
 
@@ -1407,14 +1410,13 @@ void PropertySheet::removeDependencies(CellAddress key)
 {
     /* Remove from Property <-> Key maps */
 
-    std::map<CellAddress, std::set<std::string>>::iterator i1 = cellToPropertyNameMap.find(key);
+    auto i1 = cellToPropertyNameMap.find(key);
 
     if (i1 != cellToPropertyNameMap.end()) {
         std::set<std::string>::const_iterator j = i1->second.begin();
 
         while (j != i1->second.end()) {
-            std::map<std::string, std::set<CellAddress>>::iterator k =
-                propertyNameToCellMap.find(*j);
+            auto k = propertyNameToCellMap.find(*j);
 
             // assert(k != propertyNameToCellMap.end());
             if (k != propertyNameToCellMap.end()) {
@@ -1428,14 +1430,13 @@ void PropertySheet::removeDependencies(CellAddress key)
 
     /* Remove from DocumentObject <-> Key maps */
 
-    std::map<CellAddress, std::set<std::string>>::iterator i2 = cellToDocumentObjectMap.find(key);
+    auto i2 = cellToDocumentObjectMap.find(key);
 
     if (i2 != cellToDocumentObjectMap.end()) {
         std::set<std::string>::const_iterator j = i2->second.begin();
 
         while (j != i2->second.end()) {
-            std::map<std::string, std::set<CellAddress>>::iterator k =
-                documentObjectToCellMap.find(*j);
+            auto k = documentObjectToCellMap.find(*j);
 
             // assert(k != documentObjectToCellMap.end());
             if (k != documentObjectToCellMap.end()) {
@@ -1610,8 +1611,7 @@ void PropertySheet::documentSet()
 const std::set<CellAddress>& PropertySheet::getDeps(const std::string& name) const
 {
     static std::set<CellAddress> empty;
-    std::map<std::string, std::set<CellAddress>>::const_iterator i =
-        propertyNameToCellMap.find(name);
+    auto i = propertyNameToCellMap.find(name);
 
     if (i != propertyNameToCellMap.end()) {
         return i->second;
@@ -1624,8 +1624,7 @@ const std::set<CellAddress>& PropertySheet::getDeps(const std::string& name) con
 const std::set<std::string>& PropertySheet::getDeps(CellAddress pos) const
 {
     static std::set<std::string> empty;
-    std::map<CellAddress, std::set<std::string>>::const_iterator i =
-        cellToPropertyNameMap.find(pos);
+    auto i = cellToPropertyNameMap.find(pos);
 
     if (i != cellToPropertyNameMap.end()) {
         return i->second;
@@ -1635,6 +1634,19 @@ const std::set<std::string>& PropertySheet::getDeps(CellAddress pos) const
     }
 }
 
+const std::set<std::string>& PropertySheet::getDocumentObjectDeps(CellAddress pos) const
+{
+    static std::set<std::string> empty;
+    auto i = cellToDocumentObjectMap.find(pos);
+
+    if (i != cellToDocumentObjectMap.end()) {
+        return i->second;
+    }
+    else {
+        return empty;
+    }
+}
+
 void PropertySheet::recomputeDependencies(CellAddress key)
 {
     AtomicPropertyChange signaller(*this);
@@ -24,6 +24,7 @@
 #define PROPERTYSHEET_H
 
 #include <map>
+#include <unordered_map>
 
 #include <App/DocumentObject.h>
 #include <App/PropertyLinks.h>
@@ -197,6 +198,8 @@ public:
 
     const std::set<std::string>& getDeps(App::CellAddress pos) const;
 
+    const std::set<std::string>& getDocumentObjectDeps(App::CellAddress pos) const;
+
     void recomputeDependencies(App::CellAddress key);
 
     PyObject* getPyObject() override;
@@ -306,18 +309,18 @@ private:
     /*! Cell dependencies, i.e when a change occurs to property given in key,
       the set of addresses needs to be recomputed.
       */
-    std::map<std::string, std::set<App::CellAddress>> propertyNameToCellMap;
+    std::unordered_map<std::string, std::set<App::CellAddress>> propertyNameToCellMap;
 
     /*! Properties this cell depends on */
-    std::map<App::CellAddress, std::set<std::string>> cellToPropertyNameMap;
+    std::unordered_map<App::CellAddress, std::set<std::string>> cellToPropertyNameMap;
 
     /*! Cell dependencies, i.e when a change occurs to documentObject given in key,
       the set of addresses needs to be recomputed.
       */
-    std::map<std::string, std::set<App::CellAddress>> documentObjectToCellMap;
+    std::unordered_map<std::string, std::set<App::CellAddress>> documentObjectToCellMap;
 
     /*! DocumentObject this cell depends on */
-    std::map<App::CellAddress, std::set<std::string>> cellToDocumentObjectMap;
+    std::unordered_map<App::CellAddress, std::set<std::string>> cellToDocumentObjectMap;
 
     /*! Mapping of cell position to alias property */
     std::map<App::CellAddress, std::string> aliasProp;
@@ -23,10 +23,15 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <algorithm>
+#include <atomic>
 #include <boost/tokenizer.hpp>
 #include <deque>
+#include <future>
 #include <memory>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 #endif
 
 #include <App/Application.h>
@@ -36,6 +41,7 @@
 #include <App/FeaturePythonPyImp.h>
 #include <Base/Exception.h>
 #include <Base/FileInfo.h>
+#include <Base/Interpreter.h>
 #include <Base/Reader.h>
 #include <Base/Stream.h>
 #include <Base/Tools.h>
@@ -720,43 +726,54 @@ Property* Sheet::setObjectProperty(CellAddress key, Py::Object object)
     return pyProp;
 }
 
+namespace
+{
+// The cell evaluated by the current thread, cells of a level may be evaluated concurrently
+thread_local const Sheet* currentSheet = nullptr;
+thread_local CellAddress currentAddress;
+}  // namespace
+
+// Sets the current cell and restores the previous one, a nested evaluation keeps the outer cell
 struct CurrentAddressLock
 {
-    CurrentAddressLock(int& r, int& c, const CellAddress& addr)
-        : row(r)
-        , col(c)
+    CurrentAddressLock(const Sheet* sheet, const CellAddress& addr)
+        : prevSheet(currentSheet)
+        , prevAddress(currentAddress)
     {
-        row = addr.row();
-        col = addr.col();
+        currentSheet = sheet;
+        currentAddress = addr;
     }
     ~CurrentAddressLock()
     {
-        row = -1;
-        col = -1;
+        currentSheet = prevSheet;
+        currentAddress = prevAddress;
     }
+    CurrentAddressLock(const CurrentAddressLock&) = delete;
+    CurrentAddressLock& operator=(const CurrentAddressLock&) = delete;
 
-    int& row;
-    int& col;
+private:
+    const Sheet* prevSheet;
+    CellAddress prevAddress;
 };
 
 /**
- * Update the Property given by \a key. This will also eventually trigger recomputations of cells
- * depending on \a key.
- *
- * @param key The address of the cell we want to recompute.
+ * Evaluate the content of the cell given by \a key. This only reads the sheet and the document,
+ * so the independent cells of a dependency level can be evaluated by several threads at once.
  *
+ * @param key The address of the cell to evaluate.
+ * @return The value of the cell, or null if the cell has no content.
  */
 
-void Sheet::updateProperty(CellAddress key)
+std::unique_ptr<Expression> Sheet::evaluateCell(CellAddress key)
 {
     Cell* cell = getCell(key);
+    std::unique_ptr<Expression> output;
 
     if (cell) {
-        std::unique_ptr<Expression> output;
         const Expression* input = cell->getExpression();
 
         if (input) {
-            CurrentAddressLock lock(currentRow, currentCol, key);
+            CurrentAddressLock lock(this, key);
             output.reset(input->eval());
         }
         else {
@@ -765,52 +782,80 @@ void Sheet::updateProperty(CellAddress key)
             if (cell->getStringContent(s) && !s.empty()) {
                 output = std::make_unique<StringExpression>(this, s);
             }
-            else {
-                this->removeDynamicProperty(key.toString().c_str());
-                return;
-            }
         }
+    }
+    return output;
+}
 
-        /* Eval returns either NumberExpression or StringExpression, or
-         * PyObjectExpression objects */
-        auto number = freecad_dynamic_cast<NumberExpression>(output.get());
-        if (number) {
-            long l;
-            auto constant = freecad_dynamic_cast<ConstantExpression>(output.get());
-            if (constant && !constant->isNumber()) {
-                Base::PyGILStateLocker lock;
-                setObjectProperty(key, constant->getPyValue());
-            }
-            else if (!number->getUnit().isEmpty()) {
-                setQuantityProperty(key, number->getValue(), number->getUnit());
-            }
-            else if (number->isInteger(&l)) {
-                setIntegerProperty(key, l);
-            }
-            else {
-                setFloatProperty(key, number->getValue());
-            }
+/**
+ * Update the Property given by \a key. This will also eventually trigger recomputations of cells
+ * depending on \a key.
+ *
+ * @param key The address of the cell we want to recompute.
+ *
+ */
+
+void Sheet::updateProperty(CellAddress key)
+{
+    if (getCell(key)) {
+        updateProperty(key, evaluateCell(key));
+    }
+    else {
+        clear(key);
+        cellUpdated(key);
+    }
+}
+
+/**
+ * Store the evaluated value \a output of the cell given by \a key in its property.
+ *
+ * @param key The address of the cell.
+ * @param output The value returned by evaluateCell().
+ */
+
+void Sheet::updateProperty(CellAddress key, std::unique_ptr<Expression> output)
+{
+    if (!output) {
+        this->removeDynamicProperty(key.toString().c_str());
+        return;
+    }
+
+    /* Eval returns either NumberExpression or StringExpression, or
+     * PyObjectExpression objects */
+    auto number = freecad_dynamic_cast<NumberExpression>(output.get());
+    if (number) {
+        long l;
+        auto constant = freecad_dynamic_cast<ConstantExpression>(output.get());
+        if (constant && !constant->isNumber()) {
+            Base::PyGILStateLocker lock;
+            setObjectProperty(key, constant->getPyValue());
+        }
+        else if (!number->getUnit().isEmpty()) {
+            setQuantityProperty(key, number->getValue(), number->getUnit());
+        }
+        else if (number->isInteger(&l)) {
+            setIntegerProperty(key, l);
+        }
+        else {
+            setFloatProperty(key, number->getValue());
+        }
+    }
+    else {
+        auto str_expr = freecad_dynamic_cast<StringExpression>(output.get());
+        if (str_expr) {
+            setStringProperty(key, str_expr->getText().c_str());
         }
         else {
-            auto str_expr = freecad_dynamic_cast<StringExpression>(output.get());
-            if (str_expr) {
-                setStringProperty(key, str_expr->getText().c_str());
+            Base::PyGILStateLocker lock;
+            auto py_expr = freecad_dynamic_cast<PyObjectExpression>(output.get());
+            if (py_expr) {
+                setObjectProperty(key, py_expr->getPyValue());
             }
             else {
-                Base::PyGILStateLocker lock;
-                auto py_expr = freecad_dynamic_cast<PyObjectExpression>(output.get());
-                if (py_expr) {
-                    setObjectProperty(key, py_expr->getPyValue());
-                }
-                else {
-                    setObjectProperty(key, Py::Object());
-                }
+                setObjectProperty(key, Py::Object());
             }
         }
     }
-    else {
-        clear(key);
-    }
 
     cellUpdated(key);
 }
@@ -887,9 +932,8 @@ void Sheet::recomputeCells(Range range)
 
 void Sheet::recomputeCell(CellAddress p)
 {
-    Cell* cell = cells.getValue(p);
-
-    try {
+    recomputeCell(p, [this, p]() {
+        Cell* cell = cells.getValue(p);
         if (cell && cell->hasException()) {
             std::string content;
             cell->getStringContent(content);
@@ -897,6 +941,21 @@ void Sheet::recomputeCell(CellAddress p)
         }
 
         updateProperty(p);
+    });
+}
+
+/**
+ * @brief Recompute cell at address \a p with \a update and record the errors it throws.
+ * @param p Address of cell.
+ * @param update Function updating the property of the cell.
+ */
+
+void Sheet::recomputeCell(CellAddress p, const std::function<void()>& update)
+{
+    Cell* cell = cells.getValue(p);
+
+    try {
+        update();
 
         if (!cell || !cell->hasException()) {
             cells.clearDirty(p);
@@ -924,6 +983,90 @@ void Sheet::recomputeCell(CellAddress p)
     }
 }
 
+/**
+ * @brief Recompute the cells of one dependency level. The cells of a level don't depend on each
+ * other, so the expressions of those only referring to this sheet are evaluated by \a threads
+ * threads. The properties are then set from this thread as they emit signals.
+ * @param level Addresses of the cells.
+ * @param threads Maximum number of threads.
+ */
+
+void Sheet::recomputeLevel(const std::vector<CellAddress>& level, int threads)
+{
+    // Below this size starting the threads costs more than the evaluation
+    const std::size_t minParallelCells = 64;
+
+    std::string fullName = getFullName();
+    auto isLocal = [this, &fullName](CellAddress addr) {
+        Cell* cell = cells.getValue(addr);
+        // Failed cells are parsed again, which changes them, so they are recomputed serially
+        if (!cell || !cell->getExpression() || cell->hasException()) {
+            return false;
+        }
+        // Properties of other objects may be computed on access and are read serially
+        const auto& deps = cells.getDocumentObjectDeps(addr);
+        return std::all_of(deps.begin(), deps.end(), [&fullName](const std::string& dep) {
+            return dep == fullName;
+        });
+    };
+
+    std::vector<CellAddress> pending;
+    for (const auto& addr : level) {
+        if (threads > 1 && level.size() >= minParallelCells && isLocal(addr)) {
+            pending.push_back(addr);
+        }
+        else {
+            FC_TRACE(addr.toString());
+            recomputeCell(addr);
+        }
+    }
+    if (pending.empty()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<Expression>> outputs(pending.size());
+    std::vector<std::exception_ptr> errors(pending.size());
+    std::atomic<std::size_t> next(0);
+    auto evaluate = [&]() {
+        for (std::size_t i = next++; i < pending.size(); i = next++) {
+            try {
+                outputs[i] = evaluateCell(pending[i]);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    {
+        // Expressions calling into Python lock the interpreter from the worker threads
+        std::unique_ptr<Base::PyGILStateRelease> release;
+        if (Py_IsInitialized() && PyGILState_Check()) {
+            release = std::make_unique<Base::PyGILStateRelease>();
+        }
+
+        std::vector<std::future<void>> workers;
+        std::size_t count = std::min(pending.size(), std::size_t(threads));
+        for (std::size_t i = 1; i < count; ++i) {
+            workers.push_back(std::async(std::launch::async, evaluate));
+        }
+        evaluate();
+        for (auto& worker : workers) {
+            worker.get();
+        }
+    }
+
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        FC_TRACE(pending[i].toString());
+        recomputeCell(pending[i], [&]() {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+            updateProperty(pending[i], std::move(outputs[i]));
+        });
+    }
+}
+
 PropertySheet::BindingType Sheet::getCellBinding(Range& range,
                                                  ExpressionPtr* pStart,
                                                  ExpressionPtr* pEnd,
@@ -1031,56 +1174,81 @@ DocumentObjectExecReturn* Sheet::execute()
         dirtyCells.insert(cellError);
     }
 
-    DependencyList graph;
-    std::map<CellAddress, Vertex> VertexList;
-    std::map<Vertex, CellAddress> VertexIndexList;
-    std::deque<CellAddress> workQueue(dirtyCells.begin(), dirtyCells.end());
-    while (!workQueue.empty()) {
-        CellAddress currPos = workQueue.front();
-        workQueue.pop_front();
-
-        // Insert into map of CellPos -> Index, if it doesn't exist already
-        auto res = VertexList.emplace(currPos, Vertex());
-        if (res.second) {
-            res.first->second = add_vertex(graph);
-            VertexIndexList[res.first->second] = currPos;
-        }
-
-        // Process cells that depend on the current cell
-        for (auto& dep : providesTo(currPos)) {
-            auto resDep = VertexList.emplace(dep, Vertex());
-            if (resDep.second) {
-                resDep.first->second = add_vertex(graph);
-                VertexIndexList[resDep.first->second] = dep;
-                if (dirtyCells.insert(dep).second) {
-                    workQueue.push_back(dep);
+    // Collect the dirty cells and the cells depending on them
+    std::string prefix = getFullName() + ".";
+    std::vector<CellAddress> nodes(dirtyCells.begin(), dirtyCells.end());
+    std::unordered_map<CellAddress, std::size_t> nodeIndex;
+    std::vector<std::vector<std::size_t>> dependants(nodes.size());
+    nodeIndex.reserve(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodeIndex.emplace(nodes[i], i);
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        for (const auto& dep : cells.getDeps(prefix + nodes[i].toString())) {
+            auto res = nodeIndex.emplace(dep, nodes.size());
+            if (res.second) {
+                nodes.push_back(dep);
+                dependants.emplace_back();
+            }
+            dependants[i].push_back(res.first->second);
+        }
+    }
+
+    // Sort the cells into levels, the cells of a level only depend on the previous levels
+    std::vector<int> inDegree(nodes.size(), 0);
+    for (const auto& deps : dependants) {
+        for (std::size_t dep : deps) {
+            ++inDegree[dep];
+        }
+    }
+    std::vector<std::size_t> current;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (inDegree[i] == 0) {
+            current.push_back(i);
+        }
+    }
+    std::vector<std::vector<CellAddress>> levels;
+    std::size_t sorted = 0;
+    while (!current.empty()) {
+        std::vector<std::size_t> next;
+        std::vector<CellAddress>& level = levels.emplace_back();
+        level.reserve(current.size());
+        for (std::size_t i : current) {
+            level.push_back(nodes[i]);
+            for (std::size_t dep : dependants[i]) {
+                if (--inDegree[dep] == 0) {
+                    next.push_back(dep);
                 }
             }
-            // Add edge to graph to signal dependency
-            add_edge(res.first->second, resDep.first->second, graph);
         }
+        sorted += current.size();
+        current.swap(next);
     }
-    // Compute cells
-    std::list<Vertex> make_order;
-    // Sort graph topologically to find evaluation order
-    try {
-        boost::topological_sort(graph, std::front_inserter(make_order));
+
+    if (sorted == nodes.size()) {
+        // 0 means one thread per core, 1 disables the parallel evaluation
+        int threads = App::GetApplication()
+                          .GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Spreadsheet")
+                          ->GetInt("RecomputeThreads", 0);
+        if (threads <= 0) {
+            threads = std::max(1, int(std::thread::hardware_concurrency()));
+        }
+
         // Recompute cells
         FC_LOG("recomputing " << getFullName());
-        for (auto& pos : make_order) {
-            const auto& addr = VertexIndexList[pos];
-            FC_TRACE(addr.toString());
-            recomputeCell(addr);
+        for (const auto& level : levels) {
+            recomputeLevel(level, threads);
         }
     }
-    catch (std::exception&) {
-        for (auto& v : VertexList) {
-            Cell* cell = cells.getValue(v.first);
+    else {
+        dirtyCells.insert(nodes.begin(), nodes.end());
+        for (const auto& addr : nodes) {
+            Cell* cell = cells.getValue(addr);
             // Mark as erroneous
             if (cell) {
-                cellErrors.insert(v.first);
+                cellErrors.insert(addr);
                 cell->setException("Pending computation due to cyclic dependency", true);
-                cellUpdated(v.first);
+                cellUpdated(addr);
             }
         }
 
@@ -1676,10 +1844,10 @@ bool Sheet::hasCell(const std::vector<App::Range>& ranges) const
 
 std::string Sheet::getRow(int offset) const
 {
-    if (currentRow < 0) {
+    if (currentSheet != this || currentAddress.row() < 0) {
         throw Base::RuntimeError("No current row");
     }
-    int row = currentRow + offset;
+    int row = currentAddress.row() + offset;
     if (row < 0 || row > CellAddress::MAX_ROWS) {
         throw Base::ValueError("Out of range");
     }
@@ -1688,10 +1856,10 @@ std::string Sheet::getRow(int offset) const
 
 std::string Sheet::getColumn(int offset) const
 {
-    if (currentCol < 0) {
+    if (currentSheet != this || currentAddress.col() < 0) {
         throw Base::RuntimeError("No current column");
     }
-    int col = currentCol + offset;
+    int col = currentAddress.col() + offset;
     if (col < 0 || col > CellAddress::MAX_COLUMNS) {
         throw Base::ValueError("Out of range");
     }
@@ -28,7 +28,10 @@
 #define signals signals
 #endif
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <vector>
 
 #include <App/DocumentObject.h>
 #include <App/DynamicProperty.h>
@@ -245,12 +248,20 @@ protected:
 
     void recomputeCell(App::CellAddress p);
 
+    void recomputeCell(App::CellAddress p, const std::function<void()>& update);
+
+    void recomputeLevel(const std::vector<App::CellAddress>& level, int threads);
+
     App::Property* getProperty(App::CellAddress key) const;
 
     App::Property* getProperty(const char* addr) const;
 
+    std::unique_ptr<App::Expression> evaluateCell(App::CellAddress key);
+
     void updateProperty(App::CellAddress key);
 
+    void updateProperty(App::CellAddress key, std::unique_ptr<App::Expression> output);
+
     App::Property* setStringProperty(App::CellAddress key, const std::string& value);
 
     App::Property* setObjectProperty(App::CellAddress key, Py::Object obj);
@@ -289,9 +300,6 @@ protected:
     using ObserverMap = std::map<std::string, SheetObserver*>;
     ObserverMap observers;
 
-    int currentRow = -1;
-    int currentCol = -1;
-
     std::vector<App::Range> boundRanges;
 
     std::vector<App::Range> copyCutRanges;
@@ -1572,6 +1572,35 @@ class SpreadsheetCases(unittest.TestCase):
         self.assertLess(abs(sheet.F4.Value - -1.6971), 0.0001)
         self.assertEqual(sheet.F5, FreeCAD.Vector(1.72, 2.96, 4.2))
 
+    def testWideDependencyLevel(self):
+        """Many independent cells of one level give the same results as a few"""
+        sheet = self.doc.addObject("Spreadsheet::Sheet", "Spreadsheet")
+        count = 500
+        sheet.set("A1", "2")
+        for row in range(1, count + 1):
+            sheet.set("B{}".format(row), "=A1 * {} * 1mm".format(row))
+            sheet.set("C{}".format(row), "=vector(A1; {}; 0)".format(row))
+            sheet.set("D{}".format(row), "=A1 + {}mm".format(row))
+        sheet.set("E1", "=sum(B1:B{})".format(count))
+        self.doc.recompute()
+
+        for row in range(1, count + 1):
+            self.assertEqual(
+                getattr(sheet, "B{}".format(row)), Units.Quantity("{} mm".format(2 * row))
+            )
+            self.assertEqual(getattr(sheet, "C{}".format(row)), FreeCAD.Vector(2, row, 0))
+            self.assertTrue(
+                getattr(sheet, "D{}".format(row)).startswith(
+                    "ERR: Quantity::operator +=(): Unit mismatch in plus operation"
+                )
+            )
+        self.assertEqual(sheet.E1, Units.Quantity("{} mm".format(count * (count + 1))))
+
+        sheet.set("A1", "3")
+        self.doc.recompute()
+        self.assertEqual(sheet.B500, Units.Quantity("1500 mm"))
+        self.assertEqual(sheet.E1, Units.Quantity("{} mm".format(3 * count * (count + 1) // 2)))
+
     def tearDown(self):
         # closing doc
         FreeCAD.closeDocument(self.doc.Name)
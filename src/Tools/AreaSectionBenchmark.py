@@ -0,0 +1,114 @@
+# -*- coding: utf-8 -*-
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""Measure the per level sectioning and pocketing of Path.Area.
+
+The largest solid of every demo part is sectioned from top to bottom at the
+given number of levels and each section is pocketed, like the CAM pocket
+operation does. All levels are computed in one call, which spreads them over
+the available threads, and again one level per call, which keeps to a single
+thread. Both must give the same pockets. The best time out of a few runs is
+reported. The parts in Mod/CAM/DemoParts are used if no file is given.
+
+    python3 AreaSectionBenchmark.py [--repeat N] [--levels N] [file.FCStd ...]
+"""
+
+import os
+import sys
+
+import FreeCAD
+import Part
+import Path
+
+from BenchmarkTools import best, parseOptions, projectFiles
+
+
+PATTERNS = (("ZigZag", 1), ("Offset", 2))
+
+
+def largestSolid(path):
+    doc = FreeCAD.openDocument(path, True)
+    try:
+        objs = [o for o in doc.Objects if hasattr(o, "Shape") and o.Shape.Solids]
+        return max(objs, key=lambda o: o.Shape.Volume).Shape.copy()
+    finally:
+        FreeCAD.closeDocument(doc.Name)
+
+
+def makeArea(shape, pattern):
+    box = shape.BoundBox
+    area = Path.Area()
+    # work plane at the bottom of the part, like the CAM operations use
+    area.setPlane(Part.makeCircle(10, FreeCAD.Vector(box.Center.x, box.Center.y, box.ZMin)))
+    area.add(shape)
+    radius = 0.02 * max(box.XLength, box.YLength)
+    area.setParams(
+        Fill=0,
+        Coplanar=0,
+        PocketMode=pattern,
+        ToolRadius=radius,
+        PocketStepover=radius,
+        SectionTolerance=1e-6,
+    )
+    return area
+
+
+def levelHeights(shape, levels):
+    box = shape.BoundBox
+    step = box.ZLength / levels
+    return [box.ZMax - step * (i + 0.5) for i in range(levels)]
+
+
+def pockets(shape, pattern, heights):
+    area = makeArea(shape, pattern)
+    return [s.getShape() for s in area.makeSections(mode=0, heights=heights)]
+
+
+def pocketsPerLevel(shape, pattern, heights):
+    result = []
+    for z in heights:
+        area = makeArea(shape, pattern)
+        result += [s.getShape() for s in area.makeSections(mode=0, heights=[z])]
+    return result
+
+
+def sameShape(a, b):
+    if a.isNull() or b.isNull():
+        return a.isNull() == b.isNull()
+    return len(a.Edges) == len(b.Edges) and abs(a.Length - b.Length) < 1e-6
+
+
+def main(args):
+    options, files = parseOptions(args, repeat=3, levels=50)
+    repeat = options["repeat"]
+    levels = max(1, options["levels"])
+    files = files or projectFiles("src", "Mod", "CAM", "DemoParts")
+
+    row = "{:<28} {:<7} {:>7} {:>10} {:>10} {:>8} {:>6}"
+    print(
+        row.format("File", "Pattern", "Levels", "Single [s]", "All [s]", "Speedup", "Same")
+    )
+    for path in files:
+        shape = largestSolid(path)
+        heights = levelHeights(shape, levels)
+        for name, pattern in PATTERNS:
+            single, expected = best(repeat, lambda: pocketsPerLevel(shape, pattern, heights))
+            together, result = best(repeat, lambda: pockets(shape, pattern, heights))
+            same = len(result) == len(expected) and all(
+                sameShape(a, b) for a, b in zip(result, expected)
+            )
+            print(
+                row.format(
+                    os.path.basename(path)[:28],
+                    name,
+                    len(result),
+                    "{:.3f}".format(single),
+                    "{:.3f}".format(together),
+                    "{:.2f}".format(single / together if together else 0.0),
+                    "yes" if same else "NO",
+                )
+            )
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,52 @@
+# -*- coding: utf-8 -*-
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""Helpers shared by the *Benchmark.py scripts in this folder.
+
+The scripts import FreeCAD, so run them with the FreeCAD library folder in
+PYTHONPATH, e.g.
+    PYTHONPATH=build/lib python3 src/Tools/MeshImportBenchmark.py --repeat 5
+"""
+
+import os
+import time
+
+
+def parseOptions(args, **defaults):
+    """Split the leading "--name value" pairs off args.
+
+    Returns a dict with the given defaults replaced by the options found, each
+    converted to the type of its default, and the remaining arguments.
+    """
+    options = dict(defaults)
+    args = list(args)
+    while len(args) > 1 and args[0].startswith("--") and args[0][2:] in options:
+        name = args[0][2:]
+        options[name] = type(defaults[name])(args[1])
+        args = args[2:]
+    return options, args
+
+
+def best(repeat, func):
+    """Call func repeat times, at least once.
+
+    Returns the shortest time in seconds and the result of the last call.
+    """
+    elapsed = float("inf")
+    result = None
+    for _ in range(max(1, repeat)):
+        start = time.perf_counter()
+        result = func()
+        elapsed = min(elapsed, time.perf_counter() - start)
+    return elapsed, result
+
+
+def projectFiles(*folder):
+    """Return the project files in the folder, relative to the source tree."""
+    here = os.path.dirname(os.path.abspath(__file__))
+    path = os.path.join(here, "..", "..", *folder)
+    return [
+        os.path.join(path, name)
+        for name in sorted(os.listdir(path))
+        if name.lower().endswith(".fcstd")
+    ]
@@ -0,0 +1,60 @@
+# -*- coding: utf-8 -*-
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""Compare the text and the binary BRep format of project files.
+
+Every given project file is saved once with each shape format, then the
+copies are opened again. The file size, save and restore time are reported.
+The sample models in data/tests are used if no file is given.
+
+    python3 BrepFormatBenchmark.py [--repeat N] [file.FCStd ...]
+"""
+
+import os
+import sys
+import tempfile
+
+import FreeCAD
+
+from BenchmarkTools import best, parseOptions, projectFiles
+
+
+def measure(path, binary, repeat, folder):
+    doc = FreeCAD.openDocument(path, True)
+    doc.BinaryBrep = binary
+    copy = os.path.join(folder, "binary.FCStd" if binary else "text.FCStd")
+    try:
+        saveTime, _ = best(repeat, lambda: doc.saveCopy(copy))
+    finally:
+        FreeCAD.closeDocument(doc.Name)
+
+    def restore():
+        FreeCAD.closeDocument(FreeCAD.openDocument(copy, True).Name)
+
+    restoreTime, _ = best(repeat, restore)
+    return os.path.getsize(copy), saveTime, restoreTime
+
+
+def main(args):
+    options, files = parseOptions(args, repeat=3)
+    files = files or projectFiles("data", "tests")
+
+    row = "{:<28} {:>6} {:>12} {:>10} {:>10}"
+    print(row.format("File", "Format", "Size [KiB]", "Save [s]", "Open [s]"))
+    with tempfile.TemporaryDirectory() as folder:
+        for path in files:
+            for binary in (False, True):
+                size, saveTime, restoreTime = measure(path, binary, options["repeat"], folder)
+                print(
+                    row.format(
+                        os.path.basename(path)[:28],
+                        "binary" if binary else "text",
+                        "{:.1f}".format(size / 1024.0),
+                        "{:.3f}".format(saveTime),
+                        "{:.3f}".format(restoreTime),
+                    )
+                )
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
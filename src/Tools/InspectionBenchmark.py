@@ -0,0 +1,91 @@
+# -*- coding: utf-8 -*-
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""Compare the distance computation of points to a shape.
+
+The points are inspected once with the exact distance to the whole shape and
+once with the distance to the faces found by the tessellation of the shape.
+The points per second of both and the largest difference are reported.
+
+    python3 InspectionBenchmark.py [--points N] [--radius R]
+"""
+
+import random
+import sys
+
+import FreeCAD
+import Inspection
+import Part
+import Points
+
+from BenchmarkTools import best, parseOptions
+
+PARAM = "User parameter:BaseApp/Preferences/Mod/Inspection/Inspection"
+
+
+def createShape():
+    box = Part.makeBox(100, 60, 40)
+    box = box.makeFillet(8, box.Edges)
+    return box.cut(Part.makeCylinder(12, 40, FreeCAD.Vector(50, 30, 0)))
+
+
+def samplePoints(shape, count, radius):
+    random.seed(0)
+    faces = shape.Faces
+    points = []
+    while len(points) < count:
+        face = random.choice(faces)
+        u1, u2, v1, v2 = face.ParameterRange
+        u = random.uniform(u1, u2)
+        v = random.uniform(v1, v2)
+        if not face.isInside(face.valueAt(u, v), 1e-6, True):
+            continue
+        normal = face.normalAt(u, v)
+        points.append(face.valueAt(u, v) + normal * random.uniform(-radius, radius))
+    return points
+
+
+def inspect(doc, exact):
+    FreeCAD.ParamGet(PARAM).SetBool("ExactShapeDistance", exact)
+    feature = doc.getObject("Inspection")
+    feature.touch()
+    elapsed, _ = best(1, doc.recompute)
+    return elapsed, feature.Distances
+
+
+def main(args):
+    options, _ = parseOptions(args, points=2000, radius=2.0)
+    count = options["points"]
+    radius = options["radius"]
+
+    doc = FreeCAD.newDocument("InspectionBenchmark")
+    nominal = doc.addObject("Part::Feature", "Nominal")
+    nominal.Shape = createShape()
+    actual = doc.addObject("Points::Feature", "Actual")
+    actual.Points = Points.Points(samplePoints(nominal.Shape, count, radius))
+    feature = doc.addObject("Inspection::Feature", "Inspection")
+    feature.Actual = actual
+    feature.Nominals = [nominal]
+    feature.SearchRadius = radius
+
+    param = FreeCAD.ParamGet(PARAM)
+    old = param.GetBool("ExactShapeDistance", False)
+    try:
+        exactTime, exactValues = inspect(doc, True)
+        fastTime, fastValues = inspect(doc, False)
+    finally:
+        param.SetBool("ExactShapeDistance", old)
+        FreeCAD.closeDocument(doc.Name)
+
+    diff = max(
+        (abs(a - b) for a, b in zip(exactValues, fastValues) if max(abs(a), abs(b)) <= radius),
+        default=0.0,
+    )
+    print("Points:              {}".format(count))
+    print("Exact [points/s]:    {:.0f}".format(count / exactTime))
+    print("Tessellated [pts/s]: {:.0f}".format(count / fastTime))
+    print("Max. difference:     {:.2e}".format(diff))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,53 @@
+# -*- coding: utf-8 -*-
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""Compare the serial and the parallel decimation of meshes.
+
+Every given mesh is decimated to a tenth of its facets once with a single
+thread and once with all cores. The time, the reached number of facets and
+the estimated error are printed. A subdivided sphere is used if no file is
+given.
+
+    python3 MeshDecimationBenchmark.py [--repeat N] [file.stl ...]
+"""
+
+import os
+import sys
+
+import FreeCAD
+import Mesh
+
+from BenchmarkTools import best, parseOptions
+
+
+def decimate(mesh, threads):
+    copy = mesh.copy()
+    error = copy.decimate(TargetSize=mesh.CountFacets // 10, FeatureAngle=0.5, Threads=threads)
+    return copy.CountFacets, error
+
+
+def main(args):
+    options, files = parseOptions(args, repeat=3)
+    meshes = [(os.path.basename(path), Mesh.Mesh(path)) for path in files]
+    if not meshes:
+        meshes = [("sphere", Mesh.createSphere(10.0, 500))]
+
+    row = "{:<28} {:>8} {:>10} {:>10} {:>10} {:>10}"
+    print(row.format("Mesh", "Threads", "Facets", "Result", "Time [s]", "Error"))
+    for name, mesh in meshes:
+        for threads in (1, 0):
+            seconds, (facets, error) = best(options["repeat"], lambda: decimate(mesh, threads))
+            print(
+                row.format(
+                    name[:28],
+                    threads or os.cpu_count(),
+                    mesh.CountFacets,
+                    facets,
+                    "{:.3f}".format(seconds),
+                    "{:.4g}".format(error),
+                )
+            )
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,71 @@
+# -*- coding: utf-8 -*-
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""Compare the import time of binary STL files.
+
+Every given file is read once by file name, which maps the file into memory
+and decodes it with several threads, and once from a stream, which uses the
+sequential reader. The number of facets and the read times are reported.
+A binary STL of a subdivided sphere is created if no file is given.
+
+    python3 MeshImportBenchmark.py [--repeat N] [file.stl ...]
+"""
+
+import io
+import os
+import sys
+import tempfile
+
+import FreeCAD
+import Mesh
+
+from BenchmarkTools import best, parseOptions
+
+
+def sampleFile(folder):
+    path = os.path.join(folder, "sphere.stl")
+    sphere = Mesh.createSphere(10.0, 500)
+    sphere.write(Filename=path)
+    return path
+
+
+def readMapped(path):
+    mesh = Mesh.Mesh()
+    mesh.read(Filename=path)
+    return mesh
+
+
+def readStream(data):
+    mesh = Mesh.Mesh()
+    mesh.read(Stream=io.BytesIO(data), Format="STL")
+    return mesh
+
+
+def measure(path, repeat):
+    mappedTime, mesh = best(repeat, lambda: readMapped(path))
+    with open(path, "rb") as f:
+        data = f.read()
+    streamTime, _ = best(repeat, lambda: readStream(data))
+    return mesh.CountFacets, mappedTime, streamTime
+
+
+def main(args):
+    options, files = parseOptions(args, repeat=3)
+
+    row = "{:<28} {:>10} {:>11} {:>11}"
+    print(row.format("File", "Facets", "Mapped [s]", "Stream [s]"))
+    with tempfile.TemporaryDirectory() as folder:
+        for path in files or [sampleFile(folder)]:
+            facets, mappedTime, streamTime = measure(path, options["repeat"])
+            print(
+                row.format(
+                    os.path.basename(path)[:28],
+                    facets,
+                    "{:.3f}".format(mappedTime),
+                    "{:.3f}".format(streamTime),
+                )
+            )
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
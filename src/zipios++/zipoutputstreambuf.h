@@ -49,6 +49,17 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes a complete entry whose data has already been deflated
+      (raw deflate, without zlib header) by the caller. The current
+      entry is closed first, and no entry is open afterwards.
+      @param entry the entry to write.
+      @param data the deflated data.
+      @param compressed_size the number of bytes in data.
+      @param size the uncompressed size of the data.
+      @param crc the CRC32 of the uncompressed data. */
+  void putRawEntry( const ZipCDirEntry &entry, const char *data,
+                    uint32 compressed_size, uint32 size, uint32 crc ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -69,6 +80,8 @@ protected:
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
 
+  static int currentDosTime() ;
+
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 
 				     EndOfCentralDirectory eocd,
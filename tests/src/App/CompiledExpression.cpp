@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gtest/gtest.h>
+
+#include "App/Application.h"
+#include "App/CompiledExpression.h"
+#include "App/Document.h"
+#include "App/DocumentObject.h"
+#include "App/Expression.h"
+#include "App/ExpressionParser.h"
+#include "App/PropertyStandard.h"
+#include "App/PropertyUnits.h"
+#include "Base/Exception.h"
+#include "Base/Quantity.h"
+#include <src/App/InitApplication.h>
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+class CompiledExpressionTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+    }
+
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _obj = _doc->addObject("App::FeatureTest");
+        _length = static_cast<App::PropertyLength*>(
+            _obj->addDynamicProperty("App::PropertyLength", "Length"));
+        _ratio = static_cast<App::PropertyFloat*>(
+            _obj->addDynamicProperty("App::PropertyFloat", "Ratio"));
+        _count = static_cast<App::PropertyInteger*>(
+            _obj->addDynamicProperty("App::PropertyInteger", "Count"));
+        _flag =
+            static_cast<App::PropertyBool*>(_obj->addDynamicProperty("App::PropertyBool", "Flag"));
+        _length->setValue(10.0);
+        _ratio->setValue(0.5);
+        _count->setValue(3);
+        _flag->setValue(true);
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    std::unique_ptr<App::Expression> parse(const char* text)
+    {
+        return std::unique_ptr<App::Expression>(App::Expression::parse(_obj, text));
+    }
+
+    std::unique_ptr<App::CompiledExpression> compile(const char* text)
+    {
+        return App::CompiledExpression::compile(parse(text).get());
+    }
+
+    App::CompiledExpression::Value evaluate(const char* text)
+    {
+        auto program = compile(text);
+        EXPECT_TRUE(program) << text;
+        App::CompiledExpression::Value value;
+        if (program) {
+            EXPECT_TRUE(program->evaluate(value)) << text;
+        }
+        return value;
+    }
+
+    App::DocumentObject* obj()
+    {
+        return _obj;
+    }
+    App::PropertyLength* length()
+    {
+        return _length;
+    }
+    App::PropertyInteger* count()
+    {
+        return _count;
+    }
+    App::PropertyBool* flag()
+    {
+        return _flag;
+    }
+
+private:
+    std::string _docName;
+    App::Document* _doc {};
+    App::DocumentObject* _obj {};
+    App::PropertyLength* _length {};
+    App::PropertyFloat* _ratio {};
+    App::PropertyInteger* _count {};
+    App::PropertyBool* _flag {};
+};
+
+TEST_F(CompiledExpressionTest, quantities)
+{
+    auto value = evaluate("Length * 2 + 1 mm");
+    EXPECT_EQ(value.kind, App::CompiledExpression::Kind::Quantity);
+    EXPECT_EQ(value.quantity, Base::Quantity(21.0, Base::Unit::Length));
+
+    value = evaluate("sqrt(Length * Length)");
+    EXPECT_EQ(value.kind, App::CompiledExpression::Kind::Quantity);
+    EXPECT_DOUBLE_EQ(value.quantity.getValue(), 10.0);
+    EXPECT_EQ(value.quantity.getUnit(), Base::Unit::Length);
+}
+
+TEST_F(CompiledExpressionTest, pythonNumberTypes)
+{
+    using Kind = App::CompiledExpression::Kind;
+
+    auto value = evaluate("Count * 2");
+    EXPECT_EQ(value.kind, Kind::Integer);
+    EXPECT_EQ(value.quantity.getValue(), 6.0);
+
+    value = evaluate("Count / 2");
+    EXPECT_EQ(value.kind, Kind::Float);
+    EXPECT_EQ(value.quantity.getValue(), 1.5);
+
+    value = evaluate("Count ^ -1");
+    EXPECT_EQ(value.kind, Kind::Float);
+
+    value = evaluate("Ratio + Flag");
+    EXPECT_EQ(value.kind, Kind::Float);
+    EXPECT_EQ(value.quantity.getValue(), 1.5);
+
+    value = evaluate("Count > 1");
+    EXPECT_EQ(value.kind, Kind::Boolean);
+    EXPECT_EQ(value.quantity.getValue(), 1.0);
+
+    value = evaluate("-Flag");
+    EXPECT_EQ(value.kind, Kind::Integer);
+    EXPECT_EQ(value.quantity.getValue(), -1.0);
+}
+
+TEST_F(CompiledExpressionTest, conditional)
+{
+    auto program = compile("Flag ? Length : 2 mm");
+    ASSERT_TRUE(program);
+
+    App::CompiledExpression::Value value;
+    ASSERT_TRUE(program->evaluate(value));
+    EXPECT_EQ(value.quantity, Base::Quantity(10.0, Base::Unit::Length));
+
+    flag()->setValue(false);
+    ASSERT_TRUE(program->evaluate(value));
+    EXPECT_EQ(value.quantity, Base::Quantity(2.0, Base::Unit::Length));
+}
+
+TEST_F(CompiledExpressionTest, bindingsReadCurrentValues)
+{
+    auto program = compile("Length + Count * 1 mm");
+    ASSERT_TRUE(program);
+
+    length()->setValue(1.0);
+    count()->setValue(4);
+    App::CompiledExpression::Value value;
+    ASSERT_TRUE(program->evaluate(value));
+    EXPECT_EQ(value.quantity, Base::Quantity(5.0, Base::Unit::Length));
+}
+
+TEST_F(CompiledExpressionTest, unsupportedExpressions)
+{
+    EXPECT_FALSE(compile("Length.Value"));
+    EXPECT_FALSE(compile("<<text>>"));
+    EXPECT_FALSE(compile("Count % 2"));
+    EXPECT_FALSE(compile("rotationx(Length)"));
+    EXPECT_FALSE(compile("Label"));
+    // Unit errors in constant parts are left to the interpreter
+    EXPECT_FALSE(compile("Length + (1 mm + 1 s)"));
+}
+
+TEST_F(CompiledExpressionTest, errorsFallBackToInterpreter)
+{
+    auto program = compile("Length + 2 s");
+    ASSERT_TRUE(program);
+    App::CompiledExpression::Value value;
+    EXPECT_FALSE(program->evaluate(value));
+
+    program = compile("Length / (Count - 3)");
+    ASSERT_TRUE(program);
+    EXPECT_TRUE(program->evaluate(value));
+
+    program = compile("1 / (Count - 3)");
+    ASSERT_TRUE(program);
+    EXPECT_FALSE(program->evaluate(value));
+
+    auto expr = parse("Length + 2 s");
+    EXPECT_THROW(delete expr->eval(), Base::Exception);
+}
+
+TEST_F(CompiledExpressionTest, evalResults)
+{
+    std::unique_ptr<App::Expression> result(parse("Count + 1")->eval());
+    EXPECT_EQ(result->toString(), "4");
+
+    result.reset(parse("Count / 2")->eval());
+    EXPECT_EQ(result->toString(), "1.5");
+
+    result.reset(parse("Count == 3")->eval());
+    EXPECT_EQ(result->toString(), "True");
+
+    result.reset(parse("Length * Ratio")->eval());
+    auto number = Base::freecad_dynamic_cast<App::NumberExpression>(result.get());
+    ASSERT_TRUE(number);
+    EXPECT_EQ(number->getQuantity(), Base::Quantity(5.0, Base::Unit::Length));
+}
+
+TEST_F(CompiledExpressionTest, structureChangesInvalidate)
+{
+    auto revision = App::CompiledExpression::revision();
+    obj()->removeDynamicProperty("Ratio");
+    EXPECT_NE(App::CompiledExpression::revision(), revision);
+    EXPECT_FALSE(compile("Ratio"));
+}
+
+// NOLINTEND(readability-magic-numbers)
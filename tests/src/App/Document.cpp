@@ -5,6 +5,8 @@
 
 #include "App/Application.h"
 #include "App/Document.h"
+#include "App/FeatureTest.h"
+#include "App/RecomputeProfiler.h"
 #include "App/StringHasher.h"
 #include "Base/Writer.h"
 #include <src/App/InitApplication.h>
@@ -94,4 +96,118 @@ TEST_F(DocumentTest, getStringHasherGivesExpectedHasher)
     EXPECT_EQ(hasher, foundHasher);
 }
 
+TEST_F(DocumentTest, recomputeProfilerDisabledRecordsNothing)
+{
+    // Arrange
+    doc()->addObject("App::FeatureTest");
+
+    // Act
+    doc()->recompute();
+
+    // Assert
+    EXPECT_TRUE(doc()->getRecomputeProfiler().getRuns().empty());
+}
+
+TEST_F(DocumentTest, recomputeProfilerRecordsObjectsAndCriticalPath)
+{
+    // Arrange
+    auto base = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto middle = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto top = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    middle->Source1.setValue(base);
+    top->Source1.setValue(middle);
+    auto& profiler = doc()->getRecomputeProfiler();
+    profiler.setEnabled(true);
+
+    // Act
+    doc()->recompute();
+
+    // Assert
+    ASSERT_EQ(profiler.getRuns().size(), 1);
+    const auto& run = profiler.getRuns().back();
+    ASSERT_EQ(run.objects.size(), 3);
+    EXPECT_EQ(run.objects.front().name, base->getNameInDocument());
+    EXPECT_EQ(run.objects.front().count, 1);
+    EXPECT_FALSE(run.objects.front().error);
+    ASSERT_EQ(run.criticalPath.size(), 3);
+    EXPECT_EQ(run.criticalPath.front(), base->getNameInDocument());
+    EXPECT_EQ(run.criticalPath.back(), top->getNameInDocument());
+    EXPECT_LE(run.criticalPathTime, run.time);
+}
+
+TEST_F(DocumentTest, recomputeProfilerKeepsLimitedHistory)
+{
+    // Arrange
+    auto obj = doc()->addObject("App::FeatureTest");
+    auto& profiler = doc()->getRecomputeProfiler();
+    profiler.setEnabled(true);
+    profiler.setHistorySize(2);
+
+    // Act
+    for (int i = 0; i < 3; ++i) {
+        obj->touch();
+        doc()->recompute();
+    }
+
+    // Assert
+    ASSERT_EQ(profiler.getRuns().size(), 2);
+    EXPECT_EQ(profiler.getRuns().back().id, 3);
+}
+
+TEST_F(DocumentTest, recomputeProfilerDropsAbortedRun)
+{
+    // Arrange
+    auto& profiler = doc()->getRecomputeProfiler();
+    profiler.setEnabled(true);
+
+    // Act
+    try {
+        App::RecomputeProfiler::RunGuard run(profiler);
+        EXPECT_TRUE(profiler.isRunning());
+        throw std::runtime_error("aborted");
+    }
+    catch (const std::runtime_error&) {
+    }
+
+    // Assert
+    EXPECT_FALSE(profiler.isRunning());
+    EXPECT_TRUE(profiler.getRuns().empty());
+}
+
+TEST_F(DocumentTest, recomputeProfilerWritesCSV)
+{
+    // Arrange
+    auto obj = doc()->addObject("App::FeatureTest");
+    auto& profiler = doc()->getRecomputeProfiler();
+    profiler.setEnabled(true);
+    doc()->recompute();
+    std::ostringstream str;
+
+    // Act
+    profiler.writeCSV(str);
+
+    // Assert
+    EXPECT_EQ(str.str().rfind("run,name,label,type,reason,time,count,error,critical\n", 0), 0);
+    EXPECT_NE(str.str().find(obj->getNameInDocument()), std::string::npos);
+}
+
+TEST_F(DocumentTest, recomputeProfilerKeepsRunOfNestedRecompute)
+{
+    // Arrange
+    auto obj = doc()->addObject("App::FeatureTest");
+    auto& profiler = doc()->getRecomputeProfiler();
+    profiler.setEnabled(true);
+    profiler.beginRun();
+
+    // Act
+    doc()->recomputeFeature(obj);
+    EXPECT_TRUE(profiler.isRunning());
+    profiler.endRun({obj});
+
+    // Assert
+    ASSERT_EQ(profiler.getRuns().size(), 1);
+    ASSERT_EQ(profiler.getRuns().back().objects.size(), 1);
+    EXPECT_EQ(profiler.getRuns().back().objects.front().count, 1);
+}
+
 // NOLINTEND(readability-magic-numbers)
@@ -8,6 +8,8 @@
 #include "App/Expression.h"
 #include "App/ObjectIdentifier.h"
 #include "App/PropertyExpressionEngine.h"
+#include "App/PropertyUnits.h"
+#include "Base/Exception.h"
 
 #include "src/App/InitApplication.h"
 
@@ -90,4 +92,78 @@ TEST_F(PropertyExpressionEngineTest, executeCrossPropertyReference)
     ;
 }
 
+TEST_F(PropertyExpressionEngineTest, executeAfterInputChange)
+{
+    auto width = static_cast<App::PropertyLength*>(this_obj()->addDynamicProperty("App::PropertyLength", "Width"));
+    auto height = static_cast<App::PropertyLength*>(this_obj()->addDynamicProperty("App::PropertyLength", "Height"));
+    width->setValue(2.0);
+
+    auto height_path = App::ObjectIdentifier::parse(this_obj(), "Height");
+    auto target_path = App::ObjectIdentifier::parse(this_obj(), target_name());
+    this_obj()->setExpression(height_path, std::shared_ptr<App::Expression>(App::Expression::parse(this_obj(), "Width * 2")));
+    this_obj()->setExpression(target_path, std::shared_ptr<App::Expression>(App::Expression::parse(this_obj(), "Height + 1 mm")));
+
+    this_obj()->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(height->getValue(), 4.0);
+    EXPECT_DOUBLE_EQ(static_cast<App::PropertyLength*>(target_prop())->getValue(), 5.0);
+
+    // A change of the input re-evaluates the whole chain
+    width->setValue(3.0);
+    this_obj()->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(height->getValue(), 6.0);
+    EXPECT_DOUBLE_EQ(static_cast<App::PropertyLength*>(target_prop())->getValue(), 7.0);
+
+    // A bound property changed by someone else gets its value back
+    height->setValue(1.0);
+    this_obj()->ExpressionEngine.execute();
+    EXPECT_DOUBLE_EQ(height->getValue(), 6.0);
+    EXPECT_DOUBLE_EQ(static_cast<App::PropertyLength*>(target_prop())->getValue(), 7.0);
+}
+
+TEST_F(PropertyExpressionEngineTest, executeSkipsCleanBindings)
+{
+    auto width = static_cast<App::PropertyLength*>(this_obj()->addDynamicProperty("App::PropertyLength", "Width"));
+    auto height = static_cast<App::PropertyLength*>(this_obj()->addDynamicProperty("App::PropertyLength", "Height"));
+    auto depth = static_cast<App::PropertyLength*>(this_obj()->addDynamicProperty("App::PropertyLength", "Depth"));
+    width->setValue(2.0);
+    depth->setValue(3.0);
+
+    auto height_path = App::ObjectIdentifier::parse(this_obj(), "Height");
+    auto target_path = App::ObjectIdentifier::parse(this_obj(), target_name());
+    this_obj()->setExpression(height_path, std::shared_ptr<App::Expression>(App::Expression::parse(this_obj(), "Width * 2")));
+    this_obj()->setExpression(target_path, std::shared_ptr<App::Expression>(App::Expression::parse(this_obj(), "Depth + 1 mm")));
+
+    auto& engine = this_obj()->ExpressionEngine;
+    engine.execute();
+    EXPECT_DOUBLE_EQ(height->getValue(), 4.0);
+    EXPECT_DOUBLE_EQ(static_cast<App::PropertyLength*>(target_prop())->getValue(), 4.0);
+    unsigned long evaluations = engine.numEvaluations();
+    EXPECT_EQ(evaluations, 2u);
+
+    // Nothing changed, so nothing is evaluated
+    engine.execute();
+    EXPECT_EQ(engine.numEvaluations(), evaluations);
+
+    // Only the binding that reads the changed property is evaluated
+    width->setValue(3.0);
+    engine.execute();
+    EXPECT_DOUBLE_EQ(height->getValue(), 6.0);
+    EXPECT_EQ(engine.numEvaluations(), evaluations + 1);
+}
+
+TEST_F(PropertyExpressionEngineTest, rejectCyclicBinding)
+{
+    auto width = static_cast<App::PropertyLength*>(this_obj()->addDynamicProperty("App::PropertyLength", "Width"));
+    width->setValue(2.0);
+
+    auto width_path = App::ObjectIdentifier::parse(this_obj(), "Width");
+    auto target_path = App::ObjectIdentifier::parse(this_obj(), target_name());
+    this_obj()->setExpression(target_path, std::shared_ptr<App::Expression>(App::Expression::parse(this_obj(), "Width * 2")));
+    this_obj()->ExpressionEngine.execute();
+
+    std::shared_ptr<App::Expression> cycle(App::Expression::parse(this_obj(), target_name() + " + 1 mm"));
+    EXPECT_THROW(this_obj()->setExpression(width_path, cycle), Base::RuntimeError);
+    EXPECT_EQ(this_obj()->ExpressionEngine.getExpressions().size(), 1u);
+}
+
 // clang-format on
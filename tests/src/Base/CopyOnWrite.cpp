@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <Base/CopyOnWrite.h>
+
+namespace
+{
+
+class Data: public Base::Handled
+{
+    int myValue {};
+
+public:
+    Data() = default;
+    explicit Data(int val)
+        : myValue(val)
+    {}
+    Data(const Data& other)
+        : myValue(other.myValue)
+    {}
+    Data(Data&& other) noexcept
+        : myValue(other.myValue)
+    {
+        other.myValue = 0;
+    }
+    int getValue() const
+    {
+        return myValue;
+    }
+    void setValue(int val)
+    {
+        myValue = val;
+    }
+};
+
+}  // namespace
+
+TEST(CopyOnWrite, TestCopyShares)
+{
+    Base::CopyOnWrite<Data> data(new Data(1));
+    Base::CopyOnWrite<Data> copy(data);
+    EXPECT_EQ(data.get(), copy.get());
+    EXPECT_EQ(data.useCount(), 2);
+    EXPECT_EQ(copy.useCount(), 2);
+}
+
+TEST(CopyOnWrite, TestDetachKeepsObject)
+{
+    Base::CopyOnWrite<Data> data(new Data(1));
+    Data* object = data.get();
+    Base::CopyOnWrite<Data> copy(data);
+    Base::CopyOnWrite<Data> other(copy);
+
+    EXPECT_EQ(data.detach(), object);
+    data->setValue(2);
+    EXPECT_EQ(data->getValue(), 2);
+    EXPECT_EQ(data.useCount(), 1);
+    EXPECT_NE(copy.get(), object);
+    EXPECT_EQ(copy.get(), other.get());
+    EXPECT_EQ(copy->getValue(), 1);
+}
+
+TEST(CopyOnWrite, TestDetachMovesContent)
+{
+    Base::CopyOnWrite<Data> data(new Data(1));
+    Base::CopyOnWrite<Data> copy(data);
+    data.detach(false)->setValue(2);
+    EXPECT_EQ(data->getValue(), 2);
+    EXPECT_EQ(copy->getValue(), 1);
+}
+
+TEST(CopyOnWrite, TestDetachUnshared)
+{
+    Base::CopyOnWrite<Data> data(new Data(1));
+    Data* object = data.get();
+    EXPECT_EQ(data.detach(), object);
+    EXPECT_EQ(data->getValue(), 1);
+}
+
+TEST(CopyOnWrite, TestReset)
+{
+    Base::CopyOnWrite<Data> data(new Data(1));
+    Base::CopyOnWrite<Data> copy(data);
+    data.reset(new Data(2));
+    EXPECT_EQ(data->getValue(), 2);
+    EXPECT_EQ(copy->getValue(), 1);
+    EXPECT_EQ(data.useCount(), 1);
+    EXPECT_EQ(copy.useCount(), 1);
+}
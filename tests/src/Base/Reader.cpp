@@ -9,6 +9,8 @@
 #include "Base/Exception.h"
 #include "Base/Reader.h"
 #include <array>
+#include <zipios++/zipfile.h>
+#include <zipios++/zipoutputstream.h>
 #include <boost/filesystem.hpp>
 #include <fstream>
 
@@ -338,3 +340,84 @@ TEST_F(ReaderTest, invalidDefaults)
     EXPECT_THROW({ Reader()->getAttributeAsInteger("missing", "Not a Float"); },
                  std::invalid_argument);
 }
+
+TEST(DeferredDocFileTest, fromArchive)
+{
+    // Arrange
+    auto path = fs::temp_directory_path() / "unit_test_DeferredDocFile.zip";
+    std::string data(10000, 'x');
+    data += "end";
+    {
+        std::ofstream file(path.string(), std::ios::out | std::ios::binary);
+        zipios::ZipOutputStream zip(file);
+        zip.putNextEntry("Document.xml");
+        zip << "<Document/>";
+        zip.putNextEntry("Shape.brp");
+        zip << data;
+        zip.close();
+    }
+
+    // Act
+    std::string result;
+    {
+        zipios::ZipFile zip(path.string());
+        std::ifstream archive(path.string(), std::ios::in | std::ios::binary);
+        auto file = Base::DeferredDocFile::fromArchive(zip, archive, "Shape.brp", 1);
+        file->restore([&result](Base::Reader& reader) {
+            result.assign(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>());
+        });
+        EXPECT_EQ(file->getFileName(), "Shape.brp");
+        EXPECT_LT(file->getCompressedSize(), data.size());
+        EXPECT_THROW(Base::DeferredDocFile::fromArchive(zip, archive, "Missing.brp", 1),
+                     Base::FileException);
+    }
+    fs::remove(path);
+
+    // Assert
+    EXPECT_EQ(result, data);
+}
+
+TEST(DeferredDocFileTest, loadHandleOnce)
+{
+    // Arrange
+    auto path = fs::temp_directory_path() / "unit_test_DeferredDocFileHandle.zip";
+    {
+        std::ofstream file(path.string(), std::ios::out | std::ios::binary);
+        zipios::ZipOutputStream zip(file);
+        zip.putNextEntry("Mesh.bms");
+        zip << "data";
+        zip.close();
+    }
+    Base::DeferredDocFileHandle handle;
+    Base::DeferredDocFileHandle copy;
+    {
+        zipios::ZipFile zip(path.string());
+        std::ifstream archive(path.string(), std::ios::in | std::ios::binary);
+        handle.setFile(Base::DeferredDocFile::fromArchive(zip, archive, "Mesh.bms", 1));
+    }
+    fs::remove(path);
+    copy.setFile(handle.getFile());
+
+    // Act
+    int count = 0;
+    auto read = [&count](Base::Reader& reader) {
+        std::string data;
+        reader >> data;
+        EXPECT_EQ(data, "data");
+        count++;
+    };
+    handle.load(read);
+    handle.load(read);
+
+    // Assert
+    EXPECT_EQ(count, 1);
+    EXPECT_FALSE(handle.hasFile());
+    EXPECT_EQ(handle.getCompressedSize(), 0);
+    // a copy keeps the file, even if restoring it fails
+    EXPECT_TRUE(copy.hasFile());
+    EXPECT_THROW(copy.load([](Base::Reader&) {
+        throw Base::FileException("broken");
+    }),
+                 Base::FileException);
+    EXPECT_FALSE(copy.hasFile());
+}
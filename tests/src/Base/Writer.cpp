@@ -2,7 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <memory>
+#include <sstream>
+
 #include "Base/Exception.h"
+#include "Base/FileInfo.h"
+#include "Base/Persistence.h"
 #include "Base/Writer.h"
 
 // Writer is designed to be a base class, so for testing we actually instantiate a StringWriter,
@@ -129,3 +135,196 @@ TEST_F(WriterTest, charStreamBase64Encoded)
     // Conversion done using https://www.base64encode.org for testing purposes
     EXPECT_EQ(std::string("RnJlZUNBRCByb2NrcyEg8J+qqPCfqqjwn6qo\n"), _writer.getString());
 }
+
+namespace
+{
+
+class TestPersistence: public Base::Persistence
+{
+public:
+    TestPersistence(std::string data, bool threadSafe)
+        : data(std::move(data))
+        , threadSafe(threadSafe)
+    {}
+    unsigned int getMemSize() const override
+    {
+        return 0;
+    }
+    void Save(Base::Writer& /*writer*/) const override
+    {}
+    void Restore(Base::XMLReader& /*reader*/) override
+    {}
+    void SaveDocFile(Base::Writer& writer) const override
+    {
+        if (data == "throw") {
+            throw Base::RuntimeError("SaveDocFile failed");
+        }
+        ++saveCount;
+        writer.Stream() << data;
+        if (nested) {
+            addedName = writer.addFile("nested.txt", nested);
+        }
+    }
+    bool isSaveDocFileThreadSafe(const Base::Writer& /*writer*/) const override
+    {
+        return threadSafe;
+    }
+    std::string getArchivedDocFile(const std::string& archive) const override
+    {
+        return archive == archiveId ? archiveFile : std::string();
+    }
+    void setArchivedDocFile(const std::string& archive, const std::string& file) const override
+    {
+        archiveId = archive;
+        archiveFile = file;
+    }
+
+    std::string data;
+    bool threadSafe;
+    const Base::Persistence* nested {};
+    mutable std::string addedName;
+    mutable int saveCount {};
+    mutable std::string archiveId;
+    mutable std::string archiveFile;
+};
+
+std::vector<std::pair<std::string, std::string>> readZip(const std::string& zip)
+{
+    std::vector<std::pair<std::string, std::string>> entries;
+    std::istringstream str(zip);
+    zipios::ZipInputStream zipstream(str);
+    zipios::ConstEntryPointer entry = zipstream.getNextEntry();
+    while (entry->isValid()) {
+        std::string content((std::istreambuf_iterator<char>(zipstream)),
+                            std::istreambuf_iterator<char>());
+        entries.emplace_back(entry->getName(), content);
+        zipstream.clear();
+        try {
+            entry = zipstream.getNextEntry();
+        }
+        catch (const std::exception&) {
+            break;
+        }
+    }
+    return entries;
+}
+
+std::string writeZip(const std::vector<TestPersistence*>& objects, int threads)
+{
+    std::ostringstream str;
+    {
+        Base::ZipWriter writer(str);
+        writer.setLevel(7);
+        writer.setThreadCount(threads);
+        writer.putNextEntry("Document.xml");
+        writer.Stream() << "<Document/>";
+        for (auto obj : objects) {
+            writer.addFile("File.bin", obj);
+        }
+        writer.writeFiles();
+    }
+    return str.str();
+}
+
+}  // namespace
+
+TEST(ZipWriterTest, writeFilesParallelMatchesSerial)
+{
+    // Arrange
+    std::vector<std::unique_ptr<TestPersistence>> objects;
+    std::vector<TestPersistence*> pointers;
+    for (int i = 0; i < 50; ++i) {
+        objects.push_back(
+            std::make_unique<TestPersistence>(std::string(i * 1000, char('a' + i % 26)), i % 3 != 0));
+        pointers.push_back(objects.back().get());
+    }
+
+    // Act
+    auto serial = readZip(writeZip(pointers, 1));
+    auto parallel = readZip(writeZip(pointers, 4));
+
+    // Assert
+    ASSERT_EQ(serial.size(), 51U);
+    EXPECT_EQ(serial, parallel);
+    EXPECT_EQ(parallel[0].second, "<Document/>");
+    EXPECT_EQ(parallel[10].second, objects[9]->data);
+}
+
+TEST(ZipWriterTest, writeFilesParallelNestedFile)
+{
+    // Arrange
+    TestPersistence nested("nested data", true);
+    TestPersistence first("first", false);
+    TestPersistence second("second", true);
+    first.nested = &nested;
+
+    // Act
+    auto entries = readZip(writeZip({&first, &second}, 4));
+
+    // Assert
+    ASSERT_EQ(entries.size(), 4U);
+    EXPECT_EQ(entries[1].second, "first");
+    EXPECT_EQ(entries[2].second, "second");
+    EXPECT_EQ(entries[3].first, first.addedName);
+    EXPECT_EQ(entries[3].second, "nested data");
+}
+
+TEST(ZipWriterTest, writeFilesParallelError)
+{
+    // Arrange
+    TestPersistence good("good", true);
+    TestPersistence bad("throw", true);
+
+    // Act & Assert
+    EXPECT_THROW(writeZip({&good, &bad}, 4), Base::RuntimeError);
+}
+
+TEST(ZipWriterTest, copyUnchangedFilesFromPreviousArchive)
+{
+    // Arrange
+    TestPersistence unchanged(std::string(5000, 'u'), true);
+    TestPersistence changed("old", true);
+    std::string path = Base::FileInfo::getTempFileName();
+    auto write = [&](const std::string& id, const std::string& previousId, int threads) {
+        std::ostringstream str;
+        {
+            Base::ZipWriter writer(str);
+            writer.setThreadCount(threads);
+            writer.setArchiveId(id);
+            writer.setPreviousArchive(previousId.empty() ? std::string() : path, previousId);
+            writer.putNextEntry("Document.xml");
+            writer.Stream() << "<Document/>";
+            writer.addFile("Unchanged.bin", &unchanged);
+            writer.addFile("Changed.bin", &changed);
+            writer.writeFiles();
+        }
+        return str.str();
+    };
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        file << write("first", "", 1);
+    }
+    changed.data = "new";
+    changed.archiveId.clear();
+
+    for (int threads : {1, 4}) {
+        unchanged.saveCount = 0;
+        changed.saveCount = 0;
+
+        // Act
+        auto entries = readZip(write("second", "first", threads));
+
+        // Assert
+        ASSERT_EQ(entries.size(), 3U);
+        EXPECT_EQ(entries[1].second, unchanged.data);
+        EXPECT_EQ(entries[2].second, "new");
+        EXPECT_EQ(unchanged.saveCount, 0);
+        EXPECT_EQ(changed.saveCount, 1);
+        EXPECT_EQ(unchanged.archiveId, "second");
+        EXPECT_EQ(changed.archiveId, "second");
+
+        unchanged.archiveId = "first";
+        changed.archiveId.clear();
+    }
+    Base::FileInfo(path).deleteFile();
+}
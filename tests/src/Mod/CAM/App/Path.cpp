@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <Mod/CAM/App/Path.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+namespace
+{
+
+// appends lines of moves with comments in between
+void addMoves(std::ostringstream& str, int& line, std::size_t size)
+{
+    std::size_t end = str.tellp() + std::streamoff(size);
+    while (std::size_t(str.tellp()) < end) {
+        if (line % 97 == 0) {
+            str << "(G20 G21 in a comment)\n";
+        }
+        str << "G1 X" << line % 100 << ".125 Y" << line % 37 << ".5 Z-1.25 F500\n";
+        line++;
+    }
+}
+
+// appends lines of moves that switch between inches and millimeters every few lines
+void addSwitches(std::ostringstream& str, int& line, std::size_t size)
+{
+    std::size_t end = str.tellp() + std::streamoff(size);
+    while (std::size_t(str.tellp()) < end) {
+        str << (line % 2 ? "G20\n" : "G21\n");
+        addMoves(str, line, 100);
+    }
+}
+
+}  // namespace
+
+TEST(Toolpath, parseLargeProgramInParts)
+{
+    if (std::thread::hardware_concurrency() < 2) {
+        GTEST_SKIP() << "large programs are only parsed in parts with several threads";
+    }
+
+    // More than 2 MiB, so that it is parsed in at least two parts. The units switch everywhere
+    // in the first and last quarter, the middle half is in inches without a G20 or G21, so
+    // that parts without any of them inherit the units of an earlier part.
+    const std::size_t quarter = 3 << 19;
+    std::ostringstream str;
+    int line = 0;
+    addMoves(str, line, 1000);  // moves before the first G20 or G21
+    addSwitches(str, line, quarter);
+    str << "G20\n";
+    addMoves(str, line, 2 * quarter);
+    addSwitches(str, line, quarter);
+    std::string gcode = str.str();
+    ASSERT_GT(gcode.size(), std::size_t(2 << 20));
+
+    Path::Toolpath parts;
+    parts.setFromGCode(gcode);
+
+    // the stream is always parsed as one part
+    Path::Toolpath single;
+    std::istringstream input(gcode);
+    single.setFromGCode(input);
+
+    ASSERT_EQ(parts.getSize(), single.getSize());
+    EXPECT_EQ(parts.toGCode(), single.toGCode());
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
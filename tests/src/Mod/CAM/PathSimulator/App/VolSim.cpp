@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Mod/CAM/PathSimulator/App/VolSim.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+namespace
+{
+
+const float resolution = 0.1F;
+
+// the volume of the tessellated stock
+double stockVolume(cStock& stock)
+{
+    Mesh::MeshObject outer;
+    Mesh::MeshObject inner;
+    stock.Tessellate(outer, inner);
+    outer.addMesh(inner);
+    return outer.getVolume();
+}
+
+}  // namespace
+
+TEST(VolSim, pocketInTallStock)
+{
+    // the stock is higher than wide, so clipping the rows with the width would skip the pocket
+    cStock stock(0.0F, 0.0F, 0.0F, 10.0F, 40.0F, 10.0F, resolution);
+    double volume = stockVolume(stock);
+    EXPECT_NEAR(volume, 4000.0, 1.0);
+
+    stock.CreatePocket(5.0F, 20.0F, 3.0F, 6.0F);
+    double expected = M_PI * 3.0 * 3.0 * 4.0;
+    EXPECT_NEAR(volume - stockVolume(stock), expected, expected * 0.05);
+}
+
+TEST(VolSim, pocketAtEdgeOfWideStock)
+{
+    cStock stock(0.0F, 0.0F, 0.0F, 40.0F, 10.0F, 10.0F, resolution);
+    double volume = stockVolume(stock);
+
+    // the circle is cut off one unit above its center
+    stock.CreatePocket(20.0F, 9.0F, 3.0F, 6.0F);
+    double segment = 9.0 * std::acos(1.0 / 3.0) - std::sqrt(8.0);
+    double expected = (M_PI * 3.0 * 3.0 - segment) * 4.0;
+    EXPECT_NEAR(volume - stockVolume(stock), expected, expected * 0.05);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
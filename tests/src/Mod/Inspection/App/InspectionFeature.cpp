@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <Base/FileInfo.h>
+#include <Base/Interpreter.h>
+#include <Base/Parameter.h>
+#include <Base/Stream.h>
+#include <App/Application.h>
+#include <App/Document.h>
+#include <src/App/InitApplication.h>
+#include <Mod/Inspection/App/InspectionFeature.h>
+#include <Mod/Mesh/App/MeshFeature.h>
+#include <Mod/Points/App/PointsFeature.h>
+#include <BRepBndLib.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <Bnd_Box.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+
+class InspectionFeatureTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+        Base::Interpreter().runString("import Inspection");
+    }
+
+    void SetUp() override
+    {
+        document = App::GetApplication().newDocument("Inspection");
+
+        // the nominal is the square [0, 10] x [0, 10] of the plane z = 0
+        MeshCore::MeshKernel kernel;
+        Base::Vector3f p1 {0, 0, 0};
+        Base::Vector3f p2 {10, 0, 0};
+        Base::Vector3f p3 {10, 10, 0};
+        Base::Vector3f p4 {0, 10, 0};
+        kernel.AddFacet(MeshCore::MeshGeomFacet(p1, p2, p3));
+        kernel.AddFacet(MeshCore::MeshGeomFacet(p1, p3, p4));
+        auto nominal = static_cast<Mesh::Feature*>(document->addObject("Mesh::Feature", "Nominal"));
+        nominal->Mesh.setValue(kernel);
+
+        // the actual points are the plane offset by 0.25, one point below the plane and one
+        // outside of the search radius
+        Points::PointKernel points;
+        for (int i = 1; i < 10; i++) {
+            for (int j = 1; j < 10; j++) {
+                points.push_back(Base::Vector3d(i, j, 0.25));
+            }
+        }
+        points.push_back(Base::Vector3d(5, 5, -0.5));
+        points.push_back(Base::Vector3d(5, 5, 3.0));
+        auto actual = static_cast<Points::Feature*>(document->addObject("Points::Feature", "Actual"));
+        actual->Points.setValue(points);
+
+        feature = static_cast<Inspection::Feature*>(
+            document->addObject("Inspection::Feature", "Inspection"));
+        feature->Actual.setValue(actual);
+        feature->Nominals.setValues({nominal});
+        feature->SearchRadius.setValue(1.0);
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(document->getName());
+    }
+
+    // the distances of the actual points of SetUp()
+    static std::vector<float> expectedDistances()
+    {
+        std::vector<float> distances(81, 0.25F);
+        distances.push_back(-0.5F);
+        distances.push_back(FLT_MAX);
+        return distances;
+    }
+
+    void checkStatistics() const
+    {
+        EXPECT_NEAR(feature->RMS.getValue(), std::sqrt((81 * 0.0625 + 0.25) / 82), 1.0e-6);
+        EXPECT_FLOAT_EQ(feature->MinDistance.getValue(), -0.5F);
+        EXPECT_FLOAT_EQ(feature->MaxDistance.getValue(), 0.25F);
+
+        // 20 bins from -1 to 1
+        std::vector<long> histogram(20, 0);
+        histogram[5] = 1;
+        histogram[12] = 81;
+        EXPECT_EQ(feature->Histogram.getValues(), histogram);
+    }
+
+    App::Document* document {};
+    Inspection::Feature* feature {};
+};
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+TEST_F(InspectionFeatureTest, offsetPlane)
+{
+    document->recompute();
+    ASSERT_TRUE(feature->isValid());
+
+    std::vector<float> distances = feature->Distances.getValues();
+    std::vector<float> expected = expectedDistances();
+    ASSERT_EQ(distances.size(), expected.size());
+    for (std::size_t i = 0; i < distances.size(); i++) {
+        EXPECT_FLOAT_EQ(distances[i], expected[i]);
+    }
+    checkStatistics();
+}
+
+TEST_F(InspectionFeatureTest, offsetPlaneToFile)
+{
+    Base::FileInfo fi(Base::FileInfo::getTempFileName());
+    feature->DistanceFile.setValue(fi.filePath().c_str());
+    document->recompute();
+    ASSERT_TRUE(feature->isValid());
+
+    // the distances are written to the file as native floats instead
+    EXPECT_EQ(feature->Distances.getSize(), 0);
+    std::vector<float> expected = expectedDistances();
+    ASSERT_EQ(fi.size(), expected.size() * sizeof(float));
+    std::vector<float> distances(expected.size());
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
+    file.read(reinterpret_cast<char*>(distances.data()),
+              std::streamsize(distances.size() * sizeof(float)));
+    file.close();
+    fi.deleteFile();
+    for (std::size_t i = 0; i < distances.size(); i++) {
+        EXPECT_FLOAT_EQ(distances[i], expected[i]);
+    }
+    checkStatistics();
+}
+
+// Compares the distances found with the help of the tessellation of a shape with the distances
+// to the whole shape
+static void compareShapeDistances(const TopoDS_Shape& shape, bool compareSign)
+{
+    const float radius = 10.0F;
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Mod/Inspection/Inspection");
+    hGrp->SetBool("ExactShapeDistance", false);
+    Inspection::InspectNominalShape tessellated(shape, radius);
+    hGrp->SetBool("ExactShapeDistance", true);
+    Inspection::InspectNominalShape exact(shape, radius);
+    hGrp->RemoveBool("ExactShapeDistance");
+    ASSERT_TRUE(tessellated.isThreadSafe());
+    ASSERT_FALSE(exact.isThreadSafe());
+
+    // the deflection of the tessellation
+    Bnd_Box bounds;
+    BRepBndLib::Add(shape, bounds);
+    double tolerance = std::sqrt(bounds.SquareExtent()) * 0.001;
+
+    for (int i = -6; i <= 6; i++) {
+        for (int j = -6; j <= 6; j++) {
+            for (int k = -6; k <= 6; k++) {
+                Base::Vector3f point(float(i) * 0.7F, float(j) * 0.7F, 2.5F + float(k) * 0.9F);
+                float expected = exact.getDistance(point);
+                float distance = tessellated.getDistance(point);
+                if (compareSign) {
+                    EXPECT_NEAR(distance, expected, tolerance) << point.x << ", " << point.y
+                                                               << ", " << point.z;
+                }
+                else {
+                    EXPECT_NEAR(std::fabs(distance), std::fabs(expected), tolerance)
+                        << point.x << ", " << point.y << ", " << point.z;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(InspectionFeatureTest, tessellatedShapeDistance)
+{
+    TopoDS_Shape cylinder = BRepPrimAPI_MakeCylinder(2.0, 5.0).Shape();
+    compareShapeDistances(cylinder, true);
+
+    // the sign of the distance to an open shell depends on the face used
+    TopoDS_Shape sphere = BRepPrimAPI_MakeSphere(gp_Pnt(0.0, 0.0, 2.5), 3.0).Shape();
+    TopExp_Explorer xp(sphere, TopAbs_SHELL);
+    ASSERT_TRUE(xp.More());
+    compareShapeDistances(xp.Current(), false);
+}
+// NOLINTEND(cppcoreguidelines-*,readability-*)
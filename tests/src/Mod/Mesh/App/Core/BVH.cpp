@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <list>
+#include <Base/Exception.h>
+#include <Base/Sequencer.h>
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/SetOperations.h>
+#include "MeshTestHelpers.h"
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class BVHTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A wavy surface with enough facets to be searched by several threads
+        kernel = MeshTestHelpers::createWavySurface(100);
+    }
+
+    void TearDown() override
+    {}
+
+    MeshCore::MeshKernel kernel;
+};
+
+// A sequencer that cancels at the first step that can be canceled
+class CancelSequencer: public Base::SequencerBase
+{
+protected:
+    void nextStep(bool canAbort) override
+    {
+        if (canAbort) {
+            throw Base::AbortException("canceled");
+        }
+    }
+};
+
+TEST_F(BVHTest, TestInside)
+{
+    MeshCore::MeshFacetBVH bvh(kernel);
+    EXPECT_FLOAT_EQ(bvh.GetBoundBox().MinX, kernel.GetBoundBox().MinX);
+    EXPECT_FLOAT_EQ(bvh.GetBoundBox().MaxZ, kernel.GetBoundBox().MaxZ);
+
+    Base::BoundBox3f box(10.5F, 20.5F, -10.0F, 12.5F, 22.5F, 10.0F);
+    std::vector<MeshCore::FacetIndex> facets;
+    bvh.Inside(box, facets);
+
+    std::vector<MeshCore::FacetIndex> expected;
+    for (MeshCore::FacetIndex index = 0; index < kernel.CountFacets(); index++) {
+        if (kernel.GetFacet(index).GetBoundBox() && box) {
+            expected.push_back(index);
+        }
+    }
+    EXPECT_EQ(facets, expected);
+}
+
+TEST_F(BVHTest, TestNearestFacet)
+{
+    MeshCore::MeshFacetBVH bvh(kernel);
+    for (const Base::Vector3f& point : {Base::Vector3f(10.3F, 20.7F, 8.0F),
+                                        Base::Vector3f(-5.0F, 50.0F, 0.0F),
+                                        Base::Vector3f(99.9F, 0.1F, -7.0F)}) {
+        float expected = FLT_MAX;
+        for (MeshCore::FacetIndex index = 0; index < kernel.CountFacets(); index++) {
+            expected = std::min(expected, kernel.GetFacet(index).DistanceToPoint(point));
+        }
+
+        float distance {};
+        MeshCore::FacetIndex nearest = bvh.NearestFacet(point, FLT_MAX, distance);
+        ASSERT_NE(nearest, MeshCore::FACET_INDEX_MAX);
+        EXPECT_FLOAT_EQ(distance, expected);
+        EXPECT_FLOAT_EQ(kernel.GetFacet(nearest).DistanceToPoint(point), expected);
+    }
+
+    float distance {};
+    EXPECT_EQ(bvh.NearestFacet(Base::Vector3f(50.0F, 50.0F, 100.0F), 10.0F, distance),
+              MeshCore::FACET_INDEX_MAX);
+}
+
+TEST_F(BVHTest, TestWindingNumber)
+{
+    // a sphere of radius 10 with the normals pointing outwards
+    MeshCore::MeshKernel sphere = MeshTestHelpers::createGrid(64, [](int i, int j) {
+        float theta = float(i) * float(M_PI) / 64.0F;
+        float phi = float(j) * float(M_PI) / 32.0F;
+        return Base::Vector3f(std::sin(theta) * std::cos(phi),
+                              std::sin(theta) * std::sin(phi),
+                              std::cos(theta))
+            * 10.0F;
+    });
+    MeshCore::MeshFacetBVH bvh(sphere);
+    MeshCore::MeshFacetBVH::WindingNumber winding(bvh);
+
+    Base::Vector3d dir(0.3, -0.5, 0.8);
+    dir.Normalize();
+    for (double radius : {0.0, 5.0, 9.8, 10.1, 15.0, 100.0}) {
+        EXPECT_NEAR(winding.Evaluate(dir * radius), radius < 10.0 ? 1.0 : 0.0, 0.05) << radius;
+    }
+}
+
+TEST_F(BVHTest, TestSelfPairsEqualBruteForce)
+{
+    MeshCore::MeshKernel mesh = MeshTestHelpers::createWavySurface(10);
+    MeshCore::MeshFacetBVH bvh(mesh);
+    auto pairs = bvh.FindPairs([](MeshCore::FacetIndex, MeshCore::FacetIndex) {
+        return true;
+    });
+
+    std::vector<MeshCore::MeshFacetBVH::FacetPair> expected;
+    for (MeshCore::FacetIndex i = 0; i < mesh.CountFacets(); i++) {
+        for (MeshCore::FacetIndex j = i + 1; j < mesh.CountFacets(); j++) {
+            if (mesh.GetFacet(i).GetBoundBox() && mesh.GetFacet(j).GetBoundBox()) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST_F(BVHTest, TestNoSelfIntersection)
+{
+    MeshCore::MeshEvalSelfIntersection eval(kernel);
+    EXPECT_TRUE(eval.Evaluate());
+
+    std::vector<std::pair<MeshCore::FacetIndex, MeshCore::FacetIndex>> intersection;
+    eval.GetIntersections(intersection);
+    EXPECT_TRUE(intersection.empty());
+}
+
+TEST_F(BVHTest, TestSelfIntersection)
+{
+    // add a facet that pierces the surface
+    MeshCore::MeshGeomFacet facet(Base::Vector3f(50.2F, 50.3F, -20.0F),
+                                  Base::Vector3f(50.8F, 50.4F, -20.0F),
+                                  Base::Vector3f(50.5F, 50.6F, 20.0F));
+    kernel.AddFacets(std::vector<MeshCore::MeshGeomFacet> {facet});
+    MeshCore::FacetIndex piercing = kernel.CountFacets() - 1;
+
+    MeshCore::MeshEvalSelfIntersection eval(kernel);
+    EXPECT_FALSE(eval.Evaluate());
+
+    std::vector<std::pair<MeshCore::FacetIndex, MeshCore::FacetIndex>> intersection;
+    eval.GetIntersections(intersection);
+    ASSERT_FALSE(intersection.empty());
+    for (const auto& it : intersection) {
+        EXPECT_LT(it.first, it.second);
+        EXPECT_EQ(it.second, piercing);
+    }
+}
+
+TEST_F(BVHTest, TestSelfIntersectionLines)
+{
+    MeshCore::MeshGeomFacet facet(Base::Vector3f(50.2F, 50.3F, -20.0F),
+                                  Base::Vector3f(50.8F, 50.4F, -20.0F),
+                                  Base::Vector3f(50.5F, 50.6F, 20.0F));
+    kernel.AddFacets(std::vector<MeshCore::MeshGeomFacet> {facet});
+
+    MeshCore::MeshEvalSelfIntersection eval(kernel);
+    std::vector<std::pair<MeshCore::FacetIndex, MeshCore::FacetIndex>> expected;
+    eval.GetIntersections(expected);
+    std::vector<std::pair<Base::Vector3f, Base::Vector3f>> expectedLines;
+    eval.GetIntersections(expected, expectedLines);
+
+    std::vector<std::pair<MeshCore::FacetIndex, MeshCore::FacetIndex>> intersection;
+    std::vector<std::pair<Base::Vector3f, Base::Vector3f>> lines;
+    eval.GetIntersectionsAndLines(intersection, lines);
+    EXPECT_EQ(intersection, expected);
+    ASSERT_EQ(lines.size(), expectedLines.size());
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        EXPECT_EQ(lines[i].first, expectedLines[i].first);
+        EXPECT_EQ(lines[i].second, expectedLines[i].second);
+    }
+}
+
+TEST_F(BVHTest, TestCancelSelfIntersection)
+{
+    CancelSequencer seq;
+    for (int count : {10, 100}) {
+        MeshCore::MeshKernel mesh = MeshTestHelpers::createWavySurface(count);
+        MeshCore::MeshEvalSelfIntersection eval(mesh);
+        std::vector<std::pair<MeshCore::FacetIndex, MeshCore::FacetIndex>> intersection;
+        EXPECT_THROW(eval.GetIntersections(intersection), Base::AbortException);
+        EXPECT_THROW(eval.Evaluate(), Base::AbortException);
+    }
+}
+
+TEST_F(BVHTest, TestMeshIntersection)
+{
+    auto createPlane = [](float z) {
+        Base::Vector3f p1(-1.0F, -1.0F, z);
+        Base::Vector3f p2(101.0F, -1.0F, z);
+        Base::Vector3f p3(101.0F, 101.0F, z);
+        Base::Vector3f p4(-1.0F, 101.0F, z);
+        MeshCore::MeshKernel mesh;
+        mesh = std::vector<MeshCore::MeshGeomFacet> {MeshCore::MeshGeomFacet(p1, p2, p3),
+                                                     MeshCore::MeshGeomFacet(p1, p3, p4)};
+        return mesh;
+    };
+
+    MeshCore::MeshKernel plane = createPlane(0.5F);
+    MeshCore::MeshIntersection cut(kernel, plane, 0.1F);
+    EXPECT_TRUE(cut.hasIntersection());
+
+    std::list<MeshCore::MeshIntersection::Tuple> intsct;
+    cut.getIntersection(intsct);
+    ASSERT_FALSE(intsct.empty());
+    MeshCore::FacetIndex last = 0;
+    for (const auto& it : intsct) {
+        EXPECT_LT(it.f1, kernel.CountFacets());
+        EXPECT_LT(it.f2, plane.CountFacets());
+        EXPECT_LE(last, it.f2);
+        EXPECT_NEAR(it.p1.z, 0.5F, 1e-4F);
+        last = it.f2;
+    }
+
+    MeshCore::MeshKernel above = createPlane(10.0F);
+    MeshCore::MeshIntersection miss(kernel, above, 0.1F);
+    EXPECT_FALSE(miss.hasIntersection());
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
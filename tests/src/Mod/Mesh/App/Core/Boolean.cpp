@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/Boolean.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/Predicates.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class BooleanTest: public ::testing::Test
+{
+protected:
+    // Axis-aligned box with outward normals, every face split into count x count quads
+    static MeshCore::MeshKernel
+    createBox(const Base::Vector3f& min, const Base::Vector3f& max, int count)
+    {
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        auto point = [&](float i, float j, float k) {
+            return Base::Vector3f(min.x + (max.x - min.x) * i / float(count),
+                                  min.y + (max.y - min.y) * j / float(count),
+                                  min.z + (max.z - min.z) * k / float(count));
+        };
+        auto face = [&](const std::function<Base::Vector3f(float, float)>& pnt) {
+            for (int a = 0; a < count; a++) {
+                for (int b = 0; b < count; b++) {
+                    Base::Vector3f p00 = pnt(float(a), float(b));
+                    Base::Vector3f p10 = pnt(float(a + 1), float(b));
+                    Base::Vector3f p11 = pnt(float(a + 1), float(b + 1));
+                    Base::Vector3f p01 = pnt(float(a), float(b + 1));
+                    facets.emplace_back(p00, p10, p11);
+                    facets.emplace_back(p00, p11, p01);
+                }
+            }
+        };
+        float n = float(count);
+        face([&](float a, float b) { return point(a, b, n); });
+        face([&](float a, float b) { return point(b, a, 0); });
+        face([&](float a, float b) { return point(n, a, b); });
+        face([&](float a, float b) { return point(b, n, a); });
+        face([&](float a, float b) { return point(0, b, a); });
+        face([&](float a, float b) { return point(a, 0, b); });
+
+        MeshCore::MeshKernel mesh;
+        mesh = facets;
+        return mesh;
+    }
+
+    static MeshCore::MeshKernel compute(const MeshCore::MeshKernel& mesh1,
+                                        const MeshCore::MeshKernel& mesh2,
+                                        MeshCore::MeshBoolean::Operation op)
+    {
+        MeshCore::MeshKernel result;
+        MeshCore::MeshBoolean boolean(mesh1, mesh2, result, op);
+        boolean.Do();
+        return result;
+    }
+
+    static bool isClosed(const MeshCore::MeshKernel& mesh)
+    {
+        MeshCore::MeshAlgorithm algo(mesh);
+        return algo.CountBorderEdges() == 0;
+    }
+};
+
+TEST_F(BooleanTest, TestOrient2d)
+{
+    Base::Vector3d a(0, 0, 5);
+    Base::Vector3d b(1, 0, 7);
+    EXPECT_GT(MeshCore::Predicates::orient2d(a, b, Base::Vector3d(0, 1, 0), 2), 0.0);
+    EXPECT_LT(MeshCore::Predicates::orient2d(a, b, Base::Vector3d(0, -1, 0), 2), 0.0);
+    EXPECT_EQ(MeshCore::Predicates::orient2d(a, b, Base::Vector3d(3, 0, 0), 2), 0.0);
+}
+
+TEST_F(BooleanTest, TestNearlyCollinear)
+{
+    // The naive determinant rounds to zero for points one ulp away from the line
+    double next = std::nextafter(0.5, 1.0);
+    Base::Vector3d b(12, 12, 0);
+    Base::Vector3d c(24, 24, 0);
+    EXPECT_GT(MeshCore::Predicates::orient2d(Base::Vector3d(0.5, next, 0), b, c, 2), 0.0);
+    EXPECT_LT(MeshCore::Predicates::orient2d(Base::Vector3d(next, 0.5, 0), b, c, 2), 0.0);
+    EXPECT_EQ(MeshCore::Predicates::orient2d(Base::Vector3d(0.5, 0.5, 0), b, c, 2), 0.0);
+
+    Base::Vector3d top(0, 0, 2);
+    EXPECT_GT(MeshCore::Predicates::orient3d(Base::Vector3d(0.5, next, 0), b, top, c), 0.0);
+    EXPECT_LT(MeshCore::Predicates::orient3d(Base::Vector3d(next, 0.5, 0), b, top, c), 0.0);
+    EXPECT_EQ(MeshCore::Predicates::orient3d(Base::Vector3d(0.5, 0.5, 0), b, top, c), 0.0);
+}
+
+TEST_F(BooleanTest, TestOverlappingBoxes)
+{
+    MeshCore::MeshKernel box1 = createBox(Base::Vector3f(0, 0, 0), Base::Vector3f(1, 1, 1), 3);
+    MeshCore::MeshKernel box2 =
+        createBox(Base::Vector3f(0.5F, 0.5F, 0.5F), Base::Vector3f(1.5F, 1.5F, 1.5F), 2);
+
+    MeshCore::MeshKernel result = compute(box1, box2, MeshCore::MeshBoolean::Union);
+    EXPECT_NEAR(result.GetVolume(), 1.875F, 1.0e-5F);
+    EXPECT_TRUE(isClosed(result));
+
+    result = compute(box1, box2, MeshCore::MeshBoolean::Intersection);
+    EXPECT_NEAR(result.GetVolume(), 0.125F, 1.0e-5F);
+    EXPECT_TRUE(isClosed(result));
+
+    result = compute(box1, box2, MeshCore::MeshBoolean::Difference);
+    EXPECT_NEAR(result.GetVolume(), 0.875F, 1.0e-5F);
+    EXPECT_TRUE(isClosed(result));
+}
+
+TEST_F(BooleanTest, TestSharedFaces)
+{
+    // The boxes have coplanar faces with the same and with opposite orientation
+    MeshCore::MeshKernel box1 = createBox(Base::Vector3f(0, 0, 0), Base::Vector3f(1, 1, 1), 3);
+    MeshCore::MeshKernel box2 = createBox(Base::Vector3f(0.5F, 0, 0), Base::Vector3f(1.5F, 1, 1), 2);
+
+    MeshCore::MeshKernel result = compute(box1, box2, MeshCore::MeshBoolean::Union);
+    EXPECT_NEAR(result.GetVolume(), 1.5F, 1.0e-5F);
+    EXPECT_TRUE(isClosed(result));
+
+    result = compute(box1, box2, MeshCore::MeshBoolean::Intersection);
+    EXPECT_NEAR(result.GetVolume(), 0.5F, 1.0e-5F);
+    EXPECT_TRUE(isClosed(result));
+
+    result = compute(box1, box2, MeshCore::MeshBoolean::Difference);
+    EXPECT_NEAR(result.GetVolume(), 0.5F, 1.0e-5F);
+    EXPECT_TRUE(isClosed(result));
+}
+
+TEST_F(BooleanTest, TestThinWalls)
+{
+    // Parallel walls 1e-5 apart are closer than any tolerance relative to the model size, but
+    // they are not coplanar
+    MeshCore::MeshKernel box1 = createBox(Base::Vector3f(0, 0, 0), Base::Vector3f(10, 10, 10), 2);
+    MeshCore::MeshKernel gap =
+        createBox(Base::Vector3f(10.00001F, 0, 0), Base::Vector3f(20, 10, 10), 3);
+    MeshCore::MeshKernel overlap =
+        createBox(Base::Vector3f(9.99999F, 0, 0), Base::Vector3f(20, 10, 10), 3);
+
+    MeshCore::MeshKernel result = compute(box1, gap, MeshCore::MeshBoolean::Union);
+    EXPECT_EQ(result.CountFacets(), box1.CountFacets() + gap.CountFacets());
+    EXPECT_EQ(compute(box1, gap, MeshCore::MeshBoolean::Intersection).CountFacets(), 0U);
+    EXPECT_EQ(compute(box1, gap, MeshCore::MeshBoolean::Difference).CountFacets(),
+              box1.CountFacets());
+
+    result = compute(box1, overlap, MeshCore::MeshBoolean::Intersection);
+    EXPECT_NEAR(result.GetVolume(), 1.0e-3F, 1.0e-4F);
+    EXPECT_TRUE(isClosed(result));
+
+    result = compute(box1, overlap, MeshCore::MeshBoolean::Union);
+    EXPECT_NEAR(result.GetVolume(), 2000.0F, 1.0e-2F);
+    EXPECT_TRUE(isClosed(result));
+}
+
+TEST_F(BooleanTest, TestDisjointAndContained)
+{
+    MeshCore::MeshKernel box1 = createBox(Base::Vector3f(0, 0, 0), Base::Vector3f(1, 1, 1), 1);
+    MeshCore::MeshKernel box2 = createBox(Base::Vector3f(2, 2, 2), Base::Vector3f(3, 3, 3), 1);
+    MeshCore::MeshKernel box3 =
+        createBox(Base::Vector3f(0.25F, 0.25F, 0.25F), Base::Vector3f(0.75F, 0.75F, 0.75F), 1);
+
+    EXPECT_NEAR(compute(box1, box2, MeshCore::MeshBoolean::Union).GetVolume(), 2.0F, 1.0e-5F);
+    EXPECT_EQ(compute(box1, box2, MeshCore::MeshBoolean::Intersection).CountFacets(), 0U);
+    EXPECT_NEAR(compute(box1, box3, MeshCore::MeshBoolean::Difference).GetVolume(),
+                0.875F,
+                1.0e-5F);
+    EXPECT_NEAR(compute(box1, box3, MeshCore::MeshBoolean::Intersection).GetVolume(),
+                0.125F,
+                1.0e-5F);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Mod/Mesh/App/Core/Curvature.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
+#include "MeshTestHelpers.h"
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class CurvatureTest: public ::testing::Test
+{
+protected:
+    // Sphere made of an octahedron whose facets are subdivided and projected onto the sphere
+    static MeshCore::MeshKernel createSphere(float radius, int count)
+    {
+        const Base::Vector3f corners[6] = {Base::Vector3f(1, 0, 0),
+                                           Base::Vector3f(0, 1, 0),
+                                           Base::Vector3f(-1, 0, 0),
+                                           Base::Vector3f(0, -1, 0),
+                                           Base::Vector3f(0, 0, 1),
+                                           Base::Vector3f(0, 0, -1)};
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        for (int i = 0; i < 4; i++) {
+            for (int top : {4, 5}) {
+                Base::Vector3f a = corners[i];
+                Base::Vector3f b = corners[(i + 1) % 4];
+                Base::Vector3f c = corners[top];
+                if (top == 5) {
+                    std::swap(a, b);
+                }
+                auto point = [&](int j, int k) {
+                    Base::Vector3f p = a + (b - a) * (float(j) / float(count))
+                        + (c - a) * (float(k) / float(count));
+                    return p.Normalize() * radius;
+                };
+                for (int j = 0; j < count; j++) {
+                    for (int k = 0; j + k < count; k++) {
+                        facets.emplace_back(point(j, k), point(j + 1, k), point(j, k + 1));
+                        if (j + k + 1 < count) {
+                            facets.emplace_back(point(j + 1, k),
+                                                point(j + 1, k + 1),
+                                                point(j, k + 1));
+                        }
+                    }
+                }
+            }
+        }
+
+        MeshCore::MeshKernel mesh;
+        mesh = facets;
+        return mesh;
+    }
+
+    static MeshCore::MeshKernel createSurface(int count)
+    {
+        return MeshTestHelpers::createGrid(count, [](int i, int j) {
+            float x = float(i) + 0.3F * std::sin(float(i * j));
+            float y = float(j) + 0.3F * std::cos(float(i + j));
+            return Base::Vector3f(x, y, 4.0F * std::sin(x * 0.2F) * std::cos(y * 0.15F));
+        });
+    }
+};
+
+TEST_F(CurvatureTest, TestSphere)
+{
+    MeshCore::MeshKernel kernel = createSphere(2.0F, 20);
+    MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.ComputePerVertex();
+    const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
+    ASSERT_EQ(curv.size(), kernel.CountPoints());
+
+    // The estimation is worst at the corners of the octahedron
+    double mean = 0.0;
+    for (const auto& it : curv) {
+        EXPECT_GT(it.fMinCurvature, 0.0F);
+        EXPECT_LT(it.fMaxCurvature, 0.6F);
+        mean += 0.5 * (it.fMinCurvature + it.fMaxCurvature);
+    }
+    EXPECT_NEAR(mean / double(curv.size()), 0.5, 0.05);
+}
+
+TEST_F(CurvatureTest, TestSameAsWildMagic)
+{
+    // Enough points to be split among threads
+    MeshCore::MeshKernel kernel = createSurface(150);
+    MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.ComputePerVertex();
+    const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
+
+    std::vector<Wm4::Vector3<double>> points;
+    for (const auto& it : kernel.GetPoints()) {
+        points.emplace_back(it.x, it.y, it.z);
+    }
+    std::vector<int> indices;
+    for (const auto& it : kernel.GetFacets()) {
+        for (MeshCore::PointIndex point : it._aulPoints) {
+            indices.push_back(int(point));
+        }
+    }
+    Wm4::MeshCurvature<double> wm4(int(points.size()),
+                                   points.data(),
+                                   int(kernel.CountFacets()),
+                                   indices.data());
+
+    ASSERT_EQ(curv.size(), points.size());
+    for (std::size_t i = 0; i < curv.size(); i++) {
+        EXPECT_NEAR(curv[i].fMaxCurvature, wm4.GetMaxCurvatures()[i], 1.0e-5);
+        EXPECT_NEAR(curv[i].fMinCurvature, wm4.GetMinCurvatures()[i], 1.0e-5);
+        const Wm4::Vector3<double>& dir = wm4.GetMaxDirections()[i];
+        double dot = curv[i].cMaxCurvDir.x * dir.X() + curv[i].cMaxCurvDir.y * dir.Y()
+            + curv[i].cMaxCurvDir.z * dir.Z();
+        EXPECT_NEAR(std::fabs(dot), 1.0, 1.0e-4);
+    }
+}
+
+TEST_F(CurvatureTest, TestEmptyMesh)
+{
+    MeshCore::MeshKernel kernel;
+    MeshCore::MeshCurvature meshCurv(kernel);
+    meshCurv.ComputePerVertex();
+    EXPECT_TRUE(meshCurv.GetCurvature().empty());
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/Decimation.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include "MeshTestHelpers.h"
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class DecimationTest: public ::testing::Test
+{
+protected:
+    static MeshCore::MeshKernel createSurface(int count)
+    {
+        return MeshTestHelpers::createGrid(count, [](int i, int j) {
+            return Base::Vector3f(float(i), float(j), std::sin(float(i) * 0.05F) * 0.5F);
+        });
+    }
+
+    static std::size_t countBoundaryPoints(const MeshCore::MeshKernel& mesh, float size)
+    {
+        std::size_t count = 0;
+        for (const auto& point : mesh.GetPoints()) {
+            if (point.x == 0.0F || point.y == 0.0F || point.x == size || point.y == size) {
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+TEST_F(DecimationTest, TestTargetSize)
+{
+    MeshCore::MeshKernel kernel = createSurface(50);
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.simplify(500);
+    EXPECT_LE(kernel.CountFacets(), 500);
+    EXPECT_GT(kernel.CountFacets(), 400);
+    EXPECT_GT(simplify.getMaxError(), 0.0);
+}
+
+TEST_F(DecimationTest, TestKeepBoundary)
+{
+    MeshCore::MeshKernel kernel = createSurface(50);
+    std::size_t boundary = countBoundaryPoints(kernel, 50.0F);
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setKeepBoundary(true);
+    simplify.simplify(1000);
+    EXPECT_EQ(countBoundaryPoints(kernel, 50.0F), boundary);
+    EXPECT_LE(kernel.CountFacets(), 1000);
+}
+
+TEST_F(DecimationTest, TestFeatureAngle)
+{
+    // a curved valley with a sharp edge along x = 20. Without a feature angle the quadrics of the
+    // curved sides allow facets to cut across the edge.
+    MeshCore::MeshKernel kernel = MeshTestHelpers::createGrid(40, [](int i, int j) {
+        float x = float(i - 20);
+        float y = float(j - 20);
+        return Base::Vector3f(float(i), float(j), std::fabs(x) + (x * x + y * y) * 0.01F);
+    });
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setFeatureAngle(0.5F);
+    simplify.simplify(200);
+    EXPECT_LE(kernel.CountFacets(), 200);
+
+    // the vertices of the edge are only collapsed with each other, so no facet has corners on
+    // both sides of the edge
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
+    for (const auto& facet : kernel.GetFacets()) {
+        bool left = false;
+        bool right = false;
+        for (MeshCore::PointIndex index : facet._aulPoints) {
+            left = left || points[index].x < 20.0F - 1.0e-4F;
+            right = right || points[index].x > 20.0F + 1.0e-4F;
+        }
+        EXPECT_FALSE(left && right);
+    }
+
+    std::size_t edgePoints = 0;
+    for (const auto& point : points) {
+        if (std::fabs(point.x - 20.0F) < 1.0e-4F) {
+            edgePoints++;
+        }
+    }
+    EXPECT_GE(edgePoints, 2);
+}
+
+TEST_F(DecimationTest, TestParallel)
+{
+    // Enough facets to be split into slabs
+    MeshCore::MeshKernel kernel = createSurface(250);
+    std::size_t boundary = countBoundaryPoints(kernel, 250.0F);
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.setKeepBoundary(true);
+    simplify.setNumThreads(4);
+    simplify.simplify(20000);
+    EXPECT_LE(kernel.CountFacets(), 20000);
+    EXPECT_GT(kernel.CountFacets(), 18000);
+    EXPECT_EQ(countBoundaryPoints(kernel, 250.0F), boundary);
+
+    MeshCore::MeshAlgorithm algo(kernel);
+    EXPECT_EQ(algo.CountBorderEdges(), 4 * 250);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/Grid.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include "MeshTestHelpers.h"
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class GridTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A wavy surface with enough facets to build the grid in parallel
+        kernel = MeshTestHelpers::createWavySurface(100);
+    }
+
+    void TearDown() override
+    {}
+
+    MeshCore::MeshKernel kernel;
+};
+
+TEST_F(GridTest, TestFacetGridCells)
+{
+    MeshCore::MeshFacetGrid grid(kernel, 5.0F);
+    EXPECT_TRUE(grid.Verify());
+
+    unsigned long ulX {}, ulY {}, ulZ {};
+    grid.GetCtGrids(ulX, ulY, ulZ);
+
+    // every facet is in the grids it intersects, in ascending order
+    std::vector<int> found(kernel.CountFacets(), 0);
+    for (unsigned long i = 0; i < ulX; i++) {
+        for (unsigned long j = 0; j < ulY; j++) {
+            for (unsigned long k = 0; k < ulZ; k++) {
+                MeshCore::MeshGridCell cell = grid.GetCell(i, j, k);
+                EXPECT_TRUE(std::is_sorted(cell.begin(), cell.end()));
+                EXPECT_EQ(std::adjacent_find(cell.begin(), cell.end()), cell.end());
+                EXPECT_EQ(grid.GetCtElements(i, j, k), cell.size());
+                for (MeshCore::ElementIndex index : cell) {
+                    found[index]++;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(std::count(found.begin(), found.end(), 0), 0);
+
+    MeshCore::MeshGeomFacet facet = kernel.GetFacet(1234);
+    std::vector<MeshCore::ElementIndex> elements;
+    grid.Inside(facet.GetBoundBox(), elements);
+    EXPECT_NE(std::find(elements.begin(), elements.end(), 1234), elements.end());
+}
+
+TEST_F(GridTest, TestPointGridCells)
+{
+    MeshCore::MeshPointGrid grid(kernel, 5.0F);
+
+    std::set<MeshCore::ElementIndex> elements;
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
+    for (MeshCore::ElementIndex index = 0; index < points.size(); index += 97) {
+        elements.clear();
+        grid.FindElements(points[index], elements);
+        EXPECT_EQ(elements.count(index), 1U);
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
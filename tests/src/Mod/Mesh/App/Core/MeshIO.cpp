@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshIO.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include "MeshTestHelpers.h"
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class MeshIOTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A wavy surface with enough facets to be loaded by several threads
+        kernel = MeshTestHelpers::createWavySurface(100);
+        fileInfo.setFile(Base::FileInfo::getTempFileName() + ".stl");
+    }
+
+    void TearDown() override
+    {
+        fileInfo.deleteFile();
+    }
+
+    static void expectEqual(const MeshCore::MeshKernel& mesh1, const MeshCore::MeshKernel& mesh2)
+    {
+        const MeshCore::MeshPointArray& points1 = mesh1.GetPoints();
+        const MeshCore::MeshPointArray& points2 = mesh2.GetPoints();
+        ASSERT_EQ(points1.size(), points2.size());
+        for (std::size_t i = 0; i < points1.size(); i++) {
+            EXPECT_EQ(points1[i], points2[i]);
+        }
+
+        const MeshCore::MeshFacetArray& facets1 = mesh1.GetFacets();
+        const MeshCore::MeshFacetArray& facets2 = mesh2.GetFacets();
+        ASSERT_EQ(facets1.size(), facets2.size());
+        for (std::size_t i = 0; i < facets1.size(); i++) {
+            for (int j = 0; j < 3; j++) {
+                EXPECT_EQ(facets1[i]._aulPoints[j], facets2[i]._aulPoints[j]);
+                EXPECT_EQ(facets1[i]._aulNeighbours[j], facets2[i]._aulNeighbours[j]);
+            }
+        }
+    }
+
+    MeshCore::MeshKernel kernel;
+    Base::FileInfo fileInfo;
+};
+
+TEST_F(MeshIOTest, MappedBinarySTLEqualsStream)
+{
+    {
+        Base::ofstream str(fileInfo, std::ios::out | std::ios::binary);
+        MeshCore::MeshOutput output(kernel);
+        ASSERT_TRUE(output.SaveBinarySTL(str));
+    }
+
+    MeshCore::MeshKernel mapped;
+    MeshCore::MeshInput mappedInput(mapped);
+    EXPECT_TRUE(mappedInput.LoadMappedBinarySTL(fileInfo.filePath().c_str()));
+
+    MeshCore::MeshKernel streamed;
+    MeshCore::MeshInput streamedInput(streamed);
+    Base::ifstream str(fileInfo, std::ios::in | std::ios::binary);
+    EXPECT_TRUE(streamedInput.LoadBinarySTL(str));
+
+    EXPECT_EQ(mapped.CountFacets(), kernel.CountFacets());
+    EXPECT_EQ(mapped.CountPoints(), kernel.CountPoints());
+    expectEqual(mapped, streamed);
+}
+
+TEST_F(MeshIOTest, MappedBinarySTLRejectsAsciiFile)
+{
+    {
+        Base::ofstream str(fileInfo, std::ios::out | std::ios::binary);
+        MeshCore::MeshOutput output(kernel);
+        ASSERT_TRUE(output.SaveAsciiSTL(str));
+    }
+
+    MeshCore::MeshKernel mapped;
+    MeshCore::MeshInput mappedInput(mapped);
+    EXPECT_FALSE(mappedInput.LoadMappedBinarySTL(fileInfo.filePath().c_str()));
+
+    // the fallback reads the file as ASCII
+    MeshCore::MeshInput input(mapped);
+    EXPECT_TRUE(input.LoadAny(fileInfo.filePath().c_str()));
+    EXPECT_EQ(mapped.CountFacets(), kernel.CountFacets());
+}
+
+TEST_F(MeshIOTest, BinaryPLYRoundTrip)
+{
+    std::stringstream str;
+    MeshCore::MeshOutput output(kernel);
+    ASSERT_TRUE(output.SaveBinaryPLY(str));
+
+    MeshCore::MeshKernel loaded;
+    MeshCore::MeshInput input(loaded);
+    EXPECT_TRUE(input.LoadPLY(str));
+    expectEqual(kernel, loaded);
+}
+
+TEST_F(MeshIOTest, BinaryPLYByteOrder)
+{
+    // the same triangle in both byte orders
+    auto writePLY = [](std::ostream& out, const char* format, Base::Stream::ByteOrder order) {
+        out << "ply\nformat " << format << " 1.0\n"
+            << "element vertex 3\nproperty float32 x\nproperty float32 y\nproperty float32 z\n"
+            << "element face 1\nproperty list uchar int vertex_index\nend_header\n";
+        Base::OutputStream os(out);
+        os.setByteOrder(order);
+        os << 0.0F << 0.0F << 0.5F << 1.5F << 0.0F << 0.5F << 0.0F << 2.5F << 0.5F;
+        os << static_cast<unsigned char>(3) << int32_t(0) << int32_t(1) << int32_t(2);
+    };
+    std::stringstream little;
+    writePLY(little, "binary_little_endian", Base::Stream::LittleEndian);
+    std::stringstream big;
+    writePLY(big, "binary_big_endian", Base::Stream::BigEndian);
+
+    MeshCore::MeshKernel mesh1;
+    MeshCore::MeshInput input1(mesh1);
+    ASSERT_TRUE(input1.LoadPLY(little));
+    MeshCore::MeshKernel mesh2;
+    MeshCore::MeshInput input2(mesh2);
+    ASSERT_TRUE(input2.LoadPLY(big));
+
+    ASSERT_EQ(mesh1.CountFacets(), 1);
+    EXPECT_EQ(mesh1.GetPoint(1), Base::Vector3f(1.5F, 0.0F, 0.5F));
+    EXPECT_EQ(mesh1.GetPoint(2), Base::Vector3f(0.0F, 2.5F, 0.5F));
+    expectEqual(mesh1, mesh2);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
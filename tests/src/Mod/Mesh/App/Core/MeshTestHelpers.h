@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef MESH_TEST_HELPERS_H
+#define MESH_TEST_HELPERS_H
+
+#include <cmath>
+#include <vector>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+namespace MeshTestHelpers
+{
+
+/// Returns a grid of count x count squares, each split into two facets. point(i, j) returns the
+/// corner i, j of the grid with 0 <= i, j <= count.
+template<typename PointFunc>
+MeshCore::MeshKernel createGrid(int count, PointFunc point)
+{
+    std::vector<MeshCore::MeshGeomFacet> facets;
+    facets.reserve(std::size_t(2 * count * count));
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+            facets.emplace_back(point(i, j), point(i + 1, j), point(i + 1, j + 1));
+            facets.emplace_back(point(i, j), point(i + 1, j + 1), point(i, j + 1));
+        }
+    }
+    MeshCore::MeshKernel mesh;
+    mesh = facets;
+    return mesh;
+}
+
+/// Returns a grid with unit squares in x and y that waves in z along the diagonal
+inline MeshCore::MeshKernel createWavySurface(int count)
+{
+    return createGrid(count, [](int i, int j) {
+        return Base::Vector3f(float(i), float(j), std::sin(float(i + j) * 0.2F) * 5.0F);
+    });
+}
+
+}  // namespace MeshTestHelpers
+
+#endif  // MESH_TEST_HELPERS_H
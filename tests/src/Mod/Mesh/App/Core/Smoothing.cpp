@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/Smoothing.h>
+#include "MeshTestHelpers.h"
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class SmoothingTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A plane at z = 1 with some noise
+        kernel = MeshTestHelpers::createGrid(size, [](int i, int j) {
+            return Base::Vector3f(float(i), float(j), 1.0F + float((i * 7 + j * 13) % 5) * 0.1F);
+        });
+    }
+
+    float roughness() const
+    {
+        float sum = 0.0F;
+        for (const auto& point : kernel.GetPoints()) {
+            sum += std::fabs(point.z - 1.2F);
+        }
+        return sum / float(kernel.CountPoints());
+    }
+
+    const int size = 120;
+    MeshCore::MeshKernel kernel;
+};
+
+TEST_F(SmoothingTest, TestOperator)
+{
+    MeshCore::LaplaceOperator laplace(kernel);
+    std::size_t movable = 0;
+    for (MeshCore::PointIndex index = 0; index < kernel.CountPoints(); index++) {
+        if (laplace.IsMovable(index)) {
+            movable++;
+        }
+    }
+    EXPECT_EQ(movable, std::size_t((size - 1) * (size - 1)));
+
+    // A step forward and a step backward give the same points
+    MeshCore::MeshPointArray points = kernel.GetPoints();
+    ASSERT_TRUE(laplace.Solve(1.0, 1, points));
+    MeshCore::MeshPointArray result;
+    laplace.Apply(-1.0, points, result);
+    for (MeshCore::PointIndex index = 0; index < kernel.CountPoints(); index++) {
+        EXPECT_NEAR(result[index].z, kernel.GetPoint(index).z, 1e-5F);
+    }
+}
+
+TEST_F(SmoothingTest, TestLaplace)
+{
+    float before = roughness();
+    Base::Vector3f corner = kernel.GetPoint(0);
+    MeshCore::LaplaceSmoothing smooth(kernel);
+    smooth.Smooth(10);
+    EXPECT_LT(roughness(), before * 0.2F);
+    EXPECT_EQ(kernel.GetPoint(0), corner);
+}
+
+TEST_F(SmoothingTest, TestTaubin)
+{
+    float before = roughness();
+    MeshCore::TaubinSmoothing smooth(kernel);
+    smooth.Smooth(10);
+    EXPECT_LT(roughness(), before * 0.5F);
+}
+
+TEST_F(SmoothingTest, TestImplicitLaplace)
+{
+    float before = roughness();
+    MeshCore::ImplicitLaplaceSmoothing smooth(kernel);
+    smooth.SetLambda(10.0);
+    smooth.Smooth(1);
+    EXPECT_LT(roughness(), before * 0.2F);
+}
+
+TEST_F(SmoothingTest, TestSmoothPoints)
+{
+    MeshCore::MeshPointArray points = kernel.GetPoints();
+    MeshCore::LaplaceSmoothing smooth(kernel);
+    std::vector<MeshCore::PointIndex> indices {std::size_t(size + 2)};
+    smooth.SmoothPoints(1, indices);
+    for (MeshCore::PointIndex index = 0; index < kernel.CountPoints(); index++) {
+        if (index != indices.front()) {
+            EXPECT_EQ(kernel.GetPoint(index), points[index]);
+        }
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -1,5 +1,11 @@
 #include "gtest/gtest.h"
 #include <src/App/InitApplication.h>
+#include <memory>
+#include <App/Application.h>
+#include <App/Document.h>
+#include <Base/FileInfo.h>
+#include <Base/Interpreter.h>
+#include <Base/Parameter.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 
 class MeshFeatureTest: public ::testing::Test
@@ -37,4 +43,137 @@ TEST_F(MeshFeatureTest, getComplexElementTypes)
     EXPECT_STREQ(types[0], "Mesh");
     EXPECT_STREQ(types[1], "Segment");
 }
+
+TEST_F(MeshFeatureTest, copyMeshPropertyOnWrite)
+{
+    MeshCore::MeshKernel kernel;
+    Base::Vector3f p1 {0, 0, 0};
+    Base::Vector3f p2 {1, 0, 0};
+    Base::Vector3f p3 {0, 1, 0};
+    Base::Vector3f p4 {1, 1, 0};
+    kernel.AddFacet(MeshCore::MeshGeomFacet(p1, p2, p3));
+
+    Mesh::Feature mf;
+    mf.Mesh.setValue(kernel);
+    const Mesh::MeshObject* mesh = mf.Mesh.getValuePtr();
+    unsigned int size = mf.Mesh.getMemSize();
+
+    // the copy shares the mesh
+    std::unique_ptr<Mesh::PropertyMeshKernel> copy(
+        static_cast<Mesh::PropertyMeshKernel*>(mf.Mesh.Copy()));
+    EXPECT_EQ(copy->getValuePtr(), mesh);
+    EXPECT_EQ(copy->getMemSize(), mf.Mesh.getMemSize());
+    EXPECT_LT(mf.Mesh.getMemSize(), size);
+
+    // the modified property keeps the mesh, the copy keeps the content
+    Mesh::MeshObject* editing = mf.Mesh.startEditing();
+    editing->addFacet(MeshCore::MeshGeomFacet(p3, p2, p4));
+    mf.Mesh.finishEditing();
+    EXPECT_EQ(editing, mesh);
+    EXPECT_NE(copy->getValuePtr(), mesh);
+    EXPECT_EQ(mf.Mesh.getValue().countFacets(), 2);
+    EXPECT_EQ(copy->getValue().countFacets(), 1);
+
+    // pasting back restores the content
+    mf.Mesh.Paste(*copy);
+    EXPECT_EQ(mf.Mesh.getValuePtr(), mesh);
+    EXPECT_EQ(mf.Mesh.getValue().countFacets(), 1);
+}
+
+TEST_F(MeshFeatureTest, swapSharedMeshProperty)
+{
+    Base::Vector3f p1 {0, 0, 0};
+    Base::Vector3f p2 {1, 0, 0};
+    Base::Vector3f p3 {0, 1, 0};
+    Base::Vector3f p4 {1, 1, 0};
+    MeshCore::MeshKernel kernel;
+    kernel.AddFacet(MeshCore::MeshGeomFacet(p1, p2, p3));
+
+    Mesh::Feature mf;
+    mf.Mesh.setValue(kernel);
+    const Mesh::MeshObject* mesh = mf.Mesh.getValuePtr();
+    std::unique_ptr<Mesh::PropertyMeshKernel> copy(
+        static_cast<Mesh::PropertyMeshKernel*>(mf.Mesh.Copy()));
+
+    // the caller gets the old content, the copy keeps it
+    kernel.AddFacet(MeshCore::MeshGeomFacet(p3, p2, p4));
+    mf.Mesh.swapMesh(kernel);
+    EXPECT_EQ(mf.Mesh.getValuePtr(), mesh);
+    EXPECT_EQ(mf.Mesh.getValue().countFacets(), 2);
+    EXPECT_EQ(kernel.CountFacets(), 1);
+    EXPECT_EQ(copy->getValue().countFacets(), 1);
+
+    Mesh::MeshObject other;
+    mf.Mesh.swapMesh(other);
+    EXPECT_EQ(mf.Mesh.getValue().countFacets(), 0);
+    EXPECT_EQ(other.countFacets(), 2);
+    EXPECT_EQ(copy->getValue().countFacets(), 1);
+}
+
+TEST_F(MeshFeatureTest, keepCurvatureUntilModified)
+{
+    MeshCore::MeshKernel kernel;
+    Base::Vector3f p1 {0, 0, 0};
+    Base::Vector3f p2 {1, 0, 0};
+    Base::Vector3f p3 {0, 1, 0};
+    Base::Vector3f p4 {1, 1, 1};
+    kernel.AddFacet(MeshCore::MeshGeomFacet(p1, p2, p3));
+
+    Mesh::Feature mf;
+    mf.Mesh.setValue(kernel);
+    const std::vector<MeshCore::CurvatureInfo>* curvature = &mf.Mesh.getCurvature();
+    EXPECT_EQ(curvature->size(), 3);
+    EXPECT_EQ(&mf.Mesh.getCurvature(), curvature);
+
+    // a copy shares the result with the property
+    std::unique_ptr<Mesh::PropertyMeshKernel> copy(
+        static_cast<Mesh::PropertyMeshKernel*>(mf.Mesh.Copy()));
+    EXPECT_EQ(&copy->getCurvature(), curvature);
+
+    Mesh::MeshObject* editing = mf.Mesh.startEditing();
+    editing->addFacet(MeshCore::MeshGeomFacet(p3, p2, p4));
+    mf.Mesh.finishEditing();
+    EXPECT_EQ(mf.Mesh.getCurvature().size(), 4);
+    EXPECT_EQ(&copy->getCurvature(), curvature);
+}
+
+TEST_F(MeshFeatureTest, lazyRestoreMeshProperty)
+{
+    Base::Interpreter().runString("import Mesh");
+    MeshCore::MeshKernel kernel;
+    Base::Vector3f p1 {0, 0, 0};
+    Base::Vector3f p2 {1, 0, 0};
+    Base::Vector3f p3 {0, 1, 0};
+    Base::Vector3f p4 {1, 1, 0};
+    kernel.AddFacet(MeshCore::MeshGeomFacet(p1, p2, p3));
+    kernel.AddFacet(MeshCore::MeshGeomFacet(p3, p2, p4));
+
+    App::Document* doc = App::GetApplication().newDocument("LazyMesh");
+    auto mf = static_cast<Mesh::Feature*>(doc->addObject("Mesh::Feature", "Mesh"));
+    mf->Mesh.setValue(kernel);
+    Base::FileInfo fi(Base::FileInfo::getTempFileName() + ".FCStd");
+    ASSERT_TRUE(doc->saveCopy(fi.filePath().c_str()));
+    App::GetApplication().closeDocument(doc->getName());
+
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool lazyRestore = hGrp->GetBool("LazyRestore", false);
+    hGrp->SetBool("LazyRestore", true);
+    doc = App::GetApplication().openDocument(fi.filePath().c_str());
+    hGrp->SetBool("LazyRestore", lazyRestore);
+    ASSERT_NE(doc, nullptr);
+    mf = dynamic_cast<Mesh::Feature*>(doc->getObject("Mesh"));
+    ASSERT_NE(mf, nullptr);
+
+    // a copy made before the first access loads the mesh on its own
+    std::unique_ptr<Mesh::PropertyMeshKernel> copy(
+        static_cast<Mesh::PropertyMeshKernel*>(mf->Mesh.Copy()));
+    EXPECT_EQ(mf->Mesh.getValue().countFacets(), 2);
+    EXPECT_EQ(mf->Mesh.getValue().countPoints(), 4);
+    EXPECT_EQ(copy->getValue().countFacets(), 2);
+    // restoring the mesh on access doesn't change the document
+    EXPECT_FALSE(mf->isTouched());
+    App::GetApplication().closeDocument(doc->getName());
+    fi.deleteFile();
+}
 // NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gtest/gtest.h>
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include "Mod/Part/App/FeaturePartCut.h"
+#include "Mod/Part/App/FeatureResultCache.h"
+#include <src/App/InitApplication.h>
+
+#include "PartTestHelpers.h"
+
+class FeatureResultCacheTest: public ::testing::Test, public PartTestHelpers::PartTestHelperClass
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+    }
+
+    void SetUp() override
+    {
+        createTestDoc();
+        _cut = dynamic_cast<Part::Cut*>(_doc->addObject("Part::Cut"));
+        _cut->Base.setValue(_boxes[0]);
+        _cut->Tool.setValue(_boxes[1]);
+        Part::FeatureResultCache::instance().clear();
+    }
+
+    void TearDown() override
+    {
+        getParameterGroup()->SetBool("Enable", false);
+        Part::FeatureResultCache::instance().clear();
+        Part::FeatureResultCache::instance().setMaxMemSize(256 * 1024 * 1024);  // NOLINT
+    }
+
+    static ParameterGrp::handle getParameterGroup()
+    {
+        return App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Mod/Part/ResultCache");
+    }
+
+    Part::Cut* _cut = nullptr;  // NOLINT Can't be private in a test framework
+};
+
+TEST_F(FeatureResultCacheTest, testKeyIsStable)
+{
+    // Act
+    auto key1 = Part::FeatureResultCache::computeKey(_cut);
+    auto key2 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Assert
+    EXPECT_FALSE(key1.empty());
+    EXPECT_EQ(key1, key2);
+}
+
+TEST_F(FeatureResultCacheTest, testKeyChangesWithLink)
+{
+    // Arrange
+    auto key1 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Act
+    _cut->Tool.setValue(_boxes[2]);
+    auto key2 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Assert
+    EXPECT_NE(key1, key2);
+}
+
+TEST_F(FeatureResultCacheTest, testKeyChangesWithLinkedShape)
+{
+    // Arrange
+    auto key1 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Act
+    _boxes[1]->Length.setValue(5.0);  // NOLINT
+    _boxes[1]->recomputeFeature();
+    auto key2 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Assert
+    EXPECT_NE(key1, key2);
+}
+
+TEST_F(FeatureResultCacheTest, testKeyIgnoresLabel)
+{
+    // Arrange
+    auto key1 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Act
+    _cut->Label.setValue("Renamed");
+    auto key2 = Part::FeatureResultCache::computeKey(_cut);
+
+    // Assert
+    EXPECT_EQ(key1, key2);
+}
+
+TEST_F(FeatureResultCacheTest, testRecomputeStoresResult)
+{
+    // Arrange
+    getParameterGroup()->SetBool("Enable", true);
+
+    // Act
+    _doc->recompute();
+
+    // Assert
+    EXPECT_EQ(_cut->Shape.getCacheKey(), Part::FeatureResultCache::computeKey(_cut));
+    EXPECT_GE(Part::FeatureResultCache::instance().size(), 1);
+    Part::TopoShape shape;
+    EXPECT_TRUE(Part::FeatureResultCache::instance().find(_cut->Shape.getCacheKey(), shape));
+    EXPECT_DOUBLE_EQ(PartTestHelpers::getVolume(shape.getShape()), 3.0);
+}
+
+TEST_F(FeatureResultCacheTest, testRecomputeReusesResult)
+{
+    // Arrange
+    getParameterGroup()->SetBool("Enable", true);
+    _doc->recompute();
+    auto key = _cut->Shape.getCacheKey();
+    TopoDS_Shape shape = _cut->Shape.getValue();
+    auto history = _cut->History.getValues();
+
+    // Act
+    _cut->Tool.setValue(_boxes[2]);
+    _doc->recompute();
+    EXPECT_FALSE(_cut->Shape.getValue().IsSame(shape));
+    _cut->History.setValues({});
+    _cut->Tool.setValue(_boxes[1]);
+    _doc->recompute();
+
+    // Assert
+    EXPECT_EQ(_cut->Shape.getCacheKey(), key);
+    EXPECT_DOUBLE_EQ(PartTestHelpers::getVolume(_cut->Shape.getValue()), 3.0);
+    // execute() would have made a new shape
+    EXPECT_TRUE(_cut->Shape.getValue().IsSame(shape));
+    // the other outputs are restored as well
+    EXPECT_EQ(_cut->History.getSize(), static_cast<int>(history.size()));
+}
+
+TEST_F(FeatureResultCacheTest, testSetValueClearsKey)
+{
+    // Arrange
+    getParameterGroup()->SetBool("Enable", true);
+    _doc->recompute();
+
+    // Act
+    _cut->Shape.setValue(_boxes[0]->Shape.getShape());
+
+    // Assert
+    EXPECT_TRUE(_cut->Shape.getCacheKey().empty());
+}
+
+TEST_F(FeatureResultCacheTest, testEvictLeastRecentlyUsed)
+{
+    // Arrange
+    _doc->recompute();
+    auto& cache = Part::FeatureResultCache::instance();
+    cache.clear();
+    cache.setMaxMemSize(0);
+
+    // Act
+    cache.add("first", _boxes[0]->Shape.getShape());
+    cache.add("second", _boxes[1]->Shape.getShape());
+
+    // Assert
+    Part::TopoShape shape;
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_FALSE(cache.find("first", shape));
+    EXPECT_TRUE(cache.find("second", shape));
+}
@@ -8,6 +8,12 @@
 #include <src/App/InitApplication.h>
 #include "PartTestHelpers.h"
 #include "Mod/Part/App/TopoShapeCompoundPy.h"
+#include <App/Application.h>
+#include <App/Document.h>
+#include <Base/FileInfo.h>
+#include <Base/Parameter.h>
+#include <Base/Reader.h>
+#include <Base/Writer.h>
 
 using namespace Part;
 using namespace PartTestHelpers;
@@ -186,3 +192,57 @@ TEST_F(PropertyTopoShapeTest, testPropertyShapeCachePyObj)
     Py_XDECREF(pyObjOut);
     Py_XDECREF(pyObjOutErased);
 }
+
+TEST_F(PropertyTopoShapeTest, testPropertyPartShapeRestoreDetectsFormat)
+{
+    // Arrange
+    auto shapeIn = _common->Shape.getShape();
+    for (bool binary : {true, false}) {
+        Base::StringWriter writer;
+        if (binary) {
+            writer.setMode("BinaryBrep");
+        }
+        _common->Shape.SaveDocFile(writer);
+        std::istringstream str(writer.getString());
+        // The file name tells the other format, the data must win
+        Base::Reader reader(str, binary ? "PartShape.brp" : "PartShape.bin", 0);
+        PropertyPartShape partShape;
+        // Act
+        partShape.RestoreDocFile(reader);
+        // Assert
+        EXPECT_FALSE(partShape.getValue().IsNull());
+        EXPECT_DOUBLE_EQ(getVolume(partShape.getValue()), getVolume(shapeIn.getShape()));
+    }
+}
+
+TEST_F(PropertyTopoShapeTest, testPropertyPartShapeLazyRestore)
+{
+    // Arrange
+    Base::FileInfo fi(Base::FileInfo::getTempFileName() + ".FCStd");
+    ASSERT_TRUE(_doc->saveCopy(fi.filePath().c_str()));
+    Base::StringWriter writerIn;
+    _common->Shape.SaveDocFile(writerIn);
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool lazyRestore = hGrp->GetBool("LazyRestore", false);
+    hGrp->SetBool("LazyRestore", true);
+    // Act
+    App::Document* doc = App::GetApplication().openDocument(fi.filePath().c_str());
+    hGrp->SetBool("LazyRestore", lazyRestore);
+    ASSERT_NE(doc, nullptr);
+    auto common = dynamic_cast<Common*>(doc->getObject(_common->getNameInDocument()));
+    ASSERT_NE(common, nullptr);
+    // the first access restores the shape
+    auto shapeOut = common->Shape.getShape();
+    Base::StringWriter writerOut;
+    common->Shape.SaveDocFile(writerOut);
+    // Assert
+    EXPECT_FALSE(shapeOut.isNull());
+    EXPECT_DOUBLE_EQ(getVolume(shapeOut.getShape()), getVolume(_common->Shape.getValue()));
+    EXPECT_EQ(shapeOut.getElementMapSize(), _common->Shape.getShape().getElementMapSize());
+    EXPECT_EQ(writerOut.getString(), writerIn.getString());
+    // restoring the shape on access doesn't change the document
+    EXPECT_FALSE(common->isTouched());
+    App::GetApplication().closeDocument(doc->getName());
+    fi.deleteFile();
+}